@@ -0,0 +1,54 @@
+QT      += core gui widgets svg
+
+TARGET   = ttf-explorer
+TEMPLATE = app
+
+CONFIG  += c++17
+CONFIG  += sdk_no_version_check
+
+equals(QMAKE_CXX, clang++) {
+    QMAKE_CXXFLAGS += -Wextra -Wpedantic -Wimplicit-fallthrough -Wconversion
+}
+
+# required to make C++17 work on macOS
+mac:QMAKE_MACOSX_DEPLOYMENT_TARGET = 10.15
+
+include(ttfexplorer-core.pri)
+
+# Inflates compressed SVG documents.
+# Qt exports its bundled zlib, unless it was built against the system one.
+qtHaveModule(zlib-private) {
+    QT += zlib-private
+} else {
+    LIBS += -lz
+}
+
+SOURCES += \
+    src/bitmapview.cpp \
+    src/comparewindow.cpp \
+    src/coveragedialog.cpp \
+    src/glyphgrid.cpp \
+    src/hexview.cpp \
+    src/layoutdialog.cpp \
+    src/lookupdialog.cpp \
+    src/main.cpp \
+    src/mainwindow.cpp \
+    src/pairsdialog.cpp \
+    src/svgview.cpp \
+    src/treemodel.cpp \
+    src/variationsdialog.cpp
+
+HEADERS += \
+    src/app.h \
+    src/bitmapview.h \
+    src/comparewindow.h \
+    src/coveragedialog.h \
+    src/glyphgrid.h \
+    src/hexview.h \
+    src/layoutdialog.h \
+    src/lookupdialog.h \
+    src/mainwindow.h \
+    src/pairsdialog.h \
+    src/svgview.h \
+    src/treemodel.h \
+    src/variationsdialog.h
@@ -0,0 +1,26 @@
+QT       = core
+
+TARGET   = ttf-explorer-bench
+TEMPLATE = app
+
+CONFIG  += c++17 console
+CONFIG  -= app_bundle
+CONFIG  += sdk_no_version_check
+
+equals(QMAKE_CXX, clang++) {
+    QMAKE_CXXFLAGS += -Wextra -Wpedantic -Wimplicit-fallthrough -Wconversion
+}
+
+# required to make C++17 work on macOS
+mac:QMAKE_MACOSX_DEPLOYMENT_TARGET = 10.15
+
+win32:LIBS += -lpsapi
+
+include(../ttfexplorer-core.pri)
+
+SOURCES += \
+    generator.cpp \
+    main.cpp
+
+HEADERS += \
+    generator.h
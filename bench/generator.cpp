@@ -0,0 +1,1481 @@
+#include <QString>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cmath>
+
+#include "generator.h"
+
+using namespace Generator;
+
+namespace {
+
+// A tiny LCG, so the output is identical on all platforms.
+class Random
+{
+public:
+    explicit Random(const quint32 seed)
+        : m_state(seed)
+    {
+    }
+
+    quint32 next()
+    {
+        m_state = m_state * 1664525u + 1013904223u;
+        return m_state >> 8;
+    }
+
+    quint32 range(const quint32 max)
+    {
+        return max == 0 ? 0 : next() % max;
+    }
+
+    qint32 range(const qint32 min, const qint32 max)
+    {
+        return min + qint32(range(quint32(max - min + 1)));
+    }
+
+private:
+    quint32 m_state;
+};
+
+class Writer
+{
+public:
+    void u8(const quint32 v) { m_data.append(char(v & 0xFF)); }
+    void i8(const qint32 v) { u8(quint32(v)); }
+    void u16(const quint32 v) { u8(v >> 8); u8(v); }
+    void i16(const qint32 v) { u16(quint32(v)); }
+    void u24(const quint32 v) { u8(v >> 16); u8(v >> 8); u8(v); }
+    void u32(const quint32 v) { u16(v >> 16); u16(v); }
+    void i32(const qint32 v) { u32(quint32(v)); }
+    void fixed(const double v) { i32(qint32(std::lround(v * 65536.0))); }
+    void f2dot14(const double v) { i16(qint32(std::lround(v * 16384.0))); }
+    void tag(const char *v) { m_data.append(v, 4); }
+    void bytes(const QByteArray &v) { m_data.append(v); }
+    void zeros(const quint32 n) { m_data.append(int(n), '\0'); }
+
+    void padTo(const quint32 alignment)
+    {
+        while (size() % alignment != 0) {
+            u8(0);
+        }
+    }
+
+    void setU16(const quint32 offset, const quint32 v)
+    {
+        m_data[int(offset)] = char((v >> 8) & 0xFF);
+        m_data[int(offset + 1)] = char(v & 0xFF);
+    }
+
+    void setU32(const quint32 offset, const quint32 v)
+    {
+        setU16(offset, v >> 16);
+        setU16(offset + 2, v & 0xFFFF);
+    }
+
+    quint32 size() const { return quint32(m_data.size()); }
+    const QByteArray &data() const { return m_data; }
+
+private:
+    QByteArray m_data;
+};
+
+struct Table
+{
+    const char *tag;
+    QByteArray data;
+};
+
+struct Point
+{
+    qint16 x;
+    qint16 y;
+    bool onCurve;
+};
+
+struct Glyph
+{
+    QVector<quint16> endPoints;
+    QVector<Point> points;
+    QVector<quint16> components;
+    qint16 xMin = 0;
+    qint16 yMin = 0;
+    qint16 xMax = 0;
+    qint16 yMax = 0;
+
+    bool isEmpty() const { return points.isEmpty() && components.isEmpty(); }
+
+    // The number of points used by `gvar`, without phantom points.
+    quint16 numberOfPoints() const
+    {
+        return components.isEmpty() ? quint16(points.size()) : quint16(components.size());
+    }
+};
+
+QVector<Glyph> makeGlyphs(const quint16 numberOfGlyphs)
+{
+    Random rng(numberOfGlyphs);
+
+    QVector<Glyph> glyphs;
+    glyphs.reserve(numberOfGlyphs);
+
+    int lastSimpleGlyph = -1;
+    for (quint16 i = 0; i < numberOfGlyphs; ++i) {
+        Glyph glyph;
+
+        if (i != 0 && i % 17 == 0) {
+            // Empty glyph, like a space.
+            glyphs << glyph;
+            continue;
+        }
+
+        if (i % 11 == 10 && lastSimpleGlyph > 0) {
+            glyph.components << quint16(lastSimpleGlyph) << quint16(lastSimpleGlyph - 1);
+            glyph.xMin = glyphs[lastSimpleGlyph].xMin;
+            glyph.yMin = glyphs[lastSimpleGlyph].yMin;
+            glyph.xMax = glyphs[lastSimpleGlyph].xMax;
+            glyph.yMax = glyphs[lastSimpleGlyph].yMax;
+            glyphs << glyph;
+            continue;
+        }
+
+        const auto contours = 1 + rng.range(3);
+        for (quint32 c = 0; c < contours; ++c) {
+            const auto points = 3 + rng.range(12);
+            for (quint32 p = 0; p < points; ++p) {
+                // Mix short and long coordinates.
+                const auto spread = (p % 5 == 0) ? 900 : 200;
+                Point point;
+                point.x = qint16(rng.range(0, spread));
+                point.y = qint16(rng.range(-100, spread));
+                point.onCurve = p == 0 || rng.range(3) != 0;
+                glyph.points << point;
+            }
+            glyph.endPoints << quint16(glyph.points.size() - 1);
+        }
+
+        glyph.xMin = glyph.xMax = glyph.points[0].x;
+        glyph.yMin = glyph.yMax = glyph.points[0].y;
+        for (const auto &p : glyph.points) {
+            glyph.xMin = std::min(glyph.xMin, p.x);
+            glyph.yMin = std::min(glyph.yMin, p.y);
+            glyph.xMax = std::max(glyph.xMax, p.x);
+            glyph.yMax = std::max(glyph.yMax, p.y);
+        }
+
+        lastSimpleGlyph = i;
+        glyphs << glyph;
+    }
+
+    return glyphs;
+}
+
+QByteArray encodeSimpleGlyph(const Glyph &glyph)
+{
+    Writer w;
+    w.i16(glyph.endPoints.size());
+    w.i16(glyph.xMin);
+    w.i16(glyph.yMin);
+    w.i16(glyph.xMax);
+    w.i16(glyph.yMax);
+
+    for (const auto end : glyph.endPoints) {
+        w.u16(end);
+    }
+
+    w.u16(0); // No instructions.
+
+    QVector<quint8> flags;
+    Writer xs;
+    Writer ys;
+    qint32 prevX = 0;
+    qint32 prevY = 0;
+    for (const auto &p : glyph.points) {
+        quint8 f = p.onCurve ? 0x01 : 0x00;
+
+        const auto dx = p.x - prevX;
+        if (dx == 0) {
+            f |= 0x10;
+        } else if (std::abs(dx) < 256) {
+            f |= 0x02;
+            if (dx > 0) {
+                f |= 0x10;
+            }
+            xs.u8(quint32(std::abs(dx)));
+        } else {
+            xs.i16(dx);
+        }
+
+        const auto dy = p.y - prevY;
+        if (dy == 0) {
+            f |= 0x20;
+        } else if (std::abs(dy) < 256) {
+            f |= 0x04;
+            if (dy > 0) {
+                f |= 0x20;
+            }
+            ys.u8(quint32(std::abs(dy)));
+        } else {
+            ys.i16(dy);
+        }
+
+        flags << f;
+        prevX = p.x;
+        prevY = p.y;
+    }
+
+    // Compress flags using the repeat flag.
+    for (int i = 0; i < flags.size();) {
+        int repeats = 0;
+        while (i + repeats + 1 < flags.size() && flags[i + repeats + 1] == flags[i] && repeats < 255) {
+            repeats += 1;
+        }
+
+        if (repeats > 0) {
+            w.u8(flags[i] | 0x08);
+            w.u8(quint32(repeats));
+        } else {
+            w.u8(flags[i]);
+        }
+
+        i += repeats + 1;
+    }
+
+    w.bytes(xs.data());
+    w.bytes(ys.data());
+    return w.data();
+}
+
+QByteArray encodeCompositeGlyph(const Glyph &glyph)
+{
+    Writer w;
+    w.i16(-1);
+    w.i16(glyph.xMin);
+    w.i16(glyph.yMin);
+    w.i16(glyph.xMax);
+    w.i16(glyph.yMax);
+
+    for (int i = 0; i < glyph.components.size(); ++i) {
+        const bool isLast = i + 1 == glyph.components.size();
+        // ARG_1_AND_2_ARE_WORDS | ARGS_ARE_XY_VALUES | MORE_COMPONENTS
+        quint16 flags = 0x0001 | 0x0002 | (isLast ? 0 : 0x0020);
+        if (i % 2 == 1) {
+            flags |= 0x0008; // WE_HAVE_A_SCALE
+        }
+
+        w.u16(flags);
+        w.u16(glyph.components[i]);
+        w.i16(i * 300);
+        w.i16(-i * 20);
+        if (flags & 0x0008) {
+            w.f2dot14(0.5);
+        }
+    }
+
+    return w.data();
+}
+
+Table makeGlyf(const QVector<Glyph> &glyphs, QVector<quint32> &offsets)
+{
+    Writer w;
+    offsets.clear();
+    for (const auto &glyph : glyphs) {
+        offsets << w.size();
+        if (glyph.isEmpty()) {
+            continue;
+        }
+
+        if (glyph.components.isEmpty()) {
+            w.bytes(encodeSimpleGlyph(glyph));
+        } else {
+            w.bytes(encodeCompositeGlyph(glyph));
+        }
+
+        w.padTo(2);
+    }
+    offsets << w.size();
+
+    return { "glyf", w.data() };
+}
+
+Table makeLoca(const QVector<quint32> &offsets)
+{
+    Writer w;
+    for (const auto offset : offsets) {
+        w.u32(offset);
+    }
+
+    return { "loca", w.data() };
+}
+
+Table makeHead(const QVector<Glyph> &glyphs)
+{
+    qint16 xMin = 0, yMin = 0, xMax = 0, yMax = 0;
+    for (const auto &g : glyphs) {
+        xMin = std::min(xMin, g.xMin);
+        yMin = std::min(yMin, g.yMin);
+        xMax = std::max(xMax, g.xMax);
+        yMax = std::max(yMax, g.yMax);
+    }
+
+    Writer w;
+    w.u16(1);
+    w.u16(0);
+    w.fixed(1.0);
+    w.u32(0); // Checksum adjustment.
+    w.u32(0x5F0F3CF5);
+    w.u16(0x000B);
+    w.u16(1000);
+    w.u32(0); w.u32(0xD5000000); // Created.
+    w.u32(0); w.u32(0xD5000000); // Modified.
+    w.i16(xMin);
+    w.i16(yMin);
+    w.i16(xMax);
+    w.i16(yMax);
+    w.u16(0);
+    w.u16(8);
+    w.i16(2);
+    w.i16(1); // Long `loca` offsets.
+    w.i16(0);
+    return { "head", w.data() };
+}
+
+Table makeHhea(const quint16 numberOfGlyphs)
+{
+    Writer w;
+    w.u16(1);
+    w.u16(0);
+    w.i16(800);
+    w.i16(-200);
+    w.i16(0);
+    w.u16(1200);
+    w.i16(0);
+    w.i16(0);
+    w.i16(1200);
+    w.i16(1);
+    w.i16(0);
+    w.i16(0);
+    w.zeros(8);
+    w.i16(0);
+    w.u16(numberOfGlyphs);
+    return { "hhea", w.data() };
+}
+
+Table makeHmtx(const QVector<Glyph> &glyphs)
+{
+    Random rng(7);
+    Writer w;
+    for (const auto &g : glyphs) {
+        w.u16(500 + rng.range(700));
+        w.i16(g.xMin);
+    }
+
+    return { "hmtx", w.data() };
+}
+
+Table makeMaxp(const QVector<Glyph> &glyphs, const bool isCff)
+{
+    Writer w;
+    if (isCff) {
+        w.u32(0x00005000);
+        w.u16(quint32(glyphs.size()));
+        return { "maxp", w.data() };
+    }
+
+    quint16 maxPoints = 0, maxContours = 0;
+    for (const auto &g : glyphs) {
+        maxPoints = std::max(maxPoints, quint16(g.points.size()));
+        maxContours = std::max(maxContours, quint16(g.endPoints.size()));
+    }
+
+    w.u32(0x00010000);
+    w.u16(quint32(glyphs.size()));
+    w.u16(maxPoints);
+    w.u16(maxContours);
+    w.u16(maxPoints * 2);
+    w.u16(maxContours * 2);
+    w.u16(2);
+    w.zeros(12);
+    w.u16(2);
+    w.u16(1);
+    return { "maxp", w.data() };
+}
+
+QVector<Mapping> makeMappings(const quint16 numberOfGlyphs, const quint32 numberOfCodepoints)
+{
+    Random rng(numberOfCodepoints);
+
+    QVector<Mapping> mappings;
+    if (numberOfGlyphs < 2) {
+        return mappings;
+    }
+
+    mappings.reserve(int(numberOfCodepoints));
+
+    quint32 codepoint = numberOfCodepoints > 20000 ? 0x4E00 : 0x20;
+    quint16 glyphId = 1;
+    for (quint32 i = 0; i < numberOfCodepoints; ++i) {
+        mappings.append({ codepoint, glyphId });
+
+        codepoint += (rng.range(16) == 0) ? 2 + rng.range(40) : 1;
+        if (codepoint >= 0xD800 && codepoint <= 0xDFFF) {
+            codepoint = 0xE000;
+        }
+
+        glyphId += 1;
+        if (glyphId == numberOfGlyphs) {
+            glyphId = 1;
+        }
+    }
+
+    return mappings;
+}
+
+QByteArray makeCmapFormat4(const QVector<Mapping> &mappings)
+{
+    struct Segment
+    {
+        quint16 start;
+        quint16 end;
+        QVector<quint16> glyphs;
+        bool useArray;
+    };
+
+    QVector<Segment> segments;
+    quint32 glyphArraySize = 0;
+    for (const auto &m : mappings) {
+        if (m.codepoint >= 0xFFFF) {
+            break;
+        }
+
+        if (!segments.isEmpty()) {
+            auto &last = segments.last();
+            if (last.end + 1u == m.codepoint && last.glyphs.last() + 1u == m.glyphId) {
+                last.end = quint16(m.codepoint);
+                last.glyphs << m.glyphId;
+                continue;
+            }
+        }
+
+        // The subtable size is limited to 64KiB.
+        const auto size = 16 + (segments.size() + 2) * 8 + glyphArraySize * 2;
+        if (size > 60000) {
+            break;
+        }
+
+        if (!segments.isEmpty() && segments.last().useArray) {
+            glyphArraySize += quint32(segments.last().glyphs.size());
+        }
+
+        segments.append({ quint16(m.codepoint), quint16(m.codepoint), { m.glyphId },
+                          segments.size() % 8 == 7 });
+    }
+
+    if (!segments.isEmpty() && segments.last().useArray) {
+        glyphArraySize += quint32(segments.last().glyphs.size());
+    }
+
+    segments.append({ 0xFFFF, 0xFFFF, { 0 }, false });
+
+    const auto segCount = quint32(segments.size());
+    quint32 searchRange = 1;
+    quint32 entrySelector = 0;
+    while (searchRange * 2 <= segCount) {
+        searchRange *= 2;
+        entrySelector += 1;
+    }
+    searchRange *= 2;
+
+    Writer w;
+    w.u16(4);
+    w.u16(16 + segCount * 8 + glyphArraySize * 2);
+    w.u16(0);
+    w.u16(segCount * 2);
+    w.u16(searchRange);
+    w.u16(entrySelector);
+    w.u16(segCount * 2 - searchRange);
+    for (const auto &s : segments) {
+        w.u16(s.end);
+    }
+    w.u16(0);
+    for (const auto &s : segments) {
+        w.u16(s.start);
+    }
+    for (const auto &s : segments) {
+        if (s.start == 0xFFFF) {
+            w.u16(1);
+        } else if (s.useArray) {
+            w.u16(0);
+        } else {
+            w.u16(quint16(s.glyphs.first() - s.start));
+        }
+    }
+
+    quint32 arrayIndex = 0;
+    for (quint32 i = 0; i < segCount; ++i) {
+        const auto &s = segments[int(i)];
+        if (s.useArray) {
+            w.u16((segCount - i) * 2 + arrayIndex * 2);
+            arrayIndex += quint32(s.glyphs.size());
+        } else {
+            w.u16(0);
+        }
+    }
+
+    for (const auto &s : segments) {
+        if (s.useArray) {
+            for (const auto g : s.glyphs) {
+                w.u16(g);
+            }
+        }
+    }
+
+    return w.data();
+}
+
+QByteArray makeCmapFormat12(const QVector<Mapping> &mappings)
+{
+    struct Group
+    {
+        quint32 start;
+        quint32 end;
+        quint32 glyphId;
+    };
+
+    QVector<Group> groups;
+    for (const auto &m : mappings) {
+        if (!groups.isEmpty()) {
+            auto &last = groups.last();
+            if (last.end + 1 == m.codepoint && last.glyphId + (last.end - last.start) + 1 == m.glyphId) {
+                last.end = m.codepoint;
+                continue;
+            }
+        }
+
+        groups.append({ m.codepoint, m.codepoint, m.glyphId });
+    }
+
+    Writer w;
+    w.u16(12);
+    w.u16(0);
+    w.u32(16 + quint32(groups.size()) * 12);
+    w.u32(0);
+    w.u32(quint32(groups.size()));
+    for (const auto &g : groups) {
+        w.u32(g.start);
+        w.u32(g.end);
+        w.u32(g.glyphId);
+    }
+
+    return w.data();
+}
+
+Table makeCmap(const QVector<Mapping> &mappings)
+{
+    const auto format4 = makeCmapFormat4(mappings);
+    const auto format12 = makeCmapFormat12(mappings);
+
+    Writer w;
+    w.u16(0);
+    w.u16(2);
+    w.u16(3); w.u16(1); w.u32(20);
+    w.u16(3); w.u16(10); w.u32(20 + quint32(format4.size()));
+    w.bytes(format4);
+    w.bytes(format12);
+    return { "cmap", w.data() };
+}
+
+Table makePost(const quint16 numberOfGlyphs, const bool withNames)
+{
+    Writer w;
+    w.u32(withNames ? 0x00020000 : 0x00030000);
+    w.fixed(0.0);
+    w.i16(-100);
+    w.i16(50);
+    w.u32(0);
+    w.zeros(16);
+
+    if (!withNames) {
+        return { "post", w.data() };
+    }
+
+    w.u16(numberOfGlyphs);
+    for (quint16 i = 0; i < numberOfGlyphs; ++i) {
+        w.u16(i == 0 ? 0 : 258 + i - 1);
+    }
+
+    for (quint16 i = 1; i < numberOfGlyphs; ++i) {
+        const auto name = QString("glyph%1").arg(i).toLatin1();
+        w.u8(quint32(name.size()));
+        w.bytes(name);
+    }
+
+    return { "post", w.data() };
+}
+
+Table makeName(const QString &family, const quint16 numberOfNames)
+{
+    struct Record
+    {
+        quint16 platformId;
+        quint16 encodingId;
+        quint16 languageId;
+        quint16 nameId;
+        QByteArray data;
+    };
+
+    QVector<Record> records;
+    const QVector<QString> basic = {
+        "Copyright (c) Synthetic", family, "Regular", family + " Regular", family + " Regular", "Version 1.000",
+    };
+
+    for (int i = 0; i < basic.size(); ++i) {
+        records.append({ 1, 0, 0, quint16(i), basic[i].toLatin1() });
+    }
+
+    auto toUtf16 = [](const QString &s) {
+        Writer w;
+        for (const auto c : s.toLatin1()) {
+            w.u16(quint8(c));
+        }
+        return w.data();
+    };
+
+    for (int i = 0; i < basic.size(); ++i) {
+        records.append({ 3, 1, 0x409, quint16(i), toUtf16(basic[i]) });
+    }
+
+    // String offsets are 16-bit, so the storage cannot be larger than 64KiB.
+    quint32 storageSize = 0;
+    for (const auto &r : records) {
+        storageSize += quint32(r.data.size());
+    }
+
+    for (quint16 i = 0; i < numberOfNames; ++i) {
+        auto data = toUtf16(QString("Synthetic name record %1").arg(i));
+        if (storageSize + quint32(data.size()) > 0xFFFF) {
+            break;
+        }
+
+        storageSize += quint32(data.size());
+        records.append({ 3, 1, 0x409, quint16(256 + i), data });
+    }
+
+    Writer w;
+    w.u16(0);
+    w.u16(quint32(records.size()));
+    w.u16(6 + quint32(records.size()) * 12);
+
+    quint32 offset = 0;
+    for (const auto &r : records) {
+        w.u16(r.platformId);
+        w.u16(r.encodingId);
+        w.u16(r.languageId);
+        w.u16(r.nameId);
+        w.u16(quint32(r.data.size()));
+        w.u16(offset);
+        offset += quint32(r.data.size());
+    }
+
+    for (const auto &r : records) {
+        w.bytes(r.data);
+    }
+
+    return { "name", w.data() };
+}
+
+quint32 checksum(const QByteArray &data)
+{
+    quint32 sum = 0;
+    for (int i = 0; i < data.size(); i += 4) {
+        quint32 word = 0;
+        for (int j = 0; j < 4; ++j) {
+            word <<= 8;
+            if (i + j < data.size()) {
+                word |= quint8(data[i + j]);
+            }
+        }
+        sum += word;
+    }
+
+    return sum;
+}
+
+void writeTableDirectory(const quint32 magic, const QVector<Table> &tables,
+                         const QVector<quint32> &offsets, Writer &w)
+{
+    const auto count = quint32(tables.size());
+    quint32 entrySelector = 0;
+    while ((2u << entrySelector) <= count) {
+        entrySelector += 1;
+    }
+    const auto searchRange = (1u << entrySelector) * 16;
+
+    w.u32(magic);
+    w.u16(count);
+    w.u16(searchRange);
+    w.u16(entrySelector);
+    w.u16(count * 16 - searchRange);
+
+    for (int i = 0; i < tables.size(); ++i) {
+        w.tag(tables[i].tag);
+        w.u32(checksum(tables[i].data));
+        w.u32(offsets[i]);
+        w.u32(quint32(tables[i].data.size()));
+    }
+}
+
+void sortTables(QVector<Table> &tables)
+{
+    std::sort(tables.begin(), tables.end(), [](const Table &a, const Table &b){
+        return qFromBigEndian<quint32>(a.tag) < qFromBigEndian<quint32>(b.tag);
+    });
+}
+
+QByteArray buildFont(const quint32 magic, QVector<Table> tables)
+{
+    sortTables(tables);
+
+    QVector<quint32> offsets;
+    quint32 offset = 12 + quint32(tables.size()) * 16;
+    for (const auto &table : tables) {
+        offsets << offset;
+        offset += (quint32(table.data.size()) + 3) & ~3u;
+    }
+
+    Writer w;
+    writeTableDirectory(magic, tables, offsets, w);
+    for (const auto &table : tables) {
+        w.bytes(table.data);
+        w.padTo(4);
+    }
+
+    return w.data();
+}
+
+QByteArray buildCollection(QVector<QVector<Table>> faces)
+{
+    for (auto &tables : faces) {
+        sortTables(tables);
+    }
+
+    quint32 offset = 12 + quint32(faces.size()) * 4;
+    QVector<quint32> faceOffsets;
+    for (const auto &tables : faces) {
+        faceOffsets << offset;
+        offset += 12 + quint32(tables.size()) * 16;
+    }
+
+    // Identical tables are stored only once, like in real collections.
+    QVector<QByteArray> uniqueTables;
+    QVector<quint32> uniqueOffsets;
+    QVector<QVector<quint32>> tableOffsets;
+    for (const auto &tables : faces) {
+        QVector<quint32> offsets;
+        for (const auto &table : tables) {
+            const auto idx = uniqueTables.indexOf(table.data);
+            if (idx != -1) {
+                offsets << uniqueOffsets[idx];
+                continue;
+            }
+
+            uniqueTables << table.data;
+            uniqueOffsets << offset;
+            offsets << offset;
+            offset += (quint32(table.data.size()) + 3) & ~3u;
+        }
+        tableOffsets << offsets;
+    }
+
+    Writer w;
+    w.tag("ttcf");
+    w.u16(1);
+    w.u16(0);
+    w.u32(quint32(faces.size()));
+    for (const auto offset : faceOffsets) {
+        w.u32(offset);
+    }
+
+    for (int i = 0; i < faces.size(); ++i) {
+        writeTableDirectory(0x00010000, faces[i], tableOffsets[i], w);
+    }
+
+    for (const auto &data : uniqueTables) {
+        w.bytes(data);
+        w.padTo(4);
+    }
+
+    return w.data();
+}
+
+QVector<Table> makeTrueTypeTables(const QVector<Glyph> &glyphs, const quint32 numberOfCodepoints)
+{
+    const auto numberOfGlyphs = quint16(glyphs.size());
+
+    QVector<quint32> offsets;
+    auto glyf = makeGlyf(glyphs, offsets);
+
+    return {
+        glyf,
+        makeLoca(offsets),
+        makeHead(glyphs),
+        makeHhea(numberOfGlyphs),
+        makeHmtx(glyphs),
+        makeMaxp(glyphs, false),
+        makeCmap(makeMappings(numberOfGlyphs, numberOfCodepoints)),
+        makePost(numberOfGlyphs, true),
+        makeName("Synthetic", 0),
+    };
+}
+
+// CFF
+
+void writeCharStringNumber(const qint32 n, Writer &w)
+{
+    if (n >= -107 && n <= 107) {
+        w.u8(quint32(n + 139));
+    } else if (n >= 108 && n <= 1131) {
+        const auto v = quint32(n - 108);
+        w.u8((v >> 8) + 247);
+        w.u8(v & 0xFF);
+    } else if (n >= -1131 && n <= -108) {
+        const auto v = quint32(-n - 108);
+        w.u8((v >> 8) + 251);
+        w.u8(v & 0xFF);
+    } else {
+        w.u8(28);
+        w.i16(n);
+    }
+}
+
+void writeDictInt32(const qint32 n, Writer &w)
+{
+    w.u8(29);
+    w.i32(n);
+}
+
+QByteArray makeCffIndex(const QVector<QByteArray> &items)
+{
+    Writer w;
+    w.u16(quint32(items.size()));
+    if (items.isEmpty()) {
+        return w.data();
+    }
+
+    quint32 dataSize = 0;
+    for (const auto &item : items) {
+        dataSize += quint32(item.size());
+    }
+
+    quint32 offSize = 1;
+    if (dataSize + 1 > 0xFFFFFF) {
+        offSize = 4;
+    } else if (dataSize + 1 > 0xFFFF) {
+        offSize = 3;
+    } else if (dataSize + 1 > 0xFF) {
+        offSize = 2;
+    }
+
+    w.u8(offSize);
+    auto writeOffset = [&](const quint32 offset) {
+        switch (offSize) {
+        case 1: w.u8(offset); break;
+        case 2: w.u16(offset); break;
+        case 3: w.u24(offset); break;
+        default: w.u32(offset); break;
+        }
+    };
+
+    quint32 offset = 1;
+    writeOffset(offset);
+    for (const auto &item : items) {
+        offset += quint32(item.size());
+        writeOffset(offset);
+    }
+
+    for (const auto &item : items) {
+        w.bytes(item);
+    }
+
+    return w.data();
+}
+
+qint32 subrsBias(const int count)
+{
+    if (count < 1240) {
+        return 107;
+    } else if (count < 33900) {
+        return 1131;
+    } else {
+        return 32768;
+    }
+}
+
+QVector<QByteArray> makeSubrs(const quint16 count, const quint32 seed, const bool isGlobal)
+{
+    Random rng(seed);
+    const auto bias = subrsBias(count);
+
+    QVector<QByteArray> subrs;
+    for (quint16 i = 0; i < count; ++i) {
+        Writer w;
+        const auto segments = 1 + rng.range(4);
+        for (quint32 s = 0; s < segments; ++s) {
+            if (rng.range(2) == 0) {
+                writeCharStringNumber(rng.range(-300, 300), w);
+                writeCharStringNumber(rng.range(-300, 300), w);
+                w.u8(5); // rlineto
+            } else {
+                for (int k = 0; k < 6; ++k) {
+                    writeCharStringNumber(rng.range(-120, 120), w);
+                }
+                w.u8(8); // rrcurveto
+            }
+        }
+
+        // Limited nesting.
+        if (!isGlobal && i % 4 != 0) {
+            writeCharStringNumber(qint32(i) - 1 - bias, w);
+            w.u8(10); // callsubr
+        }
+
+        w.u8(11); // return
+        subrs << w.data();
+    }
+
+    return subrs;
+}
+
+QByteArray makeCharString(const quint16 glyphId, const quint16 numberOfLocalSubrs,
+                          const quint16 numberOfGlobalSubrs, Random &rng)
+{
+    Writer w;
+    if (glyphId == 0) {
+        writeCharStringNumber(500, w); // width
+        w.u8(14); // endchar
+        return w.data();
+    }
+
+    // Hints.
+    writeCharStringNumber(0, w);
+    writeCharStringNumber(50, w);
+    writeCharStringNumber(600, w);
+    writeCharStringNumber(50, w);
+    w.u8(18); // hstemhm
+    writeCharStringNumber(20, w);
+    writeCharStringNumber(40, w);
+    w.u8(23); // vstemhm
+    w.u8(19); // hintmask
+    w.u8(0xE0); // 3 stems
+
+    writeCharStringNumber(rng.range(0, 200), w);
+    writeCharStringNumber(rng.range(0, 200), w);
+    w.u8(21); // rmoveto
+
+    const auto localBias = subrsBias(numberOfLocalSubrs);
+    const auto globalBias = subrsBias(numberOfGlobalSubrs);
+
+    const auto segments = 2 + rng.range(6);
+    for (quint32 s = 0; s < segments; ++s) {
+        switch (rng.range(5)) {
+        case 0:
+            writeCharStringNumber(rng.range(-400, 400), w);
+            writeCharStringNumber(rng.range(-400, 400), w);
+            w.u8(5); // rlineto
+            break;
+        case 1:
+            for (int k = 0; k < 6; ++k) {
+                writeCharStringNumber(rng.range(-150, 150), w);
+            }
+            w.u8(8); // rrcurveto
+            break;
+        case 2:
+            writeCharStringNumber(rng.range(-400, 400), w);
+            w.u8(6); // hlineto
+            break;
+        case 3:
+            if (numberOfLocalSubrs > 0) {
+                writeCharStringNumber(qint32(rng.range(numberOfLocalSubrs)) - localBias, w);
+                w.u8(10); // callsubr
+            }
+            break;
+        default:
+            if (numberOfGlobalSubrs > 0) {
+                writeCharStringNumber(qint32(rng.range(numberOfGlobalSubrs)) - globalBias, w);
+                w.u8(29); // callgsubr
+            }
+            break;
+        }
+    }
+
+    w.u8(14); // endchar
+    return w.data();
+}
+
+Table makeCff(const quint16 numberOfGlyphs, const quint16 numberOfSubrs)
+{
+    Random rng(numberOfGlyphs);
+
+    const auto numberOfGlobalSubrs = quint16(numberOfSubrs / 2);
+    const auto numberOfLocalSubrs = quint16(numberOfSubrs - numberOfGlobalSubrs);
+
+    const auto nameIndex = makeCffIndex({ QByteArray("Synthetic") });
+
+    QVector<QByteArray> strings;
+    for (quint16 i = 1; i < numberOfGlyphs; ++i) {
+        strings << QString("glyph%1").arg(i).toLatin1();
+    }
+    const auto stringIndex = makeCffIndex(strings);
+
+    const auto globalSubrsIndex = makeCffIndex(makeSubrs(numberOfGlobalSubrs, 1, true));
+    const auto localSubrsIndex = makeCffIndex(makeSubrs(numberOfLocalSubrs, 2, false));
+
+    QVector<QByteArray> charStrings;
+    for (quint16 i = 0; i < numberOfGlyphs; ++i) {
+        charStrings << makeCharString(i, numberOfLocalSubrs, numberOfGlobalSubrs, rng);
+    }
+    const auto charStringsIndex = makeCffIndex(charStrings);
+
+    Writer charset;
+    charset.u8(0);
+    for (quint16 i = 1; i < numberOfGlyphs; ++i) {
+        charset.u16(391 + i - 1);
+    }
+
+    // Private DICT with a single Subrs operator.
+    const quint32 privateDictSize = 6;
+
+    // Top DICT uses fixed-size numbers, so its size is known in advance.
+    const quint32 topDictSize = 23;
+    const auto topDictIndexSize = quint32(makeCffIndex({ QByteArray(int(topDictSize), '\0') }).size());
+
+    const quint32 headerSize = 4;
+    const auto charsetOffset = headerSize + quint32(nameIndex.size()) + topDictIndexSize
+        + quint32(stringIndex.size()) + quint32(globalSubrsIndex.size());
+    const auto charStringsOffset = charsetOffset + charset.size();
+    const auto privateDictOffset = charStringsOffset + quint32(charStringsIndex.size());
+
+    Writer topDict;
+    writeDictInt32(qint32(charsetOffset), topDict);
+    topDict.u8(15);
+    writeDictInt32(qint32(charStringsOffset), topDict);
+    topDict.u8(17);
+    writeDictInt32(qint32(privateDictSize), topDict);
+    writeDictInt32(qint32(privateDictOffset), topDict);
+    topDict.u8(18);
+    Q_ASSERT(topDict.size() == topDictSize);
+
+    Writer privateDict;
+    writeDictInt32(qint32(privateDictSize), privateDict);
+    privateDict.u8(19);
+
+    Writer w;
+    w.u8(1);
+    w.u8(0);
+    w.u8(headerSize);
+    w.u8(4);
+    w.bytes(nameIndex);
+    w.bytes(makeCffIndex({ topDict.data() }));
+    w.bytes(stringIndex);
+    w.bytes(globalSubrsIndex);
+    w.bytes(charset.data());
+    w.bytes(charStringsIndex);
+    w.bytes(privateDict.data());
+    w.bytes(localSubrsIndex);
+    return { "CFF ", w.data() };
+}
+
+// Variations
+
+void writePackedPoints(const QVector<quint16> &points, Writer &w)
+{
+    if (points.isEmpty()) {
+        // All points.
+        w.u8(0);
+        return;
+    }
+
+    const auto count = quint32(points.size());
+    if (count < 128) {
+        w.u8(count);
+    } else {
+        w.u8(0x80 | (count >> 8));
+        w.u8(count & 0xFF);
+    }
+
+    int i = 0;
+    quint16 prev = 0;
+    while (i < points.size()) {
+        const int runLength = std::min(128, int(points.size()) - i);
+        bool words = false;
+        for (int j = i; j < i + runLength; ++j) {
+            const auto delta = points[j] - (j == 0 ? 0 : points[j - 1]);
+            if (delta > 0xFF) {
+                words = true;
+            }
+        }
+
+        w.u8(quint32(runLength - 1) | (words ? 0x80 : 0));
+        for (int j = i; j < i + runLength; ++j) {
+            const auto delta = quint32(points[j] - prev);
+            if (words) {
+                w.u16(delta);
+            } else {
+                w.u8(delta);
+            }
+            prev = points[j];
+        }
+
+        i += runLength;
+    }
+}
+
+void writePackedDeltas(const QVector<qint16> &deltas, Writer &w)
+{
+    int i = 0;
+    while (i < deltas.size()) {
+        int runLength = 0;
+        if (deltas[i] == 0) {
+            while (i + runLength < deltas.size() && deltas[i + runLength] == 0 && runLength < 64) {
+                runLength += 1;
+            }
+            w.u8(0x80 | quint32(runLength - 1));
+        } else if (deltas[i] >= -128 && deltas[i] <= 127) {
+            while (i + runLength < deltas.size() && runLength < 64 && deltas[i + runLength] != 0
+                   && deltas[i + runLength] >= -128 && deltas[i + runLength] <= 127) {
+                runLength += 1;
+            }
+            w.u8(quint32(runLength - 1));
+            for (int j = i; j < i + runLength; ++j) {
+                w.i8(deltas[j]);
+            }
+        } else {
+            while (i + runLength < deltas.size() && runLength < 64
+                   && (deltas[i + runLength] < -128 || deltas[i + runLength] > 127)) {
+                runLength += 1;
+            }
+            w.u8(0x40 | quint32(runLength - 1));
+            for (int j = i; j < i + runLength; ++j) {
+                w.i16(deltas[j]);
+            }
+        }
+
+        i += runLength;
+    }
+}
+
+Table makeFvar()
+{
+    Writer w;
+    w.u16(1);
+    w.u16(0);
+    w.u16(16);
+    w.u16(2);
+    w.u16(2); // axes
+    w.u16(20);
+    w.u16(2); // instances
+    w.u16(4 + 2 * 4);
+
+    w.tag("wght");
+    w.fixed(100);
+    w.fixed(400);
+    w.fixed(900);
+    w.u16(0);
+    w.u16(256);
+
+    w.tag("wdth");
+    w.fixed(50);
+    w.fixed(100);
+    w.fixed(200);
+    w.u16(0);
+    w.u16(257);
+
+    w.u16(2);
+    w.u16(0);
+    w.fixed(400);
+    w.fixed(100);
+
+    w.u16(258);
+    w.u16(0);
+    w.fixed(900);
+    w.fixed(100);
+
+    return { "fvar", w.data() };
+}
+
+Table makeGvar(const QVector<Glyph> &glyphs, const quint16 numberOfTuples)
+{
+    Random rng(numberOfTuples);
+
+    const quint16 axisCount = 2;
+    const QVector<QVector<double>> sharedTuples = {
+        { 1.0, 0.0 },
+        { 0.0, 1.0 },
+        { 1.0, 1.0 },
+    };
+
+    QVector<QByteArray> glyphsData;
+    for (const auto &glyph : glyphs) {
+        if (glyph.isEmpty() || numberOfTuples == 0) {
+            glyphsData << QByteArray();
+            continue;
+        }
+
+        const auto numberOfPoints = glyph.numberOfPoints() + 4; // + phantom points
+        const bool useSharedPoints = glyphsData.size() % 2 == 0;
+
+        Writer headers;
+        Writer data;
+        if (useSharedPoints) {
+            writePackedPoints({}, data);
+        }
+
+        for (quint16 t = 0; t < numberOfTuples; ++t) {
+            Writer tupleData;
+
+            // Every third tuple uses a sparse set of points, so IUP has some work to do.
+            QVector<quint16> points;
+            const bool isSparse = !useSharedPoints && t % 3 == 2 && glyph.components.isEmpty();
+            if (isSparse) {
+                for (quint16 p = 0; p < numberOfPoints; p += 2) {
+                    points << p;
+                }
+            }
+
+            if (!useSharedPoints) {
+                writePackedPoints(points, tupleData);
+            }
+
+            const auto count = points.isEmpty() ? numberOfPoints : points.size();
+            QVector<qint16> xs, ys;
+            for (int p = 0; p < count; ++p) {
+                xs << qint16(rng.range(0, 3) == 0 ? 0 : rng.range(-200, 200));
+                ys << qint16(rng.range(0, 3) == 0 ? 0 : rng.range(-20, 20));
+            }
+            writePackedDeltas(xs, tupleData);
+            writePackedDeltas(ys, tupleData);
+
+            quint16 tupleIndex = 0;
+            if (t < sharedTuples.size()) {
+                tupleIndex = t;
+            } else {
+                tupleIndex = 0x8000; // EMBEDDED_PEAK_TUPLE
+                if (t % 2 == 0) {
+                    tupleIndex |= 0x4000; // INTERMEDIATE_REGION
+                }
+            }
+
+            if (!useSharedPoints) {
+                tupleIndex |= 0x2000; // PRIVATE_POINT_NUMBERS
+            }
+
+            headers.u16(tupleData.size());
+            headers.u16(tupleIndex);
+            if (tupleIndex & 0x8000) {
+                const auto peak = 0.25 + 0.25 * (t % 3);
+                headers.f2dot14(peak);
+                headers.f2dot14(-peak);
+                if (tupleIndex & 0x4000) {
+                    headers.f2dot14(0.0);
+                    headers.f2dot14(-1.0);
+                    headers.f2dot14(1.0);
+                    headers.f2dot14(0.0);
+                }
+            }
+
+            data.bytes(tupleData.data());
+        }
+
+        Writer glyphData;
+        glyphData.u16(quint32(numberOfTuples) | (useSharedPoints ? 0x8000 : 0));
+        glyphData.u16(4 + headers.size());
+        glyphData.bytes(headers.data());
+        glyphData.bytes(data.data());
+        glyphData.padTo(2);
+        glyphsData << glyphData.data();
+    }
+
+    const auto glyphCount = quint32(glyphs.size());
+    const quint32 sharedTuplesOffset = 20 + (glyphCount + 1) * 4;
+    const auto dataOffset = sharedTuplesOffset + quint32(sharedTuples.size()) * axisCount * 2;
+
+    Writer w;
+    w.u16(1);
+    w.u16(0);
+    w.u16(axisCount);
+    w.u16(quint32(sharedTuples.size()));
+    w.u32(sharedTuplesOffset);
+    w.u16(glyphCount);
+    w.u16(1); // Long offsets.
+    w.u32(dataOffset);
+
+    quint32 offset = 0;
+    for (const auto &data : glyphsData) {
+        w.u32(offset);
+        offset += quint32(data.size());
+    }
+    w.u32(offset);
+
+    for (const auto &tuple : sharedTuples) {
+        for (const auto coord : tuple) {
+            w.f2dot14(coord);
+        }
+    }
+
+    for (const auto &data : glyphsData) {
+        w.bytes(data);
+    }
+
+    return { "gvar", w.data() };
+}
+
+// HVAR with a single ItemVariationData indexed by glyph ID and T regions.
+Table makeHvar(const quint16 numberOfGlyphs, const quint16 numberOfRegions)
+{
+    Random rng(numberOfRegions + 1);
+
+    const quint16 axisCount = 2;
+    const quint32 storeOffset = 20;
+    const quint32 regionListOffset = 12;
+    const quint32 dataOffset = regionListOffset + 4 + quint32(numberOfRegions) * axisCount * 6;
+    // Half of the regions use 16-bit deltas.
+    const quint16 wordDeltaCount = numberOfRegions / 2;
+
+    Writer w;
+    w.u16(1);
+    w.u16(0);
+    w.u32(storeOffset);
+    w.u32(0); // Advances are indexed by glyph ID.
+    w.u32(0);
+    w.u32(0);
+
+    w.u16(1);
+    w.u32(regionListOffset);
+    w.u16(1);
+    w.u32(dataOffset);
+
+    w.u16(axisCount);
+    w.u16(numberOfRegions);
+    for (quint16 r = 0; r < numberOfRegions; ++r) {
+        const auto peak = (r / 2 % 2 == 0 ? 1.0 : -1.0) / (1 + r / 4);
+        for (quint16 a = 0; a < axisCount; ++a) {
+            const auto p = a == r % axisCount ? peak : 0.0;
+            w.f2dot14(std::min(p, 0.0));
+            w.f2dot14(p);
+            w.f2dot14(std::max(p, 0.0));
+        }
+    }
+
+    w.u16(numberOfGlyphs);
+    w.u16(wordDeltaCount);
+    w.u16(numberOfRegions);
+    for (quint16 r = 0; r < numberOfRegions; ++r) {
+        w.u16(r);
+    }
+
+    for (quint16 i = 0; i < numberOfGlyphs; ++i) {
+        for (quint16 r = 0; r < numberOfRegions; ++r) {
+            if (r < wordDeltaCount) {
+                w.i16(rng.range(-400, 400));
+            } else {
+                w.i8(rng.range(-100, 100));
+            }
+        }
+    }
+
+    return { "HVAR", w.data() };
+}
+
+}
+
+QVector<Mapping> Generator::cmapMappings(const Options &options)
+{
+    return makeMappings(options.numberOfGlyphs, options.numberOfCodepoints);
+}
+
+QByteArray Generator::makeGlyfFont(const Options &options)
+{
+    const auto glyphs = makeGlyphs(options.numberOfGlyphs);
+    return buildFont(0x00010000, makeTrueTypeTables(glyphs, options.numberOfCodepoints));
+}
+
+QByteArray Generator::makeCmapFont(const Options &options)
+{
+    const auto glyphs = makeGlyphs(2);
+    auto tables = makeTrueTypeTables(glyphs, 0);
+    for (auto &table : tables) {
+        if (qstrcmp(table.tag, "cmap") == 0) {
+            table = makeCmap(makeMappings(options.numberOfGlyphs, options.numberOfCodepoints));
+        }
+    }
+
+    return buildFont(0x00010000, tables);
+}
+
+QByteArray Generator::makeCffFont(const Options &options)
+{
+    const auto numberOfGlyphs = std::max<quint16>(options.numberOfGlyphs, 1);
+
+    // Only metrics are needed from glyphs here.
+    QVector<Glyph> glyphs(numberOfGlyphs);
+
+    return buildFont(0x4F54544F, {
+        makeCff(numberOfGlyphs, options.numberOfSubrs),
+        makeHead(glyphs),
+        makeHhea(numberOfGlyphs),
+        makeHmtx(glyphs),
+        makeMaxp(glyphs, true),
+        makeCmap(makeMappings(numberOfGlyphs, options.numberOfCodepoints)),
+        makePost(numberOfGlyphs, false),
+        makeName("Synthetic CFF", 0),
+    });
+}
+
+QByteArray Generator::makeGvarFont(const Options &options)
+{
+    const auto glyphs = makeGlyphs(options.numberOfGlyphs);
+    auto tables = makeTrueTypeTables(glyphs, options.numberOfCodepoints);
+    tables << makeFvar() << makeGvar(glyphs, options.numberOfTuples);
+    return buildFont(0x00010000, tables);
+}
+
+QByteArray Generator::makeHvarFont(const Options &options)
+{
+    const auto glyphs = makeGlyphs(options.numberOfGlyphs);
+    auto tables = makeTrueTypeTables(glyphs, options.numberOfCodepoints);
+    tables << makeFvar() << makeHvar(options.numberOfGlyphs, options.numberOfTuples);
+    return buildFont(0x00010000, tables);
+}
+
+QByteArray Generator::makeCollection(const Options &options)
+{
+    const auto glyphs = makeGlyphs(options.numberOfGlyphs);
+    const auto shared = makeTrueTypeTables(glyphs, options.numberOfCodepoints);
+
+    QVector<QVector<Table>> faces;
+    for (quint16 i = 0; i < std::max<quint16>(options.numberOfFaces, 1); ++i) {
+        auto tables = shared;
+        for (auto &table : tables) {
+            if (qstrcmp(table.tag, "name") == 0) {
+                table = makeName(QString("Synthetic %1").arg(i), 0);
+            }
+        }
+        faces << tables;
+    }
+
+    return buildCollection(faces);
+}
+
+QByteArray Generator::makeNameFont(const Options &options)
+{
+    const auto glyphs = makeGlyphs(2);
+    auto tables = makeTrueTypeTables(glyphs, 0);
+    for (auto &table : tables) {
+        if (qstrcmp(table.tag, "name") == 0) {
+            table = makeName("Synthetic", options.numberOfNames);
+        }
+    }
+
+    return buildFont(0x00010000, tables);
+}
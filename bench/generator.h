@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QByteArray>
+#include <QVector>
+
+// Deterministic synthetic fonts for benchmarking.
+//
+// Fonts are not meant to be rendered, but they are valid enough
+// for every supported table to be parsed completely.
+namespace Generator
+{
+    struct Options
+    {
+        quint16 numberOfGlyphs = 1000;
+        quint32 numberOfCodepoints = 1000;
+        quint16 numberOfSubrs = 100;
+        quint16 numberOfTuples = 4;
+        quint16 numberOfFaces = 4;
+        quint16 numberOfNames = 1000;
+    };
+
+    struct Mapping
+    {
+        quint32 codepoint;
+        quint16 glyphId;
+    };
+
+    // Codepoint to glyph mappings stored in the generated `cmap` tables. Sorted.
+    QVector<Mapping> cmapMappings(const Options &options);
+
+    // TrueType font with N glyphs in `glyf`/`loca`, `hmtx`, `post` and
+    // a `cmap` with format 4 and 12 subtables.
+    QByteArray makeGlyfFont(const Options &options);
+
+    // The same as makeGlyfFont, but `cmap` is the largest table.
+    QByteArray makeCmapFont(const Options &options);
+
+    // OpenType font with a `CFF ` table using K global and local subroutines.
+    QByteArray makeCffFont(const Options &options);
+
+    // Variable TrueType font with `fvar` and `gvar` with T tuples per glyph.
+    QByteArray makeGvarFont(const Options &options);
+
+    // Variable TrueType font with `fvar` and `HVAR` with T regions.
+    QByteArray makeHvarFont(const Options &options);
+
+    // TrueType collection with F faces sharing `glyf`, `loca` and `cmap`.
+    QByteArray makeCollection(const Options &options);
+
+    // TrueType font with a large `name` table.
+    QByteArray makeNameFont(const Options &options);
+}
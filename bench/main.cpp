@@ -0,0 +1,798 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QTextStream>
+#include <QtEndian>
+
+#include <functional>
+#include <limits>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "src/face.h"
+#include "src/font.h"
+#include "src/tables/charstring.h"
+#include "src/tables/tables.h"
+#include "src/tables/varstore.h"
+
+#include "generator.h"
+
+struct BenchCase
+{
+    QString name;
+    std::function<QByteArray(const Generator::Options&)> make;
+    Generator::Options options;
+};
+
+struct BenchResult
+{
+    QString name;
+    quint32 fileSize = 0;
+    quint32 iterations = 0;
+    quint32 nodes = 0;
+    double nsPerByte = 0;
+    double nodesPerSecond = 0;
+    quint64 peakMemoryKiB = 0;
+};
+
+struct MicroResult
+{
+    QString name;
+    quint32 operations = 0;
+    quint32 iterations = 0;
+    double nsPerOp = 0;
+};
+
+// Peak resident set size of the whole process.
+//
+// It never goes down, so each case is run in its own process.
+static quint64 peakMemoryKiB()
+{
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize / 1024;
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef Q_OS_MACOS
+    return quint64(usage.ru_maxrss) / 1024; // bytes on macOS
+#else
+    return quint64(usage.ru_maxrss);
+#endif
+#endif
+}
+
+static QVector<BenchCase> benchCases()
+{
+    Generator::Options glyf;
+    glyf.numberOfGlyphs = 5000;
+    glyf.numberOfCodepoints = 5000;
+
+    Generator::Options cmap;
+    cmap.numberOfGlyphs = 20000;
+    cmap.numberOfCodepoints = 60000;
+
+    Generator::Options cff;
+    cff.numberOfGlyphs = 5000;
+    cff.numberOfCodepoints = 5000;
+    cff.numberOfSubrs = 1000;
+
+    Generator::Options gvar;
+    gvar.numberOfGlyphs = 2000;
+    gvar.numberOfCodepoints = 2000;
+    gvar.numberOfTuples = 8;
+
+    Generator::Options ttc;
+    ttc.numberOfGlyphs = 2000;
+    ttc.numberOfCodepoints = 2000;
+    ttc.numberOfFaces = 8;
+
+    Generator::Options name;
+    name.numberOfNames = 3000;
+
+    return {
+        { "glyf", Generator::makeGlyfFont, glyf },
+        { "cmap", Generator::makeCmapFont, cmap },
+        { "cff", Generator::makeCffFont, cff },
+        { "gvar", Generator::makeGvarFont, gvar },
+        { "ttc", Generator::makeCollection, ttc },
+        { "name", Generator::makeNameFont, name },
+    };
+}
+
+static BenchResult run(const QString &name, const QByteArray &data, const bool buildTree,
+                       const qint64 minTimeMs)
+{
+    BenchResult result;
+    result.name = name;
+    result.fileSize = quint32(data.size());
+
+    const auto mode = buildTree ? Font::Mode::Tree : Font::Mode::Headless;
+
+    // Warm up and make sure that the font is actually valid.
+    {
+        const auto font = Font::parse(data, mode);
+        if (!font.error().isEmpty()) {
+            throw QString("%1: %2").arg(name, font.error());
+        }
+
+        result.nodes = font.nodesCount();
+    }
+
+    // Keep the best time, since everything else is noise.
+    qint64 bestNs = std::numeric_limits<qint64>::max();
+    QElapsedTimer total;
+    total.start();
+    while (total.elapsed() < minTimeMs || result.iterations < 3) {
+        QElapsedTimer timer;
+        timer.start();
+        Font::parse(data, mode);
+        bestNs = std::min(bestNs, timer.nsecsElapsed());
+        result.iterations += 1;
+    }
+
+    bestNs = std::max<qint64>(bestNs, 1);
+    result.nsPerByte = double(bestNs) / double(result.fileSize);
+    result.nodesPerSecond = double(result.nodes) / (double(bestNs) / 1e9);
+    result.peakMemoryKiB = peakMemoryKiB();
+    return result;
+}
+
+// Runs `f` over all operations until `minTimeMs` is reached and keeps the best pass.
+template<typename F>
+static MicroResult runMicro(const QString &name, const quint32 operations, const qint64 minTimeMs, F f)
+{
+    MicroResult result;
+    result.name = name;
+    result.operations = operations;
+
+    qint64 bestNs = std::numeric_limits<qint64>::max();
+    QElapsedTimer total;
+    total.start();
+    while (total.elapsed() < minTimeMs || result.iterations < 3) {
+        QElapsedTimer timer;
+        timer.start();
+        f();
+        bestNs = std::min(bestNs, timer.nsecsElapsed());
+        result.iterations += 1;
+    }
+
+    result.nsPerOp = double(std::max<qint64>(bestNs, 1)) / double(std::max<quint32>(operations, 1));
+    return result;
+}
+
+static const quint8* findCmapSubtable(const quint8 *cmap, const quint16 platformId, const quint16 encodingId)
+{
+    const auto count = qFromBigEndian<quint16>(cmap + 2);
+    for (quint16 i = 0; i < count; ++i) {
+        const auto *record = cmap + 4 + i * 8;
+        if (qFromBigEndian<quint16>(record) == platformId
+            && qFromBigEndian<quint16>(record + 2) == encodingId)
+        {
+            return cmap + qFromBigEndian<quint32>(record + 4);
+        }
+    }
+
+    throw QString("cmap subtable %1/%2 is missing.").arg(platformId).arg(encodingId);
+}
+
+// A straightforward segment scan, like most parsers do.
+static quint16 scanFormat4(const quint8 *subtable, const quint32 codepoint)
+{
+    const quint32 segCount = qFromBigEndian<quint16>(subtable + 6) / 2;
+    const auto *ends = subtable + 14;
+    const auto *starts = ends + segCount * 2 + 2;
+    const auto *deltas = starts + segCount * 2;
+    const auto *offsets = deltas + segCount * 2;
+    for (quint32 i = 0; i < segCount; ++i) {
+        if (codepoint > qFromBigEndian<quint16>(ends + i * 2)) {
+            continue;
+        }
+
+        const quint32 start = qFromBigEndian<quint16>(starts + i * 2);
+        if (codepoint < start) {
+            return 0;
+        }
+
+        const auto delta = qFromBigEndian<quint16>(deltas + i * 2);
+        const auto rangeOffset = qFromBigEndian<quint16>(offsets + i * 2);
+        if (rangeOffset == 0) {
+            return quint16(codepoint + delta);
+        }
+
+        const auto id = qFromBigEndian<quint16>(offsets + i * 2 + rangeOffset + (codepoint - start) * 2);
+        return id == 0 ? 0 : quint16(id + delta);
+    }
+
+    return 0;
+}
+
+static quint16 scanFormat12(const quint8 *subtable, const quint32 codepoint)
+{
+    const auto count = qFromBigEndian<quint32>(subtable + 12);
+    for (quint32 i = 0; i < count; ++i) {
+        const auto *group = subtable + 16 + i * 12;
+        const auto first = qFromBigEndian<quint32>(group);
+        if (codepoint < first) {
+            return 0;
+        }
+
+        if (codepoint <= qFromBigEndian<quint32>(group + 4)) {
+            return quint16(qFromBigEndian<quint32>(group + 8) + (codepoint - first));
+        }
+    }
+
+    return 0;
+}
+
+// Compares decoded cmap lookups with raw subtable scans on the same queries.
+static QVector<MicroResult> runCmapLookups(const QString &filter, const qint64 minTimeMs)
+{
+    Generator::Options options;
+    options.numberOfGlyphs = 20000;
+    options.numberOfCodepoints = 60000;
+
+    const auto data = Generator::makeCmapFont(options);
+    const auto *bytes = reinterpret_cast<const quint8*>(data.constData());
+    const auto font = Font::parse(data, Font::Mode::Headless);
+    if (!font.error().isEmpty()) {
+        throw QString("cmap: %1").arg(font.error());
+    }
+
+    const Face face(bytes, quint32(data.size()), 0, font.ranges().tables);
+    const auto *cmap = bytes + face.findTable("cmap")->start;
+    const auto *format4 = findCmapSubtable(cmap, 3, 1);
+    const auto *format12 = findCmapSubtable(cmap, 3, 10);
+
+    // Half hits and half random queries, which are mostly misses.
+    const auto mappings = Generator::cmapMappings(options);
+    QVector<quint32> queries;
+    QVector<quint32> bmpQueries;
+    quint32 seed = 1;
+    for (int i = 0; i < 8192; ++i) {
+        seed = seed * 1103515245 + 12345;
+        const auto codepoint = (i % 2 == 0)
+            ? mappings[int((seed >> 8) % quint32(mappings.size()))].codepoint
+            : (seed >> 8) % 0x20000;
+        queries.append(codepoint);
+        // Format 4 cannot map U+FFFF.
+        if (codepoint < 0xFFFF) {
+            bmpQueries.append(codepoint);
+        }
+    }
+
+    for (const auto c : queries) {
+        const auto expected = face.characterMap().glyphId(c);
+        if (scanFormat12(format12, c) != expected || (c < 0xFFFF && scanFormat4(format4, c) != expected)) {
+            throw QString("cmap: lookup mismatch for U+%1.").arg(c, 4, 16, QChar('0'));
+        }
+    }
+
+    const auto &map = face.characterMap();
+    QVector<MicroResult> results;
+    auto run = [&](const QString &name, const QVector<quint32> &codepoints, auto lookup) {
+        if (!filter.isEmpty() && !name.contains(filter)) {
+            return;
+        }
+
+        volatile quint32 sink = 0;
+        results << runMicro(name, quint32(codepoints.size()), minTimeMs, [&]{
+            quint32 sum = 0;
+            for (const auto c : codepoints) {
+                sum += lookup(c);
+            }
+            sink = sink + sum;
+        });
+    };
+
+    run("cmap-map", queries, [&](const quint32 c){ return map.glyphId(c); });
+    run("cmap-scan12", queries, [&](const quint32 c){ return scanFormat12(format12, c); });
+    run("cmap-map-bmp", bmpQueries, [&](const quint32 c){ return map.glyphId(c); });
+    run("cmap-scan4", bmpQueries, [&](const quint32 c){ return scanFormat4(format4, c); });
+
+    return results;
+}
+
+// Measures outline decoding throughput in points.
+static QVector<MicroResult> runGlyfDecoding(const QString &filter, const qint64 minTimeMs)
+{
+    Generator::Options options;
+    options.numberOfGlyphs = 5000;
+    options.numberOfCodepoints = 5000;
+
+    const auto data = Generator::makeGlyfFont(options);
+    const auto *bytes = reinterpret_cast<const quint8*>(data.constData());
+    const auto font = Font::parse(data, Font::Mode::Headless);
+    if (!font.error().isEmpty()) {
+        throw QString("glyf: %1").arg(font.error());
+    }
+
+    const Face face(bytes, quint32(data.size()), 0, font.ranges().tables);
+    const auto glyf = *face.findTable("glyf");
+    const auto numberOfGlyphs = face.numberOfGlyphs();
+
+    quint32 numberOfPoints = 0;
+    for (quint16 i = 0; i < numberOfGlyphs; ++i) {
+        const auto outline = face.outline(i);
+        if (!outline) {
+            throw QString("glyf: failed to decode glyph %1.").arg(i);
+        }
+
+        numberOfPoints += quint32(outline->size());
+    }
+
+    // Offsets are already validated by the Face.
+    const auto indexToLocationFormat = qFromBigEndian<quint16>(bytes + face.findTable("head")->start + 50);
+    ShadowParser locaParser(bytes + face.findTable("loca")->start, bytes + data.size());
+    const auto locaOffsets = collectLocaOffsets(numberOfGlyphs, indexToLocationFormat, locaParser);
+
+    QVector<MicroResult> results;
+    auto run = [&](const QString &name, auto decode) {
+        if (!filter.isEmpty() && !name.contains(filter)) {
+            return;
+        }
+
+        volatile float sink = 0;
+        results << runMicro(name, numberOfPoints, minTimeMs, [&]{
+            float sum = 0;
+            for (quint16 i = 0; i < numberOfGlyphs; ++i) {
+                sum += decode(i);
+            }
+            sink = sink + sum;
+        });
+    };
+
+    run("glyf-decode", [&](const quint16 id){
+        const auto outline = decodeGlyphOutline(bytes + glyf.start, glyf.size(), locaOffsets, id);
+        return outline.x.isEmpty() ? 0.0f : outline.x.last();
+    });
+
+    run("glyf-decode-cached", [&](const quint16 id){
+        const auto outline = face.outline(id);
+        return outline->x.isEmpty() ? 0.0f : outline->x.last();
+    });
+
+    return results;
+}
+
+// A CJK-sized font, where most of the outline data lives in subroutines.
+static QVector<MicroResult> runCffInterpretation(const QString &filter, const qint64 minTimeMs)
+{
+    Generator::Options options;
+    options.numberOfGlyphs = 30000;
+    options.numberOfCodepoints = 30000;
+    options.numberOfSubrs = 4000;
+
+    const auto data = Generator::makeCffFont(options);
+    const auto *bytes = reinterpret_cast<const quint8*>(data.constData());
+    const auto font = Font::parse(data, Font::Mode::Headless);
+    if (!font.error().isEmpty()) {
+        throw QString("cff: %1").arg(font.error());
+    }
+
+    const Face face(bytes, quint32(data.size()), 0, font.ranges().tables);
+    const auto cff = *face.findTable("CFF ");
+    ShadowParser parser(bytes + cff.start, bytes + cff.end);
+    const auto charStrings = collectCffCharStrings(parser);
+    const auto numberOfGlyphs = charStrings.numberOfGlyphs();
+
+    quint32 numberOfPoints = 0;
+    for (quint16 i = 0; i < numberOfGlyphs; ++i) {
+        numberOfPoints += quint32(interpretCharString(bytes + cff.start, cff.size(), charStrings, i).size());
+    }
+
+    QVector<MicroResult> results;
+    auto run = [&](const QString &name, auto interpret) {
+        if (!filter.isEmpty() && !name.contains(filter)) {
+            return;
+        }
+
+        volatile float sink = 0;
+        results << runMicro(name, numberOfPoints, minTimeMs, [&]{
+            float sum = 0;
+            for (quint16 i = 0; i < numberOfGlyphs; ++i) {
+                sum += interpret(i);
+            }
+            sink = sink + sum;
+        });
+    };
+
+    run("cff-interpret", [&](const quint16 id){
+        const auto outline = interpretCharString(bytes + cff.start, cff.size(), charStrings, id);
+        return outline.x.isEmpty() ? 0.0f : outline.x.last();
+    });
+
+    run("cff-interpret-cached", [&](const quint16 id){
+        const auto outline = face.outline(id);
+        return outline->x.isEmpty() ? 0.0f : outline->x.last();
+    });
+
+    return results;
+}
+
+// Outlines of all glyphs at a single location, as needed to validate a variable font instance.
+static QVector<MicroResult> runGvarInstancing(const QString &filter, const qint64 minTimeMs)
+{
+    Generator::Options options;
+    options.numberOfGlyphs = 5000;
+    options.numberOfCodepoints = 5000;
+    options.numberOfTuples = 8;
+
+    const auto data = Generator::makeGvarFont(options);
+    const auto *bytes = reinterpret_cast<const quint8*>(data.constData());
+    const auto font = Font::parse(data, Font::Mode::Headless);
+    if (!font.error().isEmpty()) {
+        throw QString("gvar: %1").arg(font.error());
+    }
+
+    const Face face(bytes, quint32(data.size()), 0, font.ranges().tables);
+    const auto numberOfGlyphs = face.numberOfGlyphs();
+    const QVector<float> coords = { 0.6f, 0.3f };
+
+    quint32 numberOfPoints = 0;
+    for (quint16 i = 0; i < numberOfGlyphs; ++i) {
+        const auto outline = face.outline(i, coords);
+        if (!outline) {
+            throw QString("gvar: failed to instance glyph %1.").arg(i);
+        }
+
+        numberOfPoints += quint32(outline->size());
+    }
+
+    QVector<MicroResult> results;
+    const QString name = "gvar-instance";
+    if (filter.isEmpty() || name.contains(filter)) {
+        volatile float sink = 0;
+        results << runMicro(name, numberOfPoints, minTimeMs, [&]{
+            float sum = 0;
+            for (quint16 i = 0; i < numberOfGlyphs; ++i) {
+                const auto outline = face.outline(i, coords);
+                sum += outline->x.isEmpty() ? 0.0f : outline->x.last();
+            }
+            sink = sink + sum;
+        });
+    }
+
+    return results;
+}
+
+// Advance deltas of all glyphs, as needed to lay out text at a new instance.
+static QVector<MicroResult> runHvarEvaluation(const QString &filter, const qint64 minTimeMs)
+{
+    Generator::Options options;
+    options.numberOfGlyphs = 30000;
+    options.numberOfCodepoints = 30000;
+    options.numberOfTuples = 16;
+
+    const auto data = Generator::makeHvarFont(options);
+    const auto *bytes = reinterpret_cast<const quint8*>(data.constData());
+    const auto font = Font::parse(data, Font::Mode::Headless);
+    if (!font.error().isEmpty()) {
+        throw QString("hvar: %1").arg(font.error());
+    }
+
+    const Face face(bytes, quint32(data.size()), 0, font.ranges().tables);
+    const auto hvar = *face.findTable("HVAR");
+    ShadowParser parser(bytes + hvar.start, bytes + hvar.end);
+    const auto variations = collectHvar(parser);
+    const auto numberOfGlyphs = face.numberOfGlyphs();
+    const QVector<float> coords = { 0.3f, -0.6f };
+
+    // Both paths must produce the same deltas.
+    const auto deltas = face.advanceDeltas(coords);
+    const auto scalars = variations.store.regionScalars(coords);
+    for (quint16 i = 0; i < numberOfGlyphs; ++i) {
+        if (std::abs(deltas.value(i) - variations.store.delta(0, i, scalars)) > 0.01f) {
+            throw QString("hvar: glyph %1 delta mismatch.").arg(i);
+        }
+    }
+
+    QVector<MicroResult> results;
+    auto run = [&](const QString &name, auto evaluate) {
+        if (!filter.isEmpty() && !name.contains(filter)) {
+            return;
+        }
+
+        volatile float sink = 0;
+        results << runMicro(name, numberOfGlyphs, minTimeMs, [&]{
+            sink = sink + evaluate();
+        });
+    };
+
+    run("hvar-delta", [&]{
+        const auto scalars = variations.store.regionScalars(coords);
+        float sum = 0;
+        for (quint16 i = 0; i < numberOfGlyphs; ++i) {
+            sum += variations.store.delta(0, i, scalars);
+        }
+        return sum;
+    });
+
+    run("hvar-deltas-all", [&]{
+        const auto deltas = face.advanceDeltas(coords);
+        return deltas.last();
+    });
+
+    return results;
+}
+
+static QJsonObject toJson(const BenchResult &result)
+{
+    return QJsonObject {
+        { "name", result.name },
+        { "fileSize", qint64(result.fileSize) },
+        { "iterations", qint64(result.iterations) },
+        { "nodes", qint64(result.nodes) },
+        { "nsPerByte", result.nsPerByte },
+        { "nodesPerSecond", result.nodesPerSecond },
+        { "peakMemoryKiB", qint64(result.peakMemoryKiB) },
+    };
+}
+
+static BenchResult fromJson(const QJsonObject &obj)
+{
+    BenchResult result;
+    result.name = obj.value("name").toString();
+    result.fileSize = quint32(obj.value("fileSize").toVariant().toLongLong());
+    result.iterations = quint32(obj.value("iterations").toVariant().toLongLong());
+    result.nodes = quint32(obj.value("nodes").toVariant().toLongLong());
+    result.nsPerByte = obj.value("nsPerByte").toDouble();
+    result.nodesPerSecond = obj.value("nodesPerSecond").toDouble();
+    result.peakMemoryKiB = quint64(obj.value("peakMemoryKiB").toVariant().toLongLong());
+    return result;
+}
+
+static QJsonObject toJson(const MicroResult &result)
+{
+    return QJsonObject {
+        { "name", result.name },
+        { "operations", qint64(result.operations) },
+        { "iterations", qint64(result.iterations) },
+        { "nsPerOp", result.nsPerOp },
+    };
+}
+
+struct Metric
+{
+    QString name;
+    double value;
+};
+
+// Returns the number of regressions.
+static int compareWithBaseline(const QVector<BenchResult> &results, const QVector<MicroResult> &micro,
+                               const QString &path, const double threshold, QTextStream &out)
+{
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly)) {
+        throw QString("Failed to open '%1'.").arg(path);
+    }
+
+    const auto doc = QJsonDocument::fromJson(file.readAll());
+    if (!doc.isObject()) {
+        throw QString("'%1' is not a benchmark report.").arg(path);
+    }
+
+    QHash<QString, double> baseline;
+    for (const auto value : doc.object().value("results").toArray()) {
+        const auto obj = value.toObject();
+        baseline.insert(obj.value("name").toString(), obj.value("nsPerByte").toDouble());
+    }
+
+    for (const auto value : doc.object().value("micro").toArray()) {
+        const auto obj = value.toObject();
+        baseline.insert(obj.value("name").toString(), obj.value("nsPerOp").toDouble());
+    }
+
+    QVector<Metric> metrics;
+    for (const auto &result : results) {
+        metrics.append({ result.name, result.nsPerByte });
+    }
+
+    for (const auto &result : micro) {
+        metrics.append({ result.name, result.nsPerOp });
+    }
+
+    int regressions = 0;
+    for (const auto &metric : metrics) {
+        if (!baseline.contains(metric.name)) {
+            continue;
+        }
+
+        const auto old = baseline.value(metric.name);
+        // Missing or broken values cannot be compared.
+        if (!(old > 0)) {
+            out << QString("%1 %2 ns (no baseline)\n")
+                .arg(metric.name, -12)
+                .arg(metric.value, 0, 'f', 2);
+            continue;
+        }
+
+        const auto diff = (metric.value - old) / old * 100.0;
+        const bool isRegression = diff > threshold;
+        if (isRegression) {
+            regressions += 1;
+        }
+
+        out << QString("%1 %2 -> %3 ns (%4%5%)%6\n")
+            .arg(metric.name, -12)
+            .arg(old, 0, 'f', 2)
+            .arg(metric.value, 0, 'f', 2)
+            .arg(diff >= 0 ? "+" : "")
+            .arg(diff, 0, 'f', 1)
+            .arg(isRegression ? " REGRESSION" : "");
+    }
+
+    return regressions;
+}
+
+// Runs a parse case in a child process, so its peak memory doesn't include previous cases.
+//
+// The child is this executable with `--case`, which prints the result as JSON.
+static BenchResult runInChild(const QString &name, const qint64 minTimeMs)
+{
+    QProcess process;
+    process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    process.start(QCoreApplication::applicationFilePath(),
+                  { "--case", name, "--min-time", QString::number(minTimeMs) });
+    if (!process.waitForFinished(-1)) {
+        throw QString("%1: failed to run a child process.").arg(name);
+    }
+
+    if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        throw QString("%1: the child process has failed.").arg(name);
+    }
+
+    const auto doc = QJsonDocument::fromJson(process.readAllStandardOutput());
+    if (!doc.isObject()) {
+        throw QString("%1: the child process has returned an invalid result.").arg(name);
+    }
+
+    return fromJson(doc.object());
+}
+
+// Runs a single parse case, like `glyf/tree`, and prints its result as JSON.
+static int runCase(const QString &name, const qint64 minTimeMs)
+{
+    const auto parts = name.split('/');
+    for (const auto &c : benchCases()) {
+        if (parts.size() != 2 || c.name != parts[0]) {
+            continue;
+        }
+
+        try {
+            const auto result = run(name, c.make(c.options), parts[1] == "tree", minTimeMs);
+            QTextStream(stdout) << QJsonDocument(toJson(result)).toJson(QJsonDocument::Compact);
+            return 0;
+        } catch (const QString &msg) {
+            QTextStream(stderr) << "Error: " << msg << '\n';
+            return 2;
+        }
+    }
+
+    QTextStream(stderr) << "Error: unknown case '" << name << "'.\n";
+    return 2;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("ttf-explorer-bench");
+
+    QCommandLineParser cli;
+    cli.setApplicationDescription("Parser benchmarks on synthetic fonts.");
+    cli.addHelpOption();
+
+    const QCommandLineOption outputOpt("output", "Write a JSON report to <file>.", "file");
+    const QCommandLineOption baselineOpt("baseline", "Compare against a JSON report from <file>.", "file");
+    const QCommandLineOption thresholdOpt("threshold", "Allowed slowdown in percent. Default: 10.",
+                                          "percent", "10");
+    const QCommandLineOption filterOpt("filter", "Run only cases containing <name>.", "name");
+    const QCommandLineOption minTimeOpt("min-time", "Minimal time per case in ms. Default: 500.",
+                                        "ms", "500");
+    // Used internally to run each parse case in its own process.
+    QCommandLineOption caseOpt("case", "Run a single parse case and print it as JSON.", "name");
+    caseOpt.setFlags(QCommandLineOption::HiddenFromHelp);
+    cli.addOption(outputOpt);
+    cli.addOption(baselineOpt);
+    cli.addOption(thresholdOpt);
+    cli.addOption(filterOpt);
+    cli.addOption(minTimeOpt);
+    cli.addOption(caseOpt);
+    cli.process(app);
+
+    QTextStream out(stdout);
+
+    const auto minTimeMs = cli.value(minTimeOpt).toLongLong();
+    const auto filter = cli.value(filterOpt);
+
+    if (cli.isSet(caseOpt)) {
+        return runCase(cli.value(caseOpt), minTimeMs);
+    }
+
+    QVector<BenchResult> results;
+    QVector<MicroResult> micro;
+    try {
+        for (const bool buildTree : { false, true }) {
+            for (const auto &c : benchCases()) {
+                const auto name = c.name + (buildTree ? "/tree" : "/null");
+                if (!filter.isEmpty() && !name.contains(filter)) {
+                    continue;
+                }
+
+                const auto result = runInChild(name, minTimeMs);
+                out << QString("%1 %2 KiB %3 ns/byte %4 Mnodes/s %5 MiB peak\n")
+                    .arg(result.name, -12)
+                    .arg(result.fileSize / 1024, 6)
+                    .arg(result.nsPerByte, 8, 'f', 2)
+                    .arg(result.nodesPerSecond / 1e6, 7, 'f', 2)
+                    .arg(double(result.peakMemoryKiB) / 1024.0, 7, 'f', 1);
+                out.flush();
+                results << result;
+            }
+        }
+
+        micro = runCmapLookups(filter, minTimeMs) + runGlyfDecoding(filter, minTimeMs)
+            + runCffInterpretation(filter, minTimeMs) + runGvarInstancing(filter, minTimeMs)
+            + runHvarEvaluation(filter, minTimeMs);
+        for (const auto &result : micro) {
+            out << QString("%1 %2 ns/op %3 Mops/s\n")
+                .arg(result.name, -12)
+                .arg(result.nsPerOp, 8, 'f', 2)
+                .arg(1e3 / result.nsPerOp, 8, 'f', 2);
+        }
+    } catch (const QString &msg) {
+        QTextStream(stderr) << "Error: " << msg << '\n';
+        return 2;
+    }
+
+    if (cli.isSet(outputOpt)) {
+        QJsonArray list;
+        for (const auto &result : results) {
+            list.append(toJson(result));
+        }
+
+        QJsonArray microList;
+        for (const auto &result : micro) {
+            microList.append(toJson(result));
+        }
+
+        QFile file(cli.value(outputOpt));
+        if (!file.open(QFile::WriteOnly)) {
+            QTextStream(stderr) << "Error: failed to write '" << file.fileName() << "'.\n";
+            return 2;
+        }
+
+        file.write(QJsonDocument(QJsonObject { { "version", 1 }, { "results", list }, { "micro", microList } }).toJson());
+    }
+
+    if (cli.isSet(baselineOpt)) {
+        try {
+            const auto threshold = cli.value(thresholdOpt).toDouble();
+            const auto regressions = compareWithBaseline(results, micro, cli.value(baselineOpt), threshold, out);
+            if (regressions != 0) {
+                out << regressions << " regression(s) above " << threshold << "%.\n";
+                return 1;
+            }
+        } catch (const QString &msg) {
+            QTextStream(stderr) << "Error: " << msg << '\n';
+            return 2;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,24 @@
+QT       = core
+
+TARGET   = ttf-explorer-cli
+TEMPLATE = app
+
+CONFIG  += c++17 console
+CONFIG  -= app_bundle
+CONFIG  += sdk_no_version_check
+
+equals(QMAKE_CXX, clang++) {
+    QMAKE_CXXFLAGS += -Wextra -Wpedantic -Wimplicit-fallthrough -Wconversion
+}
+
+# required to make C++17 work on macOS
+mac:QMAKE_MACOSX_DEPLOYMENT_TARGET = 10.15
+
+include(../ttfexplorer-core.pri)
+
+SOURCES += \
+    main.cpp \
+    scanner.cpp
+
+HEADERS += \
+    scanner.h
@@ -0,0 +1,151 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QThread>
+
+#include "scanner.h"
+
+static QJsonObject toJson(const Coverage &coverage)
+{
+    return QJsonObject {
+        { "covered", qint64(coverage.covered) },
+        { "padding", qint64(coverage.padding) },
+        { "unsupported", qint64(coverage.unsupported) },
+        { "ratio", coverage.ratio() },
+    };
+}
+
+static QByteArray toJsonLine(const ScanResult &result, const bool detailedCoverage)
+{
+    auto coverage = toJson(result.coverage.file);
+    if (detailedCoverage) {
+        QJsonArray tables;
+        for (const auto &table : result.coverage.tables) {
+            auto obj = toJson(table.coverage);
+            obj.insert("face", qint64(table.faceIndex));
+            obj.insert("tag", table.tag);
+            obj.insert("offset", qint64(table.range.start));
+            obj.insert("length", qint64(table.range.size()));
+            tables.append(obj);
+        }
+
+        QJsonArray faces;
+        for (const auto &face : result.coverage.faces) {
+            faces.append(toJson(face));
+        }
+
+        coverage.insert("tables", tables);
+        coverage.insert("faces", faces);
+    }
+
+    QJsonObject obj {
+        { "path", result.path },
+        { "size", qint64(result.size) },
+        { "nodes", qint64(result.nodes) },
+        { "coverage", coverage },
+        { "parseMs", result.parseMs },
+        { "warnings", QJsonArray::fromStringList(result.warnings) },
+    };
+
+    if (!result.error.isEmpty()) {
+        obj.insert("error", result.error);
+    }
+
+    return QJsonDocument(obj).toJson(QJsonDocument::Compact) + '\n';
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("ttf-explorer-cli");
+
+    QCommandLineParser cli;
+    cli.setApplicationDescription("Headless font validation.");
+    cli.addHelpOption();
+
+    const QCommandLineOption scanOpt("scan", "Parse all fonts in <dir> and its subdirectories.", "dir");
+    const QCommandLineOption outputOpt("output", "Write a report to <file> instead of stdout.", "file");
+    const QCommandLineOption jobsOpt("jobs", "Number of worker threads. Default: number of cores.", "n");
+    const QCommandLineOption treeOpt("tree", "Build a complete tree for each font. Slower.");
+    const QCommandLineOption coverageOpt("coverage", "Include per-table and per-face coverage.");
+    cli.addOption(scanOpt);
+    cli.addOption(outputOpt);
+    cli.addOption(jobsOpt);
+    cli.addOption(treeOpt);
+    cli.addOption(coverageOpt);
+    cli.process(app);
+
+    QTextStream err(stderr);
+
+    if (!cli.isSet(scanOpt)) {
+        cli.showHelp(2);
+    }
+
+    int jobs = QThread::idealThreadCount();
+    if (cli.isSet(jobsOpt)) {
+        jobs = cli.value(jobsOpt).toInt();
+        if (jobs < 1) {
+            err << "Error: invalid number of jobs.\n";
+            return 2;
+        }
+    }
+
+    QFile output;
+    if (cli.isSet(outputOpt)) {
+        output.setFileName(cli.value(outputOpt));
+        if (!output.open(QFile::WriteOnly)) {
+            err << "Error: failed to write '" << output.fileName() << "'.\n";
+            return 2;
+        }
+    } else {
+        output.open(stdout, QFile::WriteOnly);
+    }
+
+    const auto files = Scanner::findFonts(cli.value(scanOpt));
+    const auto mode = cli.isSet(treeOpt) ? Font::Mode::Tree : Font::Mode::Headless;
+    const auto detailedCoverage = cli.isSet(coverageOpt);
+
+    int failed = 0;
+    int withWarnings = 0;
+    quint64 totalSize = 0;
+    Coverage totalCoverage;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Results are written as JSON Lines as soon as they are ready,
+    // so the memory usage doesn't depend on the number of files.
+    Scanner::scan(files, jobs, mode, [&](const ScanResult &result) {
+        if (!result.error.isEmpty()) {
+            failed += 1;
+        } else if (!result.warnings.isEmpty()) {
+            withWarnings += 1;
+        }
+
+        totalSize += result.size;
+        totalCoverage += result.coverage.file;
+        output.write(toJsonLine(result, detailedCoverage));
+    });
+
+    output.flush();
+
+    const auto elapsedSec = double(timer.nsecsElapsed()) / 1e9;
+    err << QString("%1 files, %2 failed, %3 with warnings, %4 MiB in %5s (%6 MiB/s) using %7 threads\n")
+        .arg(files.size())
+        .arg(failed)
+        .arg(withWarnings)
+        .arg(double(totalSize) / 1048576.0, 0, 'f', 1)
+        .arg(elapsedSec, 0, 'f', 2)
+        .arg(elapsedSec > 0 ? double(totalSize) / 1048576.0 / elapsedSec : 0.0, 0, 'f', 1)
+        .arg(jobs);
+    err << QString("Coverage: %1% (%2 unsupported bytes)\n")
+        .arg(totalCoverage.ratio() * 100.0, 0, 'f', 2)
+        .arg(totalCoverage.unsupported);
+
+    return failed == 0 ? 0 : 1;
+}
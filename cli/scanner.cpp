@@ -0,0 +1,136 @@
+#include <QAtomicInteger>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThreadPool>
+
+#include <climits>
+
+#include "scanner.h"
+
+static ScanResult scanFile(const QString &path, const Font::Mode mode)
+{
+    ScanResult result;
+    result.path = path;
+
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly)) {
+        result.error = "Failed to open a file.";
+        return result;
+    }
+
+    result.size = quint64(file.size());
+    if (file.size() > UINT_MAX) {
+        result.error = "The file is too big.";
+        return result;
+    }
+
+    if (file.size() == 0) {
+        result.error = "The file is empty.";
+        return result;
+    }
+
+    const auto data = file.map(0, file.size());
+    if (!data) {
+        result.error = "Failed to map a file.";
+        return result;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const auto font = Font::parse(data, quint32(file.size()), mode);
+
+    result.parseMs = double(timer.nsecsElapsed()) / 1000000.0;
+    result.error = font.error();
+    result.warnings = font.warnings();
+    result.nodes = font.nodesCount();
+    result.coverage = computeCoverage(font.ranges(), quint32(result.size));
+
+    file.unmap(data);
+    return result;
+}
+
+namespace {
+
+struct SharedState
+{
+    SharedState(const QStringList &files, const Font::Mode mode,
+                const std::function<void(const ScanResult&)> &callback)
+        : files(files)
+        , mode(mode)
+        , callback(callback)
+        , nextIndex(0)
+    {
+    }
+
+    const QStringList &files;
+    const Font::Mode mode;
+    const std::function<void(const ScanResult&)> &callback;
+    QAtomicInteger<int> nextIndex;
+    QMutex callbackMutex;
+};
+
+class Worker : public QRunnable
+{
+public:
+    explicit Worker(SharedState &state)
+        : m_state(state)
+    {
+    }
+
+    void run() override
+    {
+        while (true) {
+            const auto index = m_state.nextIndex.fetchAndAddRelaxed(1);
+            if (index >= m_state.files.size()) {
+                break;
+            }
+
+            const auto result = scanFile(m_state.files.at(index), m_state.mode);
+
+            QMutexLocker locker(&m_state.callbackMutex);
+            m_state.callback(result);
+        }
+    }
+
+private:
+    SharedState &m_state;
+};
+
+}
+
+QStringList Scanner::findFonts(const QString &dir)
+{
+    static const QStringList extensions = { "ttf", "otf", "ttc", "otc" };
+
+    QStringList files;
+    QDirIterator it(dir, QDir::Files | QDir::Readable, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const auto path = it.next();
+        if (extensions.contains(it.fileInfo().suffix().toLower())) {
+            files << path;
+        }
+    }
+
+    files.sort();
+    return files;
+}
+
+void Scanner::scan(const QStringList &files, const int threads, const Font::Mode mode,
+                   const std::function<void(const ScanResult&)> &callback)
+{
+    SharedState state(files, mode, callback);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    for (int i = 0; i < std::min(threads, int(files.size())); ++i) {
+        pool.start(new Worker(state));
+    }
+
+    pool.waitForDone();
+}
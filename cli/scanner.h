@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QStringList>
+
+#include <functional>
+
+#include "src/coverage.h"
+#include "src/font.h"
+
+struct ScanResult
+{
+    QString path;
+    quint64 size = 0;
+    QString error;
+    QStringList warnings;
+    quint32 nodes = 0;
+    CoverageReport coverage;
+    double parseMs = 0;
+};
+
+namespace Scanner
+{
+    // Returns all font files in `dir` and its subdirectories, sorted by path.
+    QStringList findFonts(const QString &dir);
+
+    // Parses `files` using `threads` workers.
+    //
+    // Each worker takes the next unprocessed file as soon as it's done with the previous one,
+    // so only `threads` files are mapped at the same time.
+    //
+    // `callback` is called from worker threads, but never concurrently.
+    void scan(const QStringList &files, const int threads, const Font::Mode mode,
+              const std::function<void(const ScanResult&)> &callback);
+}
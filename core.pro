@@ -0,0 +1,16 @@
+QT       = core
+
+TARGET   = ttfexplorer-core
+TEMPLATE = lib
+
+CONFIG  += c++17 staticlib
+CONFIG  += sdk_no_version_check
+
+equals(QMAKE_CXX, clang++) {
+    QMAKE_CXXFLAGS += -Wextra -Wpedantic -Wimplicit-fallthrough -Wconversion
+}
+
+# required to make C++17 work on macOS
+mac:QMAKE_MACOSX_DEPLOYMENT_TARGET = 10.15
+
+include(src/core.pri)
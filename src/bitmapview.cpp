@@ -0,0 +1,288 @@
+#include <QGuiApplication>
+#include <QRunnable>
+#include <QThread>
+#include <QVBoxLayout>
+
+#include "bitmapview.h"
+
+static const int ThumbnailSize = 16;
+static const int MaxPreviewSize = 256;
+
+// Set bits are ink, so bitmaps are shown as black on white.
+static QImage decodeRawBitmap(const BitmapInfo &info, const uchar *data, const quint32 size)
+{
+    const auto depth = quint32(info.bitDepth);
+    if (info.width == 0 || info.height == 0 || !(depth == 1 || depth == 2 || depth == 4 || depth == 8)) {
+        return QImage();
+    }
+
+    const quint32 rowBits = info.width * depth;
+    const quint32 stride = info.format == BitmapInfo::Format::ByteAligned ? (rowBits + 7) / 8 * 8 : rowBits;
+    if (quint64(stride) * info.height > quint64(size) * 8) {
+        return QImage();
+    }
+
+    const quint32 maxValue = (1u << depth) - 1;
+    QImage image(info.width, info.height, QImage::Format_Grayscale8);
+    for (quint32 y = 0; y < info.height; ++y) {
+        auto line = image.scanLine(int(y));
+        for (quint32 x = 0; x < info.width; ++x) {
+            // Pixels never cross a byte boundary, because the depth is a power of two.
+            const auto bit = y * stride + x * depth;
+            const auto value = (quint32(data[bit / 8]) >> (8 - depth - bit % 8)) & maxValue;
+            line[x] = uchar(255 - value * 255 / maxValue);
+        }
+    }
+
+    return image;
+}
+
+static QImage decodeBitmap(const BitmapInfo &info, const uchar *data, const quint32 size)
+{
+    switch (info.format) {
+    case BitmapInfo::Format::Png: return QImage::fromData(data, int(size), "PNG");
+    case BitmapInfo::Format::Jpeg: return QImage::fromData(data, int(size), "JPG");
+    case BitmapInfo::Format::Tiff: return QImage::fromData(data, int(size), "TIFF");
+    case BitmapInfo::Format::ByteAligned:
+    case BitmapInfo::Format::BitAligned: return decodeRawBitmap(info, data, size);
+    }
+
+    Q_UNREACHABLE();
+}
+
+class BitmapDecodeTask : public QRunnable
+{
+public:
+    BitmapDecodeTask(BitmapDecoder *decoder, const quint64 generation, const TreeItem *item,
+                     const std::optional<BitmapInfo> &info, const uchar *data, const quint32 size,
+                     const qreal pixelRatio)
+        : m_decoder(decoder)
+        , m_generation(generation)
+        , m_item(item)
+        , m_info(info)
+        , m_data(data)
+        , m_size(size)
+        , m_pixelRatio(pixelRatio)
+    {
+    }
+
+    void run() override
+    {
+        const auto image = m_info ? decodeBitmap(*m_info, m_data, m_size) : QImage();
+
+        QImage thumbnail;
+        if (!image.isNull()) {
+            const auto size = QSize(ThumbnailSize, ThumbnailSize) * m_pixelRatio;
+            // Bitmaps smaller than a thumbnail are not smoothed, so pixels stay sharp.
+            const auto mode = image.width() < size.width() && image.height() < size.height()
+                ? Qt::FastTransformation : Qt::SmoothTransformation;
+            thumbnail = image.scaled(size, Qt::KeepAspectRatio, mode);
+            thumbnail.setDevicePixelRatio(m_pixelRatio);
+        }
+
+        // The decoder waits for all tasks before the data is reset, so both are still alive here.
+        const auto decoder = m_decoder;
+        const auto generation = m_generation;
+        const auto item = m_item;
+        QMetaObject::invokeMethod(decoder, [decoder, generation, item, image, thumbnail]{
+            decoder->onDecoded(generation, item, image, thumbnail);
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    BitmapDecoder * const m_decoder;
+    const quint64 m_generation;
+    const TreeItem * const m_item;
+    const std::optional<BitmapInfo> m_info;
+    const uchar * const m_data;
+    const quint32 m_size;
+    const qreal m_pixelRatio;
+};
+
+BitmapDecoder::BitmapDecoder(QObject *parent)
+    : QObject(parent)
+    , m_bitmaps(64 * 1024)
+{
+    // Keep one core for the GUI.
+    m_pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
+}
+
+BitmapDecoder::~BitmapDecoder()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+void BitmapDecoder::setData(const uchar *data, const quint32 size)
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+
+    m_data = data;
+    m_size = size;
+    m_generation += 1;
+    m_bitmaps.clear();
+    m_pending.clear();
+}
+
+bool BitmapDecoder::image(const TreeItem *item, const Priority priority, QImage &image)
+{
+    if (const auto bitmap = cached(item, priority)) {
+        image = bitmap->image;
+        return true;
+    }
+
+    return false;
+}
+
+bool BitmapDecoder::thumbnail(const TreeItem *item, QPixmap &pixmap)
+{
+    if (const auto bitmap = cached(item, Priority::Visible)) {
+        pixmap = bitmap->thumbnail;
+        return true;
+    }
+
+    return false;
+}
+
+void BitmapDecoder::cancelVisible()
+{
+    QVector<const TreeItem*> selected;
+    for (const auto &pending : m_pending) {
+        if (pending.priority == Priority::Selected) {
+            selected << pending.item;
+        }
+    }
+
+    m_pool.clear();
+    m_pending.clear();
+
+    for (const auto item : selected) {
+        schedule(item, Priority::Selected);
+    }
+}
+
+const BitmapDecoder::CachedBitmap* BitmapDecoder::cached(const TreeItem *item, const Priority priority)
+{
+    if (const auto bitmap = m_bitmaps.object(item->range.start)) {
+        return bitmap;
+    }
+
+    schedule(item, priority);
+    return nullptr;
+}
+
+void BitmapDecoder::schedule(const TreeItem *item, const Priority priority)
+{
+    if (!m_data || item->range.end > m_size) {
+        return;
+    }
+
+    // A queued visible item can be selected. Then it's queued again with a higher priority
+    // and both results are accepted.
+    const auto key = item->range.start;
+    const auto it = m_pending.constFind(key);
+    if (it != m_pending.constEnd() && (it->priority == Priority::Selected || priority == Priority::Visible)) {
+        return;
+    }
+
+    m_pending.insert(key, PendingBitmap { item, priority });
+    std::optional<BitmapInfo> info;
+    if (const auto bitmap = dynamic_cast<const BitmapItem*>(item)) {
+        info = bitmap->info;
+    }
+
+    m_pool.start(new BitmapDecodeTask(this, m_generation, item, info,
+                                      m_data + key, item->range.size(), qApp->devicePixelRatio()),
+                 priority == Priority::Selected ? 1 : 0);
+}
+
+void BitmapDecoder::onDecoded(const quint64 generation, const TreeItem *item,
+                              const QImage &image, const QImage &thumbnail)
+{
+    if (generation != m_generation) {
+        return;
+    }
+
+    // Failed images are cached as well, so they are not decoded again.
+    m_pending.remove(item->range.start);
+    const auto cost = std::min(std::max(1, int(image.sizeInBytes() / 1024)), m_bitmaps.maxCost());
+    m_bitmaps.insert(item->range.start, new CachedBitmap{ image, QPixmap::fromImage(thumbnail) }, cost);
+    emit decoded(item);
+}
+
+BitmapPreview::BitmapPreview(BitmapDecoder *decoder, QWidget *parent)
+    : QWidget(parent)
+    , m_decoder(decoder)
+    , m_lblImage(new QLabel)
+    , m_lblInfo(new QLabel)
+{
+    auto lay = new QVBoxLayout(this);
+    lay->addWidget(m_lblImage, 1);
+    lay->addWidget(m_lblInfo);
+
+    m_lblImage->setAlignment(Qt::AlignCenter);
+    m_lblImage->setMinimumSize(MaxPreviewSize / 2, MaxPreviewSize / 2);
+    m_lblInfo->setAlignment(Qt::AlignCenter);
+
+    connect(decoder, &BitmapDecoder::decoded, this, &BitmapPreview::onDecoded);
+
+    setItem(nullptr);
+}
+
+void BitmapPreview::setItem(const TreeItem *item)
+{
+    m_item = item && item->type == BitmapInfo::Type ? item : nullptr;
+
+    m_lblImage->clear();
+    m_lblInfo->clear();
+
+    if (!m_item) {
+        m_lblImage->setText("No bitmap selected");
+        return;
+    }
+
+    QImage image;
+    if (m_decoder->image(m_item, BitmapDecoder::Priority::Selected, image)) {
+        showImage(image);
+    } else {
+        m_lblImage->setText("Decoding...");
+    }
+}
+
+void BitmapPreview::onDecoded(const TreeItem *item)
+{
+    QImage image;
+    if (item == m_item && m_decoder->image(item, BitmapDecoder::Priority::Selected, image)) {
+        showImage(image);
+    }
+}
+
+void BitmapPreview::showImage(const QImage &image)
+{
+    if (image.isNull()) {
+        m_lblImage->setText("Failed to decode");
+        m_lblInfo->setText(m_item->value);
+        return;
+    }
+
+    // Small bitmaps are scaled by an integer factor, so pixels stay sharp.
+    const auto scale = std::max(1, std::min(MaxPreviewSize / image.width(), MaxPreviewSize / image.height()));
+    m_lblImage->setPixmap(QPixmap::fromImage(
+        image.scaled(image.size() * scale, Qt::IgnoreAspectRatio, Qt::FastTransformation)));
+
+    // Raw bitmaps already have a size in the value.
+    auto info = m_item->value;
+    const auto bitmap = dynamic_cast<const BitmapItem*>(m_item);
+    if (bitmap && (bitmap->info.format == BitmapInfo::Format::Png
+                   || bitmap->info.format == BitmapInfo::Format::Jpeg
+                   || bitmap->info.format == BitmapInfo::Format::Tiff)) {
+        info += QString(", %1x%2").arg(image.width()).arg(image.height());
+    }
+
+    if (scale > 1) {
+        info += QString(", scaled %1x").arg(scale);
+    }
+
+    m_lblInfo->setText(info);
+}
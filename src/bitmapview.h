@@ -0,0 +1,101 @@
+#pragma once
+
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QLabel>
+#include <QPixmap>
+#include <QThreadPool>
+
+#include "parser.h"
+#include "treeitem.h"
+
+class BitmapDecodeTask;
+
+// Decodes embedded images on worker threads.
+//
+// Images are decoded directly from the mapped file and cached along with tree thumbnails.
+// Items are identified by their offset, so the cache doesn't depend on the tree.
+class BitmapDecoder : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Priority
+    {
+        // Visible in the tree. Canceled on scroll.
+        Visible,
+        // Shown in the preview. Decoded before visible items.
+        Selected,
+    };
+
+    explicit BitmapDecoder(QObject *parent = nullptr);
+    ~BitmapDecoder();
+
+    // Waits for running tasks and drops all cached images.
+    // The data must outlive the decoder or be reset with nullptr.
+    void setData(const uchar *data, const quint32 size);
+
+    // Returns true when the item was decoded. On failure, the image is null.
+    // Otherwise, decoding is scheduled and decoded() is emitted when it's done.
+    bool image(const TreeItem *item, const Priority priority, QImage &image);
+    bool thumbnail(const TreeItem *item, QPixmap &pixmap);
+
+    // Drops queued requests of visible items. Running tasks will still finish.
+    void cancelVisible();
+
+signals:
+    void decoded(const TreeItem *item);
+
+private:
+    friend class BitmapDecodeTask;
+
+    struct CachedBitmap
+    {
+        QImage image;
+        QPixmap thumbnail;
+    };
+
+    struct PendingBitmap
+    {
+        const TreeItem *item;
+        Priority priority;
+    };
+
+    const CachedBitmap* cached(const TreeItem *item, const Priority priority);
+    void schedule(const TreeItem *item, const Priority priority);
+    void onDecoded(const quint64 generation, const TreeItem *item,
+                   const QImage &image, const QImage &thumbnail);
+
+private:
+    const uchar *m_data = nullptr;
+    quint32 m_size = 0;
+    // Results for previous data are ignored.
+    quint64 m_generation = 0;
+    QThreadPool m_pool;
+    // The key is an item offset. The cost is in KiB.
+    QCache<quint32, CachedBitmap> m_bitmaps;
+    QHash<quint32, PendingBitmap> m_pending;
+};
+
+// Shows a decoded image of the selected bitmap node.
+class BitmapPreview : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit BitmapPreview(BitmapDecoder *decoder, QWidget *parent = nullptr);
+
+    // Accepts any item. The item must outlive the preview or be reset with nullptr.
+    void setItem(const TreeItem *item);
+
+private:
+    void onDecoded(const TreeItem *item);
+    void showImage(const QImage &image);
+
+private:
+    BitmapDecoder * const m_decoder;
+    QLabel * const m_lblImage;
+    QLabel * const m_lblInfo;
+    const TreeItem *m_item = nullptr;
+};
@@ -0,0 +1,167 @@
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGridLayout>
+#include <QHeaderView>
+
+#include "font.h"
+
+#include "comparewindow.h"
+
+static TreeItem* loadTree(const QString &path, QStringList &errors)
+{
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly)) {
+        errors << QString("Failed to open '%1'.").arg(path);
+        return nullptr;
+    }
+
+    if (file.size() > UINT_MAX || file.size() == 0) {
+        errors << QString("'%1' has an invalid size.").arg(path);
+        return nullptr;
+    }
+
+    const auto data = file.map(0, file.size());
+    if (!data) {
+        errors << QString("Failed to map '%1'.").arg(path);
+        return nullptr;
+    }
+
+    auto font = Font::parse(data, quint32(file.size()), Font::Mode::HashedTree);
+    if (!font.error().isEmpty()) {
+        errors << QString("%1: %2").arg(path, font.error());
+    }
+
+    file.unmap(data);
+    return font.takeRootItem();
+}
+
+static QHash<const TreeItem*, QColor> highlights(const QHash<const TreeItem*, TreeDiff::Change> &changes)
+{
+    QHash<const TreeItem*, QColor> colors;
+    colors.reserve(changes.size());
+    for (auto it = changes.constBegin(); it != changes.constEnd(); ++it) {
+        switch (it.value()) {
+        case TreeDiff::Change::Modified: colors.insert(it.key(), QColor(255, 240, 170)); break;
+        case TreeDiff::Change::Added: colors.insert(it.key(), QColor(200, 240, 200)); break;
+        case TreeDiff::Change::Removed: colors.insert(it.key(), QColor(250, 200, 200)); break;
+        }
+    }
+
+    return colors;
+}
+
+CompareWindow::CompareWindow(const QString &leftPath, const QString &rightPath, QWidget *parent)
+    : QMainWindow(parent)
+    , m_leftView(new QTreeView)
+    , m_rightView(new QTreeView)
+    , m_lblStatus(new QLabel)
+{
+    setCentralWidget(new QWidget());
+    setWindowTitle(QString("TTF Explorer: %1 vs %2").arg(leftPath, rightPath));
+
+    m_lblStatus->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+
+    auto lay = new QGridLayout(centralWidget());
+    lay->setContentsMargins(2, 2, 2, 2);
+    lay->addWidget(new QLabel(leftPath), 0, 0);
+    lay->addWidget(new QLabel(rightPath), 0, 1);
+    lay->addWidget(m_leftView, 1, 0);
+    lay->addWidget(m_rightView, 1, 1);
+    lay->addWidget(m_lblStatus, 2, 0, 1, 2);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QStringList errors;
+    m_leftModel.reset(new TreeModel(loadTree(leftPath, errors)));
+    m_rightModel.reset(new TreeModel(loadTree(rightPath, errors)));
+    const auto parseMs = timer.restart();
+
+    m_diff = TreeDiff::diff(m_leftModel->rootItem(), m_rightModel->rootItem());
+    const auto diffMs = timer.elapsed();
+
+    m_leftModel->setHighlights(highlights(m_diff.left));
+    m_rightModel->setHighlights(highlights(m_diff.right));
+
+    setupView(m_leftView, m_leftModel.get());
+    setupView(m_rightView, m_rightModel.get());
+
+    expandChanges(m_leftView, m_leftModel.get(), m_diff.left);
+    expandChanges(m_rightView, m_rightModel.get(), m_diff.right);
+
+    connect(m_leftView->selectionModel(), &QItemSelectionModel::currentChanged, this, [this]() {
+        syncSelection(m_leftView, m_rightView, m_rightModel.get(), m_diff.leftToRight);
+    });
+    connect(m_rightView->selectionModel(), &QItemSelectionModel::currentChanged, this, [this]() {
+        syncSelection(m_rightView, m_leftView, m_leftModel.get(), m_diff.rightToLeft);
+    });
+
+    auto status = QString(" %1 modified, %2 removed, %3 added. Parsed in %4ms, compared in %5ms.")
+        .arg(m_diff.leftToRight.size())
+        .arg(m_diff.left.size() - m_diff.leftToRight.size())
+        .arg(m_diff.right.size() - m_diff.rightToLeft.size())
+        .arg(parseMs)
+        .arg(diffMs);
+    if (m_diff.left.isEmpty() && m_diff.right.isEmpty()) {
+        status = " Fonts are identical.";
+    }
+    if (!errors.isEmpty()) {
+        status += " " + errors.join(' ');
+    }
+    m_lblStatus->setText(status);
+
+    resize(1200, 700);
+}
+
+void CompareWindow::setupView(QTreeView *view, TreeModel *model)
+{
+    view->setModel(model);
+    view->setVerticalScrollMode(QTreeView::ScrollPerPixel);
+    view->header()->setSectionsMovable(false);
+    view->header()->setSectionsClickable(false);
+    view->header()->resizeSection(Column::Title, 300);
+    view->header()->resizeSection(
+        Column::Value, view->fontMetrics().horizontalAdvance("00000000000000000000"));
+}
+
+void CompareWindow::expandChanges(QTreeView *view, TreeModel *model,
+                                  const QHash<const TreeItem*, TreeDiff::Change> &changes)
+{
+    // Expand only the top levels, otherwise large changes would make the view unusable.
+    const int maxDepth = 2;
+
+    for (auto it = changes.constBegin(); it != changes.constEnd(); ++it) {
+        if (it.value() != TreeDiff::Change::Modified || !it.key()->hasChildren()) {
+            continue;
+        }
+
+        int depth = 0;
+        for (auto parent = it.key()->parent(); parent && parent != model->rootItem(); parent = parent->parent()) {
+            depth += 1;
+        }
+
+        if (depth < maxDepth) {
+            view->expand(model->indexByItem(it.key()));
+        }
+    }
+}
+
+void CompareWindow::syncSelection(QTreeView *from, QTreeView *to, TreeModel *toModel,
+                                  const QHash<const TreeItem*, const TreeItem*> &pairs)
+{
+    if (m_isSyncing) {
+        return;
+    }
+
+    const auto item = static_cast<const TreeModel*>(from->model())->itemByIndex(from->currentIndex());
+    const auto other = pairs.value(item);
+    if (!other) {
+        return;
+    }
+
+    m_isSyncing = true;
+    const auto index = toModel->indexByItem(other);
+    to->setCurrentIndex(index);
+    to->scrollTo(index);
+    m_isSyncing = false;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QLabel>
+#include <QMainWindow>
+#include <QTreeView>
+
+#include "treediff.h"
+#include "treemodel.h"
+
+// Shows two fonts side by side with changed items highlighted.
+class CompareWindow : public QMainWindow
+{
+    Q_OBJECT
+
+public:
+    explicit CompareWindow(const QString &leftPath, const QString &rightPath,
+                           QWidget *parent = nullptr);
+
+private:
+    void setupView(QTreeView *view, TreeModel *model);
+    void expandChanges(QTreeView *view, TreeModel *model,
+                       const QHash<const TreeItem*, TreeDiff::Change> &changes);
+    void syncSelection(QTreeView *from, QTreeView *to, TreeModel *toModel,
+                       const QHash<const TreeItem*, const TreeItem*> &pairs);
+
+private:
+    QTreeView * const m_leftView;
+    QTreeView * const m_rightView;
+    QLabel * const m_lblStatus;
+    QScopedPointer<TreeModel> m_leftModel;
+    QScopedPointer<TreeModel> m_rightModel;
+    TreeDiff::Result m_diff;
+    bool m_isSyncing = false;
+};
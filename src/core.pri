@@ -0,0 +1,81 @@
+# Sources of the ttfexplorer-core library.
+
+SOURCES += \
+    $$PWD/coverage.cpp \
+    $$PWD/face.cpp \
+    $$PWD/font.cpp \
+    $$PWD/parser.cpp \
+    $$PWD/tables/aat-common.cpp \
+    $$PWD/tables/ankr.cpp \
+    $$PWD/tables/avar.cpp \
+    $$PWD/tables/cbdt.cpp \
+    $$PWD/tables/cblc.cpp \
+    $$PWD/tables/cff.cpp \
+    $$PWD/tables/charstring.cpp \
+    $$PWD/tables/cff2.cpp \
+    $$PWD/tables/cmap.cpp \
+    $$PWD/tables/colr.cpp \
+    $$PWD/tables/cpal.cpp \
+    $$PWD/tables/feat.cpp \
+    $$PWD/tables/fvar.cpp \
+    $$PWD/tables/gdef.cpp \
+    $$PWD/tables/glyf.cpp \
+    $$PWD/tables/glyphnames.cpp \
+    $$PWD/tables/gpos.cpp \
+    $$PWD/tables/gsub.cpp \
+    $$PWD/tables/gvar.cpp \
+    $$PWD/tables/head.cpp \
+    $$PWD/tables/hhea.cpp \
+    $$PWD/tables/hmtx.cpp \
+    $$PWD/tables/hvar.cpp \
+    $$PWD/tables/kern.cpp \
+    $$PWD/tables/kerx.cpp \
+    $$PWD/tables/layout-common.cpp \
+    $$PWD/tables/loca.cpp \
+    $$PWD/tables/maxp.cpp \
+    $$PWD/tables/morx.cpp \
+    $$PWD/tables/mvar.cpp \
+    $$PWD/tables/name.cpp \
+    $$PWD/tables/os2.cpp \
+    $$PWD/tables/post.cpp \
+    $$PWD/tables/sbix.cpp \
+    $$PWD/tables/stat.cpp \
+    $$PWD/tables/svg.cpp \
+    $$PWD/tables/trak.cpp \
+    $$PWD/tables/varstore.cpp \
+    $$PWD/tables/vhea.cpp \
+    $$PWD/tables/vmtx.cpp \
+    $$PWD/tables/vorg.cpp \
+    $$PWD/tables/vvar.cpp \
+    $$PWD/treediff.cpp \
+    $$PWD/treeitem.cpp \
+    $$PWD/truetype.cpp \
+    $$PWD/utils.cpp
+
+HEADERS += \
+    $$PWD/algo.h \
+    $$PWD/coverage.h \
+    $$PWD/face.h \
+    $$PWD/font.h \
+    $$PWD/hash.h \
+    $$PWD/parser.h \
+    $$PWD/range.h \
+    $$PWD/tables/aat-common.h \
+    $$PWD/tables/cblc.h \
+    $$PWD/tables/cff.h \
+    $$PWD/tables/charstring.h \
+    $$PWD/tables/cmap.h \
+    $$PWD/tables/glyf.h \
+    $$PWD/tables/gpos.h \
+    $$PWD/tables/gvar.h \
+    $$PWD/tables/kern.h \
+    $$PWD/tables/glyphnames.h \
+    $$PWD/tables/layout-common.h \
+    $$PWD/tables/name.h \
+    $$PWD/tables/subtables.h \
+    $$PWD/tables/tables.h \
+    $$PWD/tables/varstore.h \
+    $$PWD/treediff.h \
+    $$PWD/treeitem.h \
+    $$PWD/truetype.h \
+    $$PWD/utils.h
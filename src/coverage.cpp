@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <array>
+
+#include "coverage.h"
+
+namespace {
+
+enum Kind
+{
+    Covered,
+    Padding,
+    Unsupported,
+    Pending,
+    KindsCount,
+};
+
+using Counters = std::array<quint64, KindsCount>;
+
+// Parsed ranges with prefix sums, so bytes of each kind
+// in an arbitrary range can be found using a binary search.
+class RangesIndex
+{
+public:
+    RangesIndex(const Ranges &ranges, const quint32 fileSize)
+        : m_fileSize(fileSize)
+    {
+        const auto &offsets = ranges.offsets;
+        m_starts.reserve(offsets.size() + 1);
+        m_kinds.reserve(offsets.size() + 1);
+
+        // Bytes before the first range are unexplained.
+        if (offsets.empty() || offsets.front() != 0) {
+            m_starts.push_back(0);
+            m_kinds.push_back(Unsupported);
+        }
+
+        size_t u = 0;
+        size_t p = 0;
+        size_t l = 0;
+        for (const auto start : offsets) {
+            if (start >= fileSize) {
+                break;
+            }
+
+            while (u < ranges.unsupported.size() && ranges.unsupported[u] < start) {
+                u += 1;
+            }
+
+            while (p < ranges.padding.size() && ranges.padding[p] < start) {
+                p += 1;
+            }
+
+            while (l < ranges.pending.size() && ranges.pending[l] < start) {
+                l += 1;
+            }
+
+            Kind kind = Covered;
+            if (l < ranges.pending.size() && ranges.pending[l] == start) {
+                kind = Pending;
+            } else if (u < ranges.unsupported.size() && ranges.unsupported[u] == start) {
+                kind = Unsupported;
+            } else if (p < ranges.padding.size() && ranges.padding[p] == start) {
+                kind = Padding;
+            }
+
+            m_starts.push_back(start);
+            m_kinds.push_back(kind);
+        }
+
+        m_prefix.resize(m_starts.size() + 1, Counters {});
+        for (size_t i = 0; i < m_starts.size(); ++i) {
+            const quint32 end = i + 1 < m_starts.size() ? m_starts[i + 1] : fileSize;
+            m_prefix[i + 1] = m_prefix[i];
+            m_prefix[i + 1][m_kinds[i]] += end - m_starts[i];
+        }
+    }
+
+    // Bytes of each kind in the `0..offset` range.
+    Counters countBefore(const quint32 offset) const
+    {
+        const auto it = std::upper_bound(m_starts.begin(), m_starts.end(), offset);
+        if (it == m_starts.begin()) {
+            return Counters {};
+        }
+
+        const auto i = size_t(std::distance(m_starts.begin(), it)) - 1;
+        auto counters = m_prefix[i];
+        counters[m_kinds[i]] += offset - m_starts[i];
+        return counters;
+    }
+
+    Coverage count(const quint32 start, const quint32 end) const
+    {
+        const auto a = countBefore(std::min(start, m_fileSize));
+        const auto b = countBefore(std::min(end, m_fileSize));
+
+        Coverage coverage;
+        coverage.covered = b[Covered] - a[Covered];
+        coverage.padding = b[Padding] - a[Padding];
+        coverage.unsupported = b[Unsupported] - a[Unsupported];
+        coverage.pending = b[Pending] - a[Pending];
+        return coverage;
+    }
+
+private:
+    const quint32 m_fileSize;
+    std::vector<quint32> m_starts;
+    std::vector<Kind> m_kinds;
+    std::vector<Counters> m_prefix;
+};
+
+}
+
+CoverageReport computeCoverage(const Ranges &ranges, const quint32 fileSize)
+{
+    const RangesIndex index(ranges, fileSize);
+
+    CoverageReport report;
+    report.file = index.count(0, fileSize);
+
+    for (const auto &table : ranges.tables) {
+        // Table records can point outside the file or overflow.
+        auto end = table.range.end;
+        if (end < table.range.start || end > fileSize) {
+            end = fileSize;
+        }
+
+        const auto coverage = index.count(table.range.start, end);
+        report.tables.append({ table.faceIndex, table.tag, table.range, coverage });
+
+        if (report.faces.size() <= int(table.faceIndex)) {
+            report.faces.resize(int(table.faceIndex) + 1);
+        }
+        report.faces[int(table.faceIndex)] += coverage;
+    }
+
+    return report;
+}
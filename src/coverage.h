@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QVector>
+
+#include "range.h"
+
+struct Coverage
+{
+    // Bytes explained by the parser.
+    quint64 covered = 0;
+    quint64 padding = 0;
+    quint64 unsupported = 0;
+    // Bytes of lazy groups, which are not parsed yet.
+    quint64 pending = 0;
+
+    quint64 total() const
+    { return covered + padding + unsupported + pending; }
+
+    // The fraction of parsed bytes that are not unsupported.
+    double ratio() const
+    {
+        const auto parsed = covered + padding + unsupported;
+        return parsed != 0 ? double(covered + padding) / double(parsed) : 1.0;
+    }
+
+    Coverage& operator+=(const Coverage &other)
+    {
+        covered += other.covered;
+        padding += other.padding;
+        unsupported += other.unsupported;
+        pending += other.pending;
+        return *this;
+    }
+};
+
+struct TableCoverage
+{
+    quint32 faceIndex;
+    QString tag;
+    Range range;
+    Coverage coverage;
+};
+
+struct CoverageReport
+{
+    Coverage file;
+    // Sorted by offset. Shared tables are listed for each face.
+    QVector<TableCoverage> tables;
+    // Sum of face tables. Shared tables are counted in each face.
+    QVector<Coverage> faces;
+};
+
+// Computes coverage using only the ranges collected by the parser.
+// Works in a headless mode as well.
+CoverageReport computeCoverage(const Ranges &ranges, const quint32 fileSize);
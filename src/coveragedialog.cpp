@@ -0,0 +1,87 @@
+#include <QHeaderView>
+#include <QLabel>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include "utils.h"
+
+#include "coveragedialog.h"
+
+namespace CoverageColumn
+{
+    enum CoverageColumn
+    {
+        Title,
+        Size,
+        Covered,
+        Padding,
+        Unsupported,
+        Ratio,
+        LastColumn,
+    };
+}
+
+static void setCoverage(QTreeWidgetItem *item, const Coverage &coverage)
+{
+    item->setText(CoverageColumn::Size, Utils::prettySize(quint32(coverage.total())));
+    item->setText(CoverageColumn::Covered, QString::number(coverage.covered));
+    item->setText(CoverageColumn::Padding, QString::number(coverage.padding));
+    item->setText(CoverageColumn::Unsupported, QString::number(coverage.unsupported));
+    item->setText(CoverageColumn::Ratio, QString::number(coverage.ratio() * 100.0, 'f', 1) + "%");
+
+    for (int i = CoverageColumn::Size; i < CoverageColumn::LastColumn; ++i) {
+        item->setTextAlignment(i, Qt::AlignRight);
+    }
+
+    if (coverage.unsupported != 0) {
+        item->setForeground(CoverageColumn::Unsupported, Qt::red);
+    }
+}
+
+CoverageDialog::CoverageDialog(const CoverageReport &report, QWidget *parent)
+    : QDialog(parent)
+{
+    setWindowTitle("Coverage");
+
+    const auto &file = report.file;
+    auto summary = QString("%1% of bytes are explained: %2 parsed, %3 padding, %4 unsupported.")
+        .arg(file.ratio() * 100.0, 0, 'f', 2)
+        .arg(file.covered).arg(file.padding).arg(file.unsupported);
+    if (file.pending != 0) {
+        summary += QString("\n%1 bytes of collapsed groups are still being parsed.").arg(file.pending);
+    }
+    auto lblSummary = new QLabel(summary);
+
+    auto tree = new QTreeWidget();
+    tree->setColumnCount(CoverageColumn::LastColumn);
+    tree->setHeaderLabels({ "Table", "Size", "Parsed", "Padding", "Unsupported", "Coverage" });
+    tree->setRootIsDecorated(report.faces.size() > 1);
+
+    QVector<QTreeWidgetItem*> faceItems;
+    if (report.faces.size() > 1) {
+        for (int i = 0; i < report.faces.size(); ++i) {
+            auto item = new QTreeWidgetItem(tree);
+            item->setText(CoverageColumn::Title, QString("Face %1").arg(i));
+            setCoverage(item, report.faces[i]);
+            faceItems << item;
+        }
+    }
+
+    for (const auto &table : report.tables) {
+        auto item = faceItems.isEmpty()
+            ? new QTreeWidgetItem(tree)
+            : new QTreeWidgetItem(faceItems[int(table.faceIndex)]);
+        item->setText(CoverageColumn::Title, table.tag);
+        setCoverage(item, table.coverage);
+    }
+
+    tree->expandAll();
+    tree->header()->setStretchLastSection(false);
+    tree->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+
+    auto lay = new QVBoxLayout(this);
+    lay->addWidget(lblSummary);
+    lay->addWidget(tree);
+
+    resize(600, 500);
+}
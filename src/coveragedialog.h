@@ -0,0 +1,13 @@
+#pragma once
+
+#include <QDialog>
+
+#include "coverage.h"
+
+class CoverageDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit CoverageDialog(const CoverageReport &report, QWidget *parent = nullptr);
+};
@@ -0,0 +1,508 @@
+#include "tables/tables.h"
+
+#include "face.h"
+
+Face::Face(const quint8 *data, const quint32 size, const quint32 index,
+           const std::vector<TableRange> &tables)
+    : m_data(data)
+    , m_size(size)
+    , m_index(index)
+{
+    for (const auto &table : tables) {
+        if (table.faceIndex == index) {
+            m_tables.push_back(table);
+        }
+    }
+}
+
+std::vector<Face> Face::fromTables(const quint8 *data, const quint32 size,
+                                   const std::vector<TableRange> &tables)
+{
+    quint32 numberOfFaces = 0;
+    for (const auto &table : tables) {
+        numberOfFaces = std::max(numberOfFaces, table.faceIndex + 1);
+    }
+
+    std::vector<Face> faces;
+    faces.reserve(numberOfFaces);
+    for (quint32 i = 0; i < numberOfFaces; ++i) {
+        faces.emplace_back(data, size, i, tables);
+    }
+
+    return faces;
+}
+
+std::optional<Range> Face::findTable(const QString &tag) const
+{
+    for (const auto &table : m_tables) {
+        if (table.tag == tag) {
+            return table.range;
+        }
+    }
+
+    return std::nullopt;
+}
+
+const CharacterMap& Face::characterMap() const
+{
+    if (m_characterMap) {
+        return *m_characterMap;
+    }
+
+    m_characterMap = CharacterMap();
+    if (const auto range = findTable("cmap")) {
+        if (range->end > m_size || range->start >= range->end) {
+            return *m_characterMap;
+        }
+
+        try {
+            ShadowParser parser(m_data + range->start, m_data + range->end);
+            m_characterMap = collectCharacterMap(parser);
+        } catch (...) {
+        }
+    }
+
+    return *m_characterMap;
+}
+
+quint16 Face::numberOfGlyphs() const
+{
+    const auto range = findTable("maxp");
+    if (!range || range->size() < 6 || range->end > m_size) {
+        return 0;
+    }
+
+    return qFromBigEndian<quint16>(m_data + range->start + 4);
+}
+
+QRectF Face::boundingBox() const
+{
+    const auto range = findTable("head");
+    if (!range || range->size() < 44 || range->end > m_size) {
+        return QRectF();
+    }
+
+    const auto *data = m_data + range->start + 36;
+    const auto xMin = qFromBigEndian<qint16>(data);
+    const auto yMin = qFromBigEndian<qint16>(data + 2);
+    const auto xMax = qFromBigEndian<qint16>(data + 4);
+    const auto yMax = qFromBigEndian<qint16>(data + 6);
+    return QRectF(xMin, yMin, xMax - xMin, yMax - yMin);
+}
+
+const QVector<quint32>& Face::locaOffsets() const
+{
+    if (m_locaOffsets) {
+        return *m_locaOffsets;
+    }
+
+    m_locaOffsets = QVector<quint32>();
+
+    const auto head = findTable("head");
+    const auto loca = findTable("loca");
+    if (head && loca && head->size() >= 54 && head->end <= m_size && loca->end <= m_size) {
+        const auto indexToLocationFormat = qFromBigEndian<quint16>(m_data + head->start + 50);
+        try {
+            ShadowParser parser(m_data + loca->start, m_data + loca->end);
+            m_locaOffsets = collectLocaOffsets(numberOfGlyphs(), indexToLocationFormat, parser);
+        } catch (const QString&) {
+        }
+    }
+
+    return *m_locaOffsets;
+}
+
+const CharStrings& Face::charStrings(const Range &range, const bool isCff2) const
+{
+    // Subroutine offsets are shared by all glyphs.
+    if (!m_charStrings) {
+        m_charStrings = CharStrings();
+        if (range.end > m_size) {
+            return *m_charStrings;
+        }
+
+        try {
+            ShadowParser parser(m_data + range.start, m_data + range.end);
+            m_charStrings = isCff2 ? collectCff2CharStrings(parser) : collectCffCharStrings(parser);
+        } catch (const QString&) {
+        }
+    }
+
+    return *m_charStrings;
+}
+
+GlyphOutline FaceInstance::decodeOutline(const quint16 glyphId) const
+{
+    if (m_glyf) {
+        if (m_glyf->end > m_size) {
+            throw QString("glyf is out of bounds");
+        }
+
+        if (!m_gvar || m_coords.isEmpty()) {
+            return decodeGlyphOutline(m_data + m_glyf->start, m_glyf->size(), m_locaOffsets, glyphId);
+        }
+
+        const auto *gvar = m_data + m_gvar->start;
+        const auto gvarSize = m_gvar->size();
+        return decodeGlyphOutline(m_data + m_glyf->start, m_glyf->size(), m_locaOffsets, glyphId,
+                                  [&](const quint16 id, GlyphOutline &points) {
+            applyGlyphVariations(gvar, gvarSize, m_glyphVariations, id, m_coords,
+                                 m_sharedTupleScalars, points);
+        });
+    }
+
+    if (m_cff) {
+        if (m_cff->end > m_size) {
+            throw QString("CFF is out of bounds");
+        }
+
+        if (m_charStrings.isCff2 && !m_coords.isEmpty()) {
+            return interpretCharString(m_data + m_cff->start, m_cff->size(), m_charStrings, glyphId,
+                                       m_blendScalars);
+        }
+
+        return interpretCharString(m_data + m_cff->start, m_cff->size(), m_charStrings, glyphId);
+    }
+
+    throw QString("no outlines");
+}
+
+std::optional<GlyphOutline> FaceInstance::outline(const quint16 glyphId) const
+{
+    try {
+        return decodeOutline(glyphId);
+    } catch (const QString&) {
+        return std::nullopt;
+    }
+}
+
+FaceInstance Face::makeInstance(const QVector<float> &coords, const bool withMetrics) const
+{
+    FaceInstance instance;
+    instance.m_data = m_data;
+    instance.m_size = m_size;
+    instance.m_coords = coords;
+
+    if (const auto glyf = findTable("glyf")) {
+        instance.m_glyf = glyf;
+        instance.m_locaOffsets = locaOffsets();
+
+        const auto gvar = findTable("gvar");
+        if (gvar && gvar->end <= m_size && !coords.isEmpty()) {
+            if (!m_glyphVariations) {
+                m_glyphVariations = GlyphVariations();
+                try {
+                    ShadowParser parser(m_data + gvar->start, m_data + gvar->end);
+                    m_glyphVariations = collectGvar(parser);
+                } catch (const QString&) {
+                }
+            }
+
+            instance.m_gvar = gvar;
+            instance.m_glyphVariations = *m_glyphVariations;
+            instance.m_sharedTupleScalars = m_glyphVariations->sharedTupleScalars(coords);
+        }
+    } else if (const auto cff = findTable("CFF ")) {
+        instance.m_cff = cff;
+        instance.m_charStrings = charStrings(*cff, false);
+    } else if (const auto cff2 = findTable("CFF2")) {
+        instance.m_cff = cff2;
+        instance.m_charStrings = charStrings(*cff2, true);
+        if (!coords.isEmpty()) {
+            instance.m_blendScalars = instance.m_charStrings.blendScalars(coords);
+        }
+    }
+
+    if (withMetrics) {
+        const auto advances = this->advances();
+        const auto deltas = advanceDeltas(coords);
+        instance.m_advances.resize(advances.size());
+        for (int i = 0; i < advances.size(); ++i) {
+            instance.m_advances[i] = advances[i] + deltas.value(i);
+        }
+
+        instance.m_metricsDeltas = metricsDeltas(coords);
+    }
+
+    return instance;
+}
+
+FaceInstance Face::instance(const QVector<float> &coords) const
+{
+    return makeInstance(coords, true);
+}
+
+const GlyphOutline* Face::outline(const quint16 glyphId) const
+{
+    if (!m_outlines) {
+        m_outlines.reset(new QCache<quint16, GlyphOutline>(1 << 20));
+    }
+
+    if (const auto outline = m_outlines->object(glyphId)) {
+        return outline;
+    }
+
+    if (!m_defaultInstance) {
+        m_defaultInstance = makeInstance({}, false);
+    }
+
+    try {
+        auto outline = new GlyphOutline(m_defaultInstance->decodeOutline(glyphId));
+        const auto cost = std::max(outline->size(), 1);
+        if (!m_outlines->insert(glyphId, outline, cost)) {
+            return nullptr;
+        }
+
+        return outline;
+    } catch (const QString&) {
+        return nullptr;
+    }
+}
+
+std::optional<GlyphOutline> Face::outline(const quint16 glyphId, const QVector<float> &coords) const
+{
+    // Scalars are computed once per instance.
+    if (!m_lastInstance || m_lastInstance->coordinates() != coords) {
+        m_lastInstance = makeInstance(coords, false);
+    }
+
+    return m_lastInstance->outline(glyphId);
+}
+
+const QVector<VariationAxis>& Face::variationAxes() const
+{
+    if (m_variationAxes) {
+        return *m_variationAxes;
+    }
+
+    m_variationAxes = QVector<VariationAxis>();
+    if (const auto range = findTable("fvar")) {
+        if (range->end <= m_size && range->start < range->end) {
+            try {
+                ShadowParser parser(m_data + range->start, m_data + range->end);
+                m_variationAxes = collectFvarAxes(parser);
+            } catch (const QString&) {
+            }
+        }
+    }
+
+    return *m_variationAxes;
+}
+
+NamesHash Face::names() const
+{
+    const auto range = findTable("name");
+    if (!range || range->end > m_size || range->start >= range->end) {
+        return {};
+    }
+
+    try {
+        ShadowParser parser(m_data + range->start, m_data + range->end);
+        return collectNameNames(parser);
+    } catch (const QString&) {
+        return {};
+    }
+}
+
+QVector<NamedInstance> Face::namedInstances() const
+{
+    const auto range = findTable("fvar");
+    if (!range || range->end > m_size || range->start >= range->end) {
+        return {};
+    }
+
+    try {
+        ShadowParser parser(m_data + range->start, m_data + range->end);
+        return collectFvarInstances(parser);
+    } catch (const QString&) {
+        return {};
+    }
+}
+
+QVector<float> Face::normalizeCoordinates(const QVector<float> &userCoords) const
+{
+    if (!m_axisSegmentMaps) {
+        m_axisSegmentMaps = QVector<AxisSegmentMap>();
+        if (const auto range = findTable("avar")) {
+            if (range->end <= m_size && range->start < range->end) {
+                try {
+                    ShadowParser parser(m_data + range->start, m_data + range->end);
+                    m_axisSegmentMaps = collectAvar(parser);
+                } catch (const QString&) {
+                }
+            }
+        }
+    }
+
+    const auto &axes = variationAxes();
+    QVector<float> coords;
+    coords.reserve(axes.size());
+    for (int i = 0; i < axes.size(); ++i) {
+        const auto value = axes[i].normalize(userCoords.value(i, axes[i].defaultValue));
+        if (i < m_axisSegmentMaps->size()) {
+            coords << qBound(-1.0f, m_axisSegmentMaps->at(i).map(value), 1.0f);
+        } else {
+            coords << value;
+        }
+    }
+
+    return coords;
+}
+
+QVector<quint16> Face::advances(const bool vertical) const
+{
+    const auto header = findTable(vertical ? "vhea" : "hhea");
+    const auto metrics = findTable(vertical ? "vmtx" : "hmtx");
+    if (!header || !metrics || header->size() < 36 || header->end > m_size || metrics->end > m_size) {
+        return {};
+    }
+
+    // numberOfHMetrics/numberOfVMetrics
+    auto numberOfMetrics = qFromBigEndian<quint16>(m_data + header->start + 34);
+    numberOfMetrics = std::min<quint32>(numberOfMetrics, metrics->size() / 4);
+    if (numberOfMetrics == 0) {
+        return {};
+    }
+
+    const auto count = numberOfGlyphs();
+    QVector<quint16> advances(count);
+    for (quint16 i = 0; i < count; ++i) {
+        // The last advance applies to all remaining glyphs.
+        const auto idx = std::min<quint16>(i, numberOfMetrics - 1);
+        advances[i] = qFromBigEndian<quint16>(m_data + metrics->start + quint32(idx) * 4);
+    }
+
+    return advances;
+}
+
+QVector<float> Face::advanceDeltas(const QVector<float> &coords, const bool vertical) const
+{
+    auto &variations = vertical ? m_vvar : m_hvar;
+    if (!variations) {
+        variations = MetricsVariations();
+        if (const auto range = findTable(vertical ? "VVAR" : "HVAR")) {
+            if (range->end <= m_size && range->start < range->end) {
+                try {
+                    ShadowParser parser(m_data + range->start, m_data + range->end);
+                    variations = vertical ? collectVvar(parser) : collectHvar(parser);
+                } catch (const QString&) {
+                }
+            }
+        }
+    }
+
+    if (variations->store.isEmpty()) {
+        return {};
+    }
+
+    // Region scalars are computed once and shared by all glyphs.
+    const auto scalars = variations->store.regionScalars(coords);
+    const auto itemDeltas = variations->store.evaluate(scalars);
+    return glyphDeltas(itemDeltas, variations->advanceMap, numberOfGlyphs());
+}
+
+QVector<QPair<Tag, float>> Face::metricsDeltas(const QVector<float> &coords) const
+{
+    if (!m_mvar) {
+        m_mvar = GlobalMetricsVariations();
+        if (const auto range = findTable("MVAR")) {
+            if (range->end <= m_size && range->start < range->end) {
+                try {
+                    ShadowParser parser(m_data + range->start, m_data + range->end);
+                    m_mvar = collectMvar(parser);
+                } catch (const QString&) {
+                }
+            }
+        }
+    }
+
+    QVector<QPair<Tag, float>> deltas;
+    if (m_mvar->store.isEmpty()) {
+        return deltas;
+    }
+
+    const auto scalars = m_mvar->store.regionScalars(coords);
+    for (const auto &record : m_mvar->records) {
+        deltas.append({ record.tag, m_mvar->store.delta(record.outerIndex, record.innerIndex, scalars) });
+    }
+
+    return deltas;
+}
+
+const LayoutLookups& Face::layoutLookups(const LayoutTableType tableType) const
+{
+    auto &lookups = tableType == LayoutTableType::Gsub ? m_gsubLookups : m_gposLookups;
+    if (lookups) {
+        return *lookups;
+    }
+
+    lookups = LayoutLookups();
+    lookups->tableType = tableType;
+    if (const auto range = findTable(tableType == LayoutTableType::Gsub ? "GSUB" : "GPOS")) {
+        if (range->end <= m_size && range->start < range->end) {
+            try {
+                ShadowParser parser(m_data + range->start, m_data + range->end);
+                lookups = collectLayoutLookups(tableType, parser);
+            } catch (const QString&) {
+            }
+        }
+    }
+
+    return *lookups;
+}
+
+const PairAdjustmentIndex& Face::pairAdjustments(const int lookupIndex) const
+{
+    static const PairAdjustmentIndex empty;
+
+    const auto &lookups = layoutLookups(LayoutTableType::Gpos);
+    if (lookupIndex < 0 || lookupIndex >= lookups.lookups.size()) {
+        return empty;
+    }
+
+    if (m_pairAdjustments.size() != lookups.lookups.size()) {
+        m_pairAdjustments.resize(lookups.lookups.size());
+    }
+
+    auto &index = m_pairAdjustments[lookupIndex];
+    if (index) {
+        return *index;
+    }
+
+    index = PairAdjustmentIndex();
+    if (const auto range = findTable("GPOS")) {
+        if (range->end <= m_size && range->start < range->end) {
+            try {
+                index = collectPairAdjustments(lookups, lookupIndex, m_data + range->start, range->size());
+            } catch (const QString&) {
+            }
+        }
+    }
+
+    return *index;
+}
+
+const KerningTable& Face::kerning() const
+{
+    if (m_kerning) {
+        return *m_kerning;
+    }
+
+    m_kerning = decodeKerning();
+    return *m_kerning;
+}
+
+KerningTable Face::decodeKerning() const
+{
+    if (const auto range = findTable("kern")) {
+        if (range->end <= m_size && range->start < range->end) {
+            try {
+                ShadowParser parser(m_data + range->start, m_data + range->end);
+                return collectKern(parser);
+            } catch (const QString&) {
+            }
+        }
+    }
+
+    return KerningTable();
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <QCache>
+#include <QRectF>
+
+#include <memory>
+#include <optional>
+
+#include "range.h"
+#include "tables/charstring.h"
+#include "tables/cmap.h"
+#include "tables/glyf.h"
+#include "tables/gpos.h"
+#include "tables/gvar.h"
+#include "tables/kern.h"
+#include "tables/varstore.h"
+
+// An immutable face snapshot at a variation instance.
+//
+// All tables are decoded in advance, so unlike Face it can be used
+// from multiple threads. Like Face, references the font data.
+class FaceInstance
+{
+public:
+    // Normalized coordinates. Empty for the default instance.
+    const QVector<float>& coordinates() const { return m_coords; }
+
+    // Returns an outline with `gvar` or `CFF2` variations applied or std::nullopt on error.
+    std::optional<GlyphOutline> outline(const quint16 glyphId) const;
+
+    // Horizontal advances with `HVAR` deltas applied.
+    const QVector<float>& advances() const { return m_advances; }
+
+    // `MVAR` deltas by value tag.
+    const QVector<QPair<Tag, float>>& metricsDeltas() const { return m_metricsDeltas; }
+
+private:
+    friend class Face;
+
+    GlyphOutline decodeOutline(const quint16 glyphId) const;
+
+private:
+    const quint8 *m_data = nullptr;
+    quint32 m_size = 0;
+    QVector<float> m_coords;
+    std::optional<Range> m_glyf;
+    std::optional<Range> m_gvar;
+    // `CFF ` or `CFF2`.
+    std::optional<Range> m_cff;
+    QVector<quint32> m_locaOffsets;
+    GlyphVariations m_glyphVariations;
+    QVector<float> m_sharedTupleScalars;
+    CharStrings m_charStrings;
+    QVector<QVector<float>> m_blendScalars;
+    QVector<float> m_advances;
+    QVector<QPair<Tag, float>> m_metricsDeltas;
+};
+
+// A single face of a font file with lazily decoded tables.
+//
+// Unlike Font, references the font data, which must outlive the face.
+// Not thread-safe.
+class Face
+{
+public:
+    Face(const quint8 *data, const quint32 size, const quint32 index,
+         const std::vector<TableRange> &tables);
+
+    // Creates faces for all table records in `tables`.
+    static std::vector<Face> fromTables(const quint8 *data, const quint32 size,
+                                        const std::vector<TableRange> &tables);
+
+    quint32 index() const { return m_index; }
+
+    // Returns a face with the same data and tables, but without decoded tables,
+    // so it can be used by another thread.
+    Face detached() const { return Face(m_data, m_size, m_index, m_tables); }
+
+    std::optional<Range> findTable(const QString &tag) const;
+
+    // Empty when the font has no supported Unicode cmap subtable or it's malformed.
+    const CharacterMap& characterMap() const;
+
+    quint16 numberOfGlyphs() const;
+
+    // The font bounding box from `head` in font units. The Y axis points up.
+    QRectF boundingBox() const;
+
+    // Returns a decoded `glyf`, `CFF ` or `CFF2` outline or null on error.
+    // Variable fonts are decoded at the default instance.
+    //
+    // Outlines are kept in an LRU cache, so the pointer is valid only until the next call.
+    const GlyphOutline* outline(const quint16 glyphId) const;
+
+    // Returns an outline at normalized coordinates with `gvar` or `CFF2` variations applied.
+    // Falls back to the default outline for non-variable fonts. Not cached.
+    std::optional<GlyphOutline> outline(const quint16 glyphId, const QVector<float> &coords) const;
+
+    // Variation axes from `fvar`. Empty for non-variable fonts.
+    const QVector<VariationAxis>& variationAxes() const;
+
+    // Names from the `name` table by name ID.
+    NamesHash names() const;
+
+    // Named instances from `fvar`.
+    QVector<NamedInstance> namedInstances() const;
+
+    // Maps user coordinates to normalized ones using `fvar` and `avar`.
+    QVector<float> normalizeCoordinates(const QVector<float> &userCoords) const;
+
+    // Decodes everything needed to render the face at normalized coordinates.
+    FaceInstance instance(const QVector<float> &coords) const;
+
+    // Default advances from `hmtx` or `vmtx` for each glyph.
+    QVector<quint16> advances(const bool vertical = false) const;
+
+    // Returns advance deltas from `HVAR` or `VVAR` for each glyph
+    // at normalized coordinates. Empty when there is no such table.
+    QVector<float> advanceDeltas(const QVector<float> &coords, const bool vertical = false) const;
+
+    // Returns `MVAR` deltas by value tag at normalized coordinates.
+    QVector<QPair<Tag, float>> metricsDeltas(const QVector<float> &coords) const;
+
+    // Lookups of `GSUB` or `GPOS` with decoded coverages and class definitions.
+    // Empty when there is no such table or it's malformed.
+    const LayoutLookups& layoutLookups(const LayoutTableType tableType) const;
+
+    // Returns an index of a `GPOS` pair adjustment lookup, built on first use.
+    // Empty for other lookups or when the lookup is malformed.
+    const PairAdjustmentIndex& pairAdjustments(const int lookupIndex) const;
+
+    // The decoded `kern` table. Decoded on first use, unless it was set in advance.
+    const KerningTable& kerning() const;
+
+    // Decodes the `kern` table without caching it. Unlike kerning(), can be called from any thread.
+    KerningTable decodeKerning() const;
+
+    // Sets the `kern` table decoded in advance, usually in a background thread.
+    void setKerning(KerningTable kerning) { m_kerning = std::move(kerning); }
+
+private:
+    FaceInstance makeInstance(const QVector<float> &coords, const bool withMetrics) const;
+    const QVector<quint32>& locaOffsets() const;
+    const CharStrings& charStrings(const Range &range, const bool isCff2) const;
+
+private:
+    const quint8 *m_data;
+    quint32 m_size;
+    quint32 m_index;
+    std::vector<TableRange> m_tables;
+
+    mutable std::optional<CharacterMap> m_characterMap;
+    mutable std::optional<QVector<quint32>> m_locaOffsets;
+    mutable std::optional<CharStrings> m_charStrings;
+    mutable std::optional<GlyphVariations> m_glyphVariations;
+    mutable std::optional<QVector<AxisSegmentMap>> m_axisSegmentMaps;
+    // Used for outlines only, so without metrics.
+    mutable std::optional<FaceInstance> m_defaultInstance;
+    mutable std::optional<FaceInstance> m_lastInstance;
+    mutable std::optional<QVector<VariationAxis>> m_variationAxes;
+    mutable std::optional<MetricsVariations> m_hvar;
+    mutable std::optional<MetricsVariations> m_vvar;
+    mutable std::optional<GlobalMetricsVariations> m_mvar;
+    mutable std::optional<LayoutLookups> m_gsubLookups;
+    mutable std::optional<LayoutLookups> m_gposLookups;
+    // By lookup index.
+    mutable QVector<std::optional<PairAdjustmentIndex>> m_pairAdjustments;
+    mutable std::optional<KerningTable> m_kerning;
+    // The cost is a number of points.
+    mutable std::unique_ptr<QCache<quint16, GlyphOutline>> m_outlines;
+};
@@ -0,0 +1,44 @@
+#include "parser.h"
+#include "truetype.h"
+
+#include "font.h"
+
+Font Font::parse(const quint8 *data, const quint32 size, const Mode mode)
+{
+    Font font;
+    if (mode != Mode::Headless) {
+        font.m_rootItem.reset(new TreeItem(nullptr));
+    }
+
+    Parser parser(data, size, font.m_rootItem.get());
+    if (mode == Mode::LazyTree) {
+        parser.enableLazyGroups();
+    } else if (mode == Mode::HashedTree) {
+        parser.enableHashes();
+    }
+
+    try {
+        font.m_warnings = TrueType::parse(parser);
+        font.m_ranges = parser.ranges();
+    } catch (const QString &msg) {
+        font.m_error = msg;
+    } catch (...) {
+        font.m_error = "Unknown error.";
+    }
+
+    // Ranges are incomplete after an error, so mark everything as unsupported.
+    if (!font.m_error.isEmpty()) {
+        font.m_ranges = Ranges {
+            { 0, size, },
+            { 0, size, },
+        };
+    }
+
+    font.m_nodesCount = parser.nodesCount();
+    return font;
+}
+
+Font Font::parse(const QByteArray &data, const Mode mode)
+{
+    return parse(reinterpret_cast<const quint8*>(data.constData()), quint32(data.size()), mode);
+}
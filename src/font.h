@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QByteArray>
+#include <QStringList>
+
+#include <memory>
+
+#include "range.h"
+#include "treeitem.h"
+
+// A parsed font file.
+//
+// This is the public API of the core library and it doesn't depend on QtGui.
+// The font data is not referenced after parsing, unless Mode::LazyTree is used.
+class Font
+{
+public:
+    enum class Mode
+    {
+        // Builds a complete tree.
+        Tree,
+        // Builds a tree with lazy groups, like `sbix` strikes, which are parsed on expansion.
+        // The data must outlive the tree.
+        LazyTree,
+        // Builds a complete tree and computes TreeItem::hash. Required by TreeDiff.
+        HashedTree,
+        // Collects only ranges and counters. Much faster and uses less memory.
+        Headless,
+    };
+
+    // Parses a TrueType/OpenType font or a font collection.
+    //
+    // Never throws. On a fatal error, the tree contains everything
+    // that was parsed before it and error() is set.
+    static Font parse(const quint8 *data, const quint32 size, const Mode mode = Mode::Tree);
+    static Font parse(const QByteArray &data, const Mode mode = Mode::Tree);
+
+    // The root item of the tree. Null in a headless mode.
+    const TreeItem* rootItem() const { return m_rootItem.get(); }
+
+    // Releases the ownership of the tree.
+    TreeItem* takeRootItem() { return m_rootItem.release(); }
+
+    // Byte ranges of all offsets and unsupported data.
+    const Ranges& ranges() const { return m_ranges; }
+    Ranges takeRanges() { return std::move(m_ranges); }
+
+    // A fatal parsing error. Empty on success.
+    const QString& error() const { return m_error; }
+
+    // Non-fatal parsing errors.
+    const QStringList& warnings() const { return m_warnings; }
+
+    quint32 nodesCount() const { return m_nodesCount; }
+
+private:
+    Font() = default;
+
+    std::unique_ptr<TreeItem> m_rootItem;
+    Ranges m_ranges;
+    QString m_error;
+    QStringList m_warnings;
+    quint32 m_nodesCount = 0;
+};
@@ -0,0 +1,413 @@
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPainterPath>
+#include <QRunnable>
+#include <QScrollBar>
+#include <QThread>
+#include <QVarLengthArray>
+#include <QVBoxLayout>
+
+#include "glyphgrid.h"
+
+static const int LabelHeight = 16;
+static const int MinCellSize = 32;
+static const int MaxCellSize = 256;
+
+static quint32 pixmapKey(const int cellSize, const quint16 glyphId)
+{
+    return (quint32(cellSize) << 16) | glyphId;
+}
+
+// TrueType contours are quadratic and can start with an off-curve point.
+// CFF contours are cubic and always start with an on-curve point.
+static QPainterPath outlineToPath(const GlyphOutline &outline)
+{
+    QPainterPath path;
+    path.setFillRule(Qt::WindingFill);
+
+    int start = 0;
+    for (const auto contourEnd : outline.contourEnds) {
+        const int end = std::min(int(contourEnd), outline.size() - 1);
+        const int count = end - start + 1;
+        if (count < 2) {
+            start = end + 1;
+            continue;
+        }
+
+        auto point = [&](const int i){ return QPointF(outline.x[start + i], outline.y[start + i]); };
+        auto flag = [&](const int i){ return outline.onCurve[start + i]; };
+
+        int first = 0;
+        while (first < count && flag(first) != 1) {
+            first += 1;
+        }
+
+        // When all points are off-curve, start between the first two.
+        QPointF startPoint;
+        if (first == count) {
+            first = 0;
+            startPoint = (point(0) + point(1)) / 2;
+        } else {
+            startPoint = point(first);
+        }
+
+        path.moveTo(startPoint);
+        std::optional<QPointF> control;
+        QVarLengthArray<QPointF, 2> cubicControls;
+        for (int k = 1; k <= count; ++k) {
+            const int i = (first + k) % count;
+            const auto p = point(i);
+            switch (flag(i)) {
+            case 1:
+                if (cubicControls.size() == 2) {
+                    path.cubicTo(cubicControls[0], cubicControls[1], p);
+                } else if (control) {
+                    path.quadTo(*control, p);
+                } else {
+                    path.lineTo(p);
+                }
+                control.reset();
+                cubicControls.clear();
+                break;
+            case 2:
+                if (cubicControls.size() < 2) {
+                    cubicControls.append(p);
+                }
+                break;
+            default:
+                if (control) {
+                    path.quadTo(*control, (*control + p) / 2);
+                }
+                control = p;
+                break;
+            }
+        }
+
+        if (control) {
+            path.quadTo(*control, startPoint);
+        }
+
+        path.closeSubpath();
+        start = end + 1;
+    }
+
+    return path;
+}
+
+class GlyphRenderTask : public QRunnable
+{
+public:
+    GlyphRenderTask(GlyphGrid *grid, const quint64 generation, const quint32 key,
+                    const std::shared_ptr<const FaceInstance> &instance, const quint16 glyphId,
+                    const QRectF &boundingBox, const int size, const qreal pixelRatio,
+                    const QColor &color)
+        : m_grid(grid)
+        , m_generation(generation)
+        , m_key(key)
+        , m_instance(instance)
+        , m_glyphId(glyphId)
+        , m_boundingBox(boundingBox)
+        , m_size(size)
+        , m_pixelRatio(pixelRatio)
+        , m_color(color)
+    {
+    }
+
+    void run() override
+    {
+        QImage image(QSize(m_size, m_size) * m_pixelRatio, QImage::Format_ARGB32_Premultiplied);
+        image.setDevicePixelRatio(m_pixelRatio);
+        image.fill(Qt::transparent);
+
+        const auto outline = m_instance->outline(m_glyphId);
+        if (outline && outline->size() != 0 && !m_boundingBox.isEmpty()) {
+            QPainter p(&image);
+            p.setRenderHint(QPainter::Antialiasing);
+
+            // The same scale for all glyphs, so they can be compared.
+            const auto scale = (m_size - 4) / std::max(m_boundingBox.width(), m_boundingBox.height());
+            p.translate(m_size / 2.0, m_size / 2.0);
+            // Font units point up.
+            p.scale(scale, -scale);
+            p.translate(-m_boundingBox.center());
+            p.fillPath(outlineToPath(*outline), m_color);
+        }
+
+        // The grid waits for all tasks on destruction, so it's still alive here.
+        const auto grid = m_grid;
+        const auto generation = m_generation;
+        const auto key = m_key;
+        QMetaObject::invokeMethod(grid, [grid, generation, key, image]{
+            grid->onRendered(generation, key, image);
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    GlyphGrid * const m_grid;
+    const quint64 m_generation;
+    const quint32 m_key;
+    const std::shared_ptr<const FaceInstance> m_instance;
+    const quint16 m_glyphId;
+    const QRectF m_boundingBox;
+    const int m_size;
+    const qreal m_pixelRatio;
+    const QColor m_color;
+};
+
+GlyphGrid::GlyphGrid(QWidget *parent)
+    : QAbstractScrollArea(parent)
+    , m_pixmaps(64 * 1024)
+{
+    // Keep one core for the GUI.
+    m_pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
+
+    setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, this, [this](){
+        // Cells that are no longer visible are not needed anymore.
+        cancelPending();
+        viewport()->update();
+    });
+}
+
+GlyphGrid::~GlyphGrid()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+void GlyphGrid::setFace(const Face *face)
+{
+    cancelPending();
+    m_pool.waitForDone();
+
+    m_face = face;
+    m_instance.reset();
+    if (face) {
+        m_instance = std::make_shared<const FaceInstance>(face->instance({}));
+    }
+    m_numberOfGlyphs = face ? face->numberOfGlyphs() : 0;
+    m_boundingBox = face ? face->boundingBox() : QRectF();
+    m_currentGlyph.reset();
+    m_generation += 1;
+    m_pixmaps.clear();
+
+    verticalScrollBar()->setValue(0);
+    updateScrollBar();
+    viewport()->update();
+}
+
+void GlyphGrid::setInstance(const FaceInstance &instance)
+{
+    if (!m_face) {
+        return;
+    }
+
+    // Cached pixmaps are kept and shown until visible glyphs are re-rendered.
+    cancelPending();
+    m_instance = std::make_shared<const FaceInstance>(instance);
+    m_generation += 1;
+    viewport()->update();
+}
+
+void GlyphGrid::onRendered(const quint64 generation, const quint32 key, const QImage &image)
+{
+    if (generation != m_generation) {
+        return;
+    }
+
+    m_pending.remove(key);
+    const auto cost = std::max(1, int(image.sizeInBytes() / 1024));
+    m_pixmaps.insert(key, new CachedPixmap{ QPixmap::fromImage(image), generation }, cost);
+    viewport()->update();
+}
+
+void GlyphGrid::scheduleRender(const quint16 glyphId, const quint32 key)
+{
+    if (m_pending.contains(key)) {
+        return;
+    }
+
+    // FaceInstance is immutable, so both decoding and rasterization are offloaded.
+    m_pending.insert(key);
+    m_pool.start(new GlyphRenderTask(this, m_generation, key, m_instance, glyphId, m_boundingBox,
+                                     m_cellSize, devicePixelRatioF(), palette().color(QPalette::Text)));
+}
+
+void GlyphGrid::cancelPending()
+{
+    // Running tasks will still finish and their results will be cached.
+    m_pool.clear();
+    m_pending.clear();
+}
+
+void GlyphGrid::updateScrollBar()
+{
+    const auto rows = (m_numberOfGlyphs + columns() - 1) / columns();
+    const auto totalHeight = qint64(rows) * cellHeight();
+    verticalScrollBar()->setRange(0, int(std::max<qint64>(0, totalHeight - viewport()->height())));
+    verticalScrollBar()->setSingleStep(cellHeight() / 2);
+    verticalScrollBar()->setPageStep(viewport()->height());
+}
+
+int GlyphGrid::columns() const
+{
+    return std::max(1, viewport()->width() / m_cellSize);
+}
+
+int GlyphGrid::cellHeight() const
+{
+    return m_cellSize + LabelHeight;
+}
+
+std::optional<quint16> GlyphGrid::glyphAt(const QPoint &pos) const
+{
+    const auto column = pos.x() / m_cellSize;
+    if (column >= columns()) {
+        return std::nullopt;
+    }
+
+    const auto row = (pos.y() + verticalScrollBar()->value()) / cellHeight();
+    const auto glyphId = qint64(row) * columns() + column;
+    if (glyphId < 0 || glyphId >= m_numberOfGlyphs) {
+        return std::nullopt;
+    }
+
+    return quint16(glyphId);
+}
+
+void GlyphGrid::paintEvent(QPaintEvent *)
+{
+    QPainter p(viewport());
+    p.fillRect(viewport()->rect(), palette().color(QPalette::Base));
+
+    if (!m_face || m_numberOfGlyphs == 0) {
+        p.setPen(palette().color(QPalette::Disabled, QPalette::Text));
+        p.drawText(viewport()->rect(), Qt::AlignCenter, "No glyphs");
+        return;
+    }
+
+    const auto cols = columns();
+    const auto height = cellHeight();
+    const auto scroll = verticalScrollBar()->value();
+    const auto firstRow = scroll / height;
+    const auto lastRow = (scroll + viewport()->height()) / height;
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = 0; column < cols; ++column) {
+            const auto index = qint64(row) * cols + column;
+            if (index >= m_numberOfGlyphs) {
+                break;
+            }
+
+            const auto glyphId = quint16(index);
+            const QRect cell(column * m_cellSize, row * height - scroll, m_cellSize, height);
+
+            if (glyphId == m_currentGlyph) {
+                p.fillRect(cell, palette().color(QPalette::Highlight).lighter(170));
+            }
+
+            p.setPen(palette().color(QPalette::Midlight));
+            p.drawRect(cell.adjusted(0, 0, -1, -1));
+
+            const auto key = pixmapKey(m_cellSize, glyphId);
+            const auto cached = m_pixmaps.object(key);
+            if (cached) {
+                p.drawPixmap(cell.topLeft(), cached->pixmap);
+            }
+
+            if (!cached || cached->generation != m_generation) {
+                scheduleRender(glyphId, key);
+            }
+
+            p.setPen(palette().color(QPalette::Disabled, QPalette::Text));
+            p.drawText(QRect(cell.x(), cell.y() + m_cellSize, m_cellSize, LabelHeight),
+                       Qt::AlignCenter, QString::number(glyphId));
+        }
+    }
+}
+
+void GlyphGrid::resizeEvent(QResizeEvent *)
+{
+    updateScrollBar();
+}
+
+void GlyphGrid::mousePressEvent(QMouseEvent *e)
+{
+    if (e->button() != Qt::LeftButton) {
+        return;
+    }
+
+    if (const auto glyphId = glyphAt(e->pos())) {
+        m_currentGlyph = glyphId;
+        viewport()->update();
+        emit glyphClicked(*glyphId);
+    }
+}
+
+void GlyphGrid::wheelEvent(QWheelEvent *e)
+{
+    if (!(e->modifiers() & Qt::ControlModifier)) {
+        QAbstractScrollArea::wheelEvent(e);
+        return;
+    }
+
+    // Zoom while keeping the first visible row in place.
+    const auto firstGlyph = (verticalScrollBar()->value() / cellHeight()) * columns();
+    const auto step = e->angleDelta().y() > 0 ? 16 : -16;
+    const auto size = qBound(MinCellSize, m_cellSize + step, MaxCellSize);
+    if (size == m_cellSize) {
+        return;
+    }
+
+    cancelPending();
+    m_cellSize = size;
+    updateScrollBar();
+    verticalScrollBar()->setValue((firstGlyph / columns()) * cellHeight());
+    viewport()->update();
+}
+
+GlyphPanel::GlyphPanel(QWidget *parent)
+    : QWidget(parent)
+    , m_cmbFace(new QComboBox)
+    , m_grid(new GlyphGrid)
+{
+    auto lay = new QVBoxLayout(this);
+    lay->setContentsMargins(0, 0, 0, 0);
+    lay->addWidget(m_cmbFace);
+    lay->addWidget(m_grid);
+
+    m_cmbFace->hide();
+
+    connect(m_cmbFace, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](const int index){
+        if (m_faces && index >= 0 && size_t(index) < m_faces->size()) {
+            m_grid->setFace(&m_faces->at(size_t(index)));
+        }
+    });
+
+    connect(m_grid, &GlyphGrid::glyphClicked, this, [this](const quint16 glyphId){
+        emit glyphClicked(quint32(std::max(0, m_cmbFace->currentIndex())), glyphId);
+    });
+}
+
+void GlyphPanel::setFaces(const std::vector<Face> *faces)
+{
+    m_grid->setFace(nullptr);
+    m_faces = faces;
+
+    // Do not trigger a face change for each item.
+    m_cmbFace->blockSignals(true);
+    m_cmbFace->clear();
+    if (faces) {
+        for (const auto &face : *faces) {
+            m_cmbFace->addItem(QString("Face %1").arg(face.index()));
+        }
+    }
+    m_cmbFace->blockSignals(false);
+    m_cmbFace->setVisible(faces && faces->size() > 1);
+
+    if (faces && !faces->empty()) {
+        m_grid->setFace(&faces->front());
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QAbstractScrollArea>
+#include <QCache>
+#include <QComboBox>
+#include <QPixmap>
+#include <QSet>
+#include <QThreadPool>
+
+#include <memory>
+
+#include "face.h"
+
+class GlyphRenderTask;
+
+// A virtualized grid of glyph previews.
+//
+// Only visible cells are rendered. Outlines are decoded and rasterized on worker threads
+// and cached as pixmaps keyed by glyph ID and cell size.
+class GlyphGrid : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    explicit GlyphGrid(QWidget *parent = nullptr);
+    ~GlyphGrid();
+
+    // The face must outlive the grid or be reset with nullptr.
+    void setFace(const Face *face);
+
+    // Re-renders visible glyphs of the current face at a variation instance.
+    void setInstance(const FaceInstance &instance);
+
+signals:
+    void glyphClicked(quint16 glyphId);
+
+private:
+    friend class GlyphRenderTask;
+
+    void onRendered(const quint64 generation, const quint32 key, const QImage &image);
+    void scheduleRender(const quint16 glyphId, const quint32 key);
+    void cancelPending();
+    void updateScrollBar();
+    int columns() const;
+    int cellHeight() const;
+    std::optional<quint16> glyphAt(const QPoint &pos) const;
+
+protected:
+    void paintEvent(QPaintEvent *);
+    void resizeEvent(QResizeEvent *);
+    void mousePressEvent(QMouseEvent *e);
+    void wheelEvent(QWheelEvent *e);
+
+private:
+    struct CachedPixmap
+    {
+        QPixmap pixmap;
+        // Pixmaps of a previous instance are shown until re-rendered.
+        quint64 generation;
+    };
+
+    const Face *m_face = nullptr;
+    std::shared_ptr<const FaceInstance> m_instance;
+    quint16 m_numberOfGlyphs = 0;
+    QRectF m_boundingBox;
+    int m_cellSize = 64;
+    std::optional<quint16> m_currentGlyph;
+    // Results from a previous face or instance are ignored.
+    quint64 m_generation = 0;
+    QThreadPool m_pool;
+    // The key is a cell size and a glyph ID. The cost is in KiB.
+    QCache<quint32, CachedPixmap> m_pixmaps;
+    QSet<quint32> m_pending;
+};
+
+// A glyph grid with a face selector.
+class GlyphPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit GlyphPanel(QWidget *parent = nullptr);
+
+    // Faces must outlive the panel or be reset with nullptr.
+    void setFaces(const std::vector<Face> *faces);
+
+signals:
+    void glyphClicked(quint32 faceIndex, quint16 glyphId);
+
+private:
+    QComboBox * const m_cmbFace;
+    GlyphGrid * const m_grid;
+    const std::vector<Face> *m_faces = nullptr;
+};
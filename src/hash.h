@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QString>
+
+#include <cstring>
+
+// A fast non-cryptographic 64-bit hash, used to compare trees.
+namespace Hash
+{
+    static inline quint64 mix(quint64 x)
+    {
+        x ^= x >> 33;
+        x *= 0xFF51AFD7ED558CCDull;
+        x ^= x >> 33;
+        x *= 0xC4CEB9FE1A85EC53ull;
+        x ^= x >> 33;
+        return x;
+    }
+
+    static inline quint64 combine(const quint64 seed, const quint64 value)
+    {
+        return mix(seed ^ (value + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2)));
+    }
+
+    static inline quint64 bytes(const void *data, const size_t len)
+    {
+        const auto *p = static_cast<const quint8*>(data);
+        quint64 h = 0x9E3779B97F4A7C15ull ^ (len * 0xFF51AFD7ED558CCDull);
+
+        size_t i = 0;
+        for (; i + 8 <= len; i += 8) {
+            quint64 v;
+            std::memcpy(&v, p + i, 8);
+            h ^= v * 0xC4CEB9FE1A85EC53ull;
+            h = ((h << 31) | (h >> 33)) * 0x9E3779B97F4A7C15ull;
+        }
+
+        quint64 tail = 0;
+        for (size_t k = 0; i < len; ++i, k += 8) {
+            tail |= quint64(p[i]) << k;
+        }
+
+        return mix(h ^ tail);
+    }
+
+    static inline quint64 string(const QString &str)
+    {
+        return bytes(str.constData(), size_t(str.size()) * sizeof(QChar));
+    }
+}
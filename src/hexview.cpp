@@ -108,6 +108,12 @@ void HexView::setData(const uchar *data, const quint32 dataSize, Ranges &&ranges
     viewport()->update();
 }
 
+void HexView::setRanges(Ranges &&ranges)
+{
+    m_ranges = std::move(ranges);
+    viewport()->update();
+}
+
 void HexView::clear()
 {
     m_data = nullptr;
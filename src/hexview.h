@@ -15,6 +15,8 @@ public:
     explicit HexView(QWidget *parent = nullptr);
 
     void setData(const uchar *data, const quint32 dataSize, Ranges &&ranges);
+    // Replaces ranges of the current data, keeping the scroll position and the selection.
+    void setRanges(Ranges &&ranges);
     void clear();
 
     void selectRegion(const Range &region);
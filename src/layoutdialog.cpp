@@ -0,0 +1,153 @@
+#include <QFormLayout>
+#include <QSplitter>
+#include <QVBoxLayout>
+
+#include "layoutdialog.h"
+
+LayoutDialog::LayoutDialog(const std::vector<Face> &faces, QWidget *parent)
+    : QDialog(parent)
+    , m_faces(faces)
+    , m_cmbFace(new QComboBox)
+    , m_cmbTable(new QComboBox)
+    , m_listLookups(new QListWidget)
+    , m_lblCoverage(new QLabel)
+    , m_textCoverage(new QPlainTextEdit)
+    , m_spinGlyphId(new QSpinBox)
+    , m_lblGlyph(new QLabel)
+{
+    setWindowTitle("Layout Lookups");
+
+    for (const auto &face : faces) {
+        m_cmbFace->addItem(QString("Face %1").arg(face.index()));
+    }
+
+    m_cmbTable->addItem("GSUB");
+    m_cmbTable->addItem("GPOS");
+
+    m_textCoverage->setReadOnly(true);
+    m_spinGlyphId->setRange(0, 0xFFFF);
+    m_lblGlyph->setWordWrap(true);
+    m_lblGlyph->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    auto form = new QFormLayout();
+    if (faces.size() > 1) {
+        form->addRow("Face:", m_cmbFace);
+    }
+    form->addRow("Table:", m_cmbTable);
+
+    auto coverageWidget = new QWidget();
+    auto coverageForm = new QFormLayout();
+    coverageForm->addRow("Coverage:", m_lblCoverage);
+    coverageForm->addRow("Glyph ID:", m_spinGlyphId);
+    coverageForm->addRow("Glyph:", m_lblGlyph);
+    auto coverageLay = new QVBoxLayout(coverageWidget);
+    coverageLay->setContentsMargins(0, 0, 0, 0);
+    coverageLay->addLayout(coverageForm);
+    coverageLay->addWidget(m_textCoverage);
+
+    auto splitter = new QSplitter();
+    splitter->addWidget(m_listLookups);
+    splitter->addWidget(coverageWidget);
+
+    auto lay = new QVBoxLayout(this);
+    lay->addLayout(form);
+    lay->addWidget(splitter);
+
+    connect(m_cmbFace, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &LayoutDialog::onTableChanged);
+    connect(m_cmbTable, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &LayoutDialog::onTableChanged);
+    connect(m_listLookups, &QListWidget::currentRowChanged, this, &LayoutDialog::onLookupChanged);
+    connect(m_spinGlyphId, QOverload<int>::of(&QSpinBox::valueChanged), this, &LayoutDialog::onGlyphIdChanged);
+
+    onTableChanged();
+
+    resize(700, 500);
+}
+
+const LayoutLookups* LayoutDialog::currentLookups() const
+{
+    const auto index = m_cmbFace->currentIndex();
+    if (index < 0) {
+        return nullptr;
+    }
+
+    const auto tableType = m_cmbTable->currentIndex() == 0 ? LayoutTableType::Gsub : LayoutTableType::Gpos;
+    return &m_faces[size_t(index)].layoutLookups(tableType);
+}
+
+void LayoutDialog::onTableChanged()
+{
+    m_listLookups->clear();
+
+    const auto lookups = currentLookups();
+    if (!lookups) {
+        return;
+    }
+
+    for (int i = 0; i < lookups->lookups.size(); ++i) {
+        const auto &lookup = lookups->lookups[i];
+        m_listLookups->addItem(QString("Lookup %1: %2, %3 glyphs")
+            .arg(i).arg(lookupTypeName(lookups->tableType, lookup.type))
+            .arg(lookup.coverage.numberOfGlyphs()));
+    }
+
+    if (lookups->lookups.isEmpty()) {
+        m_lblCoverage->setText("No lookups");
+        m_textCoverage->clear();
+        m_lblGlyph->clear();
+    } else {
+        m_listLookups->setCurrentRow(0);
+    }
+}
+
+void LayoutDialog::onLookupChanged()
+{
+    const auto lookups = currentLookups();
+    const auto row = m_listLookups->currentRow();
+    if (!lookups || row < 0 || row >= lookups->lookups.size()) {
+        return;
+    }
+
+    const auto &lookup = lookups->lookups[row];
+    m_lblCoverage->setText(QString("%1 glyphs in %2 coverage tables, %3 subtables")
+        .arg(lookup.coverage.numberOfGlyphs()).arg(lookup.coverages.size()).arg(lookup.subtables.size()));
+
+    const auto &characterMap = m_faces[size_t(m_cmbFace->currentIndex())].characterMap();
+
+    QStringList lines;
+    for (const auto glyphId : lookup.coverage.glyphs()) {
+        auto line = QString::number(glyphId);
+        for (const auto c : characterMap.codepoints(glyphId)) {
+            line += QString(" U+%1").arg(c, 4, 16, QChar('0')).toUpper();
+        }
+        lines << line;
+    }
+
+    m_textCoverage->setPlainText(lines.join('\n'));
+
+    onGlyphIdChanged();
+}
+
+void LayoutDialog::onGlyphIdChanged()
+{
+    const auto lookups = currentLookups();
+    const auto row = m_listLookups->currentRow();
+    if (!lookups || row < 0 || row >= lookups->lookups.size()) {
+        m_lblGlyph->clear();
+        return;
+    }
+
+    const auto &lookup = lookups->lookups[row];
+    const auto glyphId = quint16(m_spinGlyphId->value());
+
+    QString text = lookup.coverage.contains(glyphId) ? "Covered" : "Not covered";
+    if (!lookup.classDefinitions.isEmpty()) {
+        QStringList classes;
+        for (const auto index : lookup.classDefinitions) {
+            classes << QString::number(lookups->classDefinitions[index].glyphClass(glyphId));
+        }
+
+        text += QString(", classes: %1").arg(classes.join(", "));
+    }
+
+    m_lblGlyph->setText(text);
+}
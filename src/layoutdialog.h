@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QComboBox>
+#include <QDialog>
+#include <QLabel>
+#include <QListWidget>
+#include <QPlainTextEdit>
+#include <QSpinBox>
+
+#include "face.h"
+
+// `GSUB` and `GPOS` lookups with glyphs they are applied at.
+//
+// Coverage and Class Definition tables are decoded once per face and table,
+// so switching between lookups and glyphs doesn't touch the font data.
+class LayoutDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit LayoutDialog(const std::vector<Face> &faces, QWidget *parent = nullptr);
+
+private:
+    const LayoutLookups* currentLookups() const;
+    void onTableChanged();
+    void onLookupChanged();
+    void onGlyphIdChanged();
+
+private:
+    const std::vector<Face> &m_faces;
+    QComboBox * const m_cmbFace;
+    QComboBox * const m_cmbTable;
+    QListWidget * const m_listLookups;
+    QLabel * const m_lblCoverage;
+    QPlainTextEdit * const m_textCoverage;
+    QSpinBox * const m_spinGlyphId;
+    QLabel * const m_lblGlyph;
+};
@@ -0,0 +1,139 @@
+#include <QFormLayout>
+#include <QVBoxLayout>
+
+#include "lookupdialog.h"
+
+// Accepts `U+0041`, `0x41`, `41` or a single character.
+static std::optional<quint32> parseCodepoint(const QString &text)
+{
+    const auto ucs4 = text.toUcs4();
+    if (ucs4.size() == 1 && !QChar::isDigit(ucs4[0])) {
+        return ucs4[0];
+    }
+
+    auto hex = text.trimmed();
+    if (hex.startsWith("U+", Qt::CaseInsensitive) || hex.startsWith("0x", Qt::CaseInsensitive)) {
+        hex = hex.mid(2);
+    }
+
+    bool ok = false;
+    const auto codepoint = hex.toUInt(&ok, 16);
+    if (!ok || codepoint > 0x10FFFF) {
+        return std::nullopt;
+    }
+
+    return codepoint;
+}
+
+static QString codepointToString(const quint32 codepoint)
+{
+    return QString("U+%1").arg(codepoint, 4, 16, QChar('0')).toUpper();
+}
+
+LookupDialog::LookupDialog(const std::vector<Face> &faces, QWidget *parent)
+    : QDialog(parent)
+    , m_faces(faces)
+    , m_cmbFace(new QComboBox)
+    , m_lblSource(new QLabel)
+    , m_lineCodepoint(new QLineEdit)
+    , m_lblGlyphId(new QLabel)
+    , m_spinGlyphId(new QSpinBox)
+    , m_lblCodepoints(new QLabel)
+{
+    setWindowTitle("Lookup Codepoint");
+
+    for (const auto &face : faces) {
+        m_cmbFace->addItem(QString("Face %1").arg(face.index()));
+    }
+
+    m_lineCodepoint->setPlaceholderText("U+0041, 0x41 or A");
+    m_spinGlyphId->setRange(0, 0xFFFF);
+    m_lblCodepoints->setWordWrap(true);
+    m_lblCodepoints->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    auto form = new QFormLayout();
+    if (faces.size() > 1) {
+        form->addRow("Face:", m_cmbFace);
+    }
+    form->addRow("Subtable:", m_lblSource);
+    form->addRow("Codepoint:", m_lineCodepoint);
+    form->addRow("Glyph:", m_lblGlyphId);
+    form->addRow("Glyph ID:", m_spinGlyphId);
+    form->addRow("Codepoints:", m_lblCodepoints);
+
+    auto lay = new QVBoxLayout(this);
+    lay->addLayout(form);
+    lay->addStretch();
+
+    connect(m_cmbFace, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &LookupDialog::onFaceChanged);
+    connect(m_lineCodepoint, &QLineEdit::textChanged, this, &LookupDialog::onCodepointChanged);
+    connect(m_spinGlyphId, QOverload<int>::of(&QSpinBox::valueChanged), this, &LookupDialog::onGlyphIdChanged);
+
+    onFaceChanged();
+
+    resize(400, 0);
+}
+
+void LookupDialog::onFaceChanged()
+{
+    const auto index = m_cmbFace->currentIndex();
+    if (index < 0) {
+        m_lblSource->setText("No faces");
+        return;
+    }
+
+    const auto &map = m_faces[size_t(index)].characterMap();
+    if (map.isEmpty()) {
+        m_lblSource->setText("No supported Unicode subtable");
+    } else {
+        m_lblSource->setText(QString("Platform %1, encoding %2, format %3, %4 codepoints")
+            .arg(map.platformId()).arg(map.encodingId()).arg(map.format()).arg(map.numberOfCodepoints()));
+    }
+
+    onCodepointChanged();
+    onGlyphIdChanged();
+}
+
+void LookupDialog::onCodepointChanged()
+{
+    const auto index = m_cmbFace->currentIndex();
+    if (index < 0 || m_lineCodepoint->text().isEmpty()) {
+        m_lblGlyphId->clear();
+        return;
+    }
+
+    const auto codepoint = parseCodepoint(m_lineCodepoint->text());
+    if (!codepoint) {
+        m_lblGlyphId->setText("Invalid codepoint");
+        return;
+    }
+
+    const auto glyphId = m_faces[size_t(index)].characterMap().glyphId(*codepoint);
+    if (glyphId == 0) {
+        m_lblGlyphId->setText(QString("%1 is not mapped").arg(codepointToString(*codepoint)));
+    } else {
+        m_lblGlyphId->setText(QString("%1 -> %2").arg(codepointToString(*codepoint)).arg(glyphId));
+    }
+}
+
+void LookupDialog::onGlyphIdChanged()
+{
+    const auto index = m_cmbFace->currentIndex();
+    if (index < 0) {
+        m_lblCodepoints->clear();
+        return;
+    }
+
+    const auto codepoints = m_faces[size_t(index)].characterMap().codepoints(quint16(m_spinGlyphId->value()));
+    if (codepoints.isEmpty()) {
+        m_lblCodepoints->setText("None");
+        return;
+    }
+
+    QStringList list;
+    for (const auto c : codepoints) {
+        list << codepointToString(c);
+    }
+
+    m_lblCodepoints->setText(list.join(", "));
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <QComboBox>
+#include <QDialog>
+#include <QLabel>
+#include <QLineEdit>
+#include <QSpinBox>
+
+#include "face.h"
+
+// Codepoint to glyph and glyph to codepoints queries using the decoded `cmap`.
+class LookupDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit LookupDialog(const std::vector<Face> &faces, QWidget *parent = nullptr);
+
+private:
+    void onFaceChanged();
+    void onCodepointChanged();
+    void onGlyphIdChanged();
+
+private:
+    const std::vector<Face> &m_faces;
+    QComboBox * const m_cmbFace;
+    QLabel * const m_lblSource;
+    QLineEdit * const m_lineCodepoint;
+    QLabel * const m_lblGlyphId;
+    QSpinBox * const m_spinGlyphId;
+    QLabel * const m_lblCodepoints;
+};
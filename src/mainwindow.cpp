@@ -1,22 +1,98 @@
 #include <QApplication>
 #include <QDebug>
+#include <QDockWidget>
 #include <QElapsedTimer>
 #include <QFileDialog>
+#include <QFileInfo>
 #include <QGridLayout>
 #include <QHeaderView>
 #include <QMenuBar>
 #include <QMessageBox>
+#include <QRunnable>
+#include <QScrollBar>
 #include <QTimer>
 
-#include "truetype.h"
+#include "comparewindow.h"
+#include "coveragedialog.h"
+#include "font.h"
+#include "layoutdialog.h"
+#include "lookupdialog.h"
+#include "pairsdialog.h"
+#include "utils.h"
+#include "variationsdialog.h"
 
 #include "mainwindow.h"
 
+// Decodes `kern` after parsing, so pair queries don't stall the UI.
+class KerningTask : public QRunnable
+{
+public:
+    KerningTask(MainWindow *window, const quint64 generation, const size_t faceIndex, const Face &face)
+        : m_window(window)
+        , m_generation(generation)
+        , m_faceIndex(faceIndex)
+        , m_face(face)
+    {
+    }
+
+    void run() override
+    {
+        const auto kerning = m_face.decodeKerning();
+
+        // The window waits for all tasks before faces are reset, so both are still alive here.
+        const auto window = m_window;
+        const auto generation = m_generation;
+        const auto faceIndex = m_faceIndex;
+        QMetaObject::invokeMethod(window, [window, generation, faceIndex, kerning]{
+            window->onKerningDecoded(generation, faceIndex, kerning);
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    MainWindow * const m_window;
+    const quint64 m_generation;
+    const size_t m_faceIndex;
+    const Face &m_face;
+};
+
+// Parses the file headless to compute the ranges of lazy groups.
+class RangesTask : public QRunnable
+{
+public:
+    RangesTask(MainWindow *window, const quint64 generation, const uchar *data, const quint32 size)
+        : m_window(window)
+        , m_generation(generation)
+        , m_data(data)
+        , m_size(size)
+    {
+    }
+
+    void run() override
+    {
+        auto font = Font::parse(m_data, m_size, Font::Mode::Headless);
+        const auto ranges = font.takeRanges();
+
+        // The window waits for all tasks before the file is unmapped, so both are still alive here.
+        const auto window = m_window;
+        const auto generation = m_generation;
+        QMetaObject::invokeMethod(window, [window, generation, ranges]{
+            window->onRangesComputed(generation, ranges);
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    MainWindow * const m_window;
+    const quint64 m_generation;
+    const uchar * const m_data;
+    const quint32 m_size;
+};
+
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , m_hexView(new HexView)
     , m_treeView(new QTreeView)
     , m_lblStatus(new QLabel)
+    , m_glyphPanel(new GlyphPanel)
 {
     setCentralWidget(new QWidget());
 
@@ -36,11 +112,49 @@ MainWindow::MainWindow(QWidget *parent)
     m_treeView->setFrameShape(QFrame::NoFrame);
 #endif
 
+    auto glyphsDock = new QDockWidget("Glyphs", this);
+    glyphsDock->setObjectName("glyphsDock");
+    glyphsDock->setWidget(m_glyphPanel);
+    glyphsDock->hide();
+    addDockWidget(Qt::RightDockWidgetArea, glyphsDock);
+    connect(m_glyphPanel, &GlyphPanel::glyphClicked, this, &MainWindow::onGlyphClicked);
+
+    // Created here, because decoders are initialized after widgets.
+    m_bitmapPreview = new BitmapPreview(&m_bitmaps);
+    m_bitmapDock = new QDockWidget("Bitmap", this);
+    m_bitmapDock->setObjectName("bitmapDock");
+    m_bitmapDock->setWidget(m_bitmapPreview);
+    m_bitmapDock->hide();
+    addDockWidget(Qt::RightDockWidgetArea, m_bitmapDock);
+
+    m_svgPreview = new SvgPreview(&m_svgs);
+    m_svgDock = new QDockWidget("SVG", this);
+    m_svgDock->setObjectName("svgDock");
+    m_svgDock->setWidget(m_svgPreview);
+    m_svgDock->hide();
+    addDockWidget(Qt::RightDockWidgetArea, m_svgDock);
+
     {
         auto menuBar = new QMenuBar(this);
         auto fileMenu = menuBar->addMenu("File");
         auto openAction = fileMenu->addAction("Open");
         connect(openAction, &QAction::triggered, this, &MainWindow::onOpenFile);
+        auto compareAction = fileMenu->addAction("Compare With...");
+        connect(compareAction, &QAction::triggered, this, &MainWindow::onCompareWith);
+        auto toolsMenu = menuBar->addMenu("Tools");
+        auto coverageAction = toolsMenu->addAction("Coverage");
+        connect(coverageAction, &QAction::triggered, this, &MainWindow::onShowCoverage);
+        auto lookupAction = toolsMenu->addAction("Lookup Codepoint...");
+        connect(lookupAction, &QAction::triggered, this, &MainWindow::onLookupCodepoint);
+        auto variationsAction = toolsMenu->addAction("Variations...");
+        connect(variationsAction, &QAction::triggered, this, &MainWindow::onShowVariations);
+        auto layoutAction = toolsMenu->addAction("Layout Lookups...");
+        connect(layoutAction, &QAction::triggered, this, &MainWindow::onShowLayoutLookups);
+        auto pairsAction = toolsMenu->addAction("Glyph Pairs...");
+        connect(pairsAction, &QAction::triggered, this, &MainWindow::onShowGlyphPairs);
+        toolsMenu->addAction(glyphsDock->toggleViewAction());
+        toolsMenu->addAction(m_bitmapDock->toggleViewAction());
+        toolsMenu->addAction(m_svgDock->toggleViewAction());
         setMenuBar(menuBar);
     }
 
@@ -50,12 +164,33 @@ MainWindow::MainWindow(QWidget *parent)
     m_treeView->header()->setSectionsClickable(false);
     m_treeView->header()->setSortIndicatorShown(false);
 
+    // Thumbnails of rows that are no longer visible are not needed anymore.
+    connect(m_treeView->verticalScrollBar(), &QScrollBar::valueChanged, this, [this](){
+        m_bitmaps.cancelVisible();
+    });
+
     resize(1200, 600);
     setWindowTitle("TTF Explorer");
 
     QTimer::singleShot(1, this, &MainWindow::onStart);
 }
 
+// Child widgets are destroyed after members, so everything that references
+// the faces, the tree or the mapped file is reset here.
+MainWindow::~MainWindow()
+{
+    m_bitmapPreview->setItem(nullptr);
+    m_svgPreview->setItem(nullptr);
+    // Waits for glyph rendering tasks.
+    m_glyphPanel->setFaces(nullptr);
+    m_pool.clear();
+    m_pool.waitForDone();
+    m_bitmaps.setData(nullptr, 0);
+    m_svgs.setData(nullptr, 0);
+    m_treeView->setModel(nullptr);
+    m_model.reset();
+}
+
 void MainWindow::onStart()
 {
     if (qApp->arguments().size() == 2) {
@@ -75,10 +210,162 @@ void MainWindow::onOpenFile()
     }
 }
 
+void MainWindow::onCompareWith()
+{
+    if (m_currentPath.isEmpty()) {
+        QMessageBox::information(this, "Compare", "Open a font first.");
+        return;
+    }
+
+    const auto path = QFileDialog::getOpenFileName(this, "Compare With", QFileInfo(m_currentPath).path(),
+                                                   "TrueType Fonts (*.ttf *.otf *.ttc *.otc)");
+    if (path.isEmpty()) {
+        return;
+    }
+
+    auto window = new CompareWindow(m_currentPath, path, this);
+    window->setAttribute(Qt::WA_DeleteOnClose);
+    window->show();
+}
+
+void MainWindow::onShowCoverage()
+{
+    if (m_currentPath.isEmpty()) {
+        return;
+    }
+
+    CoverageDialog dialog(m_coverage, this);
+    dialog.exec();
+}
+
+void MainWindow::onLookupCodepoint()
+{
+    if (m_currentPath.isEmpty()) {
+        return;
+    }
+
+    LookupDialog dialog(m_faces, this);
+    dialog.exec();
+}
+
+void MainWindow::onShowVariations()
+{
+    if (m_currentPath.isEmpty()) {
+        return;
+    }
+
+    VariationsDialog dialog(m_faces, this);
+    dialog.exec();
+}
+
+void MainWindow::onShowLayoutLookups()
+{
+    if (m_currentPath.isEmpty()) {
+        return;
+    }
+
+    LayoutDialog dialog(m_faces, this);
+    dialog.exec();
+}
+
+void MainWindow::onShowGlyphPairs()
+{
+    if (m_currentPath.isEmpty()) {
+        return;
+    }
+
+    PairsDialog dialog(m_faces, this);
+    dialog.exec();
+}
+
+static bool isGlyphTitle(const QString &title, const QString &prefix)
+{
+    return title.startsWith(prefix) && (title.size() == prefix.size() || title.at(prefix.size()) == ' ');
+}
+
+// Glyph nodes are never nested in each other, so there is no need to look inside them.
+static void findGlyphItems(TreeItem *item, const QString &prefix, const int depth,
+                           QVector<TreeItem*> &items)
+{
+    for (int i = 0; i < item->childCount(); ++i) {
+        const auto child = item->child(i);
+        if (isGlyphTitle(child->title, prefix)) {
+            items << child;
+        } else if (depth > 0) {
+            findGlyphItems(child, prefix, depth - 1, items);
+        }
+    }
+}
+
+void MainWindow::onKerningDecoded(const quint64 generation, const size_t faceIndex,
+                                  const KerningTable &kerning)
+{
+    if (generation == m_generation && faceIndex < m_faces.size()) {
+        m_faces[faceIndex].setKerning(kerning);
+    }
+}
+
+void MainWindow::onRangesComputed(const quint64 generation, const Ranges &ranges)
+{
+    if (generation != m_generation) {
+        return;
+    }
+
+    m_coverage = computeCoverage(ranges, quint32(m_file.size()));
+    m_hexView->setRanges(Ranges(ranges));
+}
+
+void MainWindow::onGlyphClicked(const quint32 faceIndex, const quint16 glyphId)
+{
+    const auto prefix = QString("Glyph %1").arg(glyphId);
+    const auto root = m_model->rootItem();
+
+    // Tables shared between faces are listed only once, under the first face that uses them.
+    QVector<TreeItem*> items;
+    QVector<TreeItem*> otherFaceItems;
+    const auto faceSuffix = QString(" (Face %1)").arg(faceIndex);
+    for (int i = 0; i < root->childCount(); ++i) {
+        const auto table = root->child(i);
+        const auto isOtherFace = m_faces.size() > 1 && !table->title.endsWith(faceSuffix);
+        findGlyphItems(table, prefix, 3, isOtherFace ? otherFaceItems : items);
+    }
+
+    if (items.isEmpty()) {
+        items = otherFaceItems;
+    }
+
+    if (items.isEmpty()) {
+        return;
+    }
+
+    QItemSelection selection;
+    for (const auto item : items) {
+        const auto index = m_model->indexByItem(item);
+        selection.select(index, index);
+    }
+
+    const auto first = m_model->indexByItem(items.first());
+    m_treeView->selectionModel()->setCurrentIndex(first, QItemSelectionModel::NoUpdate);
+    m_treeView->selectionModel()->select(selection, QItemSelectionModel::ClearAndSelect
+                                                    | QItemSelectionModel::Rows);
+    m_treeView->scrollTo(first);
+}
+
 void MainWindow::loadFile(const QString &filePath)
 {
+    m_pool.clear();
+    m_pool.waitForDone();
+    m_bitmaps.setData(nullptr, 0);
+    m_svgs.setData(nullptr, 0);
+    m_generation += 1;
+
+    m_bitmapPreview->setItem(nullptr);
+    m_svgPreview->setItem(nullptr);
     m_hexView->clear();
     m_model.reset(new TreeModel());
+    m_coverage = CoverageReport();
+    m_glyphPanel->setFaces(nullptr);
+    m_faces.clear();
     m_file.close();
     m_currentPath.clear();
 
@@ -97,38 +384,37 @@ void MainWindow::loadFile(const QString &filePath)
 
     m_currentPath = filePath;
 
-    try {
-        QElapsedTimer timer;
-        timer.start();
-
-        Parser parser(data, m_file.size(), m_model.get()->rootItem());
-        const auto warnings = TrueType::parse(parser);
-
-        auto ranges = parser.ranges();
-        m_hexView->setData(data, m_file.size(), std::move(ranges));
-
-        const auto elapsedMs = (double)timer.nsecsElapsed() / 1000000.0;
-        qDebug().noquote() << QString::number(elapsedMs, 'f', 1) + "ms";
+    QElapsedTimer timer;
+    timer.start();
+
+    // The file stays mapped until the next one is loaded.
+    auto font = Font::parse(data, m_file.size(), Font::Mode::LazyTree);
+    m_model.reset(new TreeModel(font.takeRootItem()));
+    m_bitmaps.setData(data, quint32(m_file.size()));
+    m_svgs.setData(data, quint32(m_file.size()));
+    m_model->setBitmapDecoder(&m_bitmaps);
+    m_coverage = computeCoverage(font.ranges(), quint32(m_file.size()));
+    // Lazy groups are not parsed yet, so their coverage is computed in the background.
+    if (!font.ranges().pending.empty()) {
+        m_pool.start(new RangesTask(this, m_generation, data, quint32(m_file.size())));
+    }
+    m_faces = Face::fromTables(data, quint32(m_file.size()), font.ranges().tables);
+    m_hexView->setData(data, m_file.size(), font.takeRanges());
+    m_glyphPanel->setFaces(&m_faces);
 
-        if (!warnings.isEmpty()) {
-            QMessageBox::warning(this, "Warning", warnings.join('\n'));
+    for (size_t i = 0; i < m_faces.size(); ++i) {
+        if (m_faces[i].findTable("kern")) {
+            m_pool.start(new KerningTask(this, m_generation, i, m_faces[i]));
         }
-    } catch (const QString &msg) {
-        QMessageBox::warning(this, "Error", msg);
+    }
 
-        auto ranges = Ranges {
-            { 0, (quint32)m_file.size(), },
-            { 0, (quint32)m_file.size(), },
-        };
-        m_hexView->setData(data, m_file.size(), std::move(ranges));
-    } catch (...) {
-        QMessageBox::critical(this, "Error", "Unknown error.");
+    const auto elapsedMs = (double)timer.nsecsElapsed() / 1000000.0;
+    qDebug().noquote() << QString::number(elapsedMs, 'f', 1) + "ms";
 
-        auto ranges = Ranges {
-            { 0, (quint32)m_file.size(), },
-            { 0, (quint32)m_file.size(), },
-        };
-        m_hexView->setData(data, m_file.size(), std::move(ranges));
+    if (!font.error().isEmpty()) {
+        QMessageBox::warning(this, "Error", font.error());
+    } else if (!font.warnings().isEmpty()) {
+        QMessageBox::warning(this, "Warning", font.warnings().join('\n'));
     }
 
     m_treeView->setModel(m_model.get());
@@ -162,10 +448,22 @@ void MainWindow::onTreeSelectionChanged(const QItemSelection &selected,
     const auto index = indexes.first();
     if (!index.isValid()) {
         m_hexView->clearSelection();
+        m_bitmapPreview->setItem(nullptr);
+        m_svgPreview->setItem(nullptr);
         return;
     }
 
     const auto item = m_model->itemByIndex(index);
+
+    m_bitmapPreview->setItem(item);
+    if (item->type == BitmapInfo::Type) {
+        m_bitmapDock->show();
+    }
+    // Documents are decompressed only when selected.
+    m_svgPreview->setItem(item);
+    if (item->type == Parser::SvgType || item->type == Parser::SvgzType) {
+        m_svgDock->show();
+    }
     const auto range = item->range;
 
     auto msg = QString(" %1..%2 - %3")
@@ -1,13 +1,19 @@
 #pragma once
 
+#include <QDockWidget>
 #include <QItemSelectionModel>
 #include <QLabel>
 #include <QTreeView>
 #include <QMainWindow>
 #include <QFile>
+#include <QThreadPool>
 
-#include "parser.h"
+#include "bitmapview.h"
+#include "coverage.h"
+#include "face.h"
+#include "glyphgrid.h"
 #include "hexview.h"
+#include "svgview.h"
 #include "treemodel.h"
 
 class MainWindow : public QMainWindow
@@ -16,19 +22,49 @@ class MainWindow : public QMainWindow
 
 public:
     explicit MainWindow(QWidget *parent = nullptr);
+    ~MainWindow();
 
     void loadFile(const QString &filePath);
 
 private:
+    friend class KerningTask;
+    friend class RangesTask;
+
     void onStart();
     void onOpenFile();
+    void onCompareWith();
+    void onShowCoverage();
+    void onLookupCodepoint();
+    void onShowVariations();
+    void onShowLayoutLookups();
+    void onShowGlyphPairs();
+    void onGlyphClicked(const quint32 faceIndex, const quint16 glyphId);
+    void onKerningDecoded(const quint64 generation, const size_t faceIndex, const KerningTable &kerning);
+    void onRangesComputed(const quint64 generation, const Ranges &ranges);
     void onTreeSelectionChanged(const QItemSelection &selected, const QItemSelection &deselected);
 
 private:
     HexView * const m_hexView;
     QTreeView * const m_treeView;
     QLabel * const m_lblStatus;
-    QScopedPointer<TreeModel> m_model;
+    GlyphPanel * const m_glyphPanel;
+    BitmapPreview *m_bitmapPreview = nullptr;
+    QDockWidget *m_bitmapDock = nullptr;
+    SvgPreview *m_svgPreview = nullptr;
+    QDockWidget *m_svgDock = nullptr;
+    CoverageReport m_coverage;
     QString m_currentPath;
     QFile m_file;
+    // References the mapped file.
+    std::vector<Face> m_faces;
+    // Incremented on each file load, so results for previous files are ignored.
+    quint64 m_generation = 0;
+    // Decodes per-face data in the background. References the mapped file,
+    // so it must be destroyed before it.
+    QThreadPool m_pool;
+    // References the mapped file as well.
+    BitmapDecoder m_bitmaps;
+    SvgDecoder m_svgs;
+    // Uses the bitmap decoder, so it must be destroyed before it.
+    QScopedPointer<TreeModel> m_model;
 };
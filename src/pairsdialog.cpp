@@ -0,0 +1,171 @@
+#include <QElapsedTimer>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QVBoxLayout>
+
+#include "pairsdialog.h"
+
+namespace ResultsColumn
+{
+    enum ResultsColumn
+    {
+        Source,
+        Subtable,
+        Classes,
+        First,
+        Second,
+    };
+}
+
+static QString valueRecordToString(const ValueRecord &record)
+{
+    QStringList list;
+    if (record.xPlacement != 0) list << QString("X placement %1").arg(record.xPlacement);
+    if (record.yPlacement != 0) list << QString("Y placement %1").arg(record.yPlacement);
+    if (record.xAdvance != 0) list << QString("X advance %1").arg(record.xAdvance);
+    if (record.yAdvance != 0) list << QString("Y advance %1").arg(record.yAdvance);
+    return list.isEmpty() ? "0" : list.join(", ");
+}
+
+PairsDialog::PairsDialog(const std::vector<Face> &faces, QWidget *parent)
+    : QDialog(parent)
+    , m_faces(faces)
+    , m_cmbFace(new QComboBox)
+    , m_lineText(new QLineEdit)
+    , m_spinFirst(new QSpinBox)
+    , m_spinSecond(new QSpinBox)
+    , m_treeResults(new QTreeWidget)
+    , m_lblStatus(new QLabel)
+{
+    setWindowTitle("Glyph Pairs");
+
+    for (const auto &face : faces) {
+        m_cmbFace->addItem(QString("Face %1").arg(face.index()));
+    }
+
+    m_lineText->setPlaceholderText("AV");
+    m_lineText->setMaxLength(2);
+    m_spinFirst->setRange(0, 0xFFFF);
+    m_spinSecond->setRange(0, 0xFFFF);
+
+    m_treeResults->setRootIsDecorated(false);
+    m_treeResults->setHeaderLabels({ "Source", "Subtable", "Classes", "First", "Second" });
+    m_treeResults->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+
+    auto glyphsLay = new QHBoxLayout();
+    glyphsLay->addWidget(m_spinFirst);
+    glyphsLay->addWidget(m_spinSecond);
+
+    auto form = new QFormLayout();
+    if (faces.size() > 1) {
+        form->addRow("Face:", m_cmbFace);
+    }
+    form->addRow("Text:", m_lineText);
+    form->addRow("Glyph IDs:", glyphsLay);
+
+    auto lay = new QVBoxLayout(this);
+    lay->addLayout(form);
+    lay->addWidget(m_treeResults);
+    lay->addWidget(m_lblStatus);
+
+    connect(m_cmbFace, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &PairsDialog::onTextChanged);
+    connect(m_lineText, &QLineEdit::textChanged, this, &PairsDialog::onTextChanged);
+    connect(m_spinFirst, QOverload<int>::of(&QSpinBox::valueChanged), this, &PairsDialog::onPairChanged);
+    connect(m_spinSecond, QOverload<int>::of(&QSpinBox::valueChanged), this, &PairsDialog::onPairChanged);
+
+    onPairChanged();
+
+    resize(600, 300);
+}
+
+void PairsDialog::onTextChanged()
+{
+    const auto index = m_cmbFace->currentIndex();
+    const auto ucs4 = m_lineText->text().toUcs4();
+    if (index < 0 || ucs4.size() != 2) {
+        onPairChanged();
+        return;
+    }
+
+    const auto &characterMap = m_faces[size_t(index)].characterMap();
+
+    // Update both glyphs at once.
+    {
+        const QSignalBlocker blocker(m_spinFirst);
+        m_spinFirst->setValue(characterMap.glyphId(ucs4[0]));
+    }
+    m_spinSecond->setValue(characterMap.glyphId(ucs4[1]));
+    onPairChanged();
+}
+
+void PairsDialog::onPairChanged()
+{
+    m_treeResults->clear();
+
+    const auto index = m_cmbFace->currentIndex();
+    if (index < 0) {
+        m_lblStatus->setText("No faces");
+        return;
+    }
+
+    const auto &face = m_faces[size_t(index)];
+    const auto first = quint16(m_spinFirst->value());
+    const auto second = quint16(m_spinSecond->value());
+
+    // Indices are built on first use, so they are not timed.
+    const auto &kerning = face.kerning();
+    const auto &lookups = face.layoutLookups(LayoutTableType::Gpos).lookups;
+    QVector<int> pairLookups;
+    quint64 numberOfPairs = 0;
+    for (int i = 0; i < lookups.size(); ++i) {
+        const auto &pairs = face.pairAdjustments(i);
+        if (!pairs.isEmpty()) {
+            pairLookups << i;
+            numberOfPairs += pairs.numberOfPairs();
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QVector<QPair<int, PairAdjustment>> results;
+    for (const auto lookupIndex : pairLookups) {
+        if (const auto adjustment = face.pairAdjustments(lookupIndex).find(first, second)) {
+            results.append({ lookupIndex, *adjustment });
+        }
+    }
+
+    const auto kernValues = kerning.find(first, second);
+    const auto kernValue = kerning.kerning(first, second);
+
+    const auto elapsed = timer.nsecsElapsed();
+
+    for (const auto &value : kernValues) {
+        auto item = new QTreeWidgetItem(m_treeResults);
+        item->setText(ResultsColumn::Source, "kern");
+        item->setText(ResultsColumn::Subtable, QString("%1 (format %2)").arg(value.subtableIndex).arg(value.format));
+        item->setText(ResultsColumn::First, QString("Kerning %1").arg(value.value));
+    }
+
+    for (const auto &result : results) {
+        const auto &adjustment = result.second;
+        auto item = new QTreeWidgetItem(m_treeResults);
+        item->setText(ResultsColumn::Source, QString("GPOS lookup %1").arg(result.first));
+        item->setText(ResultsColumn::Subtable, QString("%1 (format %2)")
+            .arg(adjustment.subtableIndex).arg(adjustment.format));
+        if (adjustment.format == 2) {
+            item->setText(ResultsColumn::Classes, QString("%1, %2")
+                .arg(adjustment.firstClass).arg(adjustment.secondClass));
+        }
+        item->setText(ResultsColumn::First, valueRecordToString(adjustment.first));
+        item->setText(ResultsColumn::Second, valueRecordToString(adjustment.second));
+    }
+
+    const auto kernText = kernValue ? QString::number(*kernValue) : QString("none");
+    m_lblStatus->setText(QString("kern: %1 (%2 indexed pairs). GPOS: %3 of %4 pair lookups (%5 indexed pairs). "
+                                 "Queried in %6 µs")
+        .arg(kernText).arg(kerning.numberOfPairs())
+        .arg(results.size()).arg(pairLookups.size()).arg(numberOfPairs)
+        .arg(double(elapsed) / 1000.0, 0, 'f', 2));
+}
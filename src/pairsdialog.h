@@ -0,0 +1,32 @@
+#pragma once
+
+#include <QComboBox>
+#include <QDialog>
+#include <QLabel>
+#include <QLineEdit>
+#include <QSpinBox>
+#include <QTreeWidget>
+
+#include "face.h"
+
+// Glyph pair queries over `kern` subtables and `GPOS` pair adjustment lookups.
+class PairsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit PairsDialog(const std::vector<Face> &faces, QWidget *parent = nullptr);
+
+private:
+    void onTextChanged();
+    void onPairChanged();
+
+private:
+    const std::vector<Face> &m_faces;
+    QComboBox * const m_cmbFace;
+    QLineEdit * const m_lineText;
+    QSpinBox * const m_spinFirst;
+    QSpinBox * const m_spinSecond;
+    QTreeWidget * const m_treeResults;
+    QLabel * const m_lblStatus;
+};
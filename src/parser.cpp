@@ -6,12 +6,16 @@ const QString Int16::Type = QLatin1String("Int16");
 const QString UInt16::Type = QLatin1String("UInt16");
 const QString UInt24::Type = QLatin1String("UInt24");
 const QString UInt32::Type = QLatin1String("UInt32");
+const QString Int32::Type = QLatin1String("Int32");
 const QString Tag::Type = QLatin1String("Tag");
 const QString F2DOT14::Type = QLatin1String("f2.14");
 const QString F16DOT16::Type = QLatin1String("f16.16");
 const QString GlyphId::Type = QLatin1String("GlyphId");
 const QString LongDateTime::Type = QLatin1String("LongDateTime");
+const QString BGRAColor::Type = QLatin1String("Color");
+const QString BitmapInfo::Type = QLatin1String("Bitmap");
 const QString Offset16::Type = QLatin1String("Offset16");
+const QString Offset24::Type = QLatin1String("Offset24");
 const QString Offset32::Type = QLatin1String("Offset32");
 const QString OptionalOffset16::Type = QLatin1String("Offset16");
 const QString OptionalOffset16::NullValue = QLatin1String("NULL");
@@ -26,12 +30,32 @@ const QString Parser::MacRomanStringType = QLatin1String("MacRoman String");
 const QString Parser::NameTitle = QLatin1String("Name");
 const QString Parser::PaddingTitle = QLatin1String("Padding");
 const QString Parser::PascalStringType = QLatin1String("PascalString");
+const QString Parser::SvgType = QLatin1String("SVG");
+const QString Parser::SvgzType = QLatin1String("SVGZ");
 const QString Parser::UnsupportedTitle = QLatin1String("Unsupported");
 const QString Parser::Utf16StringType = QLatin1String("UTF-16 String");
 const QString Parser::Utf8StringType = QLatin1String("UTF-8 String");
 
-QHash<const char*, QString> Parser::m_stringCache = {};
-QVector<QString> Parser::m_indexCache = {};
+QString BitmapInfo::toString(const BitmapInfo &value)
+{
+    switch (value.format) {
+    case Format::Png: return QLatin1String("PNG");
+    case Format::Jpeg: return QLatin1String("JPEG");
+    case Format::Tiff: return QLatin1String("TIFF");
+    case Format::ByteAligned:
+    case Format::BitAligned: {
+        return QString("%1x%2, %3-bit, %4")
+            .arg(value.width).arg(value.height).arg(value.bitDepth)
+            .arg(value.format == Format::ByteAligned ? "byte-aligned" : "bit-aligned");
+    }
+    }
+
+    Q_UNREACHABLE();
+}
+
+
+thread_local QHash<const char*, QString> Parser::m_stringCache = {};
+thread_local QVector<QString> Parser::m_indexCache = {};
 
 /// Macintosh Roman to UTF-16 encoding table.
 ///
@@ -10,10 +10,12 @@
 #include <charconv>
 #include <memory>
 #include <optional>
+#include <utility>
 
+#include "src/hash.h"
 #include "src/utils.h"
 
-#include "treemodel.h"
+#include "treeitem.h"
 
 #define DEFAULT_DEBUG(klass) \
     friend QDebug operator<<(QDebug dbg, const klass &value) \
@@ -248,6 +250,27 @@ struct Int32
     qint32 d;
 };
 
+struct Offset24
+{
+    static const int Size = 3;
+    static const QString Type;
+
+    static Offset24 parse(const quint8 *data)
+    { return { UInt24::parse(data).d }; }
+
+    static QString toString(const Offset24 &value)
+    { return numberToString(value.d); }
+
+    DEFAULT_DEBUG(Offset24)
+
+    bool operator<(const Offset24 &other) const
+    { return d < other.d; }
+
+    operator quint32() const { return d; }
+
+    quint32 d;
+};
+
 struct Offset32
 {
     static const int Size = 4;
@@ -406,6 +429,78 @@ struct LongDateTime
     qint64 d;
 };
 
+// A color stored as blue, green, red and alpha bytes. Displayed as `#RRGGBBAA`.
+struct BGRAColor
+{
+    static const int Size = 4;
+    static const QString Type;
+
+    static BGRAColor parse(const quint8 *data)
+    { return { data[2], data[1], data[0], data[3] }; }
+
+    static QString toString(const BGRAColor &value)
+    {
+        return QString("#%1%2%3%4")
+            .arg(value.red, 2, 16, QLatin1Char('0'))
+            .arg(value.green, 2, 16, QLatin1Char('0'))
+            .arg(value.blue, 2, 16, QLatin1Char('0'))
+            .arg(value.alpha, 2, 16, QLatin1Char('0'))
+            .toUpper();
+    }
+
+    friend QDebug operator<<(QDebug dbg, const BGRAColor &value)
+    {
+        QString str;
+        QDebug(&str).nospace().noquote() << "BGRAColor(" << toString(value) << ")";
+        return dbg << str;
+    }
+
+    quint8 red;
+    quint8 green;
+    quint8 blue;
+    quint8 alpha;
+};
+
+// Describes embedded image data, so it can be previewed.
+//
+// Shown as a value of image data nodes, like `PNG` or `16x16, 1-bit, byte-aligned`.
+struct BitmapInfo
+{
+    enum class Format
+    {
+        Png,
+        Jpeg,
+        Tiff,
+        // Rows are padded to a byte boundary.
+        ByteAligned,
+        // Rows are not padded.
+        BitAligned,
+    };
+
+    static const QString Type;
+
+    static QString toString(const BitmapInfo &value);
+
+    Format format = Format::Png;
+    // Raw bitmaps only. Compressed images store their own size and depth.
+    quint16 width = 0;
+    quint16 height = 0;
+    quint8 bitDepth = 1;
+};
+
+// An image data node. Created by Parser::readBitmap.
+class BitmapItem : public TreeItem
+{
+public:
+    BitmapItem(TreeItem *parent, const BitmapInfo &info)
+        : TreeItem(parent)
+        , info(info)
+    {
+    }
+
+    const BitmapInfo info;
+};
+
 class ShadowParser
 {
 public:
@@ -563,11 +658,16 @@ public:
     static const QString Utf16StringType;
     static const QString MacRomanStringType;
     static const QString CFFNumberType;
+    // SVG documents. The value of a compressed one is its decompressed size.
+    static const QString SvgType;
+    static const QString SvgzType;
 
     static const QString PaddingTitle;
     static const QString UnsupportedTitle;
     static const QString NameTitle;
 
+    // When `root` is null, the parser runs in a headless mode:
+    // no tree items are created and only ranges and counters are collected.
     explicit Parser(const quint8 *data, const quint32 len, TreeItem *root)
         : m_start(data)
         , m_data(data)
@@ -577,10 +677,40 @@ public:
     {
     }
 
+    // Computes TreeItem::hash for all items.
+    void enableHashes()
+    {
+        m_computeHashes = true;
+    }
+
+    // Defers parsing of lazy groups until they are expanded.
+    // The data must outlive the tree.
+    void enableLazyGroups()
+    {
+        m_lazyGroups = true;
+    }
+
+    // Returns true when no tree items are created.
+    bool isHeadless() const
+    {
+        return !m_parent;
+    }
+
     Ranges&& ranges() {
         return std::move(m_ranges);
     }
 
+    void addTableRange(const quint32 faceIndex, const QString &tag, const Range range)
+    {
+        m_ranges.tables.push_back({ faceIndex, tag, range });
+    }
+
+    // The number of nodes that were (or would be, in a headless mode) added to the tree.
+    quint32 nodesCount() const
+    {
+        return m_nodesCount;
+    }
+
     quint32 offset() const
     {
         return m_data - m_start;
@@ -596,12 +726,7 @@ public:
             throw QString("read out of bounds");
         }
 
-        auto item = new TreeItem(m_parent);
-        item->title = UnsupportedTitle;
-        item->value = QString();
-        item->type = QString();
-        item->range = Range(offset(), offset() + size);
-        m_parent->addChild(item);
+        addItem(UnsupportedTitle, Range(offset(), offset() + size));
 
         m_ranges.offsets.push_back(offset());
         m_ranges.unsupported.push_back(offset());
@@ -680,12 +805,10 @@ public:
 
         m_ranges.offsets.push_back(start);
 
-        auto item = new TreeItem(m_parent);
-        item->title = title;
-        item->value = T::toString(value);
-        item->type = T::Type;
-        item->range = Range(start, start + T::Size);
-        m_parent->addChild(item);
+        if (auto item = addItem(title, Range(start, start + T::Size))) {
+            item->value = T::toString(value);
+            item->type = T::Type;
+        }
 
         return value;
     }
@@ -707,18 +830,40 @@ public:
 
         m_ranges.offsets.push_back(start);
 
-        auto item = new TreeItem(m_parent);
-        item->title = title;
-        item->value = QString();
-        item->type = BytesType;
-        item->range = Range(start, offset());
-        m_parent->addChild(item);
+        if (auto item = addItem(title, Range(start, offset()))) {
+            item->type = BytesType;
+        }
 
         return value;
     }
 
+    void readBitmap(const QString &title, const BitmapInfo &info, const quint32 size)
+    {
+        if (size == 0) {
+            return;
+        }
+
+        if (atEnd(size)) {
+            throw QString("read out of bounds");
+        }
+
+        const auto start = offset();
+        m_ranges.offsets.push_back(start);
+
+        if (auto item = addItem<BitmapItem>(title, Range(start, start + size), info)) {
+            item->value = BitmapInfo::toString(info);
+            item->type = BitmapInfo::Type;
+        }
+
+        m_data += size;
+    }
+
     void readPadding(const quint32 size)
     {
+        if (size != 0) {
+            m_ranges.padding.push_back(offset());
+        }
+
         readBytes(PaddingTitle, size);
     }
 
@@ -742,12 +887,10 @@ public:
 
         m_ranges.offsets.push_back(start);
 
-        auto item = new TreeItem(m_parent);
-        item->title = NameTitle;
-        item->value = value;
-        item->type = BytesType;
-        item->range = Range(start, start + length);
-        m_parent->addChild(item);
+        if (auto item = addItem(NameTitle, Range(start, start + length))) {
+            item->value = value;
+            item->type = BytesType;
+        }
 
         endGroup(title, value, PascalStringType);
 
@@ -835,6 +978,18 @@ public:
         }
     }
 
+    template<typename T>
+    void readValue(const quint32 index, const QString &value)
+    {
+        readValue<T>(cachedIndex(index), value);
+    }
+
+    template<typename T>
+    void readValue(const char *title, const QString &value)
+    {
+        readValue<T>(cachedString(title), value);
+    }
+
     template<typename T>
     void readValue(const QString &title, const QString &value)
     {
@@ -845,12 +1000,10 @@ public:
         const auto start = offset();
         m_ranges.offsets.push_back(start);
 
-        auto item = new TreeItem(m_parent);
-        item->title = title;
-        item->value = value;
-        item->type = T::Type;
-        item->range = Range(start, start + T::Size);
-        m_parent->addChild(item);
+        if (auto item = addItem(title, Range(start, start + T::Size))) {
+            item->value = value;
+            item->type = T::Type;
+        }
 
         m_data += T::Size;
     }
@@ -869,12 +1022,10 @@ public:
         const auto start = offset();
         m_ranges.offsets.push_back(start);
 
-        auto item = new TreeItem(m_parent);
-        item->title = title;
-        item->value = value;
-        item->type = type;
-        item->range = Range(start, start + length);
-        m_parent->addChild(item);
+        if (auto item = addItem(title, Range(start, start + length))) {
+            item->value = value;
+            item->type = type;
+        }
 
         m_data += length;
     }
@@ -886,18 +1037,20 @@ public:
 
     void beginGroup(const QString &title = QString(), const QString &value = QString())
     {
-        auto item = new TreeItem(m_parent);
-        item->title = title;
-        item->value = value;
-        item->range = Range(offset(), offset());
-        m_parent->addChild(item);
-        m_parent = item;
+        if (auto item = addItem(title, Range(offset(), offset()))) {
+            item->value = value;
+            m_parent = item;
+        }
     }
 
     void endGroup(const QString &title = QString(),
                   const QString &value = QString(),
                   const QString &type = QString())
     {
+        if (!m_parent) {
+            return;
+        }
+
         if (m_parent->parent() && m_parent->hasChildren()) {
             // Update group title after actual parsing.
             if (!title.isEmpty()) {
@@ -918,27 +1071,27 @@ public:
         m_parent->range.end = offset();
         m_parent->size = Utils::prettySize(m_parent->range.size());
 
+        if (m_computeHashes) {
+            updateHash(m_parent);
+        }
+
         Q_ASSERT(m_parent->parent() != nullptr);
         m_parent = m_parent->parent();
     }
 
     void beginArray(const QString &title, quint32 itemsCount)
     {
-        QString value;
-        if (itemsCount == 1) {
-            value = "1 item";
-        } else {
-            value = QString("%1 items").arg(itemsCount);
-        }
+        if (auto item = addItem(title, Range(offset(), offset()))) {
+            if (itemsCount == 1) {
+                item->value = "1 item";
+            } else {
+                item->value = QString("%1 items").arg(itemsCount);
+            }
 
-        auto item = new TreeItem(m_parent);
-        item->title = title;
-        item->value = value;
-        item->type = ArrayType;
-        item->range = Range(offset(), offset());
-        item->reserveChildren(itemsCount);
-        m_parent->addChild(item);
-        m_parent = item;
+            item->type = ArrayType;
+            item->reserveChildren(itemsCount);
+            m_parent = item;
+        }
     }
 
     void endArray()
@@ -972,6 +1125,66 @@ public:
         endArray();
     }
 
+    // Reads a group of `size` bytes using `f`.
+    //
+    // When lazy groups are enabled, `f` is called only when the group is expanded,
+    // so it must capture everything it needs by value. Otherwise it's called immediately.
+    // In both cases, `f` cannot read past the group and the rest of the group is unsupported.
+    //
+    // A lazy group is marked as pending in ranges, since its coverage is unknown until it's parsed.
+    template <typename F>
+    void readLazyGroup(const QString &title, const QString &value, const quint32 size, F f)
+    {
+        if (atEnd(size)) {
+            throw QString("read out of bounds");
+        }
+
+        const auto start = offset();
+
+        if (!m_lazyGroups || !m_parent) {
+            const auto end = m_end;
+            m_end = m_data + size;
+            beginGroup(title, value);
+            try {
+                f(*this);
+                readUnsupported(left());
+            } catch (...) {
+                m_end = end;
+                throw;
+            }
+            m_end = end;
+            endGroup();
+            return;
+        }
+
+        // Only the group range is known until it's parsed.
+        m_ranges.offsets.push_back(start);
+        m_ranges.pending.push_back(start);
+
+        auto item = addItem(title, Range(start, start + size));
+        item->value = value;
+        item->size = Utils::prettySize(size);
+
+        const auto fileStart = m_start;
+        const auto data = m_data;
+        item->setChildrenLoader([fileStart, data, size, f](TreeItem *root){
+            // Offsets are still from the start of the file.
+            Parser parser(fileStart, data, data + size, root);
+            try {
+                f(parser);
+                parser.readUnsupported(parser.left());
+            } catch (const QString &msg) {
+                // There is no one to report to, so the error is shown as a node
+                // and the rest of the group is unsupported.
+                parser.m_parent = root;
+                parser.readValue("Error", msg, QString(), 0);
+                parser.readUnsupported(parser.left());
+            }
+        });
+
+        m_data += size;
+    }
+
     ShadowParser shadow() const
     {
         return ShadowParser(m_data, m_end);
@@ -981,11 +1194,55 @@ public:
     {
         readUnsupported(left());
         m_ranges.offsets.push_back(m_end - m_start);
+
+        if (m_computeHashes && m_parent) {
+            updateHash(m_parent);
+        }
     }
 
 private:
+    // Hashes are computed bottom-up, so a group hash depends on all its children.
+    // Leaf hashes are computed here as well, because their type is set after creation.
+    void updateHash(TreeItem *group)
+    {
+        auto hash = Hash::combine(Hash::string(group->title), Hash::string(group->type));
+        for (int i = 0; i < group->childCount(); ++i) {
+            auto child = group->child(i);
+            if (child->hash == 0) {
+                const auto bytes = Hash::bytes(m_start + child->range.start, child->range.size());
+                child->hash = Hash::combine(
+                    Hash::combine(Hash::string(child->title), Hash::string(child->type)), bytes);
+            }
+
+            hash = Hash::combine(hash, child->hash);
+        }
+
+        group->hash = hash;
+    }
+
+    template <typename T = TreeItem, typename... Args>
+    T* addItem(const QString &title, const Range range, Args&&... args)
+    {
+        m_nodesCount += 1;
+
+        if (!m_parent) {
+            return nullptr;
+        }
+
+        auto item = new T(m_parent, std::forward<Args>(args)...);
+        item->title = title;
+        item->range = range;
+        m_parent->addChild(item);
+        return item;
+    }
+
     QString cachedString(const char *str)
     {
+        // Titles are not stored in the headless mode.
+        if (!m_parent) {
+            return QString();
+        }
+
         // TTF Explorer will allocate a lot of strings. A lot. So we better cache them.
         // This optimization is used mainly to reduce memory usage,
         // because we would have a lot of duplicated strings. But it also improves performance.
@@ -1000,6 +1257,10 @@ private:
 
     QString cachedIndex(const quint32 index)
     {
+        if (!m_parent) {
+            return QString();
+        }
+
         while (index + 1 > m_indexCache.size()) {
             m_indexCache.reserve(index);
             m_indexCache.append(numberToString(m_indexCache.size()));
@@ -1009,6 +1270,15 @@ private:
     }
 
 private:
+    Parser(const quint8 *start, const quint8 *data, const quint8 *end, TreeItem *root)
+        : m_start(start)
+        , m_data(data)
+        , m_end(end)
+        , m_parent(root)
+        , m_ranges(Ranges())
+    {
+    }
+
     Q_DISABLE_COPY(Parser)
 
 private:
@@ -1017,8 +1287,12 @@ private:
     const quint8 *m_end;
     TreeItem *m_parent;
     Ranges m_ranges;
+    quint32 m_nodesCount = 0;
+    bool m_computeHashes = false;
+    bool m_lazyGroups = false;
 
     // Cache per App instance, not per type instance.
-    static QHash<const char*, QString> m_stringCache;
-    static QVector<QString> m_indexCache;
+    // Per thread, because fonts can be parsed in parallel.
+    static thread_local QHash<const char*, QString> m_stringCache;
+    static thread_local QVector<QString> m_indexCache;
 };
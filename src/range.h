@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QDebug>
+#include <QString>
 
 struct Range
 {
@@ -45,8 +46,25 @@ inline QDebug operator<<(QDebug dbg, const Range &range)
 }
 
 
+// A table record from a font directory.
+//
+// Tables shared between faces of a collection are listed for each face.
+struct TableRange
+{
+    quint32 faceIndex;
+    QString tag;
+    Range range;
+};
+
 struct Ranges
 {
+    // Start offsets of all parsed ranges. Sorted.
     std::vector<quint32> offsets;
+    // Start offsets of unsupported ranges. Sorted.
     std::vector<quint32> unsupported;
+    // Start offsets of padding ranges. Sorted.
+    std::vector<quint32> padding;
+    // Start offsets of lazy groups, which are not parsed yet. Sorted.
+    std::vector<quint32> pending;
+    std::vector<TableRange> tables;
 };
@@ -0,0 +1,270 @@
+#include <QGuiApplication>
+#include <QPainter>
+#include <QRunnable>
+#include <QSvgRenderer>
+#include <QVBoxLayout>
+
+// Qt bundled zlib, when available. See app.pro.
+#include <zlib.h>
+
+#include "svgview.h"
+#include "utils.h"
+
+static const int MaxPreviewSize = 256;
+// Protects from gzip bombs.
+static const int MaxDocumentSize = 64 * 1024 * 1024;
+
+static QByteArray inflateGzip(const uchar *data, const quint32 size, QString &error)
+{
+    z_stream stream = {};
+    stream.next_in = const_cast<Bytef*>(data);
+    stream.avail_in = size;
+
+    // Accept only the gzip format.
+    if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) {
+        error = "Failed to initialize zlib";
+        return QByteArray();
+    }
+
+    const int chunkSize = 64 * 1024;
+    QByteArray result;
+    int status = Z_OK;
+    while (status == Z_OK) {
+        if (result.size() >= MaxDocumentSize) {
+            error = QString("Decompressed data is larger than %1").arg(Utils::prettySize(MaxDocumentSize));
+            break;
+        }
+
+        const auto pos = result.size();
+        result.resize(pos + chunkSize);
+        stream.next_out = reinterpret_cast<Bytef*>(result.data() + pos);
+        stream.avail_out = chunkSize;
+        status = inflate(&stream, Z_NO_FLUSH);
+        result.resize(pos + chunkSize - int(stream.avail_out));
+    }
+
+    if (error.isEmpty() && status != Z_STREAM_END) {
+        error = stream.msg ? QString("Invalid gzip data: %1").arg(stream.msg) : QString("Truncated gzip data");
+    }
+
+    inflateEnd(&stream);
+    return result;
+}
+
+// Renders the document view box. Documents without one are not rendered,
+// because glyphs are usually placed above the origin.
+static QImage renderSvg(const QByteArray &svg, const qreal pixelRatio)
+{
+    QSvgRenderer renderer(svg);
+    const auto viewBox = renderer.viewBoxF();
+    if (!renderer.isValid() || viewBox.isEmpty()) {
+        return QImage();
+    }
+
+    const auto size = (viewBox.size().scaled(MaxPreviewSize, MaxPreviewSize, Qt::KeepAspectRatio) * pixelRatio).toSize();
+    if (size.isEmpty()) {
+        return QImage();
+    }
+
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    image.setDevicePixelRatio(pixelRatio);
+
+    QPainter painter(&image);
+    renderer.render(&painter, QRectF(QPointF(), QSizeF(size) / pixelRatio));
+    return image;
+}
+
+class SvgDecodeTask : public QRunnable
+{
+public:
+    SvgDecodeTask(SvgDecoder *decoder, const quint64 generation, const TreeItem *item,
+                  const uchar *data, const quint32 size, const qreal pixelRatio)
+        : m_decoder(decoder)
+        , m_generation(generation)
+        , m_item(item)
+        , m_compressed(item->type == Parser::SvgzType)
+        , m_data(data)
+        , m_size(size)
+        , m_pixelRatio(pixelRatio)
+    {
+    }
+
+    void run() override
+    {
+        SvgDecoder::Document document;
+
+        QByteArray svg;
+        if (m_compressed) {
+            svg = inflateGzip(m_data, m_size, document.error);
+        } else {
+            // The data would not be copied.
+            svg = QByteArray::fromRawData(reinterpret_cast<const char *>(m_data), int(m_size));
+        }
+
+        document.size = quint32(svg.size());
+        document.text = QString::fromUtf8(svg);
+        if (document.error.isEmpty()) {
+            document.image = renderSvg(svg, m_pixelRatio);
+        }
+
+        // The decoder waits for all tasks before the data is reset, so both are still alive here.
+        const auto decoder = m_decoder;
+        const auto generation = m_generation;
+        const auto item = m_item;
+        QMetaObject::invokeMethod(decoder, [decoder, generation, item, document]{
+            decoder->onDecoded(generation, item, document);
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    SvgDecoder * const m_decoder;
+    const quint64 m_generation;
+    const TreeItem * const m_item;
+    const bool m_compressed;
+    const uchar * const m_data;
+    const quint32 m_size;
+    const qreal m_pixelRatio;
+};
+
+SvgDecoder::SvgDecoder(QObject *parent)
+    : QObject(parent)
+    , m_documents(32 * 1024)
+{
+    // Only the selected document is decoded.
+    m_pool.setMaxThreadCount(1);
+}
+
+SvgDecoder::~SvgDecoder()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+void SvgDecoder::setData(const uchar *data, const quint32 size)
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+
+    m_data = data;
+    m_size = size;
+    m_generation += 1;
+    m_documents.clear();
+    m_pending.clear();
+}
+
+bool SvgDecoder::document(const TreeItem *item, Document &document)
+{
+    const auto key = item->range.start;
+    if (const auto cached = m_documents.object(key)) {
+        document = *cached;
+        return true;
+    }
+
+    if (!m_data || item->range.end > m_size || m_pending.contains(key)) {
+        return false;
+    }
+
+    // Previously selected documents are not needed anymore.
+    // A running task will still finish and its result will be cached.
+    m_pool.clear();
+    m_pending.clear();
+
+    m_pending.insert(key);
+    m_pool.start(new SvgDecodeTask(this, m_generation, item, m_data + key, item->range.size(),
+                                   qApp->devicePixelRatio()));
+    return false;
+}
+
+void SvgDecoder::onDecoded(const quint64 generation, const TreeItem *item, const Document &document)
+{
+    if (generation != m_generation) {
+        return;
+    }
+
+    // Failed documents are cached as well, so they are not decoded again.
+    m_pending.remove(item->range.start);
+    const auto bytes = qint64(document.text.size()) * 2 + document.image.sizeInBytes();
+    const auto cost = int(std::min(std::max(qint64(1), bytes / 1024), qint64(m_documents.maxCost())));
+    m_documents.insert(item->range.start, new Document(document), cost);
+    emit decoded(item);
+}
+
+SvgPreview::SvgPreview(SvgDecoder *decoder, QWidget *parent)
+    : QWidget(parent)
+    , m_decoder(decoder)
+    , m_lblImage(new QLabel)
+    , m_lblInfo(new QLabel)
+    , m_textEdit(new QPlainTextEdit)
+{
+    auto lay = new QVBoxLayout(this);
+    lay->addWidget(m_lblImage);
+    lay->addWidget(m_lblInfo);
+    lay->addWidget(m_textEdit, 1);
+
+    m_lblImage->setAlignment(Qt::AlignCenter);
+    m_lblImage->setMinimumSize(MaxPreviewSize / 2, MaxPreviewSize / 2);
+    m_lblInfo->setAlignment(Qt::AlignCenter);
+    m_lblInfo->setWordWrap(true);
+    m_textEdit->setReadOnly(true);
+    m_textEdit->setLineWrapMode(QPlainTextEdit::NoWrap);
+    m_textEdit->setFont(QFont(Utils::monospacedFont()));
+
+    connect(decoder, &SvgDecoder::decoded, this, &SvgPreview::onDecoded);
+
+    setItem(nullptr);
+}
+
+void SvgPreview::setItem(const TreeItem *item)
+{
+    const auto isSvg = item && (item->type == Parser::SvgType || item->type == Parser::SvgzType);
+    m_item = isSvg ? item : nullptr;
+
+    m_lblImage->clear();
+    m_lblInfo->clear();
+    m_textEdit->clear();
+
+    if (!m_item) {
+        m_lblImage->setText("No SVG document selected");
+        return;
+    }
+
+    SvgDecoder::Document document;
+    if (m_decoder->document(m_item, document)) {
+        showDocument(document);
+    } else {
+        m_lblImage->setText(m_item->type == Parser::SvgzType ? "Decompressing..." : "Rendering...");
+    }
+}
+
+void SvgPreview::onDecoded(const TreeItem *item)
+{
+    SvgDecoder::Document document;
+    if (item == m_item && m_decoder->document(item, document)) {
+        showDocument(document);
+    }
+}
+
+void SvgPreview::showDocument(const SvgDecoder::Document &document)
+{
+    if (!document.image.isNull()) {
+        m_lblImage->setPixmap(QPixmap::fromImage(document.image));
+    } else {
+        m_lblImage->setText(document.error.isEmpty() ? "Cannot be rendered" : "Failed to decompress");
+    }
+
+    QString info;
+    if (m_item->type == Parser::SvgzType) {
+        info = QString("%1 compressed, %2 decompressed")
+            .arg(Utils::prettySize(m_item->range.size())).arg(Utils::prettySize(document.size));
+    } else {
+        info = Utils::prettySize(document.size);
+    }
+
+    if (!document.error.isEmpty()) {
+        info += '\n' + document.error;
+    }
+
+    m_lblInfo->setText(info);
+    m_textEdit->setPlainText(document.text);
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QCache>
+#include <QImage>
+#include <QLabel>
+#include <QPlainTextEdit>
+#include <QSet>
+#include <QThreadPool>
+
+#include "parser.h"
+#include "treeitem.h"
+
+class SvgDecodeTask;
+
+// Inflates and renders SVG documents on a worker thread.
+//
+// Documents are decoded only when requested, directly from the mapped file.
+// Items are identified by their offset, so the cache doesn't depend on the tree.
+class SvgDecoder : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Document
+    {
+        QString text;
+        // Null when the document cannot be rendered.
+        QImage image;
+        QString error;
+        quint32 size = 0;
+    };
+
+    explicit SvgDecoder(QObject *parent = nullptr);
+    ~SvgDecoder();
+
+    // Waits for running tasks and drops all cached documents.
+    // The data must outlive the decoder or be reset with nullptr.
+    void setData(const uchar *data, const quint32 size);
+
+    // Returns true when the item was decoded.
+    // Otherwise, decoding is scheduled and decoded() is emitted when it's done.
+    // Only the latest request is kept in the queue.
+    bool document(const TreeItem *item, Document &document);
+
+signals:
+    void decoded(const TreeItem *item);
+
+private:
+    friend class SvgDecodeTask;
+
+    void onDecoded(const quint64 generation, const TreeItem *item, const Document &document);
+
+private:
+    const uchar *m_data = nullptr;
+    quint32 m_size = 0;
+    // Results for previous data are ignored.
+    quint64 m_generation = 0;
+    QThreadPool m_pool;
+    // The key is an item offset. The cost is in KiB.
+    QCache<quint32, Document> m_documents;
+    QSet<quint32> m_pending;
+};
+
+// Shows the source and a rendering of the selected SVG document node.
+class SvgPreview : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit SvgPreview(SvgDecoder *decoder, QWidget *parent = nullptr);
+
+    // Accepts any item. The item must outlive the preview or be reset with nullptr.
+    void setItem(const TreeItem *item);
+
+private:
+    void onDecoded(const TreeItem *item);
+    void showDocument(const SvgDecoder::Document &document);
+
+private:
+    SvgDecoder * const m_decoder;
+    QLabel * const m_lblImage;
+    QLabel * const m_lblInfo;
+    QPlainTextEdit * const m_textEdit;
+    const TreeItem *m_item = nullptr;
+};
@@ -1,3 +1,7 @@
+#include <QStringList>
+
+#include <array>
+
 #include "aat-common.h"
 #include "src/parser.h"
 #include "src/algo.h"
@@ -29,35 +33,90 @@ static void parseAatBinarySearchTable(const quint16 format, Parser &parser, F f)
     parser.endGroup();
 }
 
-QVector<quint32> parseAatLookup(const quint16 numberOfGlyphs, Parser &parser)
+static QString lookupValueTitle(const AatLookupValue valueType)
+{
+    switch (valueType) {
+    case AatLookupValue::Offset: return "Offset";
+    case AatLookupValue::Class: return "Class";
+    case AatLookupValue::Glyph: return "Glyph";
+    case AatLookupValue::Value: return "Value";
+    }
+
+    Q_UNREACHABLE();
+}
+
+static QString lookupValuesTitle(const AatLookupValue valueType)
+{
+    switch (valueType) {
+    case AatLookupValue::Offset: return "Offsets";
+    case AatLookupValue::Class: return "Classes";
+    case AatLookupValue::Glyph: return "Glyphs";
+    case AatLookupValue::Value: return "Values";
+    }
+
+    Q_UNREACHABLE();
+}
+
+// `T` is either UInt16 or UInt32.
+template <typename T, typename Title>
+static quint32 readLookupValue(const AatLookupValue valueType, const Title &title, Parser &parser)
+{
+    switch (valueType) {
+    case AatLookupValue::Offset: {
+        if (T::Size == 2) {
+            return parser.read<Offset16>(title);
+        } else {
+            return parser.read<Offset32>(title);
+        }
+    }
+    case AatLookupValue::Glyph: {
+        if (T::Size == 2) {
+            return parser.read<GlyphId>(title);
+        } else {
+            return parser.read<UInt32>(title);
+        }
+    }
+    case AatLookupValue::Class:
+    case AatLookupValue::Value: {
+        return parser.read<T>(title);
+    }
+    }
+
+    Q_UNREACHABLE();
+}
+
+template <typename T>
+static QVector<quint32> parseLookupTable(const QString &title, const quint16 numberOfGlyphs,
+                                         const AatLookupValue valueType, Parser &parser)
 {
     const auto start = parser.offset();
+    const auto valueTitle = lookupValueTitle(valueType);
+    const auto valuesTitle = lookupValuesTitle(valueType);
 
-    QVector<quint32> offsets;
+    QVector<quint32> values;
 
-    parser.beginGroup("Lookup Table");
+    parser.beginGroup(title);
     const auto format = parser.read<UInt16>("Format");
-    // TODO: format 10
     switch (format) {
     case 0: {
-        parser.readArray("Offsets", numberOfGlyphs, [&](const auto index){
-            offsets << (quint32)parser.read<Offset16>(index);
+        parser.readArray(valuesTitle, numberOfGlyphs, [&](const auto index){
+            values << readLookupValue<T>(valueType, index, parser);
         });
         break;
     }
     case 2: {
-        parseAatBinarySearchTable(format, parser, [&offsets](const quint32 index, Parser &p) {
+        parseAatBinarySearchTable(format, parser, [&](const quint32 index, Parser &p) {
             p.beginGroup(index);
             const quint32 last = p.read<UInt16>("Last glyph");
             p.read<UInt16>("First glyph");
-            const quint32 offset = p.read<Offset16>("Offset");
+            const auto value = readLookupValue<T>(valueType, valueTitle, p);
             p.endGroup();
 
             if (last == 0xFFFF) {
                 return;
             }
 
-            offsets << offset;
+            values << value;
         });
         break;
     }
@@ -88,32 +147,49 @@ QVector<quint32> parseAatLookup(const quint16 numberOfGlyphs, Parser &parser)
         algo::sort_all_by_key(localOffsets, &Data::offset);
         for (const auto offset : localOffsets) {
             parser.advanceTo(start + offset.offset);
-            parser.readArray("Offsets", offset.count, [&](const auto index){
-                offsets << (quint32)parser.read<Offset16>(index);
+            parser.readArray(valuesTitle, offset.count, [&](const auto index){
+                values << readLookupValue<T>(valueType, index, parser);
             });
         }
         break;
     }
     case 6: {
-        parseAatBinarySearchTable(format, parser, [&offsets](const quint32 index, Parser &p) {
+        parseAatBinarySearchTable(format, parser, [&](const quint32 index, Parser &p) {
             p.beginGroup(index);
-            p.read<UInt16>("Glyph");
-            const quint32 offset = p.read<Offset16>("Offset");
+            const quint32 glyph = p.read<UInt16>("Glyph");
+            const auto value = readLookupValue<T>(valueType, valueTitle, p);
             p.endGroup();
 
-            if (offset == 0xFFFF) {
+            // The last segment is a sentinel, which is identified by the glyph.
+            // Its value is usually 0, while 0xFFFF is a valid value of a regular segment,
+            // so checking the value instead would keep the sentinel and drop real values.
+            if (glyph == 0xFFFF) {
                 return;
             }
 
-            offsets << offset;
+            values << value;
         });
         break;
     }
     case 8: {
         parser.read<UInt16>("First glyph");
         const auto count = parser.read<UInt16>("Glyph count");
-        parser.readArray("Offsets", count, [&](const auto index){
-            offsets << (quint32)parser.read<Offset16>(index);
+        parser.readArray(valuesTitle, count, [&](const auto index){
+            values << readLookupValue<T>(valueType, index, parser);
+        });
+        break;
+    }
+    case 10: {
+        const auto unitSize = parser.read<UInt16>("Value size");
+        parser.read<UInt16>("First glyph");
+        const auto count = parser.read<UInt16>("Glyph count");
+        parser.readArray(valuesTitle, count, [&](const auto index){
+            switch (unitSize) {
+            case 1: values << parser.read<UInt8>(index); break;
+            case 2: values << readLookupValue<UInt16>(valueType, index, parser); break;
+            case 4: values << readLookupValue<UInt32>(valueType, index, parser); break;
+            default: throw QString("unsupported lookup value size");
+            }
         });
         break;
     }
@@ -122,6 +198,313 @@ QVector<quint32> parseAatLookup(const quint16 numberOfGlyphs, Parser &parser)
     }
     parser.endGroup();
 
+    return values;
+}
+
+QVector<quint32> parseAatLookup(const quint16 numberOfGlyphs, Parser &parser)
+{
+    auto offsets = parseLookupTable<UInt16>("Lookup Table", numberOfGlyphs, AatLookupValue::Offset, parser);
     algo::sort_all(offsets);
     return offsets;
 }
+
+void parseAatLookup(const QString &title, const quint16 numberOfGlyphs, const AatLookupValue valueType,
+                    const bool longValues, Parser &parser)
+{
+    if (longValues) {
+        parseLookupTable<UInt32>(title, numberOfGlyphs, valueType, parser);
+    } else {
+        parseLookupTable<UInt16>(title, numberOfGlyphs, valueType, parser);
+    }
+}
+
+AatLookup collectAatLookup(const quint16 numberOfGlyphs, ShadowParser &parser)
+{
+    const auto start = parser.offset();
+
+    AatLookup lookup;
+    lookup.m_values.fill(AatLookup::NoValue, numberOfGlyphs);
+
+    const auto format = parser.read<UInt16>();
+    switch (format) {
+    case 0: {
+        for (quint32 glyphId = 0; glyphId < numberOfGlyphs; ++glyphId) {
+            lookup.set(glyphId, parser.read<UInt16>());
+        }
+        break;
+    }
+    case 2:
+    case 4:
+    case 6: {
+        const auto segmentSize = parser.read<UInt16>();
+        const auto numberOfSegments = parser.read<UInt16>();
+        parser.skip<UInt16>(); // Search range
+        parser.skip<UInt16>(); // Entry selector
+        parser.skip<UInt16>(); // Range shift
+
+        const auto segmentsStart = parser.offset();
+        for (quint32 i = 0; i < numberOfSegments; ++i) {
+            parser.jumpTo(segmentsStart + i * segmentSize);
+            if (format == 6) {
+                const quint32 glyphId = parser.read<UInt16>();
+                lookup.set(glyphId, parser.read<UInt16>());
+                continue;
+            }
+
+            const quint32 last = parser.read<UInt16>();
+            const quint32 first = parser.read<UInt16>();
+            const quint32 value = parser.read<UInt16>();
+            if (last == 0xFFFF || last < first) {
+                continue;
+            }
+
+            if (format == 2) {
+                for (quint32 glyphId = first; glyphId <= last; ++glyphId) {
+                    lookup.set(glyphId, value);
+                }
+            } else {
+                parser.jumpTo(start + value);
+                for (quint32 glyphId = first; glyphId <= last; ++glyphId) {
+                    lookup.set(glyphId, parser.read<UInt16>());
+                }
+            }
+        }
+        break;
+    }
+    case 8:
+    case 10: {
+        const quint16 unitSize = format == 10 ? quint16(parser.read<UInt16>()) : quint16(2);
+        const quint32 first = parser.read<UInt16>();
+        const quint32 count = parser.read<UInt16>();
+        for (quint32 glyphId = first; glyphId < first + count; ++glyphId) {
+            switch (unitSize) {
+            case 1: lookup.set(glyphId, parser.read<UInt8>()); break;
+            case 2: lookup.set(glyphId, parser.read<UInt16>()); break;
+            case 4: lookup.set(glyphId, parser.read<UInt32>()); break;
+            default: throw QString("unsupported lookup value size");
+            }
+        }
+        break;
+    }
+    default:
+        throw QString("unsupported lookup table format");
+    }
+
+    return lookup;
+}
+
+static QString stateName(const quint32 state)
+{
+    switch (state) {
+    case 0: return "Start of text";
+    case 1: return "Start of line";
+    default: return QString();
+    }
+}
+
+// Lists glyphs of each class, so a state array can be read without the class table.
+static QVector<QString> collectClassTitles(const AatLookup &lookup, const quint16 numberOfGlyphs,
+                                           const quint32 numberOfClasses)
+{
+    const int maxRanges = 3;
+
+    struct GlyphRange {
+        quint16 first;
+        quint16 last;
+    };
+    QVector<QVector<GlyphRange>> ranges(static_cast<int>(numberOfClasses));
+    QVector<int> numberOfRanges(static_cast<int>(numberOfClasses));
+    for (quint32 glyphId = 0; glyphId < numberOfGlyphs; ++glyphId) {
+        // Glyphs without a class are out of bounds.
+        const auto glyphClass = lookup.value(quint16(glyphId), 1);
+        if (glyphClass < 4 || glyphClass >= numberOfClasses) {
+            continue;
+        }
+
+        auto &classRanges = ranges[int(glyphClass)];
+        if (!classRanges.isEmpty() && classRanges.last().last + 1 == glyphId) {
+            classRanges.last().last = quint16(glyphId);
+            continue;
+        }
+
+        numberOfRanges[int(glyphClass)] += 1;
+        if (classRanges.size() < maxRanges) {
+            classRanges.append({ quint16(glyphId), quint16(glyphId) });
+        }
+    }
+
+    static const std::array<QString, 4> predefined = {{
+        QLatin1String("End of text"),
+        QLatin1String("Out of bounds"),
+        QLatin1String("Deleted glyph"),
+        QLatin1String("End of line"),
+    }};
+
+    QVector<QString> titles;
+    titles.reserve(int(numberOfClasses));
+    for (quint32 i = 0; i < numberOfClasses; ++i) {
+        if (i < predefined.size()) {
+            titles << predefined[i];
+            continue;
+        }
+
+        QStringList glyphs;
+        for (const auto &range : ranges[int(i)]) {
+            if (range.first == range.last) {
+                glyphs << numberToString(range.first);
+            } else {
+                glyphs << QString("%1-%2").arg(range.first).arg(range.last);
+            }
+        }
+
+        if (numberOfRanges[int(i)] > maxRanges) {
+            glyphs << "...";
+        }
+
+        if (glyphs.isEmpty()) {
+            titles << QString("Class %1").arg(i);
+        } else {
+            titles << QString("Class %1 (%2)").arg(i).arg(glyphs.join(", "));
+        }
+    }
+
+    return titles;
+}
+
+AatStateTable parseAatStateTableHeader(const quint16 numberOfGlyphs, const quint32 size,
+                                       const quint32 entrySize, Parser &parser)
+{
+    auto shadow = parser.shadow();
+
+    AatStateTable table;
+    table.start = parser.offset();
+    table.numberOfClasses = parser.read<UInt32>("Number of classes");
+    table.classTableOffset = parser.read<Offset32>("Offset to class table");
+    table.stateArrayOffset = parser.read<Offset32>("Offset to state array");
+    table.entryTableOffset = parser.read<Offset32>("Offset to entry table");
+
+    // Class values are 16-bit.
+    if (table.numberOfClasses < 4 || table.numberOfClasses > 0xFFFF) {
+        throw QString("invalid number of classes");
+    }
+
+    // The number of states and entries is not stored, so we have to follow entries
+    // from the start of text and the start of line states.
+    // Each state and each entry is read once.
+    const quint64 rowSize = quint64(table.numberOfClasses) * UInt16::Size;
+    quint32 numberOfStates = 2;
+    quint32 numberOfEntries = 0;
+    quint32 checkedStates = 0;
+    quint32 checkedEntries = 0;
+    while (checkedStates < numberOfStates) {
+        if (table.stateArrayOffset + numberOfStates * rowSize > size) {
+            throw QString("invalid state machine");
+        }
+
+        shadow.jumpTo(table.stateArrayOffset + quint32(checkedStates * rowSize));
+        for (quint64 i = checkedStates * rowSize; i < numberOfStates * rowSize; i += UInt16::Size) {
+            numberOfEntries = qMax(numberOfEntries, quint32(shadow.read<UInt16>()) + 1);
+        }
+        checkedStates = numberOfStates;
+
+        if (table.entryTableOffset + quint64(numberOfEntries) * entrySize > size) {
+            throw QString("invalid state machine");
+        }
+
+        for (quint32 i = checkedEntries; i < numberOfEntries; ++i) {
+            shadow.jumpTo(table.entryTableOffset + i * entrySize);
+            numberOfStates = qMax(numberOfStates, quint32(shadow.read<UInt16>()) + 1);
+        }
+        checkedEntries = numberOfEntries;
+    }
+
+    table.numberOfStates = numberOfStates;
+    table.numberOfEntries = numberOfEntries;
+
+    shadow.jumpTo(table.classTableOffset);
+    const auto classes = collectAatLookup(numberOfGlyphs, shadow);
+    table.classTitles = collectClassTitles(classes, numberOfGlyphs, table.numberOfClasses);
+
+    return table;
+}
+
+void parseAatTableParts(const quint32 start, const quint32 size, QVector<AatTablePart> parts, Parser &parser)
+{
+    std::stable_sort(parts.begin(), parts.end(), [](const auto &a, const auto &b){
+        return a.offset < b.offset;
+    });
+
+    for (int i = 0; i < parts.size(); ++i) {
+        const auto &part = parts[i];
+        if (part.offset >= size) {
+            throw QString("offset is out of bounds");
+        }
+
+        auto end = size;
+        for (int j = i + 1; j < parts.size(); ++j) {
+            if (parts[j].offset > part.offset) {
+                end = parts[j].offset;
+                break;
+            }
+        }
+
+        parser.padTo(start + part.offset);
+        part.parse(end - part.offset);
+    }
+}
+
+void parseAatStateTable(const quint16 numberOfGlyphs, const AatStateTable &table, const quint32 size,
+                        const std::function<void()> &parseEntry,
+                        QVector<AatTablePart> parts, Parser &parser)
+{
+    parts.append({ table.classTableOffset, [&](const quint32 /*size*/){
+        parseAatLookup("Class Table", numberOfGlyphs, AatLookupValue::Class, false, parser);
+    }});
+    parts.append({ table.stateArrayOffset, [&](const quint32 /*size*/){
+        parser.readArray("State Array", table.numberOfStates, [&](const auto index){
+            parser.beginGroup(index);
+            for (const auto &title : table.classTitles) {
+                parser.read<UInt16>(title);
+            }
+            parser.endGroup(QString(), stateName(index));
+        });
+    }});
+    parts.append({ table.entryTableOffset, [&](const quint32 /*size*/){
+        parser.readArray("Entries", table.numberOfEntries, [&](const auto index){
+            parser.beginGroup(index);
+            parser.read<UInt16>("Next state");
+            parseEntry();
+            parser.endGroup();
+        });
+    }});
+
+    parseAatTableParts(table.start, size, std::move(parts), parser);
+}
+
+void parseAatSubtableGlyphCoverage(const quint16 numberOfGlyphs, const quint32 numberOfSubtables,
+                                   const quint32 end, Parser &parser)
+{
+    if (parser.offset() >= end) {
+        return;
+    }
+
+    const auto start = parser.offset();
+
+    parser.beginGroup("Subtable Glyph Coverage");
+
+    QVector<quint32> offsets;
+    parser.readArray("Offsets", numberOfSubtables, [&](const auto index){
+        offsets << parser.read<Offset32>(index);
+    });
+
+    algo::sort_all(offsets);
+    algo::dedup_vector(offsets);
+
+    const quint32 bitfieldSize = (quint32(numberOfGlyphs) + 7) / 8;
+    parser.readArray("Coverage", offsets.size(), [&](const auto index){
+        parser.advanceTo(start + offsets[index]);
+        parser.readBytes(numberToString(index), bitfieldSize);
+    });
+
+    parser.endGroup();
+}
@@ -1,7 +1,108 @@
 #pragma once
 
+#include <QString>
 #include <QVector>
 
+#include <functional>
+
 class Parser;
+class ShadowParser;
+
+// The meaning of lookup table values. Affects only how they are displayed.
+enum class AatLookupValue
+{
+    Offset,
+    Class,
+    Glyph,
+    Value,
+};
 
+// Parses a lookup table with 16-bit offsets. Returns sorted offsets.
 QVector<quint32> parseAatLookup(const quint16 numberOfGlyphs, Parser &parser);
+
+// Parses a lookup table with 16-bit or 32-bit values into a group with `title`.
+// Format 10 stores its own value size.
+void parseAatLookup(const QString &title, const quint16 numberOfGlyphs, const AatLookupValue valueType,
+                    const bool longValues, Parser &parser);
+
+// A lookup table decoded into a glyph to value array.
+//
+// Segments and binary search tables are walked once, so repeated queries are cheap.
+class AatLookup
+{
+public:
+    quint32 value(const quint16 glyphId, const quint32 defaultValue) const
+    {
+        if (glyphId < m_values.size() && m_values[glyphId] != NoValue) {
+            return m_values[glyphId];
+        }
+
+        return defaultValue;
+    }
+
+private:
+    friend AatLookup collectAatLookup(const quint16 numberOfGlyphs, ShadowParser &parser);
+
+    void set(const quint32 glyphId, const quint32 value)
+    {
+        if (glyphId < quint32(m_values.size())) {
+            m_values[int(glyphId)] = value;
+        }
+    }
+
+    static constexpr quint32 NoValue = 0xFFFFFFFF;
+
+    QVector<quint32> m_values;
+};
+
+// `parser` must be positioned at the start of a lookup table with 16-bit values.
+AatLookup collectAatLookup(const quint16 numberOfGlyphs, ShadowParser &parser);
+
+// An extended state table header, used by `morx` and `kerx`.
+struct AatStateTable
+{
+    // An absolute offset of the header. Other offsets are from the header.
+    quint32 start = 0;
+    quint32 numberOfClasses = 0;
+    quint32 classTableOffset = 0;
+    quint32 stateArrayOffset = 0;
+    quint32 entryTableOffset = 0;
+    // Not stored in a font. Detected by following entries from the initial states.
+    quint32 numberOfStates = 0;
+    quint32 numberOfEntries = 0;
+    // Class titles for the state array, with glyphs of each class.
+    QVector<QString> classTitles;
+};
+
+// Reads an extended state table header.
+//
+// `size` is the number of bytes from the header to the end of the subtable.
+// `entrySize` includes the next state and flags.
+AatStateTable parseAatStateTableHeader(const quint16 numberOfGlyphs, const quint32 size,
+                                       const quint32 entrySize, Parser &parser);
+
+// A part of a subtable referenced by an offset.
+//
+// AAT subtables do not store sizes of their arrays,
+// so an array usually ends where the next part starts.
+struct AatTablePart
+{
+    quint32 offset;
+    // Receives the number of bytes before the next part or the end of the subtable.
+    std::function<void(quint32 size)> parse;
+};
+
+// Parses `parts` in the file order. Offsets are from `start` and `size` is the size of the subtable.
+void parseAatTableParts(const quint32 start, const quint32 size, QVector<AatTablePart> parts, Parser &parser);
+
+// Parses the class table, the state array, the entry table and `parts` in the file order.
+// Offsets of `parts` are from the state table header.
+//
+// `parseEntry` reads entry fields after the next state.
+void parseAatStateTable(const quint16 numberOfGlyphs, const AatStateTable &table, const quint32 size,
+                        const std::function<void()> &parseEntry,
+                        QVector<AatTablePart> parts, Parser &parser);
+
+// Parses an optional subtable glyph coverage table of `morx` and `kerx` version 3.
+void parseAatSubtableGlyphCoverage(const quint16 numberOfGlyphs, const quint32 numberOfSubtables,
+                                   const quint32 end, Parser &parser);
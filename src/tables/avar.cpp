@@ -1,4 +1,5 @@
 #include "tables.h"
+#include "varstore.h"
 
 void parseAvar(Parser &parser)
 {
@@ -23,3 +24,61 @@ void parseAvar(Parser &parser)
         parser.endGroup();
     });
 }
+
+QVector<AxisSegmentMap> collectAvar(ShadowParser &parser)
+{
+    const quint16 majorVersion = parser.read<UInt16>();
+    const quint16 minorVersion = parser.read<UInt16>();
+    if (!(majorVersion == 1 && minorVersion == 0)) {
+        throw QString("invalid table version");
+    }
+
+    parser.skip<UInt16>(); // reserved
+    const quint16 axisCount = parser.read<UInt16>();
+
+    QVector<AxisSegmentMap> maps;
+    for (quint16 i = 0; i < axisCount; ++i) {
+        AxisSegmentMap map;
+        const quint16 pairsCount = parser.read<UInt16>();
+        for (quint16 j = 0; j < pairsCount; ++j) {
+            map.fromCoordinates << float(parser.read<F2DOT14>());
+            map.toCoordinates << float(parser.read<F2DOT14>());
+        }
+        maps << map;
+    }
+
+    return maps;
+}
+
+float AxisSegmentMap::map(const float value) const
+{
+    const auto count = fromCoordinates.size();
+    if (count == 0) {
+        return value;
+    }
+
+    // Values outside of the map are shifted by the nearest mapping.
+    if (value <= fromCoordinates.first()) {
+        return value + toCoordinates.first() - fromCoordinates.first();
+    }
+
+    if (value >= fromCoordinates.last()) {
+        return value + toCoordinates.last() - fromCoordinates.last();
+    }
+
+    for (int i = 1; i < count; ++i) {
+        if (value == fromCoordinates[i]) {
+            return toCoordinates[i];
+        }
+
+        if (value < fromCoordinates[i]) {
+            const auto from1 = fromCoordinates[i - 1];
+            const auto from2 = fromCoordinates[i];
+            const auto to1 = toCoordinates[i - 1];
+            const auto to2 = toCoordinates[i];
+            return to1 + (value - from1) * (to2 - to1) / (from2 - from1);
+        }
+    }
+
+    return value;
+}
@@ -1,28 +1,50 @@
 #include "src/algo.h"
 #include "src/tables/tables.h"
 
-static void parseSbitSmallGlyphMetrics(Parser &parser)
+struct SbitSize
 {
-    parser.read<UInt8>("Height");
-    parser.read<UInt8>("Width");
+    quint8 width;
+    quint8 height;
+};
+
+static SbitSize parseSbitSmallGlyphMetrics(Parser &parser)
+{
+    const auto height = parser.read<UInt8>("Height");
+    const auto width = parser.read<UInt8>("Width");
     parser.read<Int8>("X-axis bearing");
     parser.read<Int8>("Y-axis bearing");
     parser.read<UInt8>("Advance");
+    return { width, height };
 }
 
-static void parseSbitBigGlyphMetrics(Parser &parser)
+static SbitSize parseSbitBigGlyphMetrics(Parser &parser)
 {
-    parser.read<UInt8>("Height");
-    parser.read<UInt8>("Width");
+    const auto height = parser.read<UInt8>("Height");
+    const auto width = parser.read<UInt8>("Width");
     parser.read<Int8>("Horizontal X-axis bearing");
     parser.read<Int8>("Horizontal Y-axis bearing");
     parser.read<UInt8>("Horizontal advance");
     parser.read<Int8>("Vertical X-axis bearing");
     parser.read<Int8>("Vertical Y-axis bearing");
     parser.read<UInt8>("Vertical advance");
+    return { width, height };
+}
+
+static void readRawBitmap(const BitmapInfo::Format format, const SbitSize size, const quint8 bitDepth,
+                          const quint32 length, Parser &parser)
+{
+    BitmapInfo info;
+    info.format = format;
+    info.width = size.width;
+    info.height = size.height;
+    info.bitDepth = bitDepth;
+
+    const auto title = format == BitmapInfo::Format::ByteAligned
+        ? "Byte-aligned bitmap data" : "Bit-aligned bitmap data";
+    parser.readBitmap(title, info, length);
 }
 
-void parseCbdt(const QVector<CblcIndex> &cblcLocations, Parser &parser)
+void parseCbdt(const CblcIndex &cblcIndex, const GlyphNames &glyphNames, Parser &parser)
 {
     const auto start = parser.offset();
 
@@ -33,24 +55,33 @@ void parseCbdt(const QVector<CblcIndex> &cblcLocations, Parser &parser)
         throw QString("invalid table version");
     }
 
-    for (const auto &loca : cblcLocations) {
+    for (const auto &loca : cblcIndex.dataLocations()) {
+        // Overlapping bitmaps are malformed and cannot be shown in the tree.
+        if (start + loca.range.start < parser.offset()) {
+            continue;
+        }
+
         parser.advanceTo(start + loca.range.start);
-        parser.beginGroup(QString("Bitmap Format %1").arg(loca.imageFormat));
+        parser.beginGroup(glyphNames.title(loca.glyphId),
+                          QString("Strike %1, format %2").arg(loca.strike).arg(loca.imageFormat));
 
+        using Format = BitmapInfo::Format;
         if (loca.imageFormat == 1) {
-            parseSbitSmallGlyphMetrics(parser);
-            parser.readBytes("Byte-aligned bitmap data", loca.range.size() - 5);
+            const auto size = parseSbitSmallGlyphMetrics(parser);
+            readRawBitmap(Format::ByteAligned, size, loca.bitDepth, loca.range.size() - 5, parser);
         } else if (loca.imageFormat == 2) {
-            parseSbitSmallGlyphMetrics(parser);
-            parser.readBytes("Bit-aligned bitmap data", loca.range.size() - 5);
+            const auto size = parseSbitSmallGlyphMetrics(parser);
+            readRawBitmap(Format::BitAligned, size, loca.bitDepth, loca.range.size() - 5, parser);
         } else if (loca.imageFormat == 5) {
-            parser.readBytes("Bit-aligned bitmap data", loca.range.size() - 5);
+            // Metrics are stored in the index subtable.
+            const SbitSize size = { loca.width, loca.height };
+            readRawBitmap(Format::BitAligned, size, loca.bitDepth, loca.range.size(), parser);
         } else if (loca.imageFormat == 6) {
-            parseSbitBigGlyphMetrics(parser);
-            parser.readBytes("Byte-aligned bitmap data", loca.range.size() - 8);
+            const auto size = parseSbitBigGlyphMetrics(parser);
+            readRawBitmap(Format::ByteAligned, size, loca.bitDepth, loca.range.size() - 8, parser);
         } else if (loca.imageFormat == 7) {
-            parseSbitBigGlyphMetrics(parser);
-            parser.readBytes("Bit-aligned bitmap data", loca.range.size() - 8);
+            const auto size = parseSbitBigGlyphMetrics(parser);
+            readRawBitmap(Format::BitAligned, size, loca.bitDepth, loca.range.size() - 8, parser);
         } else if (loca.imageFormat == 8) {
             parseSbitSmallGlyphMetrics(parser);
             parser.read<UInt8>("Pad");
@@ -75,14 +106,14 @@ void parseCbdt(const QVector<CblcIndex> &cblcLocations, Parser &parser)
         } else if (loca.imageFormat == 17) {
             parseSbitSmallGlyphMetrics(parser);
             const auto len = parser.read<UInt32>("Length of data");
-            parser.readBytes("Raw PNG data", len);
+            parser.readBitmap("Raw PNG data", BitmapInfo(), len);
         } else if (loca.imageFormat == 18) {
             parseSbitBigGlyphMetrics(parser);
             const auto len = parser.read<UInt32>("Length of data");
-            parser.readBytes("Raw PNG data", len);
+            parser.readBitmap("Raw PNG data", BitmapInfo(), len);
         } else if (loca.imageFormat == 19) {
             const auto len = parser.read<UInt32>("Length of data");
-            parser.readBytes("Raw PNG data", len);
+            parser.readBitmap("Raw PNG data", BitmapInfo(), len);
         }
 
         parser.endGroup();
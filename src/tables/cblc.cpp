@@ -110,33 +110,48 @@ void parseCblc(Parser &parser)
 
     parser.readArray("Arrays", subtableArrays.size(), [&](const auto index){
         const auto array = subtableArrays[index];
-        parser.advanceTo(start + array.offset);
-
-        for (uint i = 0; i < array.numOfSubtables; ++i) {
-            const auto start = parser.offset();
+        const quint32 arrayStart = start + array.offset;
+        parser.advanceTo(arrayStart);
+        parser.beginGroup(index);
 
-            parser.beginGroup("Index Subtable Array");
+        struct Subtable
+        {
+            quint32 offset;
+            quint16 firstGlyph;
+            quint16 lastGlyph;
+        };
+
+        // Records are followed by subtables.
+        QVector<Subtable> subtables;
+        parser.readArray("Index Subtable Array", array.numOfSubtables, [&](const auto index){
+            parser.beginGroup(index);
             const auto firstGlyph = parser.read<GlyphId>("First glyph ID");
             const auto lastGlyph = parser.read<GlyphId>("Last glyph ID");
-            const auto offset2 = parser.read<Offset32>("Additional offset to index subtable");
+            const auto offset = parser.read<Offset32>("Additional offset to index subtable");
+            parser.endGroup();
+
+            subtables.append(Subtable { offset, firstGlyph, lastGlyph });
+        });
+
+        algo::sort_all_by_key(subtables, &Subtable::offset);
+        algo::dedup_vector_by_key(subtables, &Subtable::offset);
 
-            parser.advanceTo(start + offset2);
+        for (const auto subtable : subtables) {
+            parser.advanceTo(arrayStart + subtable.offset);
             parser.beginGroup("Index Subtable");
             const auto indexFormat = parser.read<UInt16>("Index format");
             parser.read<UInt16>("Image format");
             parser.read<Offset32>("Offset to image data");
 
+            // The last offset marks the end of the last glyph.
+            const auto count = quint32(subtable.lastGlyph - subtable.firstGlyph + 2);
             if (indexFormat == 1) {
-                // TODO: check
-                const auto count = lastGlyph - firstGlyph + 1;
-                parser.readBasicArray<Offset32>("Offsets", quint32(count));
+                parser.readBasicArray<Offset32>("Offsets", count);
             } else if (indexFormat == 2) {
                 parser.read<UInt32>("Image size");
                 parseSbitBigGlyphMetrics(parser);
             } else if (indexFormat == 3) {
-                // TODO: check
-                const auto count = lastGlyph - firstGlyph + 1;
-                parser.readBasicArray<Offset16>("Offsets", quint32(count));
+                parser.readBasicArray<Offset16>("Offsets", count);
             } else if (indexFormat == 4) {
                 const auto numGlyphs = parser.read<UInt32>("Number of glyphs");
                 for (uint i = 0; i <= numGlyphs; ++i) {
@@ -152,15 +167,70 @@ void parseCblc(Parser &parser)
                 throw QString("unsupported index format");
             }
 
-            parser.endGroup();
-            parser.endGroup();
+            parser.endGroup(QString(), QString("Glyphs %1..%2").arg(subtable.firstGlyph).arg(subtable.lastGlyph));
+        }
+
+        parser.endGroup();
+    });
+}
+
+std::optional<CblcIndex::Location> CblcIndex::find(const quint32 strike, const quint16 glyphId) const
+{
+    // Find the last range that starts before or at the glyph.
+    auto it = std::upper_bound(m_ranges.begin(), m_ranges.end(), std::make_pair(strike, glyphId),
+                               [](const auto &key, const GlyphRange &range){
+        return key < std::make_pair(range.strike, range.firstGlyph);
+    });
+
+    if (it == m_ranges.begin()) {
+        return std::nullopt;
+    }
+
+    --it;
+    if (it->strike != strike || glyphId > it->lastGlyph) {
+        return std::nullopt;
+    }
+
+    return location(*it, glyphId);
+}
+
+QVector<CblcIndex::Location> CblcIndex::dataLocations() const
+{
+    QVector<Location> locations;
+    for (const auto &range : m_ranges) {
+        for (quint32 glyphId = range.firstGlyph; glyphId <= range.lastGlyph; ++glyphId) {
+            locations.append(location(range, quint16(glyphId)));
         }
+    }
+
+    // Keep the first strike and glyph that points to the data.
+    std::stable_sort(locations.begin(), locations.end(), [](const auto &a, const auto &b) {
+        return a.range.start < b.range.start;
+    });
+    algo::dedup_vector(locations, [](const auto &a, const auto &b) {
+        return a.range.start == b.range.start;
     });
+
+    return locations;
 }
 
-QVector<CblcIndex> parseCblcLocations(ShadowParser &parser)
+CblcIndex::Location CblcIndex::location(const GlyphRange &range, const quint16 glyphId)
 {
-    QVector<CblcIndex> locations;
+    const quint32 start = range.offset + quint32(glyphId - range.firstGlyph) * range.imageSize;
+    return Location {
+        range.strike,
+        glyphId,
+        range.imageFormat,
+        Range { start, start + range.imageSize },
+        range.bitDepth,
+        range.width,
+        range.height,
+    };
+}
+
+CblcIndex parseCblcLocations(ShadowParser &parser)
+{
+    using GlyphRange = CblcIndex::GlyphRange;
 
     const quint32 start = parser.offset();
 
@@ -169,137 +239,106 @@ QVector<CblcIndex> parseCblcLocations(ShadowParser &parser)
 
     const auto numSizes = parser.read<UInt32>();
 
-    struct SubtableArray
+    struct Strike
     {
         quint32 offset;
         quint32 numOfSubtables;
+        quint8 bitDepth;
     };
 
-    QVector<SubtableArray> subtableArrays;
+    QVector<Strike> strikes;
     for (uint i = 0; i < numSizes; ++i) {
         const auto offset = parser.read<Offset32>();
         parser.skip<UInt32>(); // Index tables size
         const auto numOfSubtables = parser.read<UInt32>();
-        parser.advance(36);
+        parser.advance(34); // Color ref, line metrics, glyph range and ppem
+        const auto bitDepth = parser.read<UInt8>();
+        parser.skip<UInt8>(); // Flags
 
-        subtableArrays.append(SubtableArray { offset, numOfSubtables });
+        strikes.append(Strike { offset, numOfSubtables, bitDepth });
     }
 
-    algo::sort_all_by_key(subtableArrays, &SubtableArray::offset);
-    algo::dedup_vector_by_key(subtableArrays, &SubtableArray::offset);
-
-    struct SubtableInfo
-    {
-        quint16 firstGlyph;
-        quint16 lastGlyph;
-        quint32 offset;
-    };
-
-    QVector<SubtableInfo> subtables;
-    for (const auto array : subtableArrays) {
-        parser.jumpTo(start + array.offset);
-
-        for (uint i = 0; i < array.numOfSubtables; ++i) {
-            const auto firstGlyph = parser.read<GlyphId>();
-            const auto lastGlyph = parser.read<GlyphId>();
+    CblcIndex index;
+    for (int strikeIndex = 0; strikeIndex < strikes.size(); ++strikeIndex) {
+        const auto strike = strikes.at(strikeIndex);
+        for (quint32 i = 0; i < strike.numOfSubtables; ++i) {
+            const auto arrayOffset = start + strike.offset;
+            parser.jumpTo(arrayOffset + i * 8);
+            const quint16 firstGlyph = parser.read<GlyphId>();
+            const quint16 lastGlyph = parser.read<GlyphId>();
             const auto offset2 = parser.read<Offset32>();
-
-            subtables.append(SubtableInfo { firstGlyph, lastGlyph, start + array.offset + offset2 });
-        }
-    }
-
-    algo::sort_all_by_key(subtables, &SubtableInfo::offset);
-    algo::dedup_vector_by_key(subtables, &SubtableInfo::offset);
-
-    for (const auto info : subtables) {
-        parser.jumpTo(info.offset);
-        const auto indexFormat = parser.read<UInt16>();
-        const auto imageFormat = parser.read<UInt16>();
-        const auto imageDataOffset = parser.read<Offset32>();
-
-        if (indexFormat == 1) {
-            const auto count = quint32(info.lastGlyph - info.firstGlyph + 1);
-            QVector<quint32> offsets;
-            for (quint32 i = 0; i < count; ++i) {
-                offsets.append(imageDataOffset + parser.read<Offset32>());
-            }
-
-            algo::sort_all(offsets);
-            algo::dedup_vector(offsets);
-
-            for (int i = 0; i < offsets.size() - 1; ++i) {
-                const auto start = offsets.at(i);
-                const auto end = offsets.at(i + 1);
-                locations.append(CblcIndex { imageFormat, Range { start, end } });
-            }
-        } else if (indexFormat == 2) {
-            const auto imageSize = parser.read<UInt32>();
-
-            const auto count = quint32(info.lastGlyph - info.firstGlyph + 1);
-            quint32 offset = imageDataOffset;
-            for (quint32 i = 0; i < count; ++i) {
-                const auto start = offset;
-                offset += imageSize;
-                const auto end = offset;
-                locations.append(CblcIndex { imageFormat, Range { start, end } });
-            }
-        } else if (indexFormat == 3) {
-            const auto count = quint32(info.lastGlyph - info.firstGlyph + 1);
-            QVector<quint32> offsets;
-            for (quint32 i = 0; i < count; ++i) {
-                offsets.append(imageDataOffset + parser.read<Offset16>());
+            if (lastGlyph < firstGlyph) {
+                continue;
             }
 
-            algo::sort_all(offsets);
-            algo::dedup_vector(offsets);
+            parser.jumpTo(arrayOffset + offset2);
+            const auto indexFormat = parser.read<UInt16>();
+            const auto imageFormat = parser.read<UInt16>();
+            const quint32 imageDataOffset = parser.read<Offset32>();
 
-            for (int i = 0; i < offsets.size() - 1; ++i) {
-                const auto start = offsets.at(i);
-                const auto end = offsets.at(i + 1);
-                locations.append(CblcIndex { imageFormat, Range { start, end } });
-            }
-        } else if (indexFormat == 4) {
-            const auto numGlyphs = parser.read<UInt32>();
-            QVector<quint32> offsets;
-            for (quint32 i = 0; i <= numGlyphs; ++i) {
-                parser.skip<GlyphId>();
-                offsets.append(imageDataOffset + parser.read<Offset16>());
-            }
+            GlyphRange range { quint32(strikeIndex), firstGlyph, lastGlyph, imageDataOffset, 0,
+                               imageFormat, strike.bitDepth, 0, 0 };
 
-            algo::sort_all(offsets);
-            algo::dedup_vector(offsets);
-
-            for (int i = 0; i < offsets.size() - 1; ++i) {
-                const auto start = offsets.at(i);
-                const auto end = offsets.at(i + 1);
-                locations.append(CblcIndex { imageFormat, Range { start, end } });
-            }
-        } else if (indexFormat == 5) {
-            const auto imageSize = parser.read<UInt32>();
-            parser.advance(8); // big metrics
-            const auto numGlyphs = parser.read<UInt32>();
-
-            quint32 offset = imageDataOffset;
-            QVector<quint32> offsets;
-            for (quint32 i = 0; i <= numGlyphs; ++i) {
-                offsets.append(offset);
-                offset += imageSize;
-            }
-
-            algo::sort_all(offsets);
-            algo::dedup_vector(offsets);
-
-            for (int i = 0; i < offsets.size() - 1; ++i) {
-                const auto start = offsets.at(i);
-                const auto end = offsets.at(i + 1);
-                locations.append(CblcIndex { imageFormat, Range { start, end } });
+            // Glyphs without data have equal offsets and are skipped.
+            const auto appendGlyph = [&](const quint16 glyphId, const quint32 offset, const quint32 nextOffset) {
+                if (nextOffset > offset) {
+                    index.m_ranges.append(GlyphRange { range.strike, glyphId, glyphId,
+                                                       imageDataOffset + offset, nextOffset - offset,
+                                                       imageFormat, strike.bitDepth, 0, 0 });
+                }
+            };
+
+            if (indexFormat == 1 || indexFormat == 3) {
+                // The last offset marks the end of the last glyph.
+                const auto readOffset = [&]() -> quint32 {
+                    return indexFormat == 1 ? parser.read<Offset32>() : parser.read<Offset16>();
+                };
+
+                quint32 offset = readOffset();
+                for (quint32 glyphId = firstGlyph; glyphId <= lastGlyph; ++glyphId) {
+                    const auto nextOffset = readOffset();
+                    appendGlyph(quint16(glyphId), offset, nextOffset);
+                    offset = nextOffset;
+                }
+            } else if (indexFormat == 2) {
+                range.imageSize = parser.read<UInt32>();
+                range.height = parser.read<UInt8>();
+                range.width = parser.read<UInt8>();
+                if (range.imageSize != 0) {
+                    index.m_ranges.append(range);
+                }
+            } else if (indexFormat == 4) {
+                const auto numGlyphs = parser.read<UInt32>();
+                quint16 glyphId = parser.read<GlyphId>();
+                quint32 offset = parser.read<Offset16>();
+                for (quint32 i = 0; i < numGlyphs; ++i) {
+                    const quint16 nextGlyphId = parser.read<GlyphId>();
+                    const quint32 nextOffset = parser.read<Offset16>();
+                    appendGlyph(glyphId, offset, nextOffset);
+                    glyphId = nextGlyphId;
+                    offset = nextOffset;
+                }
+            } else if (indexFormat == 5) {
+                range.imageSize = parser.read<UInt32>();
+                range.height = parser.read<UInt8>();
+                range.width = parser.read<UInt8>();
+                parser.advance(6); // the rest of big metrics
+                const auto numGlyphs = parser.read<UInt32>();
+                for (quint32 i = 0; i < numGlyphs && range.imageSize != 0; ++i) {
+                    const quint16 glyphId = parser.read<GlyphId>();
+                    auto glyphRange = range;
+                    glyphRange.firstGlyph = glyphId;
+                    glyphRange.lastGlyph = glyphId;
+                    glyphRange.offset = imageDataOffset + i * range.imageSize;
+                    index.m_ranges.append(glyphRange);
+                }
             }
         }
     }
 
-    algo::sort_all(locations, [](const auto &a, const auto &b) {
-        return a.range.start < b.range.start;
+    algo::sort_all(index.m_ranges, [](const auto &a, const auto &b) {
+        return std::make_pair(a.strike, a.firstGlyph) < std::make_pair(b.strike, b.firstGlyph);
     });
 
-    return locations;
+    return index;
 }
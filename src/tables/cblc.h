@@ -0,0 +1,57 @@
+#pragma once
+
+#include <optional>
+
+#include "src/parser.h"
+
+// Bitmap locations of a `CBLC`, `EBLC` or `bloc` table.
+//
+// Glyph ranges are sorted by strike and glyph, so any glyph bitmap is binary searched.
+// Index subtables with a constant image size are stored as a single range.
+class CblcIndex
+{
+public:
+    struct Location
+    {
+        quint32 strike;
+        quint16 glyphId;
+        quint16 imageFormat;
+        // From the start of the bitmap data table.
+        Range range;
+        // Of the strike.
+        quint8 bitDepth;
+        // Metrics shared by all glyphs of an index subtable. Zero when glyphs store their own.
+        quint8 width;
+        quint8 height;
+    };
+
+    std::optional<Location> find(const quint32 strike, const quint16 glyphId) const;
+
+    // Locations sorted by offset. Glyphs that share data are listed once.
+    QVector<Location> dataLocations() const;
+
+    bool isEmpty() const { return m_ranges.isEmpty(); }
+
+private:
+    friend CblcIndex parseCblcLocations(ShadowParser &parser);
+
+    struct GlyphRange
+    {
+        quint32 strike;
+        quint16 firstGlyph;
+        quint16 lastGlyph;
+        quint32 offset;
+        quint32 imageSize;
+        quint16 imageFormat;
+        quint8 bitDepth;
+        quint8 width;
+        quint8 height;
+    };
+
+    static Location location(const GlyphRange &range, const quint16 glyphId);
+
+    QVector<GlyphRange> m_ranges;
+};
+
+// `parser` must be positioned at the start of the table.
+CblcIndex parseCblcLocations(ShadowParser &parser);
@@ -1,5 +1,6 @@
 #include "src/algo.h"
 #include "src/tables/cff.h"
+#include "charstring.h"
 #include "tables.h"
 
 using namespace CFF;
@@ -26,6 +27,8 @@ namespace DictOperator {
     static const quint8 SUBRS = 19;
     static const quint8 DEFAULT_WIDTH_X = 20;
     static const quint8 NOMINAL_WIDTH_X = 21;
+    // CFF2 only.
+    static const quint8 VS_INDEX = 22;
 
     static const quint16 COPYRIGHT = 1200;
     static const quint16 IS_FIXED_PITCH = 1201;
@@ -62,6 +65,84 @@ namespace DictOperator {
 
 const QString OffsetSize::Type = QLatin1String("OffsetSize");
 
+// Predefined strings referenced by SIDs below 391.
+static const char* StandardStrings[391] = {
+    ".notdef", "space", "exclam", "quotedbl", "numbersign", "dollar", "percent", "ampersand",
+    "quoteright", "parenleft", "parenright", "asterisk", "plus", "comma", "hyphen", "period",
+    "slash", "zero", "one", "two", "three", "four", "five", "six", "seven", "eight", "nine",
+    "colon", "semicolon", "less", "equal", "greater", "question", "at", "A", "B", "C", "D",
+    "E", "F", "G", "H", "I", "J", "K", "L", "M", "N", "O", "P", "Q", "R", "S", "T", "U", "V",
+    "W", "X", "Y", "Z", "bracketleft", "backslash", "bracketright", "asciicircum",
+    "underscore", "quoteleft", "a", "b", "c", "d", "e", "f", "g", "h", "i", "j", "k", "l", "m",
+    "n", "o", "p", "q", "r", "s", "t", "u", "v", "w", "x", "y", "z", "braceleft", "bar",
+    "braceright", "asciitilde", "exclamdown", "cent", "sterling", "fraction", "yen", "florin",
+    "section", "currency", "quotesingle", "quotedblleft", "guillemotleft", "guilsinglleft",
+    "guilsinglright", "fi", "fl", "endash", "dagger", "daggerdbl", "periodcentered",
+    "paragraph", "bullet", "quotesinglbase", "quotedblbase", "quotedblright", "guillemotright",
+    "ellipsis", "perthousand", "questiondown", "grave", "acute", "circumflex", "tilde",
+    "macron", "breve", "dotaccent", "dieresis", "ring", "cedilla", "hungarumlaut", "ogonek",
+    "caron", "emdash", "AE", "ordfeminine", "Lslash", "Oslash", "OE", "ordmasculine", "ae",
+    "dotlessi", "lslash", "oslash", "oe", "germandbls", "onesuperior", "logicalnot", "mu",
+    "trademark", "Eth", "onehalf", "plusminus", "Thorn", "onequarter", "divide", "brokenbar",
+    "degree", "thorn", "threequarters", "twosuperior", "registered", "minus", "eth",
+    "multiply", "threesuperior", "copyright", "Aacute", "Acircumflex", "Adieresis", "Agrave",
+    "Aring", "Atilde", "Ccedilla", "Eacute", "Ecircumflex", "Edieresis", "Egrave", "Iacute",
+    "Icircumflex", "Idieresis", "Igrave", "Ntilde", "Oacute", "Ocircumflex", "Odieresis",
+    "Ograve", "Otilde", "Scaron", "Uacute", "Ucircumflex", "Udieresis", "Ugrave", "Yacute",
+    "Ydieresis", "Zcaron", "aacute", "acircumflex", "adieresis", "agrave", "aring", "atilde",
+    "ccedilla", "eacute", "ecircumflex", "edieresis", "egrave", "iacute", "icircumflex",
+    "idieresis", "igrave", "ntilde", "oacute", "ocircumflex", "odieresis", "ograve", "otilde",
+    "scaron", "uacute", "ucircumflex", "udieresis", "ugrave", "yacute", "ydieresis", "zcaron",
+    "exclamsmall", "Hungarumlautsmall", "dollaroldstyle", "dollarsuperior", "ampersandsmall",
+    "Acutesmall", "parenleftsuperior", "parenrightsuperior", "twodotenleader",
+    "onedotenleader", "zerooldstyle", "oneoldstyle", "twooldstyle", "threeoldstyle",
+    "fouroldstyle", "fiveoldstyle", "sixoldstyle", "sevenoldstyle", "eightoldstyle",
+    "nineoldstyle", "commasuperior", "threequartersemdash", "periodsuperior", "questionsmall",
+    "asuperior", "bsuperior", "centsuperior", "dsuperior", "esuperior", "isuperior",
+    "lsuperior", "msuperior", "nsuperior", "osuperior", "rsuperior", "ssuperior", "tsuperior",
+    "ff", "ffi", "ffl", "parenleftinferior", "parenrightinferior", "Circumflexsmall",
+    "hyphensuperior", "Gravesmall", "Asmall", "Bsmall", "Csmall", "Dsmall", "Esmall", "Fsmall",
+    "Gsmall", "Hsmall", "Ismall", "Jsmall", "Ksmall", "Lsmall", "Msmall", "Nsmall", "Osmall",
+    "Psmall", "Qsmall", "Rsmall", "Ssmall", "Tsmall", "Usmall", "Vsmall", "Wsmall", "Xsmall",
+    "Ysmall", "Zsmall", "colonmonetary", "onefitted", "rupiah", "Tildesmall",
+    "exclamdownsmall", "centoldstyle", "Lslashsmall", "Scaronsmall", "Zcaronsmall",
+    "Dieresissmall", "Brevesmall", "Caronsmall", "Dotaccentsmall", "Macronsmall", "figuredash",
+    "hypheninferior", "Ogoneksmall", "Ringsmall", "Cedillasmall", "questiondownsmall",
+    "oneeighth", "threeeighths", "fiveeighths", "seveneighths", "onethird", "twothirds",
+    "zerosuperior", "foursuperior", "fivesuperior", "sixsuperior", "sevensuperior",
+    "eightsuperior", "ninesuperior", "zeroinferior", "oneinferior", "twoinferior",
+    "threeinferior", "fourinferior", "fiveinferior", "sixinferior", "seveninferior",
+    "eightinferior", "nineinferior", "centinferior", "dollarinferior", "periodinferior",
+    "commainferior", "Agravesmall", "Aacutesmall", "Acircumflexsmall", "Atildesmall",
+    "Adieresissmall", "Aringsmall", "AEsmall", "Ccedillasmall", "Egravesmall", "Eacutesmall",
+    "Ecircumflexsmall", "Edieresissmall", "Igravesmall", "Iacutesmall", "Icircumflexsmall",
+    "Idieresissmall", "Ethsmall", "Ntildesmall", "Ogravesmall", "Oacutesmall",
+    "Ocircumflexsmall", "Otildesmall", "Odieresissmall", "OEsmall", "Oslashsmall",
+    "Ugravesmall", "Uacutesmall", "Ucircumflexsmall", "Udieresissmall", "Yacutesmall",
+    "Thornsmall", "Ydieresissmall", "001.000", "001.001", "001.002", "001.003", "Black",
+    "Bold", "Book", "Light", "Medium", "Regular", "Roman", "Semibold",
+};
+
+// SIDs by StandardEncoding codes.
+static const quint16 StandardEncoding[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16,
+    17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32,
+    33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48,
+    49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64,
+    65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79, 80,
+    81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110,
+    0, 111, 112, 113, 114, 0, 115, 116, 117, 118, 119, 120, 121, 122, 0, 123,
+    0, 124, 125, 126, 127, 128, 129, 130, 131, 0, 132, 133, 0, 134, 135, 136,
+    137, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 138, 0, 139, 0, 0, 0, 0, 140, 141, 142, 143, 0, 0, 0, 0,
+    0, 144, 0, 0, 0, 145, 0, 0, 146, 147, 148, 149, 0, 0, 0, 0,
+};
+
 
 static const quint8 END_OF_FLOAT_FLAG = 0xf;
 static const quint8 FLOAT_STACK_LEN = 64;
@@ -177,26 +258,6 @@ static void parseIndex(const QString &title, const QString &subtitle, Parser &pa
     parser.endGroup();
 }
 
-struct DictRecord
-{
-    quint16 op = 0;
-    QVarLengthArray<float, 8> operands;
-};
-
-struct Dict
-{
-    QVector<DictRecord> records;
-
-    std::optional<QVarLengthArray<float, 8>> operands(const quint16 op) const
-    {
-        if (const auto rec = algo::find_if(records, [=](const auto &v){ return v.op == op; })) {
-            return rec->operands;
-        } else {
-            return std::nullopt;
-        }
-    }
-};
-
 static Dict parseDict(const quint32 size, Parser &parser)
 {
     Dict dict;
@@ -700,3 +761,359 @@ void parseCff(Parser &parser)
         }
     }
 }
+
+QVector<quint32> CFF::readIndexOffsets(ShadowParser &parser, const bool isCff2)
+{
+    const auto count = isCff2 ? quint32(parser.read<UInt32>()) : quint32(parser.read<UInt16>());
+    if (count == 0) {
+        return {};
+    }
+
+    const auto offsetSize = parser.read<OffsetSize>();
+    // Offsets are relative to the byte preceding the data.
+    const auto dataStart = parser.offset() + (count + 1) * offsetSize - 1;
+
+    QVector<quint32> offsets;
+    offsets.reserve(int(count) + 1);
+    for (quint32 i = 0; i <= count; ++i) {
+        quint32 offset = 0;
+        switch (offsetSize.to_bytes()) {
+            case OffsetSizeBytes::One :   offset = parser.read<UInt8>(); break;
+            case OffsetSizeBytes::Two :   offset = parser.read<UInt16>(); break;
+            case OffsetSizeBytes::Three : offset = parser.read<UInt24>(); break;
+            case OffsetSizeBytes::Four :  offset = parser.read<UInt32>(); break;
+        }
+
+        if (offset == 0 || (!offsets.isEmpty() && dataStart + offset < offsets.last())) {
+            throw QString("invalid INDEX offset");
+        }
+
+        offsets << dataStart + offset;
+    }
+
+    return offsets;
+}
+
+Dict CFF::readDict(const quint32 end, ShadowParser &parser)
+{
+    Dict dict;
+    DictRecord currRecord;
+    while (parser.offset() < end) {
+        const quint8 b0 = parser.read<UInt8>();
+        // CFF2 operators are up to 24.
+        if (b0 <= 27) {
+            currRecord.op = b0 == 12 ? 1200 + parser.read<UInt8>() : b0;
+            dict.records << currRecord;
+            currRecord = DictRecord();
+        } else if (b0 == 28) {
+            currRecord.operands.append(qint16(parser.read<Int16>()));
+        } else if (b0 == 29) {
+            currRecord.operands.append(parser.read<Int32>());
+        } else if (b0 == 30) {
+            currRecord.operands.append(parseFloat(parser));
+        } else if (b0 >= 32 && b0 <= 246) {
+            currRecord.operands.append(int(b0) - 139);
+        } else if (b0 >= 247 && b0 <= 250) {
+            currRecord.operands.append((int(b0) - 247) * 256 + int(parser.read<UInt8>()) + 108);
+        } else if (b0 >= 251 && b0 <= 254) {
+            currRecord.operands.append(-(int(b0) - 251) * 256 - int(parser.read<UInt8>()) - 108);
+        } else {
+            throw QString("invalid DICT operator");
+        }
+    }
+
+    return dict;
+}
+
+QVector<quint16> CFF::readFdSelect(const quint16 numberOfGlyphs, ShadowParser &parser)
+{
+    QVector<quint16> fdSelect;
+    fdSelect.reserve(numberOfGlyphs);
+
+    const auto format = parser.read<UInt8>();
+    if (format == 0) {
+        for (quint16 i = 0; i < numberOfGlyphs; ++i) {
+            fdSelect << parser.read<UInt8>();
+        }
+
+        return fdSelect;
+    } else if (format != 3 && format != 4) {
+        throw QString("invalid FDSelect format");
+    }
+
+    // Format 4 is the same as 3, but with 32-bit glyph IDs and 16-bit FD indexes.
+    const bool isLong = format == 4;
+    auto readGlyphId = [&]{ return isLong ? quint32(parser.read<UInt32>()) : quint32(parser.read<UInt16>()); };
+
+    const auto numberOfRanges = readGlyphId();
+    auto first = readGlyphId();
+    for (quint32 i = 0; i < numberOfRanges; ++i) {
+        const quint16 fd = isLong ? quint16(parser.read<UInt16>()) : quint16(parser.read<UInt8>());
+        const auto next = readGlyphId();
+        if (first != quint32(fdSelect.size()) || next < first) {
+            throw QString("invalid FDSelect range");
+        }
+
+        for (auto id = first; id < std::min<quint32>(next, numberOfGlyphs); ++id) {
+            fdSelect << fd;
+        }
+
+        first = next;
+    }
+
+    return fdSelect;
+}
+
+std::optional<quint32> CFF::singleOffset(const Dict &dict, const quint16 op)
+{
+    if (const auto operands = dict.operands(op)) {
+        if (operands->size() == 1 && operands->at(0) >= 0) {
+            return quint32(operands->at(0));
+        }
+    }
+
+    return std::nullopt;
+}
+
+// Top-level structures of a CFF table.
+struct CffHeader
+{
+    quint32 tableStart = 0;
+    Dict topDict;
+    QVector<QString> strings;
+    QVector<quint32> globalSubrs;
+};
+
+static CffHeader readHeader(ShadowParser &parser)
+{
+    CffHeader header;
+    header.tableStart = parser.offset();
+
+    parser.skip<UInt8>(); // major version
+    parser.skip<UInt8>(); // minor version
+    const auto headerSize = parser.read<UInt8>();
+    parser.jumpTo(header.tableStart + headerSize);
+
+    const auto nameIndex = readIndexOffsets(parser);
+    if (!nameIndex.isEmpty()) {
+        parser.jumpTo(nameIndex.last());
+    }
+
+    const auto topDictIndex = readIndexOffsets(parser);
+    if (topDictIndex.size() < 2) {
+        throw QString("no Top DICT");
+    }
+
+    parser.jumpTo(topDictIndex[0]);
+    header.topDict = readDict(topDictIndex[1], parser);
+    parser.jumpTo(topDictIndex.last());
+
+    const auto stringIndex = readIndexOffsets(parser);
+    for (int i = 0; i + 1 < stringIndex.size(); ++i) {
+        parser.jumpTo(stringIndex[i]);
+        header.strings << QString::fromLatin1(parser.readBytes(stringIndex[i + 1] - stringIndex[i]));
+    }
+
+    if (!stringIndex.isEmpty()) {
+        parser.jumpTo(stringIndex.last());
+    }
+
+    header.globalSubrs = readIndexOffsets(parser);
+    return header;
+}
+
+static quint16 readNumberOfGlyphs(const CffHeader &header, ShadowParser &parser)
+{
+    const auto charStringsOffset = singleOffset(header.topDict, DictOperator::CHAR_STRINGS);
+    if (!charStringsOffset) {
+        return 0;
+    }
+
+    parser.jumpTo(header.tableStart + *charStringsOffset);
+    return parser.read<UInt16>();
+}
+
+// Returns SIDs of glyphs or CIDs for CID-keyed fonts.
+//
+// Can be shorter than the number of glyphs, since only ISOAdobe
+// of the predefined charsets maps glyphs to SIDs directly.
+static QVector<quint16> readCharset(const CffHeader &header, const quint16 numberOfGlyphs,
+                                    ShadowParser &parser)
+{
+    if (numberOfGlyphs == 0) {
+        return {};
+    }
+
+    QVector<quint16> sids;
+    sids.reserve(numberOfGlyphs);
+    sids << 0;
+
+    const auto charsetOffset = singleOffset(header.topDict, DictOperator::CHARSET).value_or(0);
+    if (charsetOffset <= 2) {
+        if (charsetOffset == 0) {
+            for (quint16 i = 1; i < std::min<quint16>(numberOfGlyphs, 229); ++i) {
+                sids << i;
+            }
+        }
+
+        return sids;
+    }
+
+    parser.jumpTo(header.tableStart + charsetOffset);
+    const auto format = parser.read<UInt8>();
+    switch (format) {
+    case 0: {
+        for (quint16 i = 1; i < numberOfGlyphs; ++i) {
+            sids << parser.read<UInt16>();
+        }
+        break;
+    }
+    case 1:
+    case 2: {
+        while (sids.size() < numberOfGlyphs) {
+            const quint16 first = parser.read<UInt16>();
+            const quint32 left = format == 1 ? quint32(parser.read<UInt8>()) : quint32(parser.read<UInt16>());
+            for (quint32 i = 0; i <= left && sids.size() < numberOfGlyphs; ++i) {
+                sids << quint16(first + i);
+            }
+        }
+        break;
+    }
+    default:
+        throw QString("invalid charset format");
+    }
+
+    return sids;
+}
+
+QVector<QString> collectCffGlyphNames(ShadowParser &parser)
+{
+    const auto header = readHeader(parser);
+    const auto numberOfGlyphs = readNumberOfGlyphs(header, parser);
+    const auto sids = readCharset(header, numberOfGlyphs, parser);
+
+    // CID-keyed fonts map glyphs to CIDs instead of names.
+    const bool isCid = header.topDict.operands(DictOperator::ROS).has_value();
+
+    QVector<QString> names;
+    names.reserve(sids.size());
+    for (const auto sid : sids) {
+        if (isCid) {
+            names << QString("cid%1").arg(sid, 5, 10, QChar('0'));
+        } else if (sid < 391) {
+            names << QLatin1String(StandardStrings[sid]);
+        } else if (sid - 391 < header.strings.size()) {
+            names << header.strings[sid - 391];
+        } else {
+            names << QString();
+        }
+    }
+
+    return names;
+}
+
+static QVector<quint32> relativeOffsets(QVector<quint32> offsets, const quint32 tableStart)
+{
+    for (auto &offset : offsets) {
+        offset -= tableStart;
+    }
+
+    return offsets;
+}
+
+CharStrings::Private CFF::readPrivate(const quint32 tableStart, const Dict &fontDict,
+                                      const bool isCff2, ShadowParser &parser)
+{
+    CharStrings::Private data;
+
+    const auto operands = fontDict.operands(DictOperator::PRIVATE);
+    if (!operands) {
+        return data;
+    }
+
+    if (operands->size() != 2 || operands->at(0) < 0 || operands->at(1) < 0) {
+        throw QString("invalid Private DICT operands");
+    }
+
+    const auto start = tableStart + quint32(operands->at(1));
+    const auto end = start + quint32(operands->at(0));
+    if (start == end) {
+        return data;
+    }
+
+    parser.jumpTo(start);
+    const auto privateDict = readDict(end, parser);
+
+    if (const auto widths = privateDict.operands(DictOperator::DEFAULT_WIDTH_X)) {
+        data.defaultWidthX = widths->isEmpty() ? 0 : widths->at(0);
+    }
+
+    if (const auto widths = privateDict.operands(DictOperator::NOMINAL_WIDTH_X)) {
+        data.nominalWidthX = widths->isEmpty() ? 0 : widths->at(0);
+    }
+
+    if (const auto vsindex = privateDict.operands(DictOperator::VS_INDEX)) {
+        data.vsindex = vsindex->isEmpty() ? 0 : quint16(qBound(0.0f, vsindex->at(0), 65535.0f));
+    }
+
+    // 'The local subroutines offset is relative to the beginning of the Private DICT data.'
+    if (const auto offset = singleOffset(privateDict, DictOperator::SUBRS)) {
+        parser.jumpTo(start + *offset);
+        data.subrs = relativeOffsets(readIndexOffsets(parser, isCff2), tableStart);
+    }
+
+    return data;
+}
+
+CharStrings collectCffCharStrings(ShadowParser &parser)
+{
+    const auto header = readHeader(parser);
+    const auto tableStart = header.tableStart;
+
+    CharStrings charStrings;
+    charStrings.globalSubrs = relativeOffsets(header.globalSubrs, tableStart);
+
+    const auto charStringsOffset = singleOffset(header.topDict, DictOperator::CHAR_STRINGS);
+    if (!charStringsOffset) {
+        throw QString("no CharStrings");
+    }
+
+    parser.jumpTo(tableStart + *charStringsOffset);
+    charStrings.charStrings = relativeOffsets(readIndexOffsets(parser), tableStart);
+    const auto numberOfGlyphs = charStrings.numberOfGlyphs();
+
+    if (const auto fdArrayOffset = singleOffset(header.topDict, DictOperator::FD_ARRAY)) {
+        // CID-keyed fonts have a Private DICT per Font DICT.
+        parser.jumpTo(tableStart + *fdArrayOffset);
+        const auto fdArray = readIndexOffsets(parser);
+        for (int i = 0; i + 1 < fdArray.size(); ++i) {
+            parser.jumpTo(fdArray[i]);
+            const auto fontDict = readDict(fdArray[i + 1], parser);
+            charStrings.privates << readPrivate(tableStart, fontDict, false, parser);
+        }
+
+        const auto fdSelectOffset = singleOffset(header.topDict, DictOperator::FD_SELECT);
+        if (!fdSelectOffset) {
+            throw QString("no FDSelect");
+        }
+
+        parser.jumpTo(tableStart + *fdSelectOffset);
+        charStrings.fdSelect = readFdSelect(numberOfGlyphs, parser);
+    } else {
+        charStrings.privates << readPrivate(tableStart, header.topDict, false, parser);
+
+        // Only fonts with names can use seac.
+        const auto sids = readCharset(header, numberOfGlyphs, parser);
+        QHash<quint16, quint16> glyphBySid;
+        for (int i = sids.size() - 1; i >= 0; --i) {
+            glyphBySid.insert(sids[i], quint16(i));
+        }
+
+        charStrings.standardEncoding.resize(256);
+        for (int code = 0; code < 256; ++code) {
+            charStrings.standardEncoding[code] = glyphBySid.value(StandardEncoding[code]);
+        }
+    }
+
+    return charStrings;
+}
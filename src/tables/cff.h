@@ -1,6 +1,12 @@
 #pragma once
 
+#include <QVarLengthArray>
+
+#include <optional>
+
+#include "src/algo.h"
 #include "src/parser.h"
+#include "charstring.h"
 
 namespace CFF
 {
@@ -50,5 +56,42 @@ namespace CFF
         quint8 d;
     };
 
+    struct DictRecord
+    {
+        quint16 op = 0;
+        QVarLengthArray<float, 8> operands;
+    };
+
+    struct Dict
+    {
+        QVector<DictRecord> records;
+
+        std::optional<QVarLengthArray<float, 8>> operands(const quint16 op) const
+        {
+            if (const auto rec = algo::find_if(records, [=](const auto &v){ return v.op == op; })) {
+                return rec->operands;
+            } else {
+                return std::nullopt;
+            }
+        }
+    };
+
     float parseFloat(ShadowParser &parser);
+
+    // Returns absolute offsets of all INDEX items followed by the end offset.
+    // The parser is not advanced past the INDEX data.
+    QVector<quint32> readIndexOffsets(ShadowParser &parser, const bool isCff2 = false);
+
+    // Reads only numeric operands, without building a tree.
+    Dict readDict(const quint32 end, ShadowParser &parser);
+
+    std::optional<quint32> singleOffset(const Dict &dict, const quint16 op);
+
+    // Reads a Private DICT referenced by a Top or Font DICT.
+    // Subroutine offsets are relative to `tableStart`.
+    CharStrings::Private readPrivate(const quint32 tableStart, const Dict &fontDict,
+                                     const bool isCff2, ShadowParser &parser);
+
+    // Returns a Font DICT index per glyph.
+    QVector<quint16> readFdSelect(const quint16 numberOfGlyphs, ShadowParser &parser);
 }
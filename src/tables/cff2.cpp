@@ -86,26 +86,6 @@ static void parseIndex(const QString &name, Parser &parser, Predicate p)
     parser.endGroup();
 }
 
-struct DictRecord
-{
-    quint16 op = 0;
-    QVarLengthArray<float, 8> operands;
-};
-
-struct Dict
-{
-    QVector<DictRecord> records;
-
-    std::optional<QVarLengthArray<float, 8>> operands(const quint16 op) const
-    {
-        if (const auto rec = algo::find_if(records, [=](const auto &v){ return v.op == op; })) {
-            return rec->operands;
-        } else {
-            return std::nullopt;
-        }
-    }
-};
-
 static Dict parseDict(const quint32 size, Parser &parser)
 {
     Dict dict;
@@ -475,3 +455,67 @@ void parseCff2(Parser &parser)
         parseIndex("Local Subr INDEX", parser, parseSubr);
     }
 }
+
+CharStrings collectCff2CharStrings(ShadowParser &parser)
+{
+    const auto tableStart = parser.offset();
+
+    parser.skip<UInt8>(); // major version
+    parser.skip<UInt8>(); // minor version
+    const quint8 headerSize = parser.read<UInt8>();
+    const quint16 topDictSize = parser.read<UInt16>();
+
+    const auto topDictStart = tableStart + headerSize;
+    parser.jumpTo(topDictStart);
+    const auto topDict = readDict(topDictStart + topDictSize, parser);
+
+    auto relativeOffsets = [=](QVector<quint32> offsets) {
+        for (auto &offset : offsets) {
+            offset -= tableStart;
+        }
+
+        return offsets;
+    };
+
+    CharStrings charStrings;
+    charStrings.isCff2 = true;
+
+    // The Global Subr INDEX follows the Top DICT.
+    parser.jumpTo(topDictStart + topDictSize);
+    charStrings.globalSubrs = relativeOffsets(readIndexOffsets(parser, true));
+
+    const auto charStringsOffset = singleOffset(topDict, DictOperator::CHAR_STRINGS);
+    if (!charStringsOffset) {
+        throw QString("no CharStrings");
+    }
+
+    parser.jumpTo(tableStart + *charStringsOffset);
+    charStrings.charStrings = relativeOffsets(readIndexOffsets(parser, true));
+
+    if (const auto offset = singleOffset(topDict, DictOperator::VSTORE)) {
+        parser.jumpTo(tableStart + *offset);
+        parser.skip<UInt16>(); // length
+        charStrings.variationStore = collectItemVariationStore(parser);
+    }
+
+    const auto fdArrayOffset = singleOffset(topDict, DictOperator::FD_ARRAY);
+    if (!fdArrayOffset) {
+        throw QString("no Font DICT INDEX");
+    }
+
+    parser.jumpTo(tableStart + *fdArrayOffset);
+    const auto fdArray = readIndexOffsets(parser, true);
+    for (int i = 0; i + 1 < fdArray.size(); ++i) {
+        parser.jumpTo(fdArray[i]);
+        const auto fontDict = readDict(fdArray[i + 1], parser);
+        charStrings.privates << readPrivate(tableStart, fontDict, true, parser);
+    }
+
+    // FDSelect is optional when there is only one Font DICT.
+    if (const auto offset = singleOffset(topDict, DictOperator::FD_SELECT)) {
+        parser.jumpTo(tableStart + *offset);
+        charStrings.fdSelect = readFdSelect(charStrings.numberOfGlyphs(), parser);
+    }
+
+    return charStrings;
+}
@@ -0,0 +1,827 @@
+#include <cmath>
+
+#include "charstring.h"
+
+namespace {
+
+// Type 2 and CFF2 limits.
+const int MaxArguments = 48;
+const int MaxCff2Arguments = 513;
+const int MaxSubrsDepth = 10;
+// Subroutines can call each other many times on each nesting level,
+// so the number of executed operators is limited as well.
+const quint32 MaxOperators = 300000;
+// Larger integer operands are meaningless and can overflow on conversion.
+const float MaxIntOperand = 1 << 20;
+const int TransientArraySize = 32;
+
+namespace Operator {
+    const quint8 HORIZONTAL_STEM = 1;
+    const quint8 VERTICAL_STEM = 3;
+    const quint8 VERTICAL_MOVE_TO = 4;
+    const quint8 LINE_TO = 5;
+    const quint8 HORIZONTAL_LINE_TO = 6;
+    const quint8 VERTICAL_LINE_TO = 7;
+    const quint8 CURVE_TO = 8;
+    const quint8 CALL_LOCAL_SUBROUTINE = 10;
+    const quint8 RETURN = 11;
+    const quint8 ESCAPE = 12;
+    const quint8 ENDCHAR = 14;
+    const quint8 VARIATION_STORE_INDEX = 15;
+    const quint8 BLEND = 16;
+    const quint8 HORIZONTAL_STEM_HINT_MASK = 18;
+    const quint8 HINT_MASK = 19;
+    const quint8 COUNTER_MASK = 20;
+    const quint8 MOVE_TO = 21;
+    const quint8 HORIZONTAL_MOVE_TO = 22;
+    const quint8 VERTICAL_STEM_HINT_MASK = 23;
+    const quint8 CURVE_LINE = 24;
+    const quint8 LINE_CURVE = 25;
+    const quint8 VV_CURVE_TO = 26;
+    const quint8 HH_CURVE_TO = 27;
+    const quint8 SHORT_INT = 28;
+    const quint8 CALL_GLOBAL_SUBROUTINE = 29;
+    const quint8 VH_CURVE_TO = 30;
+    const quint8 HV_CURVE_TO = 31;
+    const quint8 FIXED_16_16 = 255;
+
+    // Escaped.
+    const quint8 AND = 3;
+    const quint8 OR = 4;
+    const quint8 NOT = 5;
+    const quint8 ABS = 9;
+    const quint8 ADD = 10;
+    const quint8 SUB = 11;
+    const quint8 DIV = 12;
+    const quint8 NEG = 14;
+    const quint8 EQ = 15;
+    const quint8 DROP = 18;
+    const quint8 PUT = 20;
+    const quint8 GET = 21;
+    const quint8 IFELSE = 22;
+    const quint8 RANDOM = 23;
+    const quint8 MUL = 24;
+    const quint8 SQRT = 26;
+    const quint8 DUP = 27;
+    const quint8 EXCH = 28;
+    const quint8 INDEX = 29;
+    const quint8 ROLL = 30;
+    const quint8 HFLEX = 34;
+    const quint8 FLEX = 35;
+    const quint8 HFLEX1 = 36;
+    const quint8 FLEX1 = 37;
+}
+
+struct Seac
+{
+    float dx;
+    float dy;
+    quint8 baseCode;
+    quint8 accentCode;
+};
+
+quint32 subrsBias(const int count)
+{
+    if (count < 1240) {
+        return 107;
+    } else if (count < 33900) {
+        return 1131;
+    } else {
+        return 32768;
+    }
+}
+
+class Interpreter
+{
+public:
+    Interpreter(const quint8 *table, const quint32 tableSize, const CharStrings &charStrings,
+                const CharStrings::Private &privateData,
+                const QVector<QVector<float>> *blendScalars,
+                const float x, const float y, GlyphOutline &outline)
+        : m_table(table)
+        , m_tableSize(tableSize)
+        , m_charStrings(charStrings)
+        , m_private(privateData)
+        , m_blendScalars(blendScalars)
+        , m_maxArguments(charStrings.isCff2 ? MaxCff2Arguments : MaxArguments)
+        , m_isWidthParsed(charStrings.isCff2)
+        , m_vsindex(privateData.vsindex)
+        , m_x(x)
+        , m_y(y)
+        , m_outline(outline)
+    {
+    }
+
+    void run(const quint32 start, const quint32 end, const int depth);
+    void finish()
+    {
+        parseWidth(false);
+        closeContour();
+    }
+
+    float width() const { return m_width; }
+    const std::optional<Seac>& seac() const { return m_seac; }
+
+private:
+    void push(const float n)
+    {
+        if (m_size == m_maxArguments) {
+            throw QString("charstring operands stack overflow");
+        }
+
+        m_stack[m_size++] = n;
+    }
+
+    float pop()
+    {
+        if (m_size == 0) {
+            throw QString("charstring operands stack underflow");
+        }
+
+        return m_stack[--m_size];
+    }
+
+    // Converting NaN or an out of range float to an integer is undefined.
+    int popInt()
+    {
+        const auto n = pop();
+        return std::isnan(n) ? 0 : int(qBound(-MaxIntOperand, n, MaxIntOperand));
+    }
+
+    void require(const int count) const
+    {
+        if (m_size < count) {
+            throw QString("not enough charstring operands");
+        }
+    }
+
+    // The width is an optional first operand of the first stack-clearing operator.
+    void parseWidth(const bool hasWidth)
+    {
+        if (m_isWidthParsed) {
+            return;
+        }
+
+        m_isWidthParsed = true;
+        if (hasWidth && m_size > 0) {
+            m_width = m_private.nominalWidthX + m_stack[0];
+            std::copy(m_stack + 1, m_stack + m_size, m_stack);
+            m_size -= 1;
+        } else {
+            m_width = m_private.defaultWidthX;
+        }
+    }
+
+    void addPoint(const float x, const float y, const quint8 flag)
+    {
+        if (m_outline.size() == 0xFFFF) {
+            throw QString("too many points");
+        }
+
+        m_outline.x.append(x);
+        m_outline.y.append(y);
+        m_outline.onCurve.append(flag);
+    }
+
+    void moveTo(const float dx, const float dy)
+    {
+        closeContour();
+        m_x += dx;
+        m_y += dy;
+        m_contourStart = m_outline.size();
+        addPoint(m_x, m_y, 1);
+        m_isContourOpen = true;
+    }
+
+    void lineTo(const float dx, const float dy)
+    {
+        ensureContour();
+        m_x += dx;
+        m_y += dy;
+        addPoint(m_x, m_y, 1);
+    }
+
+    void curveTo(const float dx1, const float dy1, const float dx2, const float dy2,
+                 const float dx3, const float dy3)
+    {
+        ensureContour();
+        const auto x1 = m_x + dx1;
+        const auto y1 = m_y + dy1;
+        const auto x2 = x1 + dx2;
+        const auto y2 = y1 + dy2;
+        m_x = x2 + dx3;
+        m_y = y2 + dy3;
+        addPoint(x1, y1, 2);
+        addPoint(x2, y2, 2);
+        addPoint(m_x, m_y, 1);
+    }
+
+    // Malformed charstrings can draw without a moveto.
+    void ensureContour()
+    {
+        if (!m_isContourOpen) {
+            moveTo(0, 0);
+        }
+    }
+
+    void closeContour()
+    {
+        if (!m_isContourOpen) {
+            return;
+        }
+
+        m_isContourOpen = false;
+
+        // Contours are closed implicitly, so a final point that matches the first one is redundant.
+        const auto last = m_outline.size() - 1;
+        if (last > m_contourStart && m_outline.onCurve[last] == 1
+            && m_outline.x[last] == m_outline.x[m_contourStart]
+            && m_outline.y[last] == m_outline.y[m_contourStart])
+        {
+            m_outline.x.removeLast();
+            m_outline.y.removeLast();
+            m_outline.onCurve.removeLast();
+        }
+
+        m_outline.contourEnds.append(quint16(m_outline.size() - 1));
+    }
+
+    void addStems()
+    {
+        parseWidth(m_size % 2 == 1);
+        m_numberOfStems += quint32(m_size / 2);
+        m_size = 0;
+    }
+
+    void callSubroutine(const QVector<quint32> &subrs, const int depth)
+    {
+        const auto count = subrs.size() - 1;
+        const auto index = qint64(popInt()) + subrsBias(count);
+        if (index < 0 || index >= count) {
+            throw QString("invalid subroutine index");
+        }
+
+        run(subrs[int(index)], subrs[int(index) + 1], depth + 1);
+    }
+
+    void blend();
+    void runEscaped(const quint8 op);
+
+private:
+    const quint8 * const m_table;
+    const quint32 m_tableSize;
+    const CharStrings &m_charStrings;
+    const CharStrings::Private &m_private;
+    const QVector<QVector<float>> * const m_blendScalars;
+    const int m_maxArguments;
+
+    float m_stack[MaxCff2Arguments];
+    int m_size = 0;
+    float m_transient[TransientArraySize] = {};
+    quint32 m_numberOfStems = 0;
+    // Including operands and all subroutines.
+    quint32 m_numberOfOperators = 0;
+    bool m_isWidthParsed;
+    float m_width = 0;
+    quint16 m_vsindex;
+    bool m_isFinished = false;
+    std::optional<Seac> m_seac;
+
+    float m_x;
+    float m_y;
+    bool m_isContourOpen = false;
+    int m_contourStart = 0;
+    GlyphOutline &m_outline;
+};
+
+void Interpreter::run(const quint32 start, const quint32 end, const int depth)
+{
+    if (depth > MaxSubrsDepth) {
+        throw QString("subroutines nesting limit reached");
+    }
+
+    if (start > end || end > m_tableSize) {
+        throw QString("charstring is out of bounds");
+    }
+
+    const quint8 *p = m_table + start;
+    const quint8 * const e = m_table + end;
+    auto need = [&](const int n) {
+        if (e - p < n) {
+            throw QString("unexpected end of charstring");
+        }
+    };
+
+    while (p < e && !m_isFinished) {
+        m_numberOfOperators += 1;
+        if (m_numberOfOperators > MaxOperators) {
+            throw QString("charstring operators limit reached");
+        }
+
+        const quint8 op = *p++;
+
+        // Numbers.
+        if (op >= 32 && op <= 246) {
+            push(float(int(op) - 139));
+            continue;
+        } else if (op >= 247 && op <= 250) {
+            need(1);
+            push(float((int(op) - 247) * 256 + int(*p++) + 108));
+            continue;
+        } else if (op >= 251 && op <= 254) {
+            need(1);
+            push(float(-(int(op) - 251) * 256 - int(*p++) - 108));
+            continue;
+        } else if (op == Operator::SHORT_INT) {
+            need(2);
+            push(float(qFromBigEndian<qint16>(p)));
+            p += 2;
+            continue;
+        } else if (op == Operator::FIXED_16_16) {
+            need(4);
+            push(float(qFromBigEndian<qint32>(p)) / 65536.0f);
+            p += 4;
+            continue;
+        }
+
+        switch (op) {
+        case Operator::HORIZONTAL_STEM:
+        case Operator::VERTICAL_STEM:
+        case Operator::HORIZONTAL_STEM_HINT_MASK:
+        case Operator::VERTICAL_STEM_HINT_MASK: {
+            addStems();
+            break;
+        }
+        case Operator::HINT_MASK:
+        case Operator::COUNTER_MASK: {
+            // Operands before a mask are an implicit vstem.
+            addStems();
+            const auto maskSize = int((m_numberOfStems + 7) / 8);
+            need(maskSize);
+            p += maskSize;
+            break;
+        }
+        case Operator::MOVE_TO: {
+            parseWidth(m_size > 2);
+            require(2);
+            moveTo(m_stack[0], m_stack[1]);
+            m_size = 0;
+            break;
+        }
+        case Operator::HORIZONTAL_MOVE_TO: {
+            parseWidth(m_size > 1);
+            require(1);
+            moveTo(m_stack[0], 0);
+            m_size = 0;
+            break;
+        }
+        case Operator::VERTICAL_MOVE_TO: {
+            parseWidth(m_size > 1);
+            require(1);
+            moveTo(0, m_stack[0]);
+            m_size = 0;
+            break;
+        }
+        case Operator::LINE_TO: {
+            for (int i = 0; i + 1 < m_size; i += 2) {
+                lineTo(m_stack[i], m_stack[i + 1]);
+            }
+            m_size = 0;
+            break;
+        }
+        case Operator::HORIZONTAL_LINE_TO:
+        case Operator::VERTICAL_LINE_TO: {
+            // Alternates between horizontal and vertical lines.
+            bool isHorizontal = op == Operator::HORIZONTAL_LINE_TO;
+            for (int i = 0; i < m_size; ++i) {
+                if (isHorizontal) {
+                    lineTo(m_stack[i], 0);
+                } else {
+                    lineTo(0, m_stack[i]);
+                }
+                isHorizontal = !isHorizontal;
+            }
+            m_size = 0;
+            break;
+        }
+        case Operator::CURVE_TO: {
+            for (int i = 0; i + 5 < m_size; i += 6) {
+                const auto *s = m_stack + i;
+                curveTo(s[0], s[1], s[2], s[3], s[4], s[5]);
+            }
+            m_size = 0;
+            break;
+        }
+        case Operator::CURVE_LINE: {
+            require(8);
+            int i = 0;
+            for (; i + 6 + 2 <= m_size; i += 6) {
+                const auto *s = m_stack + i;
+                curveTo(s[0], s[1], s[2], s[3], s[4], s[5]);
+            }
+            lineTo(m_stack[i], m_stack[i + 1]);
+            m_size = 0;
+            break;
+        }
+        case Operator::LINE_CURVE: {
+            require(8);
+            int i = 0;
+            for (; i + 2 + 6 <= m_size; i += 2) {
+                lineTo(m_stack[i], m_stack[i + 1]);
+            }
+            const auto *s = m_stack + i;
+            curveTo(s[0], s[1], s[2], s[3], s[4], s[5]);
+            m_size = 0;
+            break;
+        }
+        case Operator::VV_CURVE_TO: {
+            int i = 0;
+            float dx1 = 0;
+            if (m_size % 2 == 1) {
+                dx1 = m_stack[0];
+                i = 1;
+            }
+
+            for (; i + 3 < m_size; i += 4) {
+                const auto *s = m_stack + i;
+                curveTo(dx1, s[0], s[1], s[2], 0, s[3]);
+                dx1 = 0;
+            }
+            m_size = 0;
+            break;
+        }
+        case Operator::HH_CURVE_TO: {
+            int i = 0;
+            float dy1 = 0;
+            if (m_size % 2 == 1) {
+                dy1 = m_stack[0];
+                i = 1;
+            }
+
+            for (; i + 3 < m_size; i += 4) {
+                const auto *s = m_stack + i;
+                curveTo(s[0], dy1, s[1], s[2], s[3], 0);
+                dy1 = 0;
+            }
+            m_size = 0;
+            break;
+        }
+        case Operator::VH_CURVE_TO:
+        case Operator::HV_CURVE_TO: {
+            // Alternates between curves starting horizontally and vertically.
+            // The last curve can have an extra operand for its final direction.
+            bool isHorizontal = op == Operator::HV_CURVE_TO;
+            for (int i = 0; i + 3 < m_size; i += 4) {
+                const auto *s = m_stack + i;
+                const auto last = i + 5 == m_size ? s[4] : 0.0f;
+                if (isHorizontal) {
+                    curveTo(s[0], 0, s[1], s[2], last, s[3]);
+                } else {
+                    curveTo(0, s[0], s[1], s[2], s[3], last);
+                }
+                isHorizontal = !isHorizontal;
+            }
+            m_size = 0;
+            break;
+        }
+        case Operator::CALL_LOCAL_SUBROUTINE: {
+            callSubroutine(m_private.subrs, depth);
+            break;
+        }
+        case Operator::CALL_GLOBAL_SUBROUTINE: {
+            callSubroutine(m_charStrings.globalSubrs, depth);
+            break;
+        }
+        case Operator::RETURN: {
+            return;
+        }
+        case Operator::ENDCHAR: {
+            parseWidth(m_size == 1 || m_size == 5);
+            // A deprecated accented character composition.
+            if (m_size == 4) {
+                m_seac = Seac {
+                    m_stack[0],
+                    m_stack[1],
+                    quint8(qBound(0.0f, m_stack[2], 255.0f)),
+                    quint8(qBound(0.0f, m_stack[3], 255.0f)),
+                };
+            }
+
+            closeContour();
+            m_size = 0;
+            m_isFinished = true;
+            return;
+        }
+        case Operator::ESCAPE: {
+            need(1);
+            runEscaped(*p++);
+            break;
+        }
+        case Operator::VARIATION_STORE_INDEX: {
+            if (!m_charStrings.isCff2) {
+                throw QString("vsindex in CFF");
+            }
+
+            m_vsindex = quint16(qBound(0.0f, pop(), 65535.0f));
+            m_size = 0;
+            break;
+        }
+        case Operator::BLEND: {
+            if (!m_charStrings.isCff2) {
+                throw QString("blend in CFF");
+            }
+
+            blend();
+            break;
+        }
+        default:
+            throw QString("invalid charstring operator %1").arg(op);
+        }
+    }
+}
+
+// Replaces N default values and N * K deltas with N blended values.
+void Interpreter::blend()
+{
+    const auto count = popInt();
+    const auto &regions = m_charStrings.variationStore.regionIndexes(m_vsindex);
+    const auto numberOfRegions = regions.size();
+    const auto total = qint64(count) * (numberOfRegions + 1);
+    if (count < 0 || total > m_size) {
+        throw QString("not enough blend operands");
+    }
+
+    const auto first = m_size - int(total);
+    if (m_blendScalars && m_vsindex < m_blendScalars->size()) {
+        const auto &scalars = m_blendScalars->at(m_vsindex);
+        const auto *deltas = m_stack + first + count;
+        for (int i = 0; i < count; ++i) {
+            float value = m_stack[first + i];
+            for (int j = 0; j < numberOfRegions; ++j) {
+                value += deltas[i * numberOfRegions + j] * scalars[j];
+            }
+            m_stack[first + i] = value;
+        }
+    }
+
+    m_size = first + count;
+}
+
+void Interpreter::runEscaped(const quint8 op)
+{
+    const auto *s = m_stack;
+    switch (op) {
+    case Operator::HFLEX: {
+        require(7);
+        curveTo(s[0], 0, s[1], s[2], s[3], 0);
+        curveTo(s[4], 0, s[5], -s[2], s[6], 0);
+        m_size = 0;
+        break;
+    }
+    case Operator::FLEX: {
+        // The flex depth is ignored, since curves are never flattened.
+        require(13);
+        curveTo(s[0], s[1], s[2], s[3], s[4], s[5]);
+        curveTo(s[6], s[7], s[8], s[9], s[10], s[11]);
+        m_size = 0;
+        break;
+    }
+    case Operator::HFLEX1: {
+        require(9);
+        curveTo(s[0], s[1], s[2], s[3], s[4], 0);
+        curveTo(s[5], 0, s[6], s[7], s[8], -(s[1] + s[3] + s[7]));
+        m_size = 0;
+        break;
+    }
+    case Operator::FLEX1: {
+        require(11);
+        const auto dx = s[0] + s[2] + s[4] + s[6] + s[8];
+        const auto dy = s[1] + s[3] + s[5] + s[7] + s[9];
+        curveTo(s[0], s[1], s[2], s[3], s[4], s[5]);
+        if (std::abs(dx) > std::abs(dy)) {
+            curveTo(s[6], s[7], s[8], s[9], s[10], -dy);
+        } else {
+            curveTo(s[6], s[7], s[8], s[9], -dx, s[10]);
+        }
+        m_size = 0;
+        break;
+    }
+    case Operator::AND: {
+        const auto b = pop();
+        const auto a = pop();
+        push(a != 0 && b != 0 ? 1 : 0);
+        break;
+    }
+    case Operator::OR: {
+        const auto b = pop();
+        const auto a = pop();
+        push(a != 0 || b != 0 ? 1 : 0);
+        break;
+    }
+    case Operator::NOT: {
+        push(pop() == 0 ? 1 : 0);
+        break;
+    }
+    case Operator::ABS: {
+        push(std::abs(pop()));
+        break;
+    }
+    case Operator::ADD: {
+        const auto b = pop();
+        push(pop() + b);
+        break;
+    }
+    case Operator::SUB: {
+        const auto b = pop();
+        push(pop() - b);
+        break;
+    }
+    case Operator::DIV: {
+        const auto b = pop();
+        const auto a = pop();
+        push(b != 0 ? a / b : 0);
+        break;
+    }
+    case Operator::NEG: {
+        push(-pop());
+        break;
+    }
+    case Operator::EQ: {
+        push(pop() == pop() ? 1 : 0);
+        break;
+    }
+    case Operator::DROP: {
+        pop();
+        break;
+    }
+    case Operator::PUT: {
+        const auto index = popInt();
+        const auto value = pop();
+        if (index >= 0 && index < TransientArraySize) {
+            m_transient[index] = value;
+        }
+        break;
+    }
+    case Operator::GET: {
+        const auto index = popInt();
+        push(index >= 0 && index < TransientArraySize ? m_transient[index] : 0);
+        break;
+    }
+    case Operator::IFELSE: {
+        const auto v2 = pop();
+        const auto v1 = pop();
+        const auto s2 = pop();
+        const auto s1 = pop();
+        push(v1 <= v2 ? s1 : s2);
+        break;
+    }
+    case Operator::RANDOM: {
+        // Must be in (0, 1]. A fixed value keeps outlines reproducible.
+        push(0.5f);
+        break;
+    }
+    case Operator::MUL: {
+        const auto b = pop();
+        push(pop() * b);
+        break;
+    }
+    case Operator::SQRT: {
+        push(std::sqrt(std::abs(pop())));
+        break;
+    }
+    case Operator::DUP: {
+        const auto a = pop();
+        push(a);
+        push(a);
+        break;
+    }
+    case Operator::EXCH: {
+        const auto b = pop();
+        const auto a = pop();
+        push(b);
+        push(a);
+        break;
+    }
+    case Operator::INDEX: {
+        auto index = popInt();
+        require(1);
+        if (index < 0) {
+            index = 0;
+        }
+        push(m_stack[std::max(0, m_size - 1 - index)]);
+        break;
+    }
+    case Operator::ROLL: {
+        const auto shift = popInt();
+        const auto count = popInt();
+        if (count <= 0 || count > m_size) {
+            throw QString("invalid roll operands");
+        }
+
+        const auto first = m_stack + m_size - count;
+        const auto middle = ((-shift % count) + count) % count;
+        std::rotate(first, first + middle, m_stack + m_size);
+        break;
+    }
+    default:
+        throw QString("invalid charstring operator 12 %1").arg(op);
+    }
+}
+
+const CharStrings::Private& privateFor(const CharStrings &charStrings, const quint16 glyphId)
+{
+    static const CharStrings::Private Empty;
+
+    if (charStrings.privates.isEmpty()) {
+        return Empty;
+    }
+
+    int index = 0;
+    if (!charStrings.fdSelect.isEmpty()) {
+        index = glyphId < charStrings.fdSelect.size() ? charStrings.fdSelect[glyphId] : -1;
+    }
+
+    if (index < 0 || index >= charStrings.privates.size()) {
+        throw QString("invalid Font DICT index");
+    }
+
+    return charStrings.privates[index];
+}
+
+void interpretGlyph(const quint8 *table, const quint32 tableSize, const CharStrings &charStrings,
+                    const quint16 glyphId, const QVector<QVector<float>> *blendScalars,
+                    const float x, const float y, const bool allowSeac,
+                    GlyphOutline &outline, float *advance)
+{
+    if (glyphId >= charStrings.numberOfGlyphs()) {
+        throw QString("invalid glyph ID");
+    }
+
+    Interpreter interpreter(table, tableSize, charStrings, privateFor(charStrings, glyphId),
+                            blendScalars, x, y, outline);
+    interpreter.run(charStrings.charStrings[glyphId], charStrings.charStrings[glyphId + 1], 0);
+    interpreter.finish();
+
+    if (advance) {
+        *advance = interpreter.width();
+    }
+
+    if (const auto &seac = interpreter.seac()) {
+        // Components cannot be composite themselves.
+        if (!allowSeac) {
+            throw QString("nested seac");
+        }
+
+        auto glyphByCode = [&](const quint8 code) {
+            const auto id = code < charStrings.standardEncoding.size()
+                ? charStrings.standardEncoding[code] : quint16(0);
+            if (id == 0) {
+                throw QString("invalid seac character");
+            }
+
+            return id;
+        };
+
+        interpretGlyph(table, tableSize, charStrings, glyphByCode(seac->baseCode), nullptr,
+                       x, y, false, outline, nullptr);
+        interpretGlyph(table, tableSize, charStrings, glyphByCode(seac->accentCode), nullptr,
+                       x + seac->dx, y + seac->dy, false, outline, nullptr);
+    }
+}
+
+}
+
+GlyphOutline interpretCharString(const quint8 *table, const quint32 tableSize,
+                                 const CharStrings &charStrings, const quint16 glyphId,
+                                 float *advance)
+{
+    GlyphOutline outline;
+    interpretGlyph(table, tableSize, charStrings, glyphId, nullptr, 0, 0, true, outline, advance);
+    return outline;
+}
+
+GlyphOutline interpretCharString(const quint8 *table, const quint32 tableSize,
+                                 const CharStrings &charStrings, const quint16 glyphId,
+                                 const QVector<QVector<float>> &blendScalars)
+{
+    GlyphOutline outline;
+    interpretGlyph(table, tableSize, charStrings, glyphId, &blendScalars, 0, 0, false, outline, nullptr);
+    return outline;
+}
+
+QVector<QVector<float>> CharStrings::blendScalars(const QVector<float> &coordinates) const
+{
+    const auto regionScalars = variationStore.regionScalars(coordinates);
+
+    QVector<QVector<float>> scalars;
+    scalars.reserve(variationStore.numberOfDataSets());
+    for (int i = 0; i < variationStore.numberOfDataSets(); ++i) {
+        QVector<float> dataScalars;
+        for (const auto region : variationStore.regionIndexes(quint16(i))) {
+            dataScalars << regionScalars[region];
+        }
+        scalars << dataScalars;
+    }
+
+    return scalars;
+}
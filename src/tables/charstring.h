@@ -0,0 +1,66 @@
+#pragma once
+
+#include "glyf.h"
+#include "varstore.h"
+
+// Font-level data needed to interpret Type 2 charstrings.
+//
+// All INDEXes are decoded once per font, so a subroutine call is a single lookup
+// instead of an INDEX walk. Offsets are relative to the start of the table.
+struct CharStrings
+{
+    struct Private
+    {
+        // Local Subr INDEX offsets followed by the end offset.
+        QVector<quint32> subrs;
+        float defaultWidthX = 0;
+        float nominalWidthX = 0;
+        // The default ItemVariationData index for `blend`. CFF2 only.
+        quint16 vsindex = 0;
+    };
+
+    bool isCff2 = false;
+
+    // CharStrings INDEX offsets followed by the end offset.
+    QVector<quint32> charStrings;
+    QVector<quint32> globalSubrs;
+    QVector<Private> privates;
+    // A `privates` index per glyph. Empty when there is only one Private DICT.
+    QVector<quint16> fdSelect;
+    // Glyph IDs by StandardEncoding codes, used by `seac`. Zero when not present.
+    QVector<quint16> standardEncoding;
+    // Referenced by `blend`. CFF2 only.
+    ItemVariationStore variationStore;
+
+    quint16 numberOfGlyphs() const
+    {
+        return charStrings.isEmpty() ? 0 : quint16(charStrings.size() - 1);
+    }
+
+    // Returns region scalars of each ItemVariationData at normalized coordinates.
+    //
+    // Computed once per instance and shared by all glyphs.
+    QVector<QVector<float>> blendScalars(const QVector<float> &coordinates) const;
+};
+
+// The parser must be at the start of a `CFF ` table.
+CharStrings collectCffCharStrings(ShadowParser &parser);
+
+// The parser must be at the start of a `CFF2` table.
+CharStrings collectCff2CharStrings(ShadowParser &parser);
+
+// Interprets a glyph charstring. CFF2 glyphs are interpreted at the default instance.
+//
+// Cubic curve control points are marked with 2 in GlyphOutline::onCurve.
+// `table` must point to the table `charStrings` were collected from.
+// `advance` is set to the glyph advance width when not null.
+GlyphOutline interpretCharString(const quint8 *table, const quint32 tableSize,
+                                 const CharStrings &charStrings, const quint16 glyphId,
+                                 float *advance = nullptr);
+
+// Interprets a CFF2 glyph charstring at an instance defined by CharStrings::blendScalars.
+//
+// CFF2 charstrings have no advance widths.
+GlyphOutline interpretCharString(const quint8 *table, const quint32 tableSize,
+                                 const CharStrings &charStrings, const quint16 glyphId,
+                                 const QVector<QVector<float>> &blendScalars);
@@ -1,4 +1,7 @@
+#include <map>
+
 #include "src/algo.h"
+#include "cmap.h"
 #include "name.h"
 #include "tables.h"
 
@@ -289,3 +292,345 @@ void parseCmap(Parser &parser)
         parser.endGroup(QString("Subtable %1").arg(format), title);
     }
 }
+
+CharacterMap::CharacterMap()
+    : m_bmpPages(256, 0)
+{
+    m_bmpPageIndex.fill(0);
+}
+
+quint16 CharacterMap::supplementaryGlyphId(const quint32 codepoint) const
+{
+    const auto it = std::upper_bound(m_runs.begin(), m_runs.end(), codepoint,
+                                     [](const quint32 c, const Run &run){ return c < run.first; });
+    if (it == m_runs.begin()) {
+        return 0;
+    }
+
+    const auto &run = *(it - 1);
+    return codepoint <= run.last ? run.glyphId(codepoint) : 0;
+}
+
+QVector<quint32> CharacterMap::codepoints(const quint16 glyphId) const
+{
+    if (glyphId + 1 >= m_reverseOffsets.size()) {
+        return {};
+    }
+
+    const auto start = m_reverseOffsets[glyphId];
+    const auto end = m_reverseOffsets[glyphId + 1];
+    return m_reverseCodepoints.mid(int(start), int(end - start));
+}
+
+// Lower is better. -1 indicates an unsupported subtable.
+static int subtablePriority(const quint16 platformId, const quint16 encodingId, const quint16 format)
+{
+    switch (format) {
+        case 0: case 4: case 6: case 10: case 12: case 13: break;
+        default: return -1;
+    }
+
+    if ((platformId == 0 && (encodingId == 4 || encodingId == 6)) || (platformId == 3 && encodingId == 10)) {
+        return 0; // Full Unicode.
+    }
+
+    if ((platformId == 0 && encodingId != 5) || (platformId == 3 && encodingId == 1)) {
+        return 1; // BMP only.
+    }
+
+    if (platformId == 3 && encodingId == 0) {
+        return 2; // Symbol.
+    }
+
+    return -1;
+}
+
+namespace {
+
+class CharacterMapBuilder
+{
+public:
+    CharacterMapBuilder()
+        : m_bmp(0x10000, 0)
+    {
+    }
+
+    void add(const quint32 codepoint, const quint16 glyphId)
+    {
+        if (codepoint < 0x10000) {
+            m_bmp[int(codepoint)] = glyphId;
+        } else {
+            m_runs.append({ codepoint, codepoint, glyphId, glyphId == 0 });
+        }
+    }
+
+    void addRange(const quint32 first, const quint32 last, const quint32 glyphId, const bool isConstant)
+    {
+        if (first > last || first > 0x10FFFF) {
+            return;
+        }
+
+        const auto end = std::min<quint32>(last, 0x10FFFF);
+        quint32 c = first;
+        for (; c <= end && c < 0x10000; ++c) {
+            m_bmp[int(c)] = quint16(isConstant ? glyphId : glyphId + (c - first));
+        }
+
+        if (c <= end) {
+            const auto startGlyphId = isConstant ? glyphId : glyphId + (c - first);
+            m_runs.append({ c, end, startGlyphId, isConstant });
+        }
+    }
+
+    // A full BMP array, indexed by codepoint.
+    const QVector<quint16>& bmp() const { return m_bmp; }
+
+    // Supplementary runs sorted by the first codepoint, with adjacent runs merged.
+    //
+    // Overlapping runs are malformed. Like in the BMP table, a later run overrides
+    // an earlier one, which is clipped or split. Runs mapped to glyph 0 are removed
+    // after that, so they still override earlier runs.
+    QVector<CharacterMap::Run> runs()
+    {
+        using Run = CharacterMap::Run;
+        const auto clipped = [](const Run &run, const quint32 first, const quint32 last) {
+            const auto startGlyphId = run.isConstant ? run.startGlyphId : run.startGlyphId + (first - run.first);
+            return Run { first, last, startGlyphId, run.isConstant };
+        };
+
+        // Disjoint runs by the first codepoint.
+        std::map<quint32, Run> disjoint;
+        for (const auto &run : m_runs) {
+            auto it = disjoint.upper_bound(run.first);
+            if (it != disjoint.begin()) {
+                const auto prev = std::prev(it);
+                const auto old = prev->second;
+                if (old.last >= run.first) {
+                    if (old.first < run.first) {
+                        prev->second.last = run.first - 1;
+                    } else {
+                        disjoint.erase(prev);
+                    }
+
+                    if (old.last > run.last) {
+                        disjoint.emplace(run.last + 1, clipped(old, run.last + 1, old.last));
+                    }
+                }
+            }
+
+            it = disjoint.lower_bound(run.first);
+            while (it != disjoint.end() && it->first <= run.last) {
+                const auto old = it->second;
+                it = disjoint.erase(it);
+                if (old.last > run.last) {
+                    disjoint.emplace(run.last + 1, clipped(old, run.last + 1, old.last));
+                    break;
+                }
+            }
+
+            disjoint.emplace(run.first, run);
+        }
+
+        QVector<Run> merged;
+        for (const auto &entry : disjoint) {
+            const auto &run = entry.second;
+            if (run.isConstant && run.startGlyphId == 0) {
+                continue;
+            }
+
+            if (!merged.isEmpty()) {
+                auto &prev = merged.last();
+                if (!prev.isConstant && !run.isConstant && prev.last + 1 == run.first
+                    && quint32(prev.glyphId(prev.last)) + 1 == run.startGlyphId)
+                {
+                    prev.last = run.last;
+                    continue;
+                }
+            }
+
+            merged.append(run);
+        }
+
+        return merged;
+    }
+
+private:
+    QVector<quint16> m_bmp;
+    QVector<CharacterMap::Run> m_runs;
+};
+
+}
+
+static void decodeFormat4(const quint32 subtableStart, ShadowParser &parser, CharacterMapBuilder &builder)
+{
+    parser.jumpTo(subtableStart + 6);
+    const auto segCount = quint32(parser.read<UInt16>() / 2);
+    const auto endCodesStart = subtableStart + 14;
+    const auto startCodesStart = endCodesStart + segCount * 2 + 2;
+    const auto deltasStart = startCodesStart + segCount * 2;
+    const auto offsetsStart = deltasStart + segCount * 2;
+
+    for (quint32 i = 0; i < segCount; ++i) {
+        parser.jumpTo(endCodesStart + i * 2);
+        const quint32 end = parser.read<UInt16>();
+        parser.jumpTo(startCodesStart + i * 2);
+        const quint32 start = parser.read<UInt16>();
+        parser.jumpTo(deltasStart + i * 2);
+        const auto delta = quint16(parser.read<Int16>());
+        const auto rangeOffsetPos = offsetsStart + i * 2;
+        parser.jumpTo(rangeOffsetPos);
+        const quint32 rangeOffset = parser.read<UInt16>();
+
+        for (quint32 c = start; c <= end && c != 0xFFFF; ++c) {
+            quint16 id = 0;
+            if (rangeOffset == 0) {
+                id = quint16(c + delta);
+            } else {
+                parser.jumpTo(rangeOffsetPos + rangeOffset + (c - start) * 2);
+                id = parser.read<UInt16>();
+                if (id != 0) {
+                    id = quint16(id + delta);
+                }
+            }
+
+            builder.add(c, id);
+        }
+    }
+}
+
+static void decodeTrimmedArray(const quint32 firstCode, const quint32 count,
+                               ShadowParser &parser, CharacterMapBuilder &builder)
+{
+    for (quint32 i = 0; i < count; ++i) {
+        builder.add(firstCode + i, parser.read<GlyphId>());
+    }
+}
+
+static void decodeGroups(const quint32 subtableStart, const bool isConstant,
+                         ShadowParser &parser, CharacterMapBuilder &builder)
+{
+    parser.jumpTo(subtableStart + 12);
+    const auto count = parser.read<UInt32>();
+    for (quint32 i = 0; i < count; ++i) {
+        const auto first = parser.read<UInt32>();
+        const auto last = parser.read<UInt32>();
+        const auto glyphId = parser.read<UInt32>();
+        builder.addRange(first, last, glyphId, isConstant);
+    }
+}
+
+CharacterMap collectCharacterMap(ShadowParser &parser)
+{
+    const auto tableStart = parser.offset();
+
+    CharacterMap map;
+    if (parser.read<UInt16>() != 0) {
+        return map;
+    }
+
+    struct Record
+    {
+        quint16 platformId;
+        quint16 encodingId;
+        quint16 format;
+        quint32 offset;
+    };
+
+    std::optional<Record> best;
+    int bestPriority = -1;
+
+    const auto numberOfTables = parser.read<UInt16>();
+    for (quint16 i = 0; i < numberOfTables; ++i) {
+        parser.jumpTo(tableStart + 4 + quint32(i) * 8);
+        const quint16 platformId = parser.read<UInt16>();
+        const quint16 encodingId = parser.read<UInt16>();
+        const auto offset = tableStart + parser.read<Offset32>();
+
+        parser.jumpTo(offset);
+        const quint16 format = parser.read<UInt16>();
+
+        const auto priority = subtablePriority(platformId, encodingId, format);
+        if (priority != -1 && (!best || priority < bestPriority)) {
+            best = Record { platformId, encodingId, format, offset };
+            bestPriority = priority;
+        }
+    }
+
+    if (!best) {
+        return map;
+    }
+
+    CharacterMapBuilder builder;
+    const auto start = best->offset;
+    switch (best->format) {
+        case 0: {
+            parser.jumpTo(start + 6);
+            decodeTrimmedArray(0, 256, parser, builder);
+            break;
+        }
+        case 4: {
+            decodeFormat4(start, parser, builder);
+            break;
+        }
+        case 6: {
+            parser.jumpTo(start + 6);
+            const quint32 firstCode = parser.read<UInt16>();
+            const quint32 count = parser.read<UInt16>();
+            decodeTrimmedArray(firstCode, count, parser, builder);
+            break;
+        }
+        case 10: {
+            parser.jumpTo(start + 12);
+            const auto firstCode = parser.read<UInt32>();
+            const auto count = parser.read<UInt32>();
+            decodeTrimmedArray(firstCode, count, parser, builder);
+            break;
+        }
+        case 12: {
+            decodeGroups(start, false, parser, builder);
+            break;
+        }
+        case 13: {
+            decodeGroups(start, true, parser, builder);
+            break;
+        }
+        default: break;
+    }
+
+    map.m_platformId = best->platformId;
+    map.m_encodingId = best->encodingId;
+    map.m_format = best->format;
+
+    const auto &bmp = builder.bmp();
+    for (quint32 page = 0; page < 256; ++page) {
+        const auto *data = bmp.constData() + page * 256;
+        if (std::all_of(data, data + 256, [](const quint16 id){ return id == 0; })) {
+            continue;
+        }
+
+        map.m_bmpPageIndex[page] = quint16(map.m_bmpPages.size() / 256);
+        for (int i = 0; i < 256; ++i) {
+            map.m_bmpPages.append(data[i]);
+        }
+    }
+
+    map.m_runs = builder.runs();
+
+    // Build the reverse map.
+    quint32 maxGlyphId = 0;
+    map.forEach([&](const quint32, const quint16 id){ maxGlyphId = std::max<quint32>(maxGlyphId, id); });
+
+    auto &offsets = map.m_reverseOffsets;
+    offsets.fill(0, int(maxGlyphId) + 2);
+    map.forEach([&](const quint32, const quint16 id){ offsets[id + 1] += 1; });
+    for (int i = 1; i < offsets.size(); ++i) {
+        offsets[i] += offsets[i - 1];
+    }
+
+    map.m_numberOfCodepoints = offsets.last();
+    map.m_reverseCodepoints.resize(int(map.m_numberOfCodepoints));
+    auto next = offsets;
+    map.forEach([&](const quint32 c, const quint16 id){ map.m_reverseCodepoints[int(next[id]++)] = c; });
+
+    return map;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+
+#include "src/parser.h"
+
+// A decoded Unicode codepoint to glyph mapping.
+//
+// The Basic Multilingual Plane is stored as a two-level page table, where all empty
+// pages share the same storage. Supplementary planes are stored as sorted runs,
+// which is how they are defined by the format 12 and 13 subtables anyway.
+class CharacterMap
+{
+public:
+    // A range of supplementary codepoints.
+    struct Run
+    {
+        quint32 first;
+        quint32 last;
+        quint32 startGlyphId;
+        bool isConstant;
+
+        quint16 glyphId(const quint32 codepoint) const
+        { return quint16(isConstant ? startGlyphId : startGlyphId + (codepoint - first)); }
+    };
+
+    CharacterMap();
+
+    // Returns 0 for unmapped codepoints.
+    quint16 glyphId(const quint32 codepoint) const
+    {
+        if (codepoint < 0x10000) {
+            return m_bmpPages[(quint32(m_bmpPageIndex[codepoint >> 8]) << 8) | (codepoint & 0xFF)];
+        }
+
+        return supplementaryGlyphId(codepoint);
+    }
+
+    // Returns all codepoints mapped to the glyph in ascending order.
+    QVector<quint32> codepoints(const quint16 glyphId) const;
+
+    // Calls `f(codepoint, glyphId)` for each mapped codepoint in ascending order.
+    template<typename F>
+    void forEach(F f) const
+    {
+        for (quint32 page = 0; page < 256; ++page) {
+            const auto index = m_bmpPageIndex[page];
+            if (index == 0) {
+                continue;
+            }
+
+            for (quint32 i = 0; i < 256; ++i) {
+                if (const auto id = m_bmpPages[(quint32(index) << 8) | i]) {
+                    f((page << 8) | i, id);
+                }
+            }
+        }
+
+        for (const auto &run : m_runs) {
+            for (quint32 c = run.first; c <= run.last; ++c) {
+                if (const auto id = run.glyphId(c)) {
+                    f(c, id);
+                }
+            }
+        }
+    }
+
+    bool isEmpty() const { return m_numberOfCodepoints == 0; }
+    quint32 numberOfCodepoints() const { return m_numberOfCodepoints; }
+
+    // The subtable the map was built from.
+    quint16 platformId() const { return m_platformId; }
+    quint16 encodingId() const { return m_encodingId; }
+    quint16 format() const { return m_format; }
+
+private:
+    friend CharacterMap collectCharacterMap(ShadowParser &parser);
+
+    quint16 supplementaryGlyphId(const quint32 codepoint) const;
+
+    std::array<quint16, 256> m_bmpPageIndex;
+    // Page 0 is always empty.
+    QVector<quint16> m_bmpPages;
+    QVector<Run> m_runs;
+    // Glyph to codepoints map in a compressed sparse row form.
+    QVector<quint32> m_reverseOffsets;
+    QVector<quint32> m_reverseCodepoints;
+    quint32 m_numberOfCodepoints = 0;
+    quint16 m_platformId = 0;
+    quint16 m_encodingId = 0;
+    quint16 m_format = 0;
+};
+
+// Builds a map from the preferred Unicode subtable.
+// `parser` must be positioned at the start of the `cmap` table.
+CharacterMap collectCharacterMap(ShadowParser &parser);
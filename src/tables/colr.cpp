@@ -0,0 +1,677 @@
+#include <QHash>
+#include <QSet>
+
+#include <array>
+#include <vector>
+
+#include "src/parser.h"
+#include "subtables.h"
+#include "tables.h"
+
+enum class ColrSubtableType
+{
+    BaseGlyphRecords,
+    LayerRecords,
+    BaseGlyphList,
+    LayerList,
+    ClipList,
+    VarIndexMap,
+    ItemVariationStore,
+    Paint,
+    ColorLine,
+    VarColorLine,
+    Affine,
+    VarAffine,
+    ClipBox,
+    LastType,
+};
+
+static QString subtableName(const ColrSubtableType type)
+{
+    switch (type) {
+    case ColrSubtableType::BaseGlyphRecords: return "Base Glyph Records";
+    case ColrSubtableType::LayerRecords: return "Layer Records";
+    case ColrSubtableType::BaseGlyphList: return "Base Glyph List";
+    case ColrSubtableType::LayerList: return "Layer List";
+    case ColrSubtableType::ClipList: return "Clip List";
+    case ColrSubtableType::VarIndexMap: return "Variation Index Map";
+    case ColrSubtableType::ItemVariationStore: return "Item Variation Store";
+    case ColrSubtableType::Paint: return "Paint";
+    case ColrSubtableType::ColorLine: return "Color Line";
+    case ColrSubtableType::VarColorLine: return "Variable Color Line";
+    case ColrSubtableType::Affine: return "Affine Transformation";
+    case ColrSubtableType::VarAffine: return "Variable Affine Transformation";
+    case ColrSubtableType::ClipBox: return "Clip Box";
+    case ColrSubtableType::LastType: break;
+    }
+
+    Q_UNREACHABLE();
+}
+
+struct ColrSubtable
+{
+    ColrSubtableType type;
+    // An absolute offset.
+    quint32 offset = 0;
+    // The number of version 0 records.
+    quint16 count = 0;
+    QString title;
+};
+
+// Paints, color lines, transformations and clip boxes are often shared between glyphs.
+using ColrSubtables = SubtableQueue<ColrSubtable>;
+
+enum class PaintField : quint8
+{
+    UInt8,
+    UInt16,
+    UInt32,
+    GlyphId,
+    FWord,
+    UFWord,
+    F2Dot14,
+    Fixed,
+    CompositeMode,
+    Paint,
+    ColorLine,
+    Affine,
+};
+
+static quint32 paintFieldSize(const PaintField field)
+{
+    switch (field) {
+    case PaintField::UInt8: return UInt8::Size;
+    case PaintField::UInt16: return UInt16::Size;
+    case PaintField::UInt32: return UInt32::Size;
+    case PaintField::GlyphId: return GlyphId::Size;
+    case PaintField::FWord: return Int16::Size;
+    case PaintField::UFWord: return UInt16::Size;
+    case PaintField::F2Dot14: return F2DOT14::Size;
+    case PaintField::Fixed: return F16DOT16::Size;
+    case PaintField::CompositeMode: return UInt8::Size;
+    case PaintField::Paint: return Offset24::Size;
+    case PaintField::ColorLine: return Offset24::Size;
+    case PaintField::Affine: return Offset24::Size;
+    }
+
+    Q_UNREACHABLE();
+}
+
+struct PaintFieldInfo
+{
+    PaintField type;
+    const char *title;
+};
+
+struct PaintFormat
+{
+    QString name;
+    // Fields after the format.
+    std::vector<PaintFieldInfo> fields;
+    bool isVariable = false;
+};
+
+// Paint tables are described by data, so the tree parser and the cycle detection
+// read the same layout. Variable formats follow their base format.
+static const std::array<PaintFormat, 33>& paintFormats()
+{
+    static const auto formats = []{
+        const PaintFieldInfo paint = { PaintField::Paint, "Offset to Paint table" };
+        const PaintFieldInfo colorLine = { PaintField::ColorLine, "Offset to ColorLine table" };
+        const PaintFieldInfo centerX = { PaintField::FWord, "Center X" };
+        const PaintFieldInfo centerY = { PaintField::FWord, "Center Y" };
+
+        std::array<PaintFormat, 33> list;
+        list[1] = { "Layers", {
+            { PaintField::UInt8, "Number of layers" },
+            { PaintField::UInt32, "Index of the first layer" },
+        }};
+        list[2] = { "Solid", {
+            { PaintField::UInt16, "Palette index" },
+            { PaintField::F2Dot14, "Alpha" },
+        }};
+        list[4] = { "Linear Gradient", {
+            colorLine,
+            { PaintField::FWord, "Start X" },
+            { PaintField::FWord, "Start Y" },
+            { PaintField::FWord, "End X" },
+            { PaintField::FWord, "End Y" },
+            { PaintField::FWord, "Rotation point X" },
+            { PaintField::FWord, "Rotation point Y" },
+        }};
+        list[6] = { "Radial Gradient", {
+            colorLine,
+            { PaintField::FWord, "Start circle center X" },
+            { PaintField::FWord, "Start circle center Y" },
+            { PaintField::UFWord, "Start circle radius" },
+            { PaintField::FWord, "End circle center X" },
+            { PaintField::FWord, "End circle center Y" },
+            { PaintField::UFWord, "End circle radius" },
+        }};
+        list[8] = { "Sweep Gradient", {
+            colorLine,
+            centerX,
+            centerY,
+            { PaintField::F2Dot14, "Start angle" },
+            { PaintField::F2Dot14, "End angle" },
+        }};
+        list[10] = { "Glyph", {
+            paint,
+            { PaintField::GlyphId, "Glyph ID" },
+        }};
+        list[11] = { "Color Glyph", {
+            { PaintField::GlyphId, "Base glyph ID" },
+        }};
+        list[12] = { "Transform", {
+            paint,
+            { PaintField::Affine, "Offset to Affine2x3 table" },
+        }};
+        list[14] = { "Translate", {
+            paint,
+            { PaintField::FWord, "Translation X" },
+            { PaintField::FWord, "Translation Y" },
+        }};
+        list[16] = { "Scale", {
+            paint,
+            { PaintField::F2Dot14, "Scale X" },
+            { PaintField::F2Dot14, "Scale Y" },
+        }};
+        list[18] = { "Scale Around Center", {
+            paint,
+            { PaintField::F2Dot14, "Scale X" },
+            { PaintField::F2Dot14, "Scale Y" },
+            centerX,
+            centerY,
+        }};
+        list[20] = { "Scale Uniform", {
+            paint,
+            { PaintField::F2Dot14, "Scale" },
+        }};
+        list[22] = { "Scale Uniform Around Center", {
+            paint,
+            { PaintField::F2Dot14, "Scale" },
+            centerX,
+            centerY,
+        }};
+        list[24] = { "Rotate", {
+            paint,
+            { PaintField::F2Dot14, "Angle" },
+        }};
+        list[26] = { "Rotate Around Center", {
+            paint,
+            { PaintField::F2Dot14, "Angle" },
+            centerX,
+            centerY,
+        }};
+        list[28] = { "Skew", {
+            paint,
+            { PaintField::F2Dot14, "X skew angle" },
+            { PaintField::F2Dot14, "Y skew angle" },
+        }};
+        list[30] = { "Skew Around Center", {
+            paint,
+            { PaintField::F2Dot14, "X skew angle" },
+            { PaintField::F2Dot14, "Y skew angle" },
+            centerX,
+            centerY,
+        }};
+        list[32] = { "Composite", {
+            { PaintField::Paint, "Offset to source Paint table" },
+            { PaintField::CompositeMode, "Composite mode" },
+            { PaintField::Paint, "Offset to backdrop Paint table" },
+        }};
+
+        for (quint8 format = 3; format <= 31; format += 2) {
+            if (format == 11) {
+                continue;
+            }
+
+            auto &var = list[format];
+            var = list[format - 1];
+            var.name = "Variable " + var.name;
+            var.fields.push_back({ PaintField::UInt32, "Base variation index" });
+            var.isVariable = true;
+        }
+
+        return list;
+    }();
+
+    return formats;
+}
+
+static const PaintFormat* paintFormat(const quint8 format)
+{
+    if (format < paintFormats().size() && !paintFormats()[format].name.isEmpty()) {
+        return &paintFormats()[format];
+    }
+
+    return nullptr;
+}
+
+static QString compositeModeName(const quint8 mode)
+{
+    switch (mode) {
+    case 0: return "Clear";
+    case 1: return "Source";
+    case 2: return "Destination";
+    case 3: return "Source Over";
+    case 4: return "Destination Over";
+    case 5: return "Source In";
+    case 6: return "Destination In";
+    case 7: return "Source Out";
+    case 8: return "Destination Out";
+    case 9: return "Source Atop";
+    case 10: return "Destination Atop";
+    case 11: return "XOR";
+    case 12: return "Plus";
+    case 13: return "Screen";
+    case 14: return "Overlay";
+    case 15: return "Darken";
+    case 16: return "Lighten";
+    case 17: return "Color Dodge";
+    case 18: return "Color Burn";
+    case 19: return "Hard Light";
+    case 20: return "Soft Light";
+    case 21: return "Difference";
+    case 22: return "Exclusion";
+    case 23: return "Multiply";
+    case 24: return "Hue";
+    case 25: return "Saturation";
+    case 26: return "Color";
+    case 27: return "Luminosity";
+    default: return "Unknown";
+    }
+}
+
+// Finds paints that reference one of their ancestors.
+//
+// Offsets to child paints always point forward, so cycles can be formed only
+// by layer and color glyph paints. Each paint is visited once.
+//
+// `parser` must be positioned at the start of the table. Offsets are from the start of the table.
+static QSet<quint32> findPaintCycles(const quint32 tableSize,
+                                     const quint32 baseGlyphListOffset,
+                                     const quint32 layerListOffset,
+                                     ShadowParser &parser)
+{
+    // Glyph paints are kept in the record order as well, so the result does not depend on hashing.
+    QHash<quint16, quint32> baseGlyphPaints;
+    QVector<quint32> glyphPaints;
+    QVector<quint32> layerPaints;
+    QSet<quint32> cyclic;
+
+    // A paint that cannot be read will be reported by the tree parser.
+    try {
+        if (baseGlyphListOffset != 0) {
+            parser.jumpTo(baseGlyphListOffset);
+            const auto count = parser.read<UInt32>();
+            for (quint32 i = 0; i < count; ++i) {
+                const auto glyphId = parser.read<GlyphId>();
+                const auto offset = parser.read<Offset32>();
+                baseGlyphPaints.insert(glyphId, baseGlyphListOffset + offset);
+                glyphPaints << baseGlyphListOffset + offset;
+            }
+        }
+
+        if (layerListOffset != 0) {
+            parser.jumpTo(layerListOffset);
+            const auto count = parser.read<UInt32>();
+            layerPaints.reserve(int(qMin(quint32(count), parser.left() / Offset32::Size)));
+            for (quint32 i = 0; i < count; ++i) {
+                layerPaints << layerListOffset + parser.read<Offset32>();
+            }
+        }
+
+        const auto children = [&](const quint32 offset) {
+            QVector<quint32> offsets;
+            if (offset >= tableSize) {
+                return offsets;
+            }
+
+            parser.jumpTo(offset);
+            const auto format = parser.read<UInt8>();
+            if (format == 1) {
+                const quint32 count = parser.read<UInt8>();
+                const quint32 first = parser.read<UInt32>();
+                for (quint32 i = first; i < first + count && i < quint32(layerPaints.size()); ++i) {
+                    offsets << layerPaints[int(i)];
+                }
+            } else if (format == 11) {
+                const auto paint = baseGlyphPaints.value(parser.read<GlyphId>(), 0);
+                if (paint != 0) {
+                    offsets << paint;
+                }
+            } else if (const auto info = paintFormat(format)) {
+                auto fieldOffset = offset + UInt8::Size;
+                for (const auto &field : info->fields) {
+                    if (field.type == PaintField::Paint) {
+                        parser.jumpTo(fieldOffset);
+                        const auto child = parser.read<Offset24>();
+                        if (child != 0) {
+                            offsets << offset + child;
+                        }
+                    }
+                    fieldOffset += paintFieldSize(field.type);
+                }
+            }
+
+            return offsets;
+        };
+
+        struct Frame
+        {
+            quint32 offset;
+            QVector<quint32> children;
+            int next;
+        };
+
+        enum State : quint8 { Unvisited, Active, Done };
+        QHash<quint32, quint8> states;
+        std::vector<Frame> stack;
+        const auto visit = [&](const quint32 root) {
+            if (states.value(root, Unvisited) != Unvisited) {
+                return;
+            }
+
+            states.insert(root, Active);
+            stack.push_back({ root, children(root), 0 });
+            while (!stack.empty()) {
+                auto &frame = stack.back();
+                if (frame.next == frame.children.size()) {
+                    states.insert(frame.offset, Done);
+                    stack.pop_back();
+                    continue;
+                }
+
+                const auto child = frame.children[frame.next++];
+                const auto state = states.value(child, Unvisited);
+                if (state == Active) {
+                    cyclic.insert(frame.offset);
+                } else if (state == Unvisited) {
+                    states.insert(child, Active);
+                    stack.push_back({ child, children(child), 0 });
+                }
+            }
+        };
+
+        for (const auto paint : glyphPaints) {
+            visit(paint);
+        }
+
+        for (const auto paint : layerPaints) {
+            visit(paint);
+        }
+    } catch (const QString&) {
+    }
+
+    return cyclic;
+}
+
+static QString parsePaint(const ColrSubtable &subtable, const QSet<quint32> &cyclic,
+                          const quint32 tableStart, ColrSubtables &subtables, Parser &parser)
+{
+    const auto format = parser.read<UInt8>("Format");
+    const auto info = paintFormat(format);
+    if (!info) {
+        throw QString("%1 has an unknown format").arg(subtable.title);
+    }
+
+    for (const auto &field : info->fields) {
+        switch (field.type) {
+        case PaintField::UInt8: parser.read<UInt8>(field.title); break;
+        case PaintField::UInt16: parser.read<UInt16>(field.title); break;
+        case PaintField::UInt32: parser.read<UInt32>(field.title); break;
+        case PaintField::GlyphId: parser.read<GlyphId>(field.title); break;
+        case PaintField::FWord: parser.read<Int16>(field.title); break;
+        case PaintField::UFWord: parser.read<UInt16>(field.title); break;
+        case PaintField::F2Dot14: parser.read<F2DOT14>(field.title); break;
+        case PaintField::Fixed: parser.read<F16DOT16>(field.title); break;
+        case PaintField::CompositeMode: {
+            const auto mode = parser.peek<UInt8>();
+            parser.readValue<UInt8>(field.title, QString("%1 (%2)").arg(compositeModeName(mode)).arg(mode));
+            break;
+        }
+        case PaintField::Paint: {
+            subtables.readOffset<Offset24>(field.title, subtable.offset, { ColrSubtableType::Paint }, parser);
+            break;
+        }
+        case PaintField::ColorLine: {
+            const auto type = info->isVariable ? ColrSubtableType::VarColorLine : ColrSubtableType::ColorLine;
+            subtables.readOffset<Offset24>(field.title, subtable.offset, { type }, parser);
+            break;
+        }
+        case PaintField::Affine: {
+            const auto type = info->isVariable ? ColrSubtableType::VarAffine : ColrSubtableType::Affine;
+            subtables.readOffset<Offset24>(field.title, subtable.offset, { type }, parser);
+            break;
+        }
+        }
+    }
+
+    if (cyclic.contains(subtable.offset - tableStart)) {
+        return info->name + ", cyclic";
+    }
+
+    return info->name;
+}
+
+static void parseColorLine(const bool isVariable, Parser &parser)
+{
+    const auto extend = parser.peek<UInt8>();
+    QString extendName = "Unknown";
+    switch (extend) {
+    case 0: extendName = "Pad"; break;
+    case 1: extendName = "Repeat"; break;
+    case 2: extendName = "Reflect"; break;
+    default: break;
+    }
+    parser.readValue<UInt8>("Extend", QString("%1 (%2)").arg(extendName).arg(extend));
+
+    const auto count = parser.read<UInt16>("Number of color stops");
+    parser.readArray("Color Stops", count, [&](const auto index){
+        parser.beginGroup(index);
+        parser.read<F2DOT14>("Stop offset");
+        parser.read<UInt16>("Palette index");
+        parser.read<F2DOT14>("Alpha");
+        if (isVariable) {
+            parser.read<UInt32>("Base variation index");
+        }
+        parser.endGroup();
+    });
+}
+
+static void parseAffine(const bool isVariable, Parser &parser)
+{
+    parser.read<F16DOT16>("xx");
+    parser.read<F16DOT16>("yx");
+    parser.read<F16DOT16>("xy");
+    parser.read<F16DOT16>("yy");
+    parser.read<F16DOT16>("dx");
+    parser.read<F16DOT16>("dy");
+    if (isVariable) {
+        parser.read<UInt32>("Base variation index");
+    }
+}
+
+// Unlike `HVAR`, `COLR` can use the 32-bit format of a DeltaSetIndexMap.
+static void parseDeltaSetIndexMap(Parser &parser)
+{
+    const auto format = parser.read<UInt8>("Format");
+    const auto entryFormat = parser.peek<UInt8>();
+    const auto innerIndexBits = (entryFormat & 0x0F) + 1;
+    const auto entrySize = ((entryFormat >> 4) & 0x03) + 1;
+    parser.readValue<UInt8>("Entry format", QString("%1-byte entries, %2 inner index bits")
+                            .arg(entrySize).arg(innerIndexBits));
+
+    quint32 count = 0;
+    if (format == 0) {
+        count = parser.read<UInt16>("Number of entries");
+    } else if (format == 1) {
+        count = parser.read<UInt32>("Number of entries");
+    } else {
+        throw QString("invalid delta-set index map format");
+    }
+
+    parser.readArray("Entries", count, [&](const auto index){
+        quint32 entry = 0;
+        switch (entrySize) {
+        case 1: entry = parser.peek<UInt8>(); break;
+        case 2: entry = parser.peek<UInt16>(); break;
+        case 3: entry = parser.peek<UInt24>(); break;
+        default: entry = parser.peek<UInt32>(); break;
+        }
+
+        const auto value = QString("Outer index: %1\nInner index: %2")
+            .arg(entry >> innerIndexBits).arg(entry & ((1u << innerIndexBits) - 1));
+        switch (entrySize) {
+        case 1: parser.readValue<UInt8>(index, value); break;
+        case 2: parser.readValue<UInt16>(index, value); break;
+        case 3: parser.readValue<UInt24>(index, value); break;
+        default: parser.readValue<UInt32>(index, value); break;
+        }
+    });
+}
+
+void parseColr(const quint32 tableSize, Parser &parser)
+{
+    const auto start = parser.offset();
+    auto shadow = parser.shadow();
+
+    const auto version = parser.read<UInt16>("Version");
+    if (version > 1) {
+        throw QString("invalid table version");
+    }
+
+    const auto numberOfBaseGlyphRecords = parser.read<UInt16>("Number of base glyph records");
+    const quint32 baseGlyphRecordsOffset = parser.read<OptionalOffset32>("Offset to base glyph records");
+    const quint32 layerRecordsOffset = parser.read<OptionalOffset32>("Offset to layer records");
+    const auto numberOfLayerRecords = parser.read<UInt16>("Number of layer records");
+
+    ColrSubtables subtables(start + tableSize, subtableName);
+
+    const auto addRecords = [&](const ColrSubtableType type, const quint32 offset, const quint16 count) {
+        if (offset != 0 && count != 0) {
+            subtables.add({ type, start + offset, count, subtableName(type) });
+        }
+    };
+    addRecords(ColrSubtableType::BaseGlyphRecords, baseGlyphRecordsOffset, numberOfBaseGlyphRecords);
+    addRecords(ColrSubtableType::LayerRecords, layerRecordsOffset, numberOfLayerRecords);
+
+    QSet<quint32> cyclic;
+    if (version == 1) {
+        quint32 baseGlyphListOffset = 0;
+        quint32 layerListOffset = 0;
+
+        const auto readOffset = [&](const char *title, const ColrSubtableType type) {
+            const quint32 offset = parser.peek<OptionalOffset32>();
+            if (offset != 0) {
+                subtables.add({ type, start + offset, 0, subtableName(type) });
+            }
+            parser.read<OptionalOffset32>(title);
+            return offset;
+        };
+
+        baseGlyphListOffset = readOffset("Offset to BaseGlyphList table", ColrSubtableType::BaseGlyphList);
+        layerListOffset = readOffset("Offset to LayerList table", ColrSubtableType::LayerList);
+        readOffset("Offset to ClipList table", ColrSubtableType::ClipList);
+        readOffset("Offset to DeltaSetIndexMap table", ColrSubtableType::VarIndexMap);
+        readOffset("Offset to ItemVariationStore table", ColrSubtableType::ItemVariationStore);
+
+        cyclic = findPaintCycles(tableSize, baseGlyphListOffset, layerListOffset, shadow);
+    }
+
+    subtables.parse(parser, [&](const ColrSubtable &subtable) -> QString {
+        switch (subtable.type) {
+        case ColrSubtableType::BaseGlyphRecords: {
+            parser.readArray("Records", subtable.count, [&](const auto index){
+                parser.beginGroup(index);
+                parser.read<GlyphId>("Glyph ID");
+                parser.read<UInt16>("Index of the first layer record");
+                parser.read<UInt16>("Number of layers");
+                parser.endGroup();
+            });
+            break;
+        }
+        case ColrSubtableType::LayerRecords: {
+            parser.readArray("Records", subtable.count, [&](const auto index){
+                parser.beginGroup(index);
+                parser.read<GlyphId>("Glyph ID");
+                const auto paletteIndex = parser.peek<UInt16>();
+                if (paletteIndex == 0xFFFF) {
+                    parser.readValue<UInt16>("Palette index", "Foreground color");
+                } else {
+                    parser.read<UInt16>("Palette index");
+                }
+                parser.endGroup();
+            });
+            break;
+        }
+        case ColrSubtableType::BaseGlyphList: {
+            const auto count = parser.read<UInt32>("Number of records");
+            parser.readArray("Records", count, [&](const auto index){
+                parser.beginGroup(index);
+                parser.read<GlyphId>("Glyph ID");
+                subtables.readOffset<Offset32>("Offset to Paint table", subtable.offset,
+                                               { ColrSubtableType::Paint }, parser);
+                parser.endGroup();
+            });
+            break;
+        }
+        case ColrSubtableType::LayerList: {
+            const auto count = parser.read<UInt32>("Number of layers");
+            parser.readArray("Offsets to Paint tables", count, [&](const auto index){
+                subtables.readOffset<Offset32>(index, subtable.offset, { ColrSubtableType::Paint }, parser);
+            });
+            break;
+        }
+        case ColrSubtableType::ClipList: {
+            parser.read<UInt8>("Format");
+            const auto count = parser.read<UInt32>("Number of clips");
+            parser.readArray("Clips", count, [&](const auto index){
+                parser.beginGroup(index);
+                parser.read<GlyphId>("First glyph ID");
+                parser.read<GlyphId>("Last glyph ID");
+                subtables.readOffset<Offset24>("Offset to ClipBox table", subtable.offset,
+                                               { ColrSubtableType::ClipBox }, parser);
+                parser.endGroup();
+            });
+            break;
+        }
+        case ColrSubtableType::VarIndexMap: {
+            parseDeltaSetIndexMap(parser);
+            break;
+        }
+        case ColrSubtableType::ItemVariationStore: {
+            parseItemVariationStore(parser);
+            break;
+        }
+        case ColrSubtableType::Paint: {
+            return parsePaint(subtable, cyclic, start, subtables, parser);
+        }
+        case ColrSubtableType::ColorLine:
+        case ColrSubtableType::VarColorLine: {
+            parseColorLine(subtable.type == ColrSubtableType::VarColorLine, parser);
+            break;
+        }
+        case ColrSubtableType::Affine:
+        case ColrSubtableType::VarAffine: {
+            parseAffine(subtable.type == ColrSubtableType::VarAffine, parser);
+            break;
+        }
+        case ColrSubtableType::ClipBox: {
+            const auto format = parser.read<UInt8>("Format");
+            parser.read<Int16>("x min");
+            parser.read<Int16>("y min");
+            parser.read<Int16>("x max");
+            parser.read<Int16>("y max");
+            if (format == 2) {
+                parser.read<UInt32>("Base variation index");
+            }
+            break;
+        }
+        case ColrSubtableType::LastType: break;
+        }
+
+        return QString();
+    });
+}
@@ -0,0 +1,164 @@
+#include <QStringList>
+
+#include <bitset>
+#include <map>
+
+#include "src/algo.h"
+#include "src/parser.h"
+#include "tables.h"
+
+struct PaletteType
+{
+    static const int Size = 4;
+    static const QString Type;
+
+    static PaletteType parse(const quint8 *data)
+    { return { qFromBigEndian<quint32>(data) }; }
+
+    static QString toString(const PaletteType &value)
+    {
+        std::bitset<32> bits(value.d);
+        auto flagsStr = QString::fromUtf8(bits.to_string().c_str()) + '\n';
+
+        if (bits[0]) flagsStr += "Bit 0: Usable with light background\n";
+        if (bits[1]) flagsStr += "Bit 1: Usable with dark background\n";
+
+        flagsStr.chop(1);
+
+        return flagsStr;
+    }
+
+    quint32 d;
+};
+
+const QString PaletteType::Type = Parser::BitflagsType;
+
+// Groups color records by palettes.
+//
+// Palettes can share color records, so palettes with the same first record
+// share a group, and partially overlapping palettes list only the remaining records.
+static void parseColorRecords(const QVector<quint16> &firstIndices, const quint16 numberOfEntries,
+                              const quint16 numberOfColorRecords, Parser &parser)
+{
+    std::map<quint16, QVector<int>> palettes;
+    for (int i = 0; i < firstIndices.size(); ++i) {
+        if (quint32(firstIndices[i]) + numberOfEntries > numberOfColorRecords) {
+            throw QString("palette %1 is out of bounds").arg(i);
+        }
+
+        palettes[firstIndices[i]].append(i);
+    }
+
+    // Unused records keep their indices in the color records array.
+    const auto readUnused = [&](const quint32 from, const quint32 to) {
+        parser.readArray("Unused Color Records", to - from, [&](const auto i){
+            parser.read<BGRAColor>(from + i);
+        });
+    };
+
+    parser.beginGroup("Color Records");
+    quint32 index = 0;
+    for (const auto &[first, indices] : palettes) {
+        const quint32 end = quint32(first) + numberOfEntries;
+        if (first > index) {
+            readUnused(index, first);
+            index = first;
+        }
+
+        QStringList titles;
+        for (const auto i : indices) {
+            titles << QString::number(i);
+        }
+
+        const auto title = QString(indices.size() == 1 ? "Palette %1" : "Palettes %1").arg(titles.join(", "));
+        parser.beginGroup(title);
+        for (auto i = index; i < end; ++i) {
+            parser.read<BGRAColor>(i - first);
+        }
+        parser.endGroup(QString(), index > first
+            ? QString("%1 of %2 records are shared").arg(index - first).arg(numberOfEntries) : QString());
+
+        index = end;
+    }
+
+    readUnused(index, numberOfColorRecords);
+    parser.endGroup();
+}
+
+void parseCpal(const NamesHash &names, Parser &parser)
+{
+    const auto start = parser.offset();
+
+    const auto version = parser.read<UInt16>("Version");
+    if (version > 1) {
+        throw QString("invalid table version");
+    }
+
+    const auto numberOfEntries = parser.read<UInt16>("Number of palette entries in each palette");
+    const auto numberOfPalettes = parser.read<UInt16>("Number of palettes");
+    const auto numberOfColorRecords = parser.read<UInt16>("Number of color records");
+    const quint32 colorRecordsOffset = parser.read<Offset32>("Offset to the color records array");
+
+    QVector<quint16> firstIndices;
+    parser.readArray("Indices of the first color record", numberOfPalettes, [&](const auto index){
+        firstIndices.append(parser.read<UInt16>(index));
+    });
+
+    quint32 paletteTypesOffset = 0;
+    quint32 paletteLabelsOffset = 0;
+    quint32 paletteEntryLabelsOffset = 0;
+    if (version == 1) {
+        paletteTypesOffset = parser.read<OptionalOffset32>("Offset to the palette types array");
+        paletteLabelsOffset = parser.read<OptionalOffset32>("Offset to the palette labels array");
+        paletteEntryLabelsOffset = parser.read<OptionalOffset32>("Offset to the palette entry labels array");
+    }
+
+    enum class OffsetType {
+        ColorRecords,
+        PaletteTypes,
+        PaletteLabels,
+        PaletteEntryLabels,
+    };
+    struct Offset {
+        OffsetType type;
+        quint32 offset;
+    };
+    std::array<Offset, 4> offsets = {{
+        { OffsetType::ColorRecords, colorRecordsOffset },
+        { OffsetType::PaletteTypes, paletteTypesOffset },
+        { OffsetType::PaletteLabels, paletteLabelsOffset },
+        { OffsetType::PaletteEntryLabels, paletteEntryLabelsOffset },
+    }};
+
+    algo::sort_all_by_key(offsets, &Offset::offset);
+
+    for (const auto offset : offsets) {
+        if (offset.offset == 0) {
+            continue;
+        }
+
+        parser.advanceTo(start + offset.offset);
+        switch (offset.type) {
+        case OffsetType::ColorRecords: {
+            parseColorRecords(firstIndices, numberOfEntries, numberOfColorRecords, parser);
+            break;
+        }
+        case OffsetType::PaletteTypes: {
+            parser.readBasicArray<PaletteType>("Palette Types", numberOfPalettes);
+            break;
+        }
+        case OffsetType::PaletteLabels: {
+            parser.readArray("Palette Labels", numberOfPalettes, [&](const auto index){
+                parser.readNameId(numberToString(index), names);
+            });
+            break;
+        }
+        case OffsetType::PaletteEntryLabels: {
+            parser.readArray("Palette Entry Labels", numberOfEntries, [&](const auto index){
+                parser.readNameId(numberToString(index), names);
+            });
+            break;
+        }
+        }
+    }
+}
@@ -1,4 +1,5 @@
 #include "tables.h"
+#include "varstore.h"
 
 void parseFvar(const NamesHash &names, Parser &parser)
 {
@@ -44,3 +45,75 @@ void parseFvar(const NamesHash &names, Parser &parser)
         parser.endGroup(QString(), name);
     });
 }
+
+QVector<VariationAxis> collectFvarAxes(ShadowParser &parser)
+{
+    const auto start = parser.offset();
+
+    const quint16 majorVersion = parser.read<UInt16>();
+    const quint16 minorVersion = parser.read<UInt16>();
+    if (!(majorVersion == 1 && minorVersion == 0)) {
+        throw QString("invalid table version");
+    }
+
+    const quint16 axesOffset = parser.read<Offset16>();
+    parser.skip<UInt16>(); // reserved
+    const quint16 axesCount = parser.read<UInt16>();
+    const quint16 axisSize = parser.read<UInt16>();
+    if (axisSize < 20) {
+        throw QString("invalid axis record size");
+    }
+
+    QVector<VariationAxis> axes;
+    for (quint16 i = 0; i < axesCount; ++i) {
+        parser.jumpTo(start + axesOffset + quint32(i) * axisSize);
+        VariationAxis axis;
+        axis.tag = parser.read<Tag>();
+        axis.minValue = parser.read<F16DOT16>();
+        axis.defaultValue = parser.read<F16DOT16>();
+        axis.maxValue = parser.read<F16DOT16>();
+        parser.skip<UInt16>(); // flags
+        axis.nameId = parser.read<UInt16>();
+        axes << axis;
+    }
+
+    return axes;
+}
+
+QVector<NamedInstance> collectFvarInstances(ShadowParser &parser)
+{
+    const auto start = parser.offset();
+
+    const quint16 majorVersion = parser.read<UInt16>();
+    const quint16 minorVersion = parser.read<UInt16>();
+    if (!(majorVersion == 1 && minorVersion == 0)) {
+        throw QString("invalid table version");
+    }
+
+    const quint16 axesOffset = parser.read<Offset16>();
+    parser.skip<UInt16>(); // reserved
+    const quint16 axesCount = parser.read<UInt16>();
+    const quint16 axisSize = parser.read<UInt16>();
+    const quint16 instancesCount = parser.read<UInt16>();
+    const quint16 instanceSize = parser.read<UInt16>();
+    if (instanceSize < axesCount * 4 + 4) {
+        throw QString("invalid instance record size");
+    }
+
+    // Instances follow axes.
+    const quint32 instancesStart = start + axesOffset + quint32(axesCount) * axisSize;
+
+    QVector<NamedInstance> instances;
+    for (quint16 i = 0; i < instancesCount; ++i) {
+        parser.jumpTo(instancesStart + quint32(i) * instanceSize);
+        NamedInstance instance;
+        instance.subfamilyNameId = parser.read<UInt16>();
+        parser.skip<UInt16>(); // flags
+        for (quint16 a = 0; a < axesCount; ++a) {
+            instance.coordinates << float(parser.read<F16DOT16>());
+        }
+        instances << instance;
+    }
+
+    return instances;
+}
@@ -2,57 +2,11 @@
 
 #include "src/algo.h"
 #include "src/parser.h"
+#include "layout-common.h"
 #include "tables.h"
 
 // TODO: ligCaretListOffset
 
-static void parseClassDefinitionTable(Parser &parser)
-{
-    const auto classFormat = parser.read<UInt16>("Format");
-
-    if (classFormat == 1) {
-        parser.read<UInt16>("First glyph ID");
-        const auto glyphCount = parser.read<UInt16>("Number of classes");
-        for (auto i = 0; i < glyphCount; ++i) {
-            parser.read<UInt16>("Class");
-        }
-    } else if (classFormat == 2) {
-        const auto classRangeCount = parser.read<UInt16>("Number of records");
-        for (auto i = 0; i < classRangeCount; ++i) {
-            parser.beginGroup("Class Range Record");
-            const auto first = parser.read<UInt16>("First glyph ID");
-            const auto last = parser.read<UInt16>("Last glyph ID");
-            const auto klass = parser.read<UInt16>("Class");
-            parser.endGroup(QString(), QString("%1..%2 %3").arg(first).arg(last).arg(klass));
-        }
-    } else {
-        throw QString("invalid class format");
-    }
-}
-
-static void parseCoverageTable(Parser &parser)
-{
-    const auto format = parser.read<UInt16>("Format");
-
-    if (format == 1) {
-        const auto glyphCount = parser.read<UInt16>("Number of glyphs");
-        for (auto i = 0; i < glyphCount; ++i) {
-            parser.read<GlyphId>("Glyph");
-        }
-    } else if (format == 2) {
-        const auto rangeCount = parser.read<UInt16>("Number of records");
-        for (auto i = 0; i < rangeCount; ++i) {
-            parser.beginGroup("Range Record");
-            const auto first = parser.read<UInt16>("First glyph ID");
-            const auto last = parser.read<UInt16>("Last glyph ID");
-            const auto index = parser.read<UInt16>("Coverage Index of first glyph ID");
-            parser.endGroup(QString(), QString("%1..%2 %3").arg(first).arg(last).arg(index));
-        }
-    } else {
-        throw QString("invalid coverage format");
-    }
-}
-
 void parseGdef(Parser &parser)
 {
     const auto start = parser.offset();
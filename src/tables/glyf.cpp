@@ -2,7 +2,16 @@
 
 #include <QVarLengthArray>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define GLYF_USE_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define GLYF_USE_NEON
+#endif
+
 #include "src/algo.h"
+#include "glyf.h"
 
 #include "tables.h"
 
@@ -55,8 +64,8 @@ struct SimpleGlyphFlags
         // This method would be called a lot, therefore we have to use a cache.
         //
         // Valid flags would be in a 0..64 range, so using a QVarLengthArray
-        // is more performant than QHash.
-        static QVarLengthArray<QString, 64> cache;
+        // is more performant than QHash. Per thread, because fonts can be parsed in parallel.
+        static thread_local QVarLengthArray<QString, 64> cache;
 
         if (cache.isEmpty()) {
             cache.resize(64);
@@ -349,7 +358,11 @@ static void parseCompositeGlyph(Parser &parser)
     }
 }
 
-void parseGlyf(const quint16 numberOfGlyphs, const QVector<quint32> &glyphOffsets, Parser &parser)
+static const QString EmptyGlyphValue = QLatin1String("Empty");
+static const QString CompositeGlyphValue = QLatin1String("Composite");
+
+void parseGlyf(const quint16 numberOfGlyphs, const QVector<quint32> &glyphOffsets,
+               const GlyphNames &glyphNames, Parser &parser)
 {
     Q_ASSERT(int(numberOfGlyphs) + 1 == glyphOffsets.size());
 
@@ -397,12 +410,348 @@ void parseGlyf(const quint16 numberOfGlyphs, const QVector<quint32> &glyphOffset
         }
 
         if (numberOfContours == 0) {
-            parser.endGroup(QString("Glyph %1 (empty)").arg(index));
+            parser.endGroup(glyphNames.title(index), EmptyGlyphValue);
         } else if (numberOfContours > 0) {
-            parser.endGroup(QString("Glyph %1").arg(index));
+            parser.endGroup(glyphNames.title(index));
         } else {
-            parser.endGroup(QString("Glyph %1 (composite)").arg(index));
+            parser.endGroup(glyphNames.title(index), CompositeGlyphValue);
         }
     }
     parser.endArray();
 }
+
+// Converts deltas into absolute coordinates.
+static void prefixSumToFloat(const qint32 *deltas, const int count, float *out)
+{
+    int i = 0;
+    qint32 carry = 0;
+
+#if defined(GLYF_USE_SSE2)
+    auto sum = _mm_setzero_si128();
+    for (; i + 4 <= count; i += 4) {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(deltas + i));
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 8));
+        v = _mm_add_epi32(v, sum);
+        _mm_storeu_ps(out + i, _mm_cvtepi32_ps(v));
+        sum = _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    carry = _mm_cvtsi128_si32(sum);
+#elif defined(GLYF_USE_NEON)
+    auto sum = vdupq_n_s32(0);
+    const auto zero = vdupq_n_s32(0);
+    for (; i + 4 <= count; i += 4) {
+        auto v = vld1q_s32(deltas + i);
+        v = vaddq_s32(v, vextq_s32(zero, v, 3));
+        v = vaddq_s32(v, vextq_s32(zero, v, 2));
+        v = vaddq_s32(v, sum);
+        vst1q_f32(out + i, vcvtq_f32_s32(v));
+        sum = vdupq_n_s32(vgetq_lane_s32(v, 3));
+    }
+    carry = vgetq_lane_s32(sum, 0);
+#endif
+
+    for (; i < count; ++i) {
+        carry += deltas[i];
+        out[i] = float(carry);
+    }
+}
+
+// Reads coordinate deltas for one axis. `shortFlag` and `sameFlag` select the axis.
+static const quint8* decodeDeltas(const quint8 *data, const quint8 *end,
+                                  const QVarLengthArray<quint8, 256> &flags,
+                                  const quint8 shortFlag, const quint8 sameFlag,
+                                  QVarLengthArray<qint32, 256> &deltas)
+{
+    // Check bounds once instead of on each read.
+    quint32 size = 0;
+    for (const auto f : flags) {
+        size += (f & shortFlag) ? 1 : ((f & sameFlag) ? 0 : 2);
+    }
+
+    if (data + size > end) {
+        throw QString("read out of bounds");
+    }
+
+    deltas.resize(flags.size());
+    for (int i = 0; i < flags.size(); ++i) {
+        const auto f = flags[i];
+        if (f & shortFlag) {
+            deltas[i] = (f & sameFlag) ? qint32(*data) : -qint32(*data);
+            data += 1;
+        } else if (f & sameFlag) {
+            deltas[i] = 0;
+        } else {
+            deltas[i] = qFromBigEndian<qint16>(data);
+            data += 2;
+        }
+    }
+
+    return data;
+}
+
+static void decodeSimpleOutline(const quint16 numberOfContours, const quint8 *start, const quint8 *end,
+                                GlyphOutline &outline)
+{
+    ShadowParser parser(start, end);
+    parser.advance(10); // header
+
+    quint16 lastPoint = 0;
+    outline.contourEnds.reserve(numberOfContours);
+    for (quint16 i = 0; i < numberOfContours; ++i) {
+        const quint16 contourEnd = parser.read<UInt16>();
+        if (i != 0 && contourEnd < lastPoint) {
+            throw QString("invalid contour end point");
+        }
+
+        lastPoint = contourEnd;
+        outline.contourEnds << contourEnd;
+    }
+
+    const quint16 instructionsLength = parser.read<UInt16>();
+    parser.advance(instructionsLength);
+    const auto totalPoints = int(lastPoint) + 1;
+
+    QVarLengthArray<quint8, 256> flags;
+    flags.reserve(totalPoints);
+    while (flags.size() < totalPoints) {
+        const quint8 f = parser.read<UInt8>();
+        flags.append(f);
+        if (f & SimpleGlyphFlags::REPEAT_FLAG) {
+            const auto repeats = std::min<int>(parser.read<UInt8>(), totalPoints - flags.size());
+            for (int i = 0; i < repeats; ++i) {
+                flags.append(f);
+            }
+        }
+    }
+
+    QVarLengthArray<qint32, 256> deltas;
+    auto data = start + parser.offset();
+
+    outline.x.resize(totalPoints);
+    data = decodeDeltas(data, end, flags, SimpleGlyphFlags::X_SHORT_VECTOR,
+                        SimpleGlyphFlags::X_IS_SAME_OR_POSITIVE_X_SHORT_VECTOR, deltas);
+    prefixSumToFloat(deltas.constData(), totalPoints, outline.x.data());
+
+    outline.y.resize(totalPoints);
+    decodeDeltas(data, end, flags, SimpleGlyphFlags::Y_SHORT_VECTOR,
+                 SimpleGlyphFlags::Y_IS_SAME_OR_POSITIVE_Y_SHORT_VECTOR, deltas);
+    prefixSumToFloat(deltas.constData(), totalPoints, outline.y.data());
+
+    outline.onCurve.resize(totalPoints);
+    for (int i = 0; i < totalPoints; ++i) {
+        outline.onCurve[i] = flags[i] & SimpleGlyphFlags::ON_CURVE_POINT;
+    }
+}
+
+static void decodeOutline(const quint8 *glyf, const quint32 glyfSize, const QVector<quint32> &locaOffsets,
+                          const quint16 glyphId, const GlyphPointsTransform *transform,
+                          const int depth, quint32 &numberOfVisits, GlyphOutline &outline);
+
+static void transformPoints(const GlyphPointsTransform &transform, const quint16 glyphId,
+                            GlyphOutline &points)
+{
+    const auto numberOfPoints = points.size();
+    for (int i = 0; i < 4; ++i) {
+        points.x << 0;
+        points.y << 0;
+    }
+
+    transform(glyphId, points);
+
+    points.x.resize(numberOfPoints);
+    points.y.resize(numberOfPoints);
+}
+
+static void decodeCompositeOutline(const quint8 *glyf, const quint32 glyfSize,
+                                   const QVector<quint32> &locaOffsets, const quint16 glyphId,
+                                   const quint8 *start, const quint8 *end,
+                                   const GlyphPointsTransform *transform, const int depth,
+                                   quint32 &numberOfVisits, GlyphOutline &outline)
+{
+    ShadowParser parser(start, end);
+    parser.advance(10); // header
+
+    struct Component
+    {
+        CompositeGlyphFlags flags;
+        quint16 glyphId;
+        qint32 arg1;
+        qint32 arg2;
+        // a b c d
+        std::array<float, 4> m;
+    };
+
+    // Components are read first, because a transform can change their offsets.
+    QVarLengthArray<Component, 8> components;
+    CompositeGlyphFlags flags;
+    do {
+        flags = parser.read<CompositeGlyphFlags>();
+        const quint16 componentId = parser.read<GlyphId>();
+
+        qint32 arg1 = 0;
+        qint32 arg2 = 0;
+        if (flags & CompositeGlyphFlags::ARG_1_AND_2_ARE_WORDS) {
+            if (flags & CompositeGlyphFlags::ARGS_ARE_XY_VALUES) {
+                arg1 = qint16(parser.read<Int16>());
+                arg2 = qint16(parser.read<Int16>());
+            } else {
+                arg1 = parser.read<UInt16>();
+                arg2 = parser.read<UInt16>();
+            }
+        } else {
+            if (flags & CompositeGlyphFlags::ARGS_ARE_XY_VALUES) {
+                arg1 = qint8(parser.read<Int8>());
+                arg2 = qint8(parser.read<Int8>());
+            } else {
+                arg1 = parser.read<UInt8>();
+                arg2 = parser.read<UInt8>();
+            }
+        }
+
+        // a b c d
+        std::array<float, 4> m = { 1, 0, 0, 1 };
+        if (flags & CompositeGlyphFlags::WE_HAVE_A_TWO_BY_TWO) {
+            m[0] = parser.read<F2DOT14>();
+            m[1] = parser.read<F2DOT14>();
+            m[2] = parser.read<F2DOT14>();
+            m[3] = parser.read<F2DOT14>();
+        } else if (flags & CompositeGlyphFlags::WE_HAVE_AN_X_AND_Y_SCALE) {
+            m[0] = parser.read<F2DOT14>();
+            m[3] = parser.read<F2DOT14>();
+        } else if (flags & CompositeGlyphFlags::WE_HAVE_A_SCALE) {
+            m[0] = parser.read<F2DOT14>();
+            m[3] = m[0];
+        }
+
+        components.append({ flags, componentId, arg1, arg2, m });
+    } while (flags & CompositeGlyphFlags::MORE_COMPONENTS);
+
+    // Offsets as points. Point-matching components have no offset.
+    GlyphOutline offsets;
+    for (const auto &c : components) {
+        const bool isXY = c.flags & CompositeGlyphFlags::ARGS_ARE_XY_VALUES;
+        offsets.x << (isXY ? float(c.arg1) : 0.0f);
+        offsets.y << (isXY ? float(c.arg2) : 0.0f);
+    }
+
+    if (transform) {
+        transformPoints(*transform, glyphId, offsets);
+    }
+
+    for (int ci = 0; ci < components.size(); ++ci) {
+        const auto flags = components[ci].flags;
+        const auto arg1 = components[ci].arg1;
+        const auto arg2 = components[ci].arg2;
+        const auto &m = components[ci].m;
+
+        GlyphOutline component;
+        decodeOutline(glyf, glyfSize, locaOffsets, components[ci].glyphId, transform, depth + 1,
+                      numberOfVisits, component);
+
+        const auto count = component.size();
+        for (int i = 0; i < count; ++i) {
+            const auto x = component.x[i];
+            const auto y = component.y[i];
+            component.x[i] = m[0] * x + m[2] * y;
+            component.y[i] = m[1] * x + m[3] * y;
+        }
+
+        float dx = 0;
+        float dy = 0;
+        if (flags & CompositeGlyphFlags::ARGS_ARE_XY_VALUES) {
+            dx = offsets.x[ci];
+            dy = offsets.y[ci];
+            // Offsets are unscaled by default.
+            if ((flags & CompositeGlyphFlags::SCALED_COMPONENT_OFFSET)
+                && !(flags & CompositeGlyphFlags::UNSCALED_COMPONENT_OFFSET))
+            {
+                dx = m[0] * offsets.x[ci] + m[2] * offsets.y[ci];
+                dy = m[1] * offsets.x[ci] + m[3] * offsets.y[ci];
+            }
+        } else {
+            // Align a component point with an already placed one.
+            if (arg1 >= outline.size() || arg2 >= count) {
+                throw QString("invalid component point index");
+            }
+
+            dx = outline.x[arg1] - component.x[arg2];
+            dy = outline.y[arg1] - component.y[arg2];
+        }
+
+        const auto pointsOffset = quint32(outline.size());
+        if (pointsOffset + quint32(count) > 0xFFFF) {
+            throw QString("too many points");
+        }
+
+        for (int i = 0; i < count; ++i) {
+            outline.x << component.x[i] + dx;
+            outline.y << component.y[i] + dy;
+        }
+        outline.onCurve << component.onCurve;
+        for (const auto contourEnd : component.contourEnds) {
+            outline.contourEnds << quint16(pointsOffset + contourEnd);
+        }
+    }
+}
+
+static void decodeOutline(const quint8 *glyf, const quint32 glyfSize, const QVector<quint32> &locaOffsets,
+                          const quint16 glyphId, const GlyphPointsTransform *transform,
+                          const int depth, quint32 &numberOfVisits, GlyphOutline &outline)
+{
+    // Also protects from cycles.
+    if (depth > 16) {
+        throw QString("composite glyph nesting is too deep");
+    }
+
+    // Components can reference the same glyph many times on each nesting level,
+    // and empty components don't count towards the points limit.
+    numberOfVisits += 1;
+    if (numberOfVisits > 0xFFFF) {
+        throw QString("too many components");
+    }
+
+    if (glyphId + 1 >= locaOffsets.size()) {
+        throw QString("glyph ID is out of bounds");
+    }
+
+    const auto start = locaOffsets[glyphId];
+    const auto end = locaOffsets[glyphId + 1];
+    if (start == end) {
+        return;
+    }
+
+    if (start > end || end > glyfSize || end - start < 10) {
+        throw QString("invalid glyph offsets");
+    }
+
+    const auto numberOfContours = qFromBigEndian<qint16>(glyf + start);
+    if (numberOfContours > 0) {
+        decodeSimpleOutline(quint16(numberOfContours), glyf + start, glyf + end, outline);
+        if (transform) {
+            transformPoints(*transform, glyphId, outline);
+        }
+    } else if (numberOfContours < 0) {
+        decodeCompositeOutline(glyf, glyfSize, locaOffsets, glyphId, glyf + start, glyf + end,
+                               transform, depth, numberOfVisits, outline);
+    }
+}
+
+GlyphOutline decodeGlyphOutline(const quint8 *glyf, const quint32 glyfSize,
+                                const QVector<quint32> &locaOffsets, const quint16 glyphId)
+{
+    GlyphOutline outline;
+    quint32 numberOfVisits = 0;
+    decodeOutline(glyf, glyfSize, locaOffsets, glyphId, nullptr, 0, numberOfVisits, outline);
+    return outline;
+}
+
+GlyphOutline decodeGlyphOutline(const quint8 *glyf, const quint32 glyfSize,
+                                const QVector<quint32> &locaOffsets, const quint16 glyphId,
+                                const GlyphPointsTransform &transform)
+{
+    GlyphOutline outline;
+    quint32 numberOfVisits = 0;
+    decodeOutline(glyf, glyfSize, locaOffsets, glyphId, &transform, 0, numberOfVisits, outline);
+    return outline;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <functional>
+
+#include "src/parser.h"
+
+// A decoded glyph outline in a structure-of-arrays form.
+struct GlyphOutline
+{
+    QVector<float> x;
+    QVector<float> y;
+    // 1 for on-curve points, 0 for quadratic and 2 for cubic control points.
+    QVector<quint8> onCurve;
+    // Indexes of the last point of each contour.
+    QVector<quint16> contourEnds;
+
+    int size() const { return x.size(); }
+};
+
+// Decodes a simple or a composite glyph with all components applied.
+//
+// `glyf` must point to the start of the `glyf` table and `locaOffsets`
+// must contain numberOfGlyphs + 1 offsets, as returned by collectLocaOffsets.
+GlyphOutline decodeGlyphOutline(const quint8 *glyf, const quint32 glyfSize,
+                                const QVector<quint32> &locaOffsets, const quint16 glyphId);
+
+// Called for each simple glyph with its points and for each composite glyph with
+// its component offsets, before the glyph is placed. Points are followed by four phantom
+// points at the origin, which are discarded afterwards. Can modify points in place.
+using GlyphPointsTransform = std::function<void(const quint16 glyphId, GlyphOutline &points)>;
+
+// The same as above, but with `transform` applied to each glyph, like `gvar` variations.
+GlyphOutline decodeGlyphOutline(const quint8 *glyf, const quint32 glyfSize,
+                                const QVector<quint32> &locaOffsets, const quint16 glyphId,
+                                const GlyphPointsTransform &transform);
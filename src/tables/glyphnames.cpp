@@ -0,0 +1,63 @@
+#include "glyphnames.h"
+
+GlyphNames::GlyphNames(const quint16 numberOfGlyphs, CharacterMap characterMap, const QVector<QString> &names)
+    : m_characterMap(std::move(characterMap))
+    , m_names({ QString() })
+    , m_nameIds(numberOfGlyphs, 0)
+    , m_titles(numberOfGlyphs)
+    , m_hasTitles(true)
+{
+    QHash<QString, quint32> ids;
+    for (int i = 0; i < std::min<int>(names.size(), numberOfGlyphs); ++i) {
+        const auto &name = names[i];
+        if (name.isEmpty()) {
+            continue;
+        }
+
+        auto &id = ids[name];
+        if (id == 0) {
+            id = quint32(m_names.size());
+            m_names << name;
+        }
+
+        m_nameIds[i] = id;
+    }
+}
+
+QString GlyphNames::title(const quint16 glyphId) const
+{
+    if (!m_hasTitles) {
+        return QString();
+    }
+
+    if (glyphId >= m_titles.size()) {
+        return QString("Glyph %1").arg(glyphId);
+    }
+
+    auto &title = m_titles[glyphId];
+    if (!title.isNull()) {
+        return title;
+    }
+
+    QStringList parts;
+    if (const auto id = m_nameIds[glyphId]) {
+        parts << m_names[int(id)];
+    }
+
+    // Glyphs like space can have a lot of codepoints, so show only a few.
+    const auto codepoints = m_characterMap.codepoints(glyphId);
+    for (int i = 0; i < std::min<int>(codepoints.size(), 3); ++i) {
+        parts << QString("U+%1").arg(codepoints[i], 4, 16, QChar('0')).toUpper();
+    }
+
+    if (codepoints.size() > 3) {
+        parts << "...";
+    }
+
+    title = QString("Glyph %1").arg(glyphId);
+    if (!parts.isEmpty()) {
+        title += " (" + parts.join(", ") + ")";
+    }
+
+    return title;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "cmap.h"
+
+// Glyph titles annotated with glyph names and codepoints, like `Glyph 36 (A, U+0041)`.
+//
+// Names are stored as ids into a deduplicated string list. Titles are created on demand
+// and cached, so all tables of a face share the same implicitly shared strings.
+//
+// A default constructed object is used by headless parses, which don't need titles.
+class GlyphNames
+{
+public:
+    GlyphNames() = default;
+    GlyphNames(const quint16 numberOfGlyphs, CharacterMap characterMap, const QVector<QString> &names);
+
+    // Returns a null string when there are no titles.
+    QString title(const quint16 glyphId) const;
+
+private:
+    CharacterMap m_characterMap;
+    // The first name is always empty.
+    QVector<QString> m_names;
+    QVector<quint32> m_nameIds;
+    mutable QVector<QString> m_titles;
+    bool m_hasTitles = false;
+};
@@ -0,0 +1,490 @@
+#include <QtAlgorithms>
+
+#include <bitset>
+
+#include "gpos.h"
+#include "tables.h"
+
+struct ValueFormat
+{
+    static const int Size = 2;
+    static const QString Type;
+
+    static ValueFormat parse(const quint8 *data)
+    { return { qFromBigEndian<quint16>(data) }; }
+
+    static QString toString(const ValueFormat &value)
+    {
+        std::bitset<16> bits(value.d);
+        auto flagsStr = QString::fromUtf8(bits.to_string().c_str()) + '\n';
+
+        if (bits[0]) flagsStr += "Bit 0: X placement\n";
+        if (bits[1]) flagsStr += "Bit 1: Y placement\n";
+        if (bits[2]) flagsStr += "Bit 2: X advance\n";
+        if (bits[3]) flagsStr += "Bit 3: Y advance\n";
+        if (bits[4]) flagsStr += "Bit 4: X placement device\n";
+        if (bits[5]) flagsStr += "Bit 5: Y placement device\n";
+        if (bits[6]) flagsStr += "Bit 6: X advance device\n";
+        if (bits[7]) flagsStr += "Bit 7: Y advance device\n";
+        // 8-15 - reserved
+
+        flagsStr.chop(1); // trim trailing newline
+
+        return flagsStr;
+    }
+
+    operator quint16() const { return d; }
+
+    quint16 d;
+};
+
+const QString ValueFormat::Type = Parser::BitflagsType;
+
+// Device offsets are relative to `base`.
+static void readValueRecord(const quint16 format, const quint32 base, LayoutSubtables &subtables, Parser &parser)
+{
+    if (format & 0x0001) parser.read<Int16>("X placement");
+    if (format & 0x0002) parser.read<Int16>("Y placement");
+    if (format & 0x0004) parser.read<Int16>("X advance");
+    if (format & 0x0008) parser.read<Int16>("Y advance");
+
+    const LayoutSubtable device { LayoutSubtableType::Device };
+    if (format & 0x0010) {
+        subtables.readOffset<OptionalOffset16>("Offset to X placement Device table", base, device, parser);
+    }
+    if (format & 0x0020) {
+        subtables.readOffset<OptionalOffset16>("Offset to Y placement Device table", base, device, parser);
+    }
+    if (format & 0x0040) {
+        subtables.readOffset<OptionalOffset16>("Offset to X advance Device table", base, device, parser);
+    }
+    if (format & 0x0080) {
+        subtables.readOffset<OptionalOffset16>("Offset to Y advance Device table", base, device, parser);
+    }
+}
+
+// Pair values are grouped only when both are present.
+static void readPairValueRecords(const quint16 format1, const quint16 format2, const quint32 base,
+                                 LayoutSubtables &subtables, Parser &parser)
+{
+    if (format1 != 0 && format2 != 0) {
+        parser.beginGroup("First Value Record");
+        readValueRecord(format1, base, subtables, parser);
+        parser.endGroup();
+        parser.beginGroup("Second Value Record");
+        readValueRecord(format2, base, subtables, parser);
+        parser.endGroup();
+    } else {
+        readValueRecord(format1, base, subtables, parser);
+        readValueRecord(format2, base, subtables, parser);
+    }
+}
+
+static LayoutSubtable markClassesSubtable(const LayoutSubtableType type, const quint16 markClassCount)
+{
+    LayoutSubtable subtable { type };
+    subtable.format1 = markClassCount;
+    return subtable;
+}
+
+// Base, Mark2 and Component records are arrays of anchor offsets, one per mark class.
+static void readAnchorOffsets(const QString &title, const quint16 count, const quint16 markClassCount,
+                              const quint32 start, LayoutSubtables &subtables, Parser &parser)
+{
+    parser.readArray(title, count, [&](const auto index){
+        parser.beginGroup(index);
+        for (quint16 i = 0; i < markClassCount; ++i) {
+            subtables.readOffset<OptionalOffset16>(i, start, { LayoutSubtableType::Anchor }, parser);
+        }
+        parser.endGroup();
+    });
+}
+
+static QString parseLookupSubtable(const LayoutSubtable &subtable, LayoutSubtables &subtables, Parser &parser)
+{
+    const auto start = parser.offset();
+    const LayoutSubtable coverage { LayoutSubtableType::Coverage };
+
+    switch (subtable.lookupType) {
+    case 1: {
+        const auto format = parser.read<UInt16>("Format");
+        subtables.readOffset<Offset16>("Offset to Coverage table", start, coverage, parser);
+        const auto valueFormat = parser.read<ValueFormat>("Value format");
+        if (format == 1) {
+            readValueRecord(valueFormat, start, subtables, parser);
+        } else if (format == 2) {
+            const auto count = parser.read<UInt16>("Number of value records");
+            parser.readArray("Value Records", count, [&](const auto index){
+                parser.beginGroup(index);
+                readValueRecord(valueFormat, start, subtables, parser);
+                parser.endGroup();
+            });
+        } else {
+            throw QString("invalid single adjustment format");
+        }
+
+        return QString("Format %1").arg(format);
+    }
+    case 2: {
+        const auto format = parser.read<UInt16>("Format");
+        subtables.readOffset<Offset16>("Offset to Coverage table", start, coverage, parser);
+        const auto valueFormat1 = parser.read<ValueFormat>("First value format");
+        const auto valueFormat2 = parser.read<ValueFormat>("Second value format");
+        if (format == 1) {
+            LayoutSubtable pairSet { LayoutSubtableType::PairSet };
+            pairSet.format1 = valueFormat1;
+            pairSet.format2 = valueFormat2;
+
+            const auto count = parser.read<UInt16>("Number of pair sets");
+            parser.readArray("Pair Set Offsets", count, [&](const auto index){
+                subtables.readOffset<Offset16>(index, start, pairSet, parser);
+            });
+        } else if (format == 2) {
+            subtables.readOffset<Offset16>("Offset to first Class Definition table", start,
+                                           { LayoutSubtableType::ClassDef }, parser);
+            subtables.readOffset<Offset16>("Offset to second Class Definition table", start,
+                                           { LayoutSubtableType::ClassDef }, parser);
+            const auto class1Count = parser.read<UInt16>("Number of first classes");
+            const auto class2Count = parser.read<UInt16>("Number of second classes");
+            parser.readArray("Class 1 Records", class1Count, [&](const auto index){
+                parser.beginArray(QString::number(index), class2Count);
+                for (quint16 i = 0; i < class2Count; ++i) {
+                    parser.beginGroup(i);
+                    readPairValueRecords(valueFormat1, valueFormat2, start, subtables, parser);
+                    parser.endGroup();
+                }
+                parser.endArray();
+            });
+        } else {
+            throw QString("invalid pair adjustment format");
+        }
+
+        return QString("Format %1").arg(format);
+    }
+    case 3: {
+        const auto format = parser.read<UInt16>("Format");
+        if (format != 1) {
+            throw QString("invalid cursive attachment format");
+        }
+
+        subtables.readOffset<Offset16>("Offset to Coverage table", start, coverage, parser);
+        const auto count = parser.read<UInt16>("Number of records");
+        parser.readArray("Entry Exit Records", count, [&](const auto index){
+            parser.beginGroup(index);
+            subtables.readOffset<OptionalOffset16>("Offset to entry Anchor table", start,
+                                                   { LayoutSubtableType::Anchor }, parser);
+            subtables.readOffset<OptionalOffset16>("Offset to exit Anchor table", start,
+                                                   { LayoutSubtableType::Anchor }, parser);
+            parser.endGroup();
+        });
+
+        return QString("Format %1").arg(format);
+    }
+    case 4:
+    case 5:
+    case 6: {
+        const auto format = parser.read<UInt16>("Format");
+        if (format != 1) {
+            throw QString("invalid mark attachment format");
+        }
+
+        auto baseType = LayoutSubtableType::BaseArray;
+        QString baseName = "base";
+        if (subtable.lookupType == 5) {
+            baseType = LayoutSubtableType::LigatureArray;
+            baseName = "ligature";
+        } else if (subtable.lookupType == 6) {
+            baseType = LayoutSubtableType::Mark2Array;
+            baseName = "second mark";
+        }
+
+        subtables.readOffset<Offset16>("Offset to mark Coverage table", start, coverage, parser);
+        subtables.readOffset<Offset16>(QString("Offset to %1 Coverage table").arg(baseName),
+                                       start, coverage, parser);
+        const auto markClassCount = parser.read<UInt16>("Number of mark classes");
+        subtables.readOffset<Offset16>("Offset to Mark Array table", start,
+                                       { LayoutSubtableType::MarkArray }, parser);
+        subtables.readOffset<Offset16>(QString("Offset to %1 array table").arg(baseName), start,
+                                       markClassesSubtable(baseType, markClassCount), parser);
+
+        return QString("Format %1").arg(format);
+    }
+    case 7: return parseSequenceContext(subtable, subtables, parser);
+    case 8: return parseChainedSequenceContext(subtable, subtables, parser);
+    case 9: return parseExtension(LayoutTableType::Gpos, subtable, subtables, parser);
+    default:
+        // Unknown lookups will be marked as unsupported.
+        return QString();
+    }
+}
+
+static QString parseSubtable(const LayoutSubtable &subtable, LayoutSubtables &subtables, Parser &parser)
+{
+    const auto start = parser.offset();
+
+    switch (subtable.type) {
+    case LayoutSubtableType::LookupSubtable: {
+        return parseLookupSubtable(subtable, subtables, parser);
+    }
+    case LayoutSubtableType::PairSet: {
+        const auto count = parser.read<UInt16>("Number of records");
+        parser.readArray("Pair Value Records", count, [&](const auto index){
+            parser.beginGroup(index);
+            const auto glyph = parser.read<GlyphId>("Second glyph");
+            // Device offsets are relative to the Pair Set, like in HarfBuzz and fontTools.
+            readPairValueRecords(subtable.format1, subtable.format2, start, subtables, parser);
+            parser.endGroup(QString(), GlyphId::toString(glyph));
+        });
+        return QString();
+    }
+    case LayoutSubtableType::Anchor: {
+        const auto format = parser.read<UInt16>("Format");
+        const auto x = parser.read<Int16>("X coordinate");
+        const auto y = parser.read<Int16>("Y coordinate");
+        if (format == 2) {
+            parser.read<UInt16>("Anchor point");
+        } else if (format == 3) {
+            subtables.readOffset<OptionalOffset16>("Offset to X Device table", start,
+                                                   { LayoutSubtableType::Device }, parser);
+            subtables.readOffset<OptionalOffset16>("Offset to Y Device table", start,
+                                                   { LayoutSubtableType::Device }, parser);
+        } else if (format != 1) {
+            throw QString("invalid anchor format");
+        }
+        return QString("%1, %2").arg(x).arg(y);
+    }
+    case LayoutSubtableType::MarkArray: {
+        const auto count = parser.read<UInt16>("Number of records");
+        parser.readArray("Mark Records", count, [&](const auto index){
+            parser.beginGroup(index);
+            const auto markClass = parser.read<UInt16>("Mark class");
+            subtables.readOffset<Offset16>("Offset to Anchor table", start,
+                                           { LayoutSubtableType::Anchor }, parser);
+            parser.endGroup(QString(), QString("Class %1").arg(markClass));
+        });
+        return QString();
+    }
+    case LayoutSubtableType::BaseArray: {
+        const auto count = parser.read<UInt16>("Number of records");
+        readAnchorOffsets("Base Records", count, subtable.format1, start, subtables, parser);
+        return QString();
+    }
+    case LayoutSubtableType::Mark2Array: {
+        const auto count = parser.read<UInt16>("Number of records");
+        readAnchorOffsets("Mark2 Records", count, subtable.format1, start, subtables, parser);
+        return QString();
+    }
+    case LayoutSubtableType::LigatureArray: {
+        const auto count = parser.read<UInt16>("Number of ligatures");
+        const auto attach = markClassesSubtable(LayoutSubtableType::LigatureAttach, subtable.format1);
+        parser.readArray("Ligature Attach Offsets", count, [&](const auto index){
+            subtables.readOffset<Offset16>(index, start, attach, parser);
+        });
+        return QString();
+    }
+    case LayoutSubtableType::LigatureAttach: {
+        const auto count = parser.read<UInt16>("Number of components");
+        readAnchorOffsets("Component Records", count, subtable.format1, start, subtables, parser);
+        return QString();
+    }
+    default:
+        throw QString("invalid subtable type");
+    }
+}
+
+void parseGpos(const NamesHash &names, const quint32 tableSize, Parser &parser)
+{
+    parseLayoutTable(LayoutTableType::Gpos, names, tableSize, parseSubtable, parser);
+}
+
+static quint32 valueRecordSize(const quint16 format)
+{
+    return quint32(qPopulationCount(quint32(format & 0x00FF))) * 2;
+}
+
+static ValueRecord decodeValueRecord(quint16 format, const quint8 *data)
+{
+    ValueRecord record;
+    for (auto field : { &record.xPlacement, &record.yPlacement, &record.xAdvance, &record.yAdvance }) {
+        if (format & 1) {
+            *field = qFromBigEndian<qint16>(data);
+            data += 2;
+        }
+        format >>= 1;
+    }
+
+    return record;
+}
+
+// Returns glyphs in the Coverage index order, unlike GlyphCoverage.
+static QVector<quint16> collectCoverageGlyphs(ShadowParser &parser)
+{
+    QVector<quint16> glyphs;
+
+    const auto format = parser.read<UInt16>();
+    if (format == 1) {
+        const auto count = parser.read<UInt16>();
+        for (quint16 i = 0; i < count; ++i) {
+            glyphs << parser.read<GlyphId>();
+        }
+    } else if (format == 2) {
+        const auto count = parser.read<UInt16>();
+        for (quint16 i = 0; i < count; ++i) {
+            const quint16 first = parser.read<UInt16>();
+            const quint16 last = parser.read<UInt16>();
+            const quint16 startIndex = parser.read<UInt16>();
+            if (startIndex != glyphs.size()) {
+                throw QString("invalid coverage index");
+            }
+
+            for (quint32 id = first; id <= last; ++id) {
+                glyphs << quint16(id);
+            }
+        }
+    } else {
+        throw QString("invalid coverage format");
+    }
+
+    return glyphs;
+}
+
+PairAdjustmentIndex collectPairAdjustments(const LayoutLookups &lookups, const int lookupIndex,
+                                           const quint8 *data, const quint32 size)
+{
+    PairAdjustmentIndex index;
+    index.m_data = data;
+
+    if (lookups.tableType != LayoutTableType::Gpos || lookupIndex < 0 || lookupIndex >= lookups.lookups.size()) {
+        return index;
+    }
+
+    const auto &lookup = lookups.lookups[lookupIndex];
+    if (lookup.type != 2) {
+        return index;
+    }
+
+    ShadowParser parser(data, data + size);
+    for (const auto &subtable : lookup.subtables) {
+        parser.jumpTo(subtable.offset);
+        parser.skip<UInt16>(); // Format
+        const quint32 coverageOffset = parser.read<Offset16>();
+
+        PairAdjustmentIndex::Subtable pairs;
+        pairs.format = subtable.format;
+        pairs.valueFormat1 = parser.read<UInt16>();
+        pairs.valueFormat2 = parser.read<UInt16>();
+        // The second glyph or the class matrix row precedes values.
+        const auto recordSize = valueRecordSize(pairs.valueFormat1) + valueRecordSize(pairs.valueFormat2);
+
+        if (subtable.format == 1) {
+            const auto count = parser.read<UInt16>();
+            QVector<quint32> offsets;
+            for (quint16 i = 0; i < count; ++i) {
+                offsets << subtable.offset + quint32(parser.read<Offset16>());
+            }
+
+            parser.jumpTo(subtable.offset + coverageOffset);
+            const auto glyphs = collectCoverageGlyphs(parser);
+
+            for (int i = 0; i < std::min(glyphs.size(), offsets.size()); ++i) {
+                parser.jumpTo(offsets[i]);
+                const quint16 pairCount = parser.read<UInt16>();
+                if (offsets[i] + 2 + quint64(pairCount) * (2 + recordSize) > size) {
+                    throw QString("pair set is out of bounds");
+                }
+
+                // Only the first pair set of a glyph can be reached.
+                if (!pairs.pairSets.contains(glyphs[i])) {
+                    pairs.pairSets.insert(glyphs[i], { offsets[i] + 2, pairCount });
+                    index.m_numberOfPairs += pairCount;
+                }
+            }
+        } else if (subtable.format == 2) {
+            if (subtable.coverage < 0 || subtable.classDefinitions.size() != 2
+                || subtable.classDefinitions[0] < 0 || subtable.classDefinitions[1] < 0)
+            {
+                throw QString("invalid pair adjustment subtable");
+            }
+
+            parser.skip<UInt16>(); // First Class Definition offset
+            parser.skip<UInt16>(); // Second Class Definition offset
+            pairs.class1Count = parser.read<UInt16>();
+            pairs.class2Count = parser.read<UInt16>();
+            pairs.records = parser.offset();
+            if (pairs.records + quint64(pairs.class1Count) * pairs.class2Count * recordSize > size) {
+                throw QString("class matrix is out of bounds");
+            }
+
+            // Decoded tables are shared with the lookup list.
+            pairs.coverage = lookups.coverages[subtable.coverage];
+            pairs.classDef1 = lookups.classDefinitions[subtable.classDefinitions[0]];
+            pairs.classDef2 = lookups.classDefinitions[subtable.classDefinitions[1]];
+            index.m_numberOfPairs += quint64(pairs.class1Count) * pairs.class2Count;
+        } else {
+            throw QString("invalid pair adjustment format");
+        }
+
+        index.m_subtables << pairs;
+    }
+
+    return index;
+}
+
+std::optional<PairAdjustment> PairAdjustmentIndex::find(const quint16 first, const quint16 second) const
+{
+    for (int i = 0; i < m_subtables.size(); ++i) {
+        const auto &subtable = m_subtables[i];
+        const auto size1 = valueRecordSize(subtable.valueFormat1);
+        const auto recordSize = size1 + valueRecordSize(subtable.valueFormat2);
+
+        PairAdjustment adjustment;
+        adjustment.subtableIndex = i;
+        adjustment.format = subtable.format;
+
+        const quint8 *values = nullptr;
+        if (subtable.format == 1) {
+            // Pair value records are sorted by the second glyph.
+            const auto pairSet = subtable.pairSets.value(first, { 0, 0 });
+            const auto stride = 2 + recordSize;
+            const auto records = m_data + pairSet.offset;
+            quint32 low = 0;
+            quint32 high = pairSet.count;
+            while (low < high) {
+                const auto mid = (low + high) / 2;
+                const auto glyph = qFromBigEndian<quint16>(records + mid * stride);
+                if (glyph < second) {
+                    low = mid + 1;
+                } else if (glyph > second) {
+                    high = mid;
+                } else {
+                    values = records + mid * stride + 2;
+                    break;
+                }
+            }
+
+            // A pair set without the second glyph passes the pair to the next subtable.
+            if (!values) {
+                continue;
+            }
+        } else {
+            if (!subtable.coverage.contains(first)) {
+                continue;
+            }
+
+            adjustment.firstClass = subtable.classDef1.glyphClass(first);
+            adjustment.secondClass = subtable.classDef2.glyphClass(second);
+            if (adjustment.firstClass >= subtable.class1Count || adjustment.secondClass >= subtable.class2Count) {
+                continue;
+            }
+
+            const auto cell = quint32(adjustment.firstClass) * subtable.class2Count + adjustment.secondClass;
+            values = m_data + subtable.records + cell * recordSize;
+        }
+
+        adjustment.first = decodeValueRecord(subtable.valueFormat1, values);
+        adjustment.second = decodeValueRecord(subtable.valueFormat2, values + size1);
+        return adjustment;
+    }
+
+    return std::nullopt;
+}
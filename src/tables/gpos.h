@@ -0,0 +1,78 @@
+#pragma once
+
+#include <optional>
+
+#include "layout-common.h"
+
+// A value record without Device tables.
+struct ValueRecord
+{
+    qint16 xPlacement = 0;
+    qint16 yPlacement = 0;
+    qint16 xAdvance = 0;
+    qint16 yAdvance = 0;
+};
+
+struct PairAdjustment
+{
+    // An index of a subtable in a lookup.
+    int subtableIndex = 0;
+    quint16 format = 0;
+    // Glyph classes. Format 2 only.
+    quint16 firstClass = 0;
+    quint16 secondClass = 0;
+    ValueRecord first;
+    ValueRecord second;
+};
+
+// An index of a pair adjustment lookup.
+//
+// Format 1 subtables are indexed by the first glyph, which points to a pair set
+// sorted by the second glyph. Format 2 subtables use decoded class definitions
+// and a class matrix, so class pairs are never expanded into glyph pairs.
+// Values are read from the font data on query, which must outlive the index.
+class PairAdjustmentIndex
+{
+public:
+    // Returns an adjustment from the first subtable that has the pair, like shapers do.
+    std::optional<PairAdjustment> find(const quint16 first, const quint16 second) const;
+
+    bool isEmpty() const { return m_subtables.isEmpty(); }
+
+    // Explicit glyph pairs in format 1 subtables and class pairs in format 2 ones.
+    quint64 numberOfPairs() const { return m_numberOfPairs; }
+
+private:
+    friend PairAdjustmentIndex collectPairAdjustments(const LayoutLookups &lookups, const int lookupIndex,
+                                                      const quint8 *data, const quint32 size);
+
+    struct PairSet
+    {
+        quint32 offset;
+        quint16 count;
+    };
+
+    struct Subtable
+    {
+        quint16 format = 0;
+        quint16 valueFormat1 = 0;
+        quint16 valueFormat2 = 0;
+        // Format 1.
+        QHash<quint16, PairSet> pairSets;
+        // Format 2.
+        GlyphCoverage coverage;
+        GlyphClassDefinition classDef1;
+        GlyphClassDefinition classDef2;
+        quint16 class1Count = 0;
+        quint16 class2Count = 0;
+        quint32 records = 0;
+    };
+
+    const quint8 *m_data = nullptr;
+    QVector<Subtable> m_subtables;
+    quint64 m_numberOfPairs = 0;
+};
+
+// `data` is the `GPOS` table. Returns an empty index for other lookup types.
+PairAdjustmentIndex collectPairAdjustments(const LayoutLookups &lookups, const int lookupIndex,
+                                           const quint8 *data, const quint32 size);
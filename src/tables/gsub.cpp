@@ -0,0 +1,125 @@
+#include "layout-common.h"
+#include "tables.h"
+
+static void readCoverageOffsets(const QString &title, const quint16 count, const quint32 start,
+                                LayoutSubtables &subtables, Parser &parser)
+{
+    parser.readArray(title, count, [&](const auto index){
+        subtables.readOffset<Offset16>(index, start, { LayoutSubtableType::Coverage }, parser);
+    });
+}
+
+static QString parseLookupSubtable(const LayoutSubtable &subtable, LayoutSubtables &subtables, Parser &parser)
+{
+    const auto start = parser.offset();
+
+    switch (subtable.lookupType) {
+    case 1: {
+        const auto format = parser.read<UInt16>("Format");
+        subtables.readOffset<Offset16>("Offset to Coverage table", start, { LayoutSubtableType::Coverage }, parser);
+        if (format == 1) {
+            parser.read<Int16>("Delta glyph ID");
+        } else if (format == 2) {
+            const auto count = parser.read<UInt16>("Number of glyphs");
+            parser.readBasicArray<GlyphId>("Substitute Glyphs", count);
+        } else {
+            throw QString("invalid single substitution format");
+        }
+
+        return QString("Format %1").arg(format);
+    }
+    case 2:
+    case 3:
+    case 4: {
+        const auto format = parser.read<UInt16>("Format");
+        if (format != 1) {
+            throw QString("invalid substitution format");
+        }
+
+        subtables.readOffset<Offset16>("Offset to Coverage table", start, { LayoutSubtableType::Coverage }, parser);
+
+        auto type = LayoutSubtableType::Sequence;
+        QString title = "Sequence Offsets";
+        if (subtable.lookupType == 3) {
+            type = LayoutSubtableType::AlternateSet;
+            title = "Alternate Set Offsets";
+        } else if (subtable.lookupType == 4) {
+            type = LayoutSubtableType::LigatureSet;
+            title = "Ligature Set Offsets";
+        }
+
+        const auto count = parser.read<UInt16>("Number of offsets");
+        parser.readArray(title, count, [&](const auto index){
+            subtables.readOffset<Offset16>(index, start, { type }, parser);
+        });
+
+        return QString("Format %1").arg(format);
+    }
+    case 5: return parseSequenceContext(subtable, subtables, parser);
+    case 6: return parseChainedSequenceContext(subtable, subtables, parser);
+    case 7: return parseExtension(LayoutTableType::Gsub, subtable, subtables, parser);
+    case 8: {
+        const auto format = parser.read<UInt16>("Format");
+        if (format != 1) {
+            throw QString("invalid reverse chaining substitution format");
+        }
+
+        subtables.readOffset<Offset16>("Offset to Coverage table", start, { LayoutSubtableType::Coverage }, parser);
+        const auto backtrackCount = parser.read<UInt16>("Number of backtrack glyphs");
+        readCoverageOffsets("Backtrack Coverage Offsets", backtrackCount, start, subtables, parser);
+        const auto lookaheadCount = parser.read<UInt16>("Number of lookahead glyphs");
+        readCoverageOffsets("Lookahead Coverage Offsets", lookaheadCount, start, subtables, parser);
+        const auto count = parser.read<UInt16>("Number of glyphs");
+        parser.readBasicArray<GlyphId>("Substitute Glyphs", count);
+
+        return QString("Format %1").arg(format);
+    }
+    default:
+        // Unknown lookups will be marked as unsupported.
+        return QString();
+    }
+}
+
+static QString parseSubtable(const LayoutSubtable &subtable, LayoutSubtables &subtables, Parser &parser)
+{
+    const auto start = parser.offset();
+
+    switch (subtable.type) {
+    case LayoutSubtableType::LookupSubtable: {
+        return parseLookupSubtable(subtable, subtables, parser);
+    }
+    case LayoutSubtableType::Sequence: {
+        const auto count = parser.read<UInt16>("Number of glyphs");
+        parser.readBasicArray<GlyphId>("Substitute Glyphs", count);
+        return QString();
+    }
+    case LayoutSubtableType::AlternateSet: {
+        const auto count = parser.read<UInt16>("Number of glyphs");
+        parser.readBasicArray<GlyphId>("Alternate Glyphs", count);
+        return QString();
+    }
+    case LayoutSubtableType::LigatureSet: {
+        const auto count = parser.read<UInt16>("Number of ligatures");
+        parser.readArray("Ligature Offsets", count, [&](const auto index){
+            subtables.readOffset<Offset16>(index, start, { LayoutSubtableType::Ligature }, parser);
+        });
+        return QString();
+    }
+    case LayoutSubtableType::Ligature: {
+        const auto glyph = parser.read<GlyphId>("Ligature glyph");
+        const auto count = parser.read<UInt16>("Number of components");
+        if (count == 0) {
+            throw QString("invalid number of ligature components");
+        }
+        parser.readBasicArray<GlyphId>("Component Glyphs", count - 1);
+        return GlyphId::toString(glyph);
+    }
+    default:
+        throw QString("invalid subtable type");
+    }
+}
+
+void parseGsub(const NamesHash &names, const quint32 tableSize, Parser &parser)
+{
+    parseLayoutTable(LayoutTableType::Gsub, names, tableSize, parseSubtable, parser);
+}
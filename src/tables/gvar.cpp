@@ -1,4 +1,5 @@
 #include "src/algo.h"
+#include "gvar.h"
 #include "tables.h"
 
 static const quint16 SHARED_POINT_NUMBERS = 0x8000;
@@ -172,3 +173,371 @@ void parseGvar(Parser &parser)
         parser.endGroup();
     });
 }
+
+GlyphVariations collectGvar(ShadowParser &parser)
+{
+    const auto start = parser.offset();
+
+    const quint16 majorVersion = parser.read<UInt16>();
+    parser.skip<UInt16>(); // minor version
+    if (majorVersion != 1) {
+        throw QString("invalid table version");
+    }
+
+    GlyphVariations variations;
+    variations.numberOfAxes = parser.read<UInt16>();
+    const quint16 sharedTupleCount = parser.read<UInt16>();
+    const quint32 sharedTuplesOffset = parser.read<Offset32>();
+    const quint16 glyphCount = parser.read<UInt16>();
+    const quint16 flags = parser.read<UInt16>();
+    const quint32 dataOffset = parser.read<Offset32>();
+    const bool longFormat = (flags & 1) == 1;
+
+    variations.offsets.reserve(glyphCount + 1);
+    for (int i = 0; i < glyphCount + 1; ++i) {
+        const quint32 offset = longFormat ? quint32(parser.read<Offset32>())
+                                          : quint32(parser.read<Offset16>()) * 2;
+        variations.offsets << start + dataOffset + offset;
+    }
+
+    if (sharedTupleCount != 0) {
+        parser.jumpTo(start + sharedTuplesOffset);
+        variations.sharedTuples.reserve(sharedTupleCount * variations.numberOfAxes);
+        for (int i = 0; i < sharedTupleCount * variations.numberOfAxes; ++i) {
+            variations.sharedTuples << parser.read<F2DOT14>();
+        }
+    }
+
+    return variations;
+}
+
+// Returns a tuple scalar. `start` and `end` are null when there is no intermediate region.
+static float tupleScalar(const float *peak, const float *start, const float *end,
+                         const QVector<float> &coords, const quint16 numberOfAxes)
+{
+    float scalar = 1;
+    for (quint16 i = 0; i < numberOfAxes; ++i) {
+        const auto p = peak[i];
+        if (p == 0) {
+            continue;
+        }
+
+        const auto v = coords.value(i);
+        if (v == p) {
+            continue;
+        }
+
+        const auto s = start ? start[i] : std::min(p, 0.0f);
+        const auto e = end ? end[i] : std::max(p, 0.0f);
+        // Invalid regions are ignored.
+        if (s > p || p > e || (s < 0 && e > 0)) {
+            continue;
+        }
+
+        if (v == 0 || v < s || v > e) {
+            return 0;
+        }
+
+        scalar *= v < p ? (v - s) / (p - s) : (e - v) / (e - p);
+    }
+
+    return scalar;
+}
+
+QVector<float> GlyphVariations::sharedTupleScalars(const QVector<float> &coords) const
+{
+    QVector<float> scalars;
+    if (numberOfAxes == 0) {
+        return scalars;
+    }
+
+    const auto count = sharedTuples.size() / numberOfAxes;
+    scalars.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        scalars << tupleScalar(sharedTuples.constData() + i * numberOfAxes, nullptr, nullptr,
+                               coords, numberOfAxes);
+    }
+
+    return scalars;
+}
+
+// Returns point numbers or an empty array when all points are referenced.
+static QVector<quint16> readPackedPoints(ShadowParser &parser)
+{
+    QVector<quint16> points;
+
+    const quint8 control = parser.read<UInt8>();
+    if (control == 0) {
+        return points;
+    }
+
+    quint16 count = control;
+    if (control & POINTS_ARE_WORDS) {
+        count = quint16(((control & POINT_RUN_COUNT_MASK) << 8) | parser.read<UInt8>());
+    }
+
+    points.reserve(count);
+    quint16 point = 0;
+    while (points.size() < count) {
+        const quint8 run = parser.read<UInt8>();
+        const auto runCount = (run & POINT_RUN_COUNT_MASK) + 1;
+        for (int j = 0; j < runCount && points.size() < count; ++j) {
+            // Point numbers are stored as differences from the previous one.
+            point += (run & POINTS_ARE_WORDS) ? quint16(parser.read<UInt16>()) : quint16(parser.read<UInt8>());
+            points << point;
+        }
+    }
+
+    return points;
+}
+
+static void readPackedDeltas(const int count, ShadowParser &parser, QVarLengthArray<float, 256> &deltas)
+{
+    deltas.resize(count);
+    int i = 0;
+    while (i < count) {
+        const quint8 control = parser.read<UInt8>();
+        const auto runCount = std::min((control & DELTA_RUN_COUNT_MASK) + 1, count - i);
+        float *out = deltas.data() + i;
+        if (control & DELTAS_ARE_ZERO) {
+            std::fill(out, out + runCount, 0.0f);
+        } else if (control & DELTAS_ARE_WORDS) {
+            for (int j = 0; j < runCount; ++j) {
+                out[j] = qint16(parser.read<Int16>());
+            }
+        } else {
+            for (int j = 0; j < runCount; ++j) {
+                out[j] = qint8(parser.read<Int8>());
+            }
+        }
+
+        i += runCount;
+    }
+}
+
+// Interpolates deltas of untouched points on one axis between two reference points.
+static void interpolateSegment(const float *coords, const int from, const int to,
+                               const int ref1, const int ref2,
+                               const QVarLengthArray<float, 256> &deltas, float *out)
+{
+    auto x1 = coords[ref1];
+    auto x2 = coords[ref2];
+    auto d1 = deltas[ref1];
+    auto d2 = deltas[ref2];
+
+    if (x1 == x2) {
+        const auto d = d1 == d2 ? d1 : 0.0f;
+        for (int i = from; i < to; ++i) {
+            out[i] = d;
+        }
+        return;
+    }
+
+    if (x1 > x2) {
+        std::swap(x1, x2);
+        std::swap(d1, d2);
+    }
+
+    const auto scale = (d2 - d1) / (x2 - x1);
+    for (int i = from; i < to; ++i) {
+        const auto x = coords[i];
+        if (x <= x1) {
+            out[i] = d1;
+        } else if (x >= x2) {
+            out[i] = d2;
+        } else {
+            out[i] = d1 + (x - x1) * scale;
+        }
+    }
+}
+
+// Fills deltas of untouched points within each contour. Untouched points outside of contours get zero.
+static void interpolateUntouched(const float *coords, const QVector<quint16> &contourEnds,
+                                 const QVarLengthArray<bool, 256> &touched,
+                                 QVarLengthArray<float, 256> &deltas)
+{
+    const int numberOfPoints = touched.size();
+    QVarLengthArray<float, 256> out(deltas);
+
+    int start = 0;
+    for (const auto contourEnd : contourEnds) {
+        const int end = std::min<int>(contourEnd + 1, numberOfPoints);
+        if (start >= end) {
+            break;
+        }
+
+        int first = -1;
+        int last = -1;
+        for (int i = start; i < end; ++i) {
+            if (touched[i]) {
+                if (first == -1) {
+                    first = i;
+                }
+                last = i;
+            }
+        }
+
+        if (first == -1) {
+            std::fill(out.begin() + start, out.begin() + end, 0.0f);
+        } else {
+            // A segment that wraps around the contour start.
+            interpolateSegment(coords, start, first, first, last, deltas, out.data());
+            interpolateSegment(coords, last + 1, end, last, first, deltas, out.data());
+
+            int prev = first;
+            for (int i = first + 1; i <= last; ++i) {
+                if (touched[i]) {
+                    interpolateSegment(coords, prev + 1, i, prev, i, deltas, out.data());
+                    prev = i;
+                }
+            }
+        }
+
+        start = end;
+    }
+
+    for (int i = start; i < numberOfPoints; ++i) {
+        if (!touched[i]) {
+            out[i] = 0;
+        }
+    }
+
+    deltas = out;
+}
+
+void applyGlyphVariations(const quint8 *gvar, const quint32 gvarSize,
+                          const GlyphVariations &variations, const quint16 glyphId,
+                          const QVector<float> &coords, const QVector<float> &sharedScalars,
+                          GlyphOutline &points)
+{
+    if (glyphId + 1 >= variations.offsets.size()) {
+        return;
+    }
+
+    const auto start = variations.offsets[glyphId];
+    const auto end = variations.offsets[glyphId + 1];
+    if (start >= end) {
+        return;
+    }
+
+    if (end > gvarSize) {
+        throw QString("glyph variation data is out of bounds");
+    }
+
+    const auto numberOfAxes = variations.numberOfAxes;
+    const auto numberOfPoints = points.size();
+
+    ShadowParser parser(gvar + start, gvar + end);
+    const quint16 value = parser.read<UInt16>();
+    const quint16 dataOffset = parser.read<Offset16>();
+    const auto tupleCount = value & COUNT_MASK;
+
+    // Untouched points are interpolated using the original coordinates for all tuples.
+    const auto origX = points.x;
+    const auto origY = points.y;
+
+    QVector<quint16> sharedPoints;
+    quint32 dataStart = dataOffset;
+    if (value & SHARED_POINT_NUMBERS) {
+        ShadowParser dataParser(gvar + start + dataStart, gvar + end);
+        sharedPoints = readPackedPoints(dataParser);
+        dataStart += dataParser.offset();
+    }
+
+    QVarLengthArray<float, 16> peak;
+    QVarLengthArray<float, 16> regionStart;
+    QVarLengthArray<float, 16> regionEnd;
+    peak.resize(numberOfAxes);
+    regionStart.resize(numberOfAxes);
+    regionEnd.resize(numberOfAxes);
+    QVarLengthArray<float, 256> deltasX;
+    QVarLengthArray<float, 256> deltasY;
+    QVarLengthArray<bool, 256> touched;
+    for (int t = 0; t < tupleCount; ++t) {
+        const quint16 dataSize = parser.read<UInt16>();
+        const quint16 tupleIndex = parser.read<UInt16>();
+        const auto tupleData = dataStart;
+        dataStart += dataSize;
+
+        const bool hasIntermediate = tupleIndex & INTERMEDIATE_REGION;
+        float scalar = 0;
+        if (tupleIndex & EMBEDDED_PEAK_TUPLE) {
+            for (quint16 i = 0; i < numberOfAxes; ++i) {
+                peak[i] = parser.read<F2DOT14>();
+            }
+        } else {
+            const auto index = tupleIndex & COUNT_MASK;
+            if ((index + 1) * numberOfAxes > variations.sharedTuples.size()) {
+                throw QString("invalid shared tuple index");
+            }
+
+            if (!hasIntermediate) {
+                scalar = sharedScalars.value(index);
+            }
+
+            std::copy_n(variations.sharedTuples.constData() + index * numberOfAxes, numberOfAxes, peak.data());
+        }
+
+        if (hasIntermediate) {
+            for (quint16 i = 0; i < numberOfAxes; ++i) {
+                regionStart[i] = parser.read<F2DOT14>();
+            }
+            for (quint16 i = 0; i < numberOfAxes; ++i) {
+                regionEnd[i] = parser.read<F2DOT14>();
+            }
+        }
+
+        if ((tupleIndex & EMBEDDED_PEAK_TUPLE) || hasIntermediate) {
+            scalar = tupleScalar(peak.data(), hasIntermediate ? regionStart.data() : nullptr,
+                                 hasIntermediate ? regionEnd.data() : nullptr, coords, numberOfAxes);
+        }
+
+        if (scalar == 0) {
+            continue;
+        }
+
+        if (start + quint64(tupleData) + dataSize > end) {
+            throw QString("tuple data is out of bounds");
+        }
+
+        ShadowParser dataParser(gvar + start + tupleData, gvar + start + tupleData + dataSize);
+        const auto pointNumbers = (tupleIndex & PRIVATE_POINT_NUMBERS)
+            ? readPackedPoints(dataParser) : sharedPoints;
+
+        if (pointNumbers.isEmpty()) {
+            readPackedDeltas(numberOfPoints, dataParser, deltasX);
+            readPackedDeltas(numberOfPoints, dataParser, deltasY);
+            for (int i = 0; i < numberOfPoints; ++i) {
+                points.x[i] += deltasX[i] * scalar;
+                points.y[i] += deltasY[i] * scalar;
+            }
+            continue;
+        }
+
+        QVarLengthArray<float, 256> packedX;
+        QVarLengthArray<float, 256> packedY;
+        readPackedDeltas(pointNumbers.size(), dataParser, packedX);
+        readPackedDeltas(pointNumbers.size(), dataParser, packedY);
+
+        deltasX.resize(numberOfPoints);
+        deltasY.resize(numberOfPoints);
+        touched.resize(numberOfPoints);
+        std::fill(touched.begin(), touched.end(), false);
+        for (int i = 0; i < pointNumbers.size(); ++i) {
+            const auto point = pointNumbers[i];
+            if (point < numberOfPoints) {
+                deltasX[point] = packedX[i];
+                deltasY[point] = packedY[i];
+                touched[point] = true;
+            }
+        }
+
+        interpolateUntouched(origX.constData(), points.contourEnds, touched, deltasX);
+        interpolateUntouched(origY.constData(), points.contourEnds, touched, deltasY);
+
+        for (int i = 0; i < numberOfPoints; ++i) {
+            points.x[i] += deltasX[i] * scalar;
+            points.y[i] += deltasY[i] * scalar;
+        }
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "glyf.h"
+
+// A decoded `gvar` header.
+struct GlyphVariations
+{
+    quint16 numberOfAxes = 0;
+    // Peak tuples referenced by index, `numberOfAxes` values each.
+    QVector<float> sharedTuples;
+    // Glyph Variation Data offsets from the start of the table, numberOfGlyphs + 1 items.
+    QVector<quint32> offsets;
+
+    bool isEmpty() const { return offsets.size() < 2; }
+
+    // Returns scalars of shared tuples at normalized coordinates.
+    //
+    // They depend only on coordinates, so they should be computed once per instance.
+    QVector<float> sharedTupleScalars(const QVector<float> &coords) const;
+};
+
+// The parser must be at the start of the table.
+GlyphVariations collectGvar(ShadowParser &parser);
+
+// Applies variations of a single glyph at normalized coordinates.
+//
+// `points` must contain points of a simple glyph or component offsets of a composite one,
+// followed by four phantom points. Points that are not referenced by a tuple are
+// interpolated (IUP) within their contours. Points outside `contourEnds` are not.
+void applyGlyphVariations(const quint8 *gvar, const quint32 gvarSize,
+                          const GlyphVariations &variations, const quint16 glyphId,
+                          const QVector<float> &coords, const QVector<float> &sharedScalars,
+                          GlyphOutline &points);
@@ -1,5 +1,6 @@
 #include "src/algo.h"
 #include "tables.h"
+#include "varstore.h"
 
 struct HvarMasks
 {
@@ -32,29 +33,24 @@ void parseHvarDeltaSet(Parser &parser)
 
     const auto innerIndexBits = format.innerIndexBits();
     const auto entrySize = format.entrySize();
+    // Values depend on the entry format, so the cache is per delta set.
+    QHash<quint16, QString> cache;
+    const auto entryValue = [&](const quint16 entry) {
+        if (!cache.contains(entry)) {
+            const auto outerIndex = entry >> (innerIndexBits + 1);
+            const auto innerIndex = entry & ((1 << (innerIndexBits + 1)) - 1);
+            const auto value = QString("Outer index: %1\nInner index: %2")
+                .arg(outerIndex).arg(innerIndex);
+            cache.insert(entry, value);
+        }
+        return cache.value(entry);
+    };
+
     parser.readArray("Entries", count, [&](const auto index){
         if (entrySize == 1) {
-            static QHash<quint8, QString> cache;
-            const auto entry = parser.peek<UInt8>();
-            if (!cache.contains(entry)) {
-                const auto outerIndex = entry >> (innerIndexBits + 1);
-                const auto innerIndex = entry & ((1 << (innerIndexBits + 1)) - 1);
-                const auto value = QString("Outer index: %1\nInner index: %2")
-                    .arg(outerIndex).arg(innerIndex);
-                cache.insert(entry, value);
-            }
-            parser.readValue<UInt8>(numberToString(index), cache.value(entry));
+            parser.readValue<UInt8>(numberToString(index), entryValue(parser.peek<UInt8>()));
         } else if (entrySize == 2) {
-            static QHash<quint8, QString> cache;
-            const auto entry = parser.peek<UInt16>();
-            if (!cache.contains(entry)) {
-                const auto outerIndex = entry >> (innerIndexBits + 1);
-                const auto innerIndex = entry & ((1 << (innerIndexBits + 1)) - 1);
-                const auto value = QString("Outer index: %1\nInner index: %2")
-                    .arg(outerIndex).arg(innerIndex);
-                cache.insert(entry, value);
-            }
-            parser.readValue<UInt16>(numberToString(index), cache.value(entry));
+            parser.readValue<UInt16>(numberToString(index), entryValue(parser.peek<UInt16>()));
         } else {
             throw QString("unsupported entry size");
         }
@@ -129,3 +125,51 @@ void parseHvar(Parser &parser)
         }
     }
 }
+
+// Shared by HVAR and VVAR, which differ only by the number of mappings.
+static MetricsVariations collectMetricsVariations(const int numberOfMappings, ShadowParser &parser)
+{
+    const auto start = parser.offset();
+
+    const quint16 majorVersion = parser.read<UInt16>();
+    const quint16 minorVersion = parser.read<UInt16>();
+    if (!(majorVersion == 1 && minorVersion == 0)) {
+        throw QString("invalid table version");
+    }
+
+    const quint32 varStoreOffset = parser.read<Offset32>();
+    QVector<quint32> mappingOffsets;
+    for (int i = 0; i < numberOfMappings; ++i) {
+        mappingOffsets << quint32(parser.read<OptionalOffset32>());
+    }
+
+    auto readMap = [&](const quint32 offset) -> QVector<quint32> {
+        if (offset == 0) {
+            return {};
+        }
+
+        parser.jumpTo(start + offset);
+        return collectDeltaSetIndexMap(parser);
+    };
+
+    MetricsVariations variations;
+    variations.advanceMap = readMap(mappingOffsets[0]);
+    variations.startSideBearingMap = readMap(mappingOffsets[1]);
+    variations.endSideBearingMap = readMap(mappingOffsets[2]);
+
+    parser.jumpTo(start + varStoreOffset);
+    variations.store = collectItemVariationStore(parser);
+
+    return variations;
+}
+
+MetricsVariations collectHvar(ShadowParser &parser)
+{
+    return collectMetricsVariations(3, parser);
+}
+
+MetricsVariations collectVvar(ShadowParser &parser)
+{
+    // The vertical origin mapping is not used.
+    return collectMetricsVariations(4, parser);
+}
@@ -1,6 +1,7 @@
 #include <bitset>
 
 #include "src/algo.h"
+#include "kern.h"
 #include "tables.h"
 
 struct OpenTypeCoverage
@@ -484,3 +485,224 @@ void parseKern(Parser &parser)
         parseKernApple(parser);
     }
 }
+
+KerningTable collectKern(ShadowParser &parser)
+{
+    KerningTable table;
+
+    // See parseKern() for how variants are detected.
+    const bool isApple = parser.read<UInt16>() != 0;
+    quint32 numberOfTables = 0;
+    if (isApple) {
+        parser.skip<UInt16>(); // The second half of the version
+        numberOfTables = parser.read<UInt32>();
+    } else {
+        numberOfTables = parser.read<UInt16>();
+    }
+
+    auto subtableStart = parser.offset();
+    for (quint32 i = 0; i < numberOfTables; ++i) {
+        parser.jumpTo(subtableStart);
+
+        KerningTable::Subtable subtable;
+        subtable.index = int(i);
+
+        quint32 length = 0;
+        quint8 coverage = 0;
+        if (isApple) {
+            length = parser.read<UInt32>();
+            coverage = parser.read<UInt8>();
+            subtable.format = parser.read<UInt8>();
+            parser.skip<UInt16>(); // Tuple index
+            subtable.isHorizontal = !(coverage & 0x80);
+            subtable.isAccumulated = !(coverage & 0x60);
+        } else {
+            parser.skip<UInt16>(); // Version
+            length = parser.read<UInt16>();
+            subtable.format = parser.read<UInt8>();
+            coverage = parser.read<UInt8>();
+            subtable.isHorizontal = coverage & 0x01;
+            subtable.isAccumulated = !(coverage & 0x06);
+            subtable.isOverride = coverage & 0x08;
+        }
+
+        const auto headerSize = parser.offset() - subtableStart;
+
+        switch (subtable.format) {
+        case 0: {
+            const auto count = parser.read<UInt16>();
+            parser.skip<UInt16>(); // Search range
+            parser.skip<UInt16>(); // Entry selector
+            parser.skip<UInt16>(); // Range shift
+
+            subtable.pairs.reserve(count);
+            for (quint16 j = 0; j < count; ++j) {
+                const quint32 left = parser.read<GlyphId>();
+                const quint32 right = parser.read<GlyphId>();
+                subtable.pairs.append({ (left << 16) | right, parser.read<Int16>() });
+            }
+
+            // Pairs must be sorted already, but the first duplicate wins anyway.
+            std::stable_sort(subtable.pairs.begin(), subtable.pairs.end(), [](const auto &a, const auto &b){
+                return a.glyphs < b.glyphs;
+            });
+            table.m_numberOfPairs += count;
+
+            // Large OpenType subtables overflow the 16-bit length.
+            if (!isApple) {
+                length = headerSize + 8 + quint32(count) * 6;
+            }
+            break;
+        }
+        case 2: {
+            parser.skip<UInt16>(); // Row width
+            const quint32 leftOffset = parser.read<Offset16>();
+            const quint32 rightOffset = parser.read<Offset16>();
+            subtable.valuesOffset = parser.read<Offset16>();
+
+            auto readClasses = [&](const quint32 offset, quint16 &firstGlyph, QVector<quint16> &classes){
+                parser.jumpTo(subtableStart + offset);
+                firstGlyph = parser.read<GlyphId>();
+                const auto count = parser.read<UInt16>();
+                for (quint16 j = 0; j < count; ++j) {
+                    classes << parser.read<UInt16>();
+                }
+            };
+
+            readClasses(leftOffset, subtable.leftFirstGlyph, subtable.leftClasses);
+            readClasses(rightOffset, subtable.rightFirstGlyph, subtable.rightClasses);
+
+            // The array has no explicit size, so it spans to the end of the subtable.
+            if (length > subtable.valuesOffset) {
+                parser.jumpTo(subtableStart + subtable.valuesOffset);
+                const auto count = (length - subtable.valuesOffset) / 2;
+                for (quint32 j = 0; j < count; ++j) {
+                    subtable.values << parser.read<Int16>();
+                }
+            }
+
+            table.m_numberOfPairs += quint64(subtable.values.size());
+            break;
+        }
+        case 3: {
+            const auto glyphCount = parser.read<UInt16>();
+            const auto valueCount = parser.read<UInt8>();
+            const auto leftClassCount = parser.read<UInt8>();
+            subtable.rightClassCount = parser.read<UInt8>();
+            parser.skip<UInt8>(); // Flags
+
+            for (quint8 j = 0; j < valueCount; ++j) {
+                subtable.values << parser.read<Int16>();
+            }
+            for (quint16 j = 0; j < glyphCount; ++j) {
+                subtable.leftClasses << parser.read<UInt8>();
+            }
+            for (quint16 j = 0; j < glyphCount; ++j) {
+                subtable.rightClasses << parser.read<UInt8>();
+            }
+            for (quint32 j = 0; j < quint32(leftClassCount) * subtable.rightClassCount; ++j) {
+                subtable.indices << parser.read<UInt8>();
+            }
+
+            table.m_numberOfPairs += quint64(leftClassCount) * subtable.rightClassCount;
+            break;
+        }
+        default:
+            // Format 1 is a state machine.
+            break;
+        }
+
+        if (subtable.format != 1) {
+            table.m_subtables << subtable;
+        }
+
+        if (length < headerSize) {
+            throw QString("invalid subtable length");
+        }
+
+        subtableStart += length;
+    }
+
+    return table;
+}
+
+std::optional<qint16> KerningTable::find(const Subtable &subtable, const quint16 left, const quint16 right)
+{
+    switch (subtable.format) {
+    case 0: {
+        const quint32 glyphs = (quint32(left) << 16) | right;
+        const auto it = std::lower_bound(subtable.pairs.begin(), subtable.pairs.end(), glyphs,
+                                         [](const Pair &pair, const quint32 g){ return pair.glyphs < g; });
+        if (it == subtable.pairs.end() || it->glyphs != glyphs) {
+            return std::nullopt;
+        }
+
+        return it->value;
+    }
+    case 2: {
+        const auto leftIndex = int(left) - int(subtable.leftFirstGlyph);
+        const auto rightIndex = int(right) - int(subtable.rightFirstGlyph);
+        if (leftIndex < 0 || leftIndex >= subtable.leftClasses.size()
+            || rightIndex < 0 || rightIndex >= subtable.rightClasses.size())
+        {
+            return std::nullopt;
+        }
+
+        // Classes are byte offsets from the subtable start.
+        const auto offset = quint32(subtable.leftClasses[leftIndex]) + subtable.rightClasses[rightIndex];
+        if (offset < subtable.valuesOffset || (offset - subtable.valuesOffset) / 2 >= quint32(subtable.values.size())) {
+            return std::nullopt;
+        }
+
+        return subtable.values[int((offset - subtable.valuesOffset) / 2)];
+    }
+    case 3: {
+        if (left >= subtable.leftClasses.size() || right >= subtable.rightClasses.size()) {
+            return std::nullopt;
+        }
+
+        const auto cell = quint32(subtable.leftClasses[left]) * subtable.rightClassCount
+                        + subtable.rightClasses[right];
+        if (subtable.rightClasses[right] >= subtable.rightClassCount || cell >= quint32(subtable.indices.size())) {
+            return std::nullopt;
+        }
+
+        const auto index = subtable.indices[int(cell)];
+        if (index >= subtable.values.size()) {
+            return std::nullopt;
+        }
+
+        return subtable.values[index];
+    }
+    default:
+        return std::nullopt;
+    }
+}
+
+QVector<KerningTable::Value> KerningTable::find(const quint16 left, const quint16 right) const
+{
+    QVector<Value> values;
+    for (const auto &subtable : m_subtables) {
+        if (const auto value = find(subtable, left, right)) {
+            values.append({ subtable.index, subtable.format, *value });
+        }
+    }
+
+    return values;
+}
+
+std::optional<qint32> KerningTable::kerning(const quint16 left, const quint16 right) const
+{
+    std::optional<qint32> kerning;
+    for (const auto &subtable : m_subtables) {
+        if (!subtable.isHorizontal || !subtable.isAccumulated) {
+            continue;
+        }
+
+        if (const auto value = find(subtable, left, right)) {
+            kerning = subtable.isOverride ? *value : kerning.value_or(0) + *value;
+        }
+    }
+
+    return kerning;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <optional>
+
+#include "src/parser.h"
+
+// A decoded `kern` table of either the OpenType or the Apple variant.
+//
+// Format 0 pairs are stored as a sorted array and are binary searched.
+// Formats 2 and 3 keep their class arrays and kerning matrices.
+// Format 1 state machines are not pair-based, so they are skipped.
+class KerningTable
+{
+public:
+    struct Value
+    {
+        int subtableIndex;
+        quint8 format;
+        qint16 value;
+    };
+
+    // Returns values of all subtables that have the pair, including
+    // vertical and cross-stream ones.
+    QVector<Value> find(const quint16 left, const quint16 right) const;
+
+    // Returns the horizontal kerning of a pair or std::nullopt when no subtable has it.
+    //
+    // Values of horizontal subtables are accumulated, unless a subtable overrides them.
+    // Cross-stream, minimum and variation subtables are ignored.
+    std::optional<qint32> kerning(const quint16 left, const quint16 right) const;
+
+    bool isEmpty() const { return m_subtables.isEmpty(); }
+
+    // The number of format 0 pairs and class pairs of formats 2 and 3.
+    quint64 numberOfPairs() const { return m_numberOfPairs; }
+
+private:
+    friend KerningTable collectKern(ShadowParser &parser);
+
+    struct Pair
+    {
+        // The left glyph in the high 16 bits.
+        quint32 glyphs;
+        qint16 value;
+    };
+
+    struct Subtable
+    {
+        int index = 0;
+        quint8 format = 0;
+        bool isHorizontal = true;
+        // Cross-stream, minimum and variation subtables do not affect horizontal kerning.
+        bool isAccumulated = true;
+        bool isOverride = false;
+        // Format 0.
+        QVector<Pair> pairs;
+        // Formats 2 and 3. Format 2 classes are byte offsets of rows and columns.
+        quint16 leftFirstGlyph = 0;
+        quint16 rightFirstGlyph = 0;
+        QVector<quint16> leftClasses;
+        QVector<quint16> rightClasses;
+        // Format 2 values start at this byte offset from the subtable start.
+        quint32 valuesOffset = 0;
+        quint16 rightClassCount = 0;
+        // Format 3 kerning value indices.
+        QVector<quint8> indices;
+        QVector<qint16> values;
+    };
+
+    static std::optional<qint16> find(const Subtable &subtable, const quint16 left, const quint16 right);
+
+    QVector<Subtable> m_subtables;
+    quint64 m_numberOfPairs = 0;
+};
+
+// `parser` must be positioned at the start of the table.
+KerningTable collectKern(ShadowParser &parser);
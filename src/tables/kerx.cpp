@@ -0,0 +1,275 @@
+#include <bitset>
+
+#include "aat-common.h"
+#include "tables.h"
+
+// https://developer.apple.com/fonts/TrueType-Reference-Manual/RM06/Chap6kerx.html
+
+struct KerxCoverage
+{
+    static const int Size = 4;
+    static const QString Type;
+
+    static KerxCoverage parse(const quint8 *data)
+    { return { qFromBigEndian<quint32>(data) }; }
+
+    static QString toString(const KerxCoverage &value)
+    {
+        std::bitset<32> bits(value.d);
+        auto flagsStr = QString::fromUtf8(bits.to_string().c_str()) + '\n';
+
+        flagsStr += QString("Format: %1\n").arg(value.d & 0xFF);
+        // 8-28 - reserved
+        if (bits[29]) { flagsStr += "Bit 29: Has variation\n"; }
+        if (bits[30]) { flagsStr += "Bit 30: Cross-stream\n"; }
+        if (bits[31]) { flagsStr += "Bit 31: Vertical\n"; }
+
+        flagsStr.chop(1); // trim trailing newline
+
+        return flagsStr;
+    }
+
+    quint32 d;
+};
+
+const QString KerxCoverage::Type = Parser::BitflagsType;
+
+struct ContextualKerningFlags
+{
+    static const int Size = 2;
+    static const QString Type;
+
+    static ContextualKerningFlags parse(const quint8 *data)
+    { return { qFromBigEndian<quint16>(data) }; }
+
+    static QString toString(const ContextualKerningFlags &value)
+    {
+        std::bitset<16> bits(value.d);
+        auto flagsStr = QString::fromUtf8(bits.to_string().c_str()) + '\n';
+
+        // 0-12 - reserved
+        if (bits[13]) { flagsStr += "Bit 13: Reset\n"; }
+        if (bits[14]) { flagsStr += "Bit 14: Don't advance\n"; }
+        if (bits[15]) { flagsStr += "Bit 15: Push onto the kerning stack\n"; }
+
+        flagsStr.chop(1); // trim trailing newline
+
+        return flagsStr;
+    }
+
+    quint16 d;
+};
+
+const QString ContextualKerningFlags::Type = Parser::BitflagsType;
+
+struct AttachmentFlags
+{
+    static const int Size = 2;
+    static const QString Type;
+
+    static AttachmentFlags parse(const quint8 *data)
+    { return { qFromBigEndian<quint16>(data) }; }
+
+    static QString toString(const AttachmentFlags &value)
+    {
+        std::bitset<16> bits(value.d);
+        auto flagsStr = QString::fromUtf8(bits.to_string().c_str()) + '\n';
+
+        // 0-13 - reserved
+        if (bits[14]) { flagsStr += "Bit 14: Don't advance\n"; }
+        if (bits[15]) { flagsStr += "Bit 15: Mark\n"; }
+
+        flagsStr.chop(1); // trim trailing newline
+
+        return flagsStr;
+    }
+
+    quint16 d;
+};
+
+const QString AttachmentFlags::Type = Parser::BitflagsType;
+
+static void readOptionalIndex(const char *title, Parser &parser)
+{
+    if (parser.peek<UInt16>() == 0xFFFF) {
+        parser.readValue<UInt16>(title, QLatin1String("None"));
+    } else {
+        parser.read<UInt16>(title);
+    }
+}
+
+static void parseFormat0(Parser &parser)
+{
+    const auto count = parser.read<UInt32>("Number of kerning pairs");
+    parser.read<UInt32>("Search range");
+    parser.read<UInt32>("Entry selector");
+    parser.read<UInt32>("Range shift");
+    parser.readArray("Values", count, [&](const auto index){
+        parser.beginGroup(index);
+        parser.read<GlyphId>("Left");
+        parser.read<GlyphId>("Right");
+        parser.read<Int16>("Value");
+        parser.endGroup();
+    });
+}
+
+static void parseFormat1(const quint16 numberOfGlyphs, const quint32 size, Parser &parser)
+{
+    const auto table = parseAatStateTableHeader(numberOfGlyphs, size, 6, parser);
+    const quint32 valuesOffset = parser.read<Offset32>("Offset to values");
+
+    parseAatStateTable(numberOfGlyphs, table, size, [&](){
+        parser.read<ContextualKerningFlags>("Flags");
+        readOptionalIndex("Value index", parser);
+    }, {
+        { valuesOffset, [&](const quint32 partSize){
+            parser.readBasicArray<Int16>("Values", partSize / Int16::Size);
+        }},
+    }, parser);
+}
+
+static void parseFormat2(const quint16 numberOfGlyphs, const quint32 subtableStart,
+                         const quint32 length, Parser &parser)
+{
+    parser.read<UInt32>("Row width in bytes");
+    const quint32 leftOffset = parser.read<Offset32>("Offset to left-hand class table");
+    const quint32 rightOffset = parser.read<Offset32>("Offset to right-hand class table");
+    const quint32 arrayOffset = parser.read<Offset32>("Offset to kerning array");
+
+    parseAatTableParts(subtableStart, length, {
+        { leftOffset, [&](const quint32){
+            parseAatLookup("Left-hand Class Table", numberOfGlyphs, AatLookupValue::Value, false, parser);
+        }},
+        { rightOffset, [&](const quint32){
+            parseAatLookup("Right-hand Class Table", numberOfGlyphs, AatLookupValue::Value, false, parser);
+        }},
+        { arrayOffset, [&](const quint32 partSize){
+            parser.readBasicArray<Int16>("Kerning Values", partSize / Int16::Size);
+        }},
+    }, parser);
+}
+
+static void parseFormat4(const quint16 numberOfGlyphs, const quint32 size, Parser &parser)
+{
+    const auto table = parseAatStateTableHeader(numberOfGlyphs, size, 6, parser);
+
+    const auto flags = parser.peek<UInt32>();
+    const quint32 actionType = flags >> 30;
+    const quint32 actionsOffset = flags & 0x00FFFFFF;
+    static const std::array<const char*, 4> actionTypes = {{
+        "Control point actions",
+        "Anchor point actions",
+        "Coordinate actions",
+        "Unknown actions",
+    }};
+    parser.readValue<UInt32>("Flags", QString("%1 at offset %2").arg(actionTypes[actionType]).arg(actionsOffset));
+
+    QVector<AatTablePart> parts;
+    if (actionsOffset != 0) {
+        parts.append({ actionsOffset, [&](const quint32 partSize){
+            if (actionType == 0 || actionType == 1) {
+                const auto title = actionType == 0 ? "point" : "anchor";
+                parser.readArray("Actions", partSize / 4, [&](const auto index){
+                    parser.beginGroup(index);
+                    parser.read<UInt16>(QString("Marked %1").arg(title));
+                    parser.read<UInt16>(QString("Current %1").arg(title));
+                    parser.endGroup();
+                });
+            } else if (actionType == 2) {
+                parser.readArray("Actions", partSize / 8, [&](const auto index){
+                    parser.beginGroup(index);
+                    parser.read<Int16>("Marked X");
+                    parser.read<Int16>("Marked Y");
+                    parser.read<Int16>("Current X");
+                    parser.read<Int16>("Current Y");
+                    parser.endGroup();
+                });
+            }
+        }});
+    }
+
+    parseAatStateTable(numberOfGlyphs, table, size, [&](){
+        parser.read<AttachmentFlags>("Flags");
+        readOptionalIndex("Action index", parser);
+    }, parts, parser);
+}
+
+static void parseFormat6(const quint16 numberOfGlyphs, const quint32 subtableStart,
+                         const quint32 length, Parser &parser)
+{
+    const auto flags = parser.peek<UInt32>();
+    const bool longValues = flags & 0x00000001;
+    parser.readValue<UInt32>("Flags", longValues ? QString("Values are long") : QString());
+    parser.read<UInt16>("Number of rows");
+    parser.read<UInt16>("Number of columns");
+    const quint32 rowsOffset = parser.read<Offset32>("Offset to row index table");
+    const quint32 columnsOffset = parser.read<Offset32>("Offset to column index table");
+    const quint32 arrayOffset = parser.read<Offset32>("Offset to kerning array");
+    const quint32 vectorOffset = parser.read<OptionalOffset32>("Offset to kerning vector");
+
+    QVector<AatTablePart> parts = {
+        { rowsOffset, [&](const quint32){
+            parseAatLookup("Row Index Table", numberOfGlyphs, AatLookupValue::Value, longValues, parser);
+        }},
+        { columnsOffset, [&](const quint32){
+            parseAatLookup("Column Index Table", numberOfGlyphs, AatLookupValue::Value, longValues, parser);
+        }},
+        { arrayOffset, [&](const quint32 partSize){
+            if (longValues) {
+                parser.readBasicArray<Int32>("Kerning Values", partSize / Int32::Size);
+            } else {
+                parser.readBasicArray<Int16>("Kerning Values", partSize / Int16::Size);
+            }
+        }},
+    };
+
+    if (vectorOffset != 0) {
+        parts.append({ vectorOffset, [&](const quint32 partSize){
+            parser.readBasicArray<Int16>("Kerning Vector", partSize / Int16::Size);
+        }});
+    }
+
+    parseAatTableParts(subtableStart, length, parts, parser);
+}
+
+void parseKerx(const quint16 numberOfGlyphs, const quint32 tableSize, Parser &parser)
+{
+    const auto tableStart = parser.offset();
+
+    const auto version = parser.read<UInt16>("Version");
+    if (version < 2 || version > 4) {
+        throw QString("invalid table version");
+    }
+
+    parser.read<UInt16>("Padding");
+    const auto numberOfTables = parser.read<UInt32>("Number of tables");
+    parser.readArray("Subtables", numberOfTables, [&](const auto index){
+        const auto subtableStart = parser.offset();
+
+        parser.beginGroup(index);
+        const quint32 length = parser.read<UInt32>("Length");
+        const quint8 format = parser.read<KerxCoverage>("Coverage").d & 0xFF;
+        parser.read<UInt32>("Tuple count");
+
+        const auto headerSize = parser.offset() - subtableStart;
+        if (length < headerSize) {
+            throw QString("invalid subtable length");
+        }
+
+        switch (format) {
+        case 0: parseFormat0(parser); break;
+        case 1: parseFormat1(numberOfGlyphs, length - headerSize, parser); break;
+        case 2: parseFormat2(numberOfGlyphs, subtableStart, length, parser); break;
+        case 4: parseFormat4(numberOfGlyphs, length - headerSize, parser); break;
+        case 6: parseFormat6(numberOfGlyphs, subtableStart, length, parser); break;
+        default: break;
+        }
+
+        parser.advanceTo(subtableStart + length);
+        parser.endGroup(QString(), QString("Format %1").arg(format));
+    });
+
+    if (version >= 3) {
+        parseAatSubtableGlyphCoverage(numberOfGlyphs, numberOfTables, tableStart + tableSize, parser);
+    }
+}
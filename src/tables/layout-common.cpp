@@ -0,0 +1,899 @@
+#include <QtAlgorithms>
+
+#include <bitset>
+
+#include "layout-common.h"
+
+struct LookupFlags
+{
+    static const int Size = 2;
+    static const QString Type;
+
+    static LookupFlags parse(const quint8 *data)
+    { return { qFromBigEndian<quint16>(data) }; }
+
+    static QString toString(const LookupFlags &value)
+    {
+        std::bitset<16> bits(value.d);
+        auto flagsStr = QString::fromUtf8(bits.to_string().c_str()) + '\n';
+
+        if (bits[0]) flagsStr += "Bit 0: Right to left\n";
+        if (bits[1]) flagsStr += "Bit 1: Ignore base glyphs\n";
+        if (bits[2]) flagsStr += "Bit 2: Ignore ligatures\n";
+        if (bits[3]) flagsStr += "Bit 3: Ignore marks\n";
+        if (bits[4]) flagsStr += "Bit 4: Use mark filtering set\n";
+        // 5-7 - reserved
+        if (value.d & 0xFF00) {
+            flagsStr += QString("Bits 8-15: Mark attachment type %1\n").arg(value.d >> 8);
+        }
+
+        flagsStr.chop(1); // trim trailing newline
+
+        return flagsStr;
+    }
+
+    operator quint16() const { return d; }
+
+    quint16 d;
+};
+
+const QString LookupFlags::Type = Parser::BitflagsType;
+
+void parseClassDefinitionTable(Parser &parser)
+{
+    const auto classFormat = parser.read<UInt16>("Format");
+
+    if (classFormat == 1) {
+        parser.read<UInt16>("First glyph ID");
+        const auto glyphCount = parser.read<UInt16>("Number of classes");
+        for (auto i = 0; i < glyphCount; ++i) {
+            parser.read<UInt16>("Class");
+        }
+    } else if (classFormat == 2) {
+        const auto classRangeCount = parser.read<UInt16>("Number of records");
+        for (auto i = 0; i < classRangeCount; ++i) {
+            parser.beginGroup("Class Range Record");
+            const auto first = parser.read<UInt16>("First glyph ID");
+            const auto last = parser.read<UInt16>("Last glyph ID");
+            const auto klass = parser.read<UInt16>("Class");
+            parser.endGroup(QString(), QString("%1..%2 %3").arg(first).arg(last).arg(klass));
+        }
+    } else {
+        throw QString("invalid class format");
+    }
+}
+
+void parseCoverageTable(Parser &parser)
+{
+    const auto format = parser.read<UInt16>("Format");
+
+    if (format == 1) {
+        const auto glyphCount = parser.read<UInt16>("Number of glyphs");
+        for (auto i = 0; i < glyphCount; ++i) {
+            parser.read<GlyphId>("Glyph");
+        }
+    } else if (format == 2) {
+        const auto rangeCount = parser.read<UInt16>("Number of records");
+        for (auto i = 0; i < rangeCount; ++i) {
+            parser.beginGroup("Range Record");
+            const auto first = parser.read<UInt16>("First glyph ID");
+            const auto last = parser.read<UInt16>("Last glyph ID");
+            const auto index = parser.read<UInt16>("Coverage Index of first glyph ID");
+            parser.endGroup(QString(), QString("%1..%2 %3").arg(first).arg(last).arg(index));
+        }
+    } else {
+        throw QString("invalid coverage format");
+    }
+}
+
+void parseDeviceTable(Parser &parser)
+{
+    const auto deltaFormat = parser.peek<UInt16>(4);
+    if (deltaFormat == 0x8000) {
+        parser.read<UInt16>("Delta-set outer index");
+        parser.read<UInt16>("Delta-set inner index");
+        parser.read<UInt16>("Format");
+        return;
+    }
+
+    const auto startSize = parser.read<UInt16>("Smallest size to correct");
+    const auto endSize = parser.read<UInt16>("Largest size to correct");
+    parser.read<UInt16>("Format");
+
+    if (deltaFormat < 1 || deltaFormat > 3 || endSize < startSize) {
+        throw QString("invalid device table");
+    }
+
+    // 2, 4 or 8 bits per size.
+    const auto bitsPerValue = 1 << deltaFormat;
+    const auto count = (quint32(endSize - startSize + 1) * bitsPerValue + 15) / 16;
+    parser.readBasicArray<UInt16>("Packed Deltas", count);
+}
+
+static QString subtableName(const LayoutSubtableType type)
+{
+    switch (type) {
+    case LayoutSubtableType::ScriptList: return "Script List";
+    case LayoutSubtableType::Script: return "Script";
+    case LayoutSubtableType::LangSys: return "Language System";
+    case LayoutSubtableType::FeatureList: return "Feature List";
+    case LayoutSubtableType::Feature: return "Feature";
+    case LayoutSubtableType::FeatureParams: return "Feature Parameters";
+    case LayoutSubtableType::LookupList: return "Lookup List";
+    case LayoutSubtableType::Lookup: return "Lookup";
+    case LayoutSubtableType::LookupSubtable: return "Lookup Subtable";
+    case LayoutSubtableType::FeatureVariations: return "Feature Variations";
+    case LayoutSubtableType::ConditionSet: return "Condition Set";
+    case LayoutSubtableType::Condition: return "Condition";
+    case LayoutSubtableType::FeatureTableSubstitution: return "Feature Table Substitution";
+    case LayoutSubtableType::Coverage: return "Coverage";
+    case LayoutSubtableType::ClassDef: return "Class Definition";
+    case LayoutSubtableType::Device: return "Device";
+    case LayoutSubtableType::SequenceRuleSet: return "Sequence Rule Set";
+    case LayoutSubtableType::SequenceRule: return "Sequence Rule";
+    case LayoutSubtableType::ClassSequenceRuleSet: return "Class Sequence Rule Set";
+    case LayoutSubtableType::ClassSequenceRule: return "Class Sequence Rule";
+    case LayoutSubtableType::ChainedSequenceRuleSet: return "Chained Sequence Rule Set";
+    case LayoutSubtableType::ChainedSequenceRule: return "Chained Sequence Rule";
+    case LayoutSubtableType::ChainedClassSequenceRuleSet: return "Chained Class Sequence Rule Set";
+    case LayoutSubtableType::ChainedClassSequenceRule: return "Chained Class Sequence Rule";
+    case LayoutSubtableType::Sequence: return "Sequence";
+    case LayoutSubtableType::AlternateSet: return "Alternate Set";
+    case LayoutSubtableType::LigatureSet: return "Ligature Set";
+    case LayoutSubtableType::Ligature: return "Ligature";
+    case LayoutSubtableType::PairSet: return "Pair Set";
+    case LayoutSubtableType::Anchor: return "Anchor";
+    case LayoutSubtableType::MarkArray: return "Mark Array";
+    case LayoutSubtableType::BaseArray: return "Base Array";
+    case LayoutSubtableType::LigatureArray: return "Ligature Array";
+    case LayoutSubtableType::LigatureAttach: return "Ligature Attach";
+    case LayoutSubtableType::Mark2Array: return "Mark2 Array";
+    case LayoutSubtableType::LastType: break;
+    }
+
+    return QString();
+}
+
+static LayoutSubtable namedSubtable(const LayoutSubtableType type, const QString &title)
+{
+    LayoutSubtable subtable { type };
+    subtable.title = title;
+    return subtable;
+}
+
+static LayoutSubtable taggedSubtable(const LayoutSubtableType type, const Tag tag)
+{
+    LayoutSubtable subtable { type };
+    subtable.tag = tag;
+    return subtable;
+}
+
+QString lookupTypeName(const LayoutTableType tableType, const quint16 lookupType)
+{
+    if (tableType == LayoutTableType::Gsub) {
+        switch (lookupType) {
+        case 1: return "Single";
+        case 2: return "Multiple";
+        case 3: return "Alternate";
+        case 4: return "Ligature";
+        case 5: return "Context";
+        case 6: return "Chaining Context";
+        case 7: return "Extension";
+        case 8: return "Reverse Chaining Context Single";
+        default: return "Unknown";
+        }
+    } else {
+        switch (lookupType) {
+        case 1: return "Single Adjustment";
+        case 2: return "Pair Adjustment";
+        case 3: return "Cursive Attachment";
+        case 4: return "Mark-to-Base Attachment";
+        case 5: return "Mark-to-Ligature Attachment";
+        case 6: return "Mark-to-Mark Attachment";
+        case 7: return "Context Positioning";
+        case 8: return "Chained Context Positioning";
+        case 9: return "Extension Positioning";
+        default: return "Unknown";
+        }
+    }
+}
+
+static QString parseScriptList(LayoutSubtables &subtables, Parser &parser)
+{
+    const auto start = parser.offset();
+    const auto count = parser.read<UInt16>("Number of records");
+    parser.readArray("Script Records", count, [&](const auto index){
+        parser.beginGroup(index);
+        const auto tag = parser.read<Tag>("Script tag");
+        subtables.readOffset<Offset16>("Offset to Script table", start,
+                                       taggedSubtable(LayoutSubtableType::Script, tag), parser);
+        parser.endGroup(QString(), tag.toString());
+    });
+
+    return QString();
+}
+
+static QString parseScript(const LayoutSubtable &subtable, LayoutSubtables &subtables, Parser &parser)
+{
+    const auto start = parser.offset();
+    subtables.readOffset<OptionalOffset16>("Offset to default Language System table", start,
+                                           taggedSubtable(LayoutSubtableType::LangSys, Tag { FOURCC("dflt") }),
+                                           parser);
+    const auto count = parser.read<UInt16>("Number of records");
+    parser.readArray("Language System Records", count, [&](const auto index){
+        parser.beginGroup(index);
+        const auto tag = parser.read<Tag>("Language system tag");
+        subtables.readOffset<Offset16>("Offset to Language System table", start,
+                                       taggedSubtable(LayoutSubtableType::LangSys, tag), parser);
+        parser.endGroup(QString(), tag.toString());
+    });
+
+    return subtable.tag.toString();
+}
+
+static QString parseLangSys(const LayoutSubtable &subtable, Parser &parser)
+{
+    parser.read<OptionalOffset16>("Lookup order offset");
+    parser.read<UInt16>("Required feature index");
+    const auto count = parser.read<UInt16>("Number of features");
+    parser.readBasicArray<UInt16>("Feature Indices", count);
+    return subtable.tag.toString();
+}
+
+static QString parseFeatureList(LayoutSubtables &subtables, Parser &parser)
+{
+    const auto start = parser.offset();
+    const auto count = parser.read<UInt16>("Number of records");
+    parser.readArray("Feature Records", count, [&](const auto index){
+        parser.beginGroup(index);
+        const auto tag = parser.read<Tag>("Feature tag");
+        subtables.readOffset<Offset16>("Offset to Feature table", start,
+                                       taggedSubtable(LayoutSubtableType::Feature, tag), parser);
+        parser.endGroup(QString(), tag.toString());
+    });
+
+    return QString();
+}
+
+static QString parseFeature(const LayoutSubtable &subtable, LayoutSubtables &subtables, Parser &parser)
+{
+    const auto start = parser.offset();
+    subtables.readOffset<OptionalOffset16>("Offset to Feature Parameters table", start,
+                                           taggedSubtable(LayoutSubtableType::FeatureParams, subtable.tag),
+                                           parser);
+    const auto count = parser.read<UInt16>("Number of lookups");
+    parser.readBasicArray<UInt16>("Lookup List Indices", count);
+    return subtable.tag.toString();
+}
+
+static QString parseFeatureParams(const NamesHash &names, const LayoutSubtable &subtable, Parser &parser)
+{
+    const auto tag = subtable.tag.toString();
+    if (tag == "size") {
+        parser.read<UInt16>("Design size");
+        parser.read<UInt16>("Subfamily identifier");
+        parser.readNameId("Subfamily name ID", names);
+        parser.read<UInt16>("Range start");
+        parser.read<UInt16>("Range end");
+    } else if (tag.startsWith("ss")) {
+        parser.read<UInt16>("Version");
+        parser.readNameId("UI name ID", names);
+    } else if (tag.startsWith("cv")) {
+        parser.read<UInt16>("Format");
+        parser.readNameId("UI label name ID", names);
+        parser.readNameId("Tooltip text name ID", names);
+        parser.readNameId("Sample text name ID", names);
+        parser.read<UInt16>("Number of named parameters");
+        parser.readNameId("First parameter UI label name ID", names);
+        const auto count = parser.read<UInt16>("Number of characters");
+        parser.readBasicArray<UInt24>("Characters", count);
+    }
+
+    // Parameters of other features are not specified.
+
+    return tag;
+}
+
+static QString parseLookupList(LayoutSubtables &subtables, Parser &parser)
+{
+    const auto start = parser.offset();
+    const auto count = parser.read<UInt16>("Number of lookups");
+    parser.readArray("Lookup Offsets", count, [&](const auto index){
+        subtables.readOffset<Offset16>(index, start,
+            namedSubtable(LayoutSubtableType::Lookup, QString("Lookup %1").arg(index)), parser);
+    });
+
+    return QString();
+}
+
+static QString parseLookup(const LayoutTableType tableType, const LayoutSubtable &subtable,
+                           LayoutSubtables &subtables, Parser &parser)
+{
+    const auto start = parser.offset();
+    const auto lookupType = parser.peek<UInt16>();
+    const auto lookupTypeStr = lookupTypeName(tableType, lookupType);
+    parser.readValue<UInt16>("Lookup type", QString("%1 (%2)").arg(lookupTypeStr).arg(lookupType));
+    const auto flags = parser.read<LookupFlags>("Lookup flags");
+    const auto count = parser.read<UInt16>("Number of subtables");
+    parser.readArray("Subtable Offsets", count, [&](const auto index){
+        LayoutSubtable lookupSubtable { LayoutSubtableType::LookupSubtable };
+        lookupSubtable.lookupType = lookupType;
+        lookupSubtable.title = QString("%1 Subtable %2").arg(subtable.title).arg(index);
+        subtables.readOffset<Offset16>(index, start, lookupSubtable, parser);
+    });
+
+    if (flags & 0x0010) {
+        parser.read<UInt16>("Mark filtering set");
+    }
+
+    return lookupTypeStr;
+}
+
+static QString parseFeatureVariations(LayoutSubtables &subtables, Parser &parser)
+{
+    const auto start = parser.offset();
+    parser.read<UInt16>("Major version");
+    parser.read<UInt16>("Minor version");
+    const auto count = parser.read<UInt32>("Number of records");
+    parser.readArray("Feature Variation Records", count, [&](const auto index){
+        parser.beginGroup(index);
+        subtables.readOffset<OptionalOffset32>("Offset to Condition Set table", start,
+                                               { LayoutSubtableType::ConditionSet }, parser);
+        subtables.readOffset<OptionalOffset32>("Offset to Feature Table Substitution table", start,
+                                               { LayoutSubtableType::FeatureTableSubstitution }, parser);
+        parser.endGroup();
+    });
+
+    return QString();
+}
+
+static QString parseConditionSet(LayoutSubtables &subtables, Parser &parser)
+{
+    const auto start = parser.offset();
+    const auto count = parser.read<UInt16>("Number of conditions");
+    parser.readArray("Condition Offsets", count, [&](const auto index){
+        subtables.readOffset<Offset32>(index, start, { LayoutSubtableType::Condition }, parser);
+    });
+
+    return QString();
+}
+
+static QString parseCondition(Parser &parser)
+{
+    const auto format = parser.read<UInt16>("Format");
+    if (format != 1) {
+        throw QString("invalid condition format");
+    }
+
+    const auto axisIndex = parser.read<UInt16>("Axis index");
+    const auto min = parser.read<F2DOT14>("Minimum value");
+    const auto max = parser.read<F2DOT14>("Maximum value");
+    return QString("Axis %1: %2..%3").arg(axisIndex).arg(double(min)).arg(double(max));
+}
+
+static QString parseFeatureTableSubstitution(LayoutSubtables &subtables, Parser &parser)
+{
+    const auto start = parser.offset();
+    parser.read<UInt16>("Major version");
+    parser.read<UInt16>("Minor version");
+    const auto count = parser.read<UInt16>("Number of records");
+    parser.readArray("Substitution Records", count, [&](const auto index){
+        parser.beginGroup(index);
+        const auto featureIndex = parser.read<UInt16>("Feature index");
+        subtables.readOffset<Offset32>("Offset to alternate Feature table", start,
+                                       { LayoutSubtableType::Feature }, parser);
+        parser.endGroup(QString(), QString("Feature %1").arg(featureIndex));
+    });
+
+    return QString();
+}
+
+static void readSequenceLookupRecords(const quint16 count, Parser &parser)
+{
+    parser.readArray("Sequence Lookup Records", count, [&](const auto index){
+        parser.beginGroup(index);
+        const auto sequenceIndex = parser.read<UInt16>("Sequence index");
+        const auto lookupIndex = parser.read<UInt16>("Lookup index");
+        parser.endGroup(QString(), QString("Lookup %1 at %2").arg(lookupIndex).arg(sequenceIndex));
+    });
+}
+
+// Rule sets of glyph and class based contexts are identical, except the input values.
+static QString parseRuleSet(const LayoutSubtableType ruleType, LayoutSubtables &subtables, Parser &parser)
+{
+    const auto start = parser.offset();
+    const auto count = parser.read<UInt16>("Number of rules");
+    parser.readArray("Rule Offsets", count, [&](const auto index){
+        subtables.readOffset<Offset16>(index, start, { ruleType }, parser);
+    });
+
+    return QString();
+}
+
+template<typename T>
+static QString parseSequenceRule(Parser &parser)
+{
+    const auto glyphCount = parser.read<UInt16>("Number of input glyphs");
+    const auto lookupCount = parser.read<UInt16>("Number of lookup records");
+    if (glyphCount == 0) {
+        throw QString("invalid number of input glyphs");
+    }
+
+    parser.readBasicArray<T>("Input Sequence", glyphCount - 1);
+    readSequenceLookupRecords(lookupCount, parser);
+    return QString();
+}
+
+template<typename T>
+static QString parseChainedSequenceRule(Parser &parser)
+{
+    const auto backtrackCount = parser.read<UInt16>("Number of backtrack glyphs");
+    parser.readBasicArray<T>("Backtrack Sequence", backtrackCount);
+    const auto inputCount = parser.read<UInt16>("Number of input glyphs");
+    if (inputCount == 0) {
+        throw QString("invalid number of input glyphs");
+    }
+    parser.readBasicArray<T>("Input Sequence", inputCount - 1);
+    const auto lookaheadCount = parser.read<UInt16>("Number of lookahead glyphs");
+    parser.readBasicArray<T>("Lookahead Sequence", lookaheadCount);
+    const auto lookupCount = parser.read<UInt16>("Number of lookup records");
+    readSequenceLookupRecords(lookupCount, parser);
+    return QString();
+}
+
+static void readCoverageOffsets(const QString &title, const quint16 count, const quint32 start,
+                                LayoutSubtables &subtables, Parser &parser)
+{
+    parser.readArray(title, count, [&](const auto index){
+        subtables.readOffset<Offset16>(index, start, { LayoutSubtableType::Coverage }, parser);
+    });
+}
+
+QString parseSequenceContext(const LayoutSubtable&, LayoutSubtables &subtables, Parser &parser)
+{
+    const auto start = parser.offset();
+    const auto format = parser.read<UInt16>("Format");
+    switch (format) {
+    case 1: {
+        subtables.readOffset<Offset16>("Offset to Coverage table", start,
+                                       { LayoutSubtableType::Coverage }, parser);
+        const auto count = parser.read<UInt16>("Number of rule sets");
+        parser.readArray("Rule Set Offsets", count, [&](const auto index){
+            subtables.readOffset<OptionalOffset16>(index, start,
+                                                   { LayoutSubtableType::SequenceRuleSet }, parser);
+        });
+        break;
+    }
+    case 2: {
+        subtables.readOffset<Offset16>("Offset to Coverage table", start,
+                                       { LayoutSubtableType::Coverage }, parser);
+        subtables.readOffset<Offset16>("Offset to Class Definition table", start,
+                                       { LayoutSubtableType::ClassDef }, parser);
+        const auto count = parser.read<UInt16>("Number of rule sets");
+        parser.readArray("Rule Set Offsets", count, [&](const auto index){
+            subtables.readOffset<OptionalOffset16>(index, start,
+                                                   { LayoutSubtableType::ClassSequenceRuleSet }, parser);
+        });
+        break;
+    }
+    case 3: {
+        const auto glyphCount = parser.read<UInt16>("Number of input glyphs");
+        const auto lookupCount = parser.read<UInt16>("Number of lookup records");
+        readCoverageOffsets("Input Coverage Offsets", glyphCount, start, subtables, parser);
+        readSequenceLookupRecords(lookupCount, parser);
+        break;
+    }
+    default:
+        throw QString("invalid sequence context format");
+    }
+
+    return QString("Format %1").arg(format);
+}
+
+QString parseChainedSequenceContext(const LayoutSubtable&, LayoutSubtables &subtables, Parser &parser)
+{
+    const auto start = parser.offset();
+    const auto format = parser.read<UInt16>("Format");
+    switch (format) {
+    case 1: {
+        subtables.readOffset<Offset16>("Offset to Coverage table", start,
+                                       { LayoutSubtableType::Coverage }, parser);
+        const auto count = parser.read<UInt16>("Number of rule sets");
+        parser.readArray("Rule Set Offsets", count, [&](const auto index){
+            subtables.readOffset<OptionalOffset16>(index, start,
+                                                   { LayoutSubtableType::ChainedSequenceRuleSet }, parser);
+        });
+        break;
+    }
+    case 2: {
+        subtables.readOffset<Offset16>("Offset to Coverage table", start,
+                                       { LayoutSubtableType::Coverage }, parser);
+        subtables.readOffset<OptionalOffset16>("Offset to backtrack Class Definition table", start,
+                                               { LayoutSubtableType::ClassDef }, parser);
+        subtables.readOffset<OptionalOffset16>("Offset to input Class Definition table", start,
+                                               { LayoutSubtableType::ClassDef }, parser);
+        subtables.readOffset<OptionalOffset16>("Offset to lookahead Class Definition table", start,
+                                               { LayoutSubtableType::ClassDef }, parser);
+        const auto count = parser.read<UInt16>("Number of rule sets");
+        parser.readArray("Rule Set Offsets", count, [&](const auto index){
+            subtables.readOffset<OptionalOffset16>(index, start,
+                                                   { LayoutSubtableType::ChainedClassSequenceRuleSet }, parser);
+        });
+        break;
+    }
+    case 3: {
+        const auto backtrackCount = parser.read<UInt16>("Number of backtrack glyphs");
+        readCoverageOffsets("Backtrack Coverage Offsets", backtrackCount, start, subtables, parser);
+        const auto inputCount = parser.read<UInt16>("Number of input glyphs");
+        readCoverageOffsets("Input Coverage Offsets", inputCount, start, subtables, parser);
+        const auto lookaheadCount = parser.read<UInt16>("Number of lookahead glyphs");
+        readCoverageOffsets("Lookahead Coverage Offsets", lookaheadCount, start, subtables, parser);
+        const auto lookupCount = parser.read<UInt16>("Number of lookup records");
+        readSequenceLookupRecords(lookupCount, parser);
+        break;
+    }
+    default:
+        throw QString("invalid chained sequence context format");
+    }
+
+    return QString("Format %1").arg(format);
+}
+
+QString parseExtension(const LayoutTableType tableType, const LayoutSubtable &subtable,
+                       LayoutSubtables &subtables, Parser &parser)
+{
+    const auto start = parser.offset();
+    const auto format = parser.read<UInt16>("Format");
+    if (format != 1) {
+        throw QString("invalid extension format");
+    }
+
+    const auto lookupType = parser.peek<UInt16>();
+    if (lookupType == subtable.lookupType) {
+        throw QString("nested extension");
+    }
+
+    parser.readValue<UInt16>("Extension lookup type", QString("%1 (%2)")
+                             .arg(lookupTypeName(tableType, lookupType)).arg(lookupType));
+
+    LayoutSubtable extended { LayoutSubtableType::LookupSubtable };
+    extended.lookupType = lookupType;
+    extended.title = QString("%1 (Extended)").arg(subtable.title);
+    subtables.readOffset<Offset32>("Offset to extension subtable", start, extended, parser);
+
+    return QString("Format %1").arg(format);
+}
+
+void parseLayoutTable(const LayoutTableType tableType, const NamesHash &names, const quint32 tableSize,
+                      const LayoutSubtableParser &parseSubtable, Parser &parser)
+{
+    const auto start = parser.offset();
+
+    const auto majorVersion = parser.read<UInt16>("Major version");
+    const auto minorVersion = parser.read<UInt16>("Minor version");
+    if (majorVersion != 1) {
+        throw QString("invalid table version");
+    }
+
+    // All offsets are from the beginning of a table or a subtable that contains them,
+    // so subtables are always after their parents.
+    LayoutSubtables subtables(start + tableSize, subtableName);
+    subtables.readOffset<OptionalOffset16>("Offset to Script List table", start,
+        namedSubtable(LayoutSubtableType::ScriptList, "Script List"), parser);
+    subtables.readOffset<OptionalOffset16>("Offset to Feature List table", start,
+        namedSubtable(LayoutSubtableType::FeatureList, "Feature List"), parser);
+    subtables.readOffset<OptionalOffset16>("Offset to Lookup List table", start,
+        namedSubtable(LayoutSubtableType::LookupList, "Lookup List"), parser);
+
+    if (minorVersion >= 1) {
+        subtables.readOffset<OptionalOffset32>("Offset to Feature Variations table", start,
+            namedSubtable(LayoutSubtableType::FeatureVariations, "Feature Variations"), parser);
+    }
+
+    subtables.parse(parser, [&](const LayoutSubtable &subtable) -> QString {
+        switch (subtable.type) {
+        case LayoutSubtableType::ScriptList: return parseScriptList(subtables, parser);
+        case LayoutSubtableType::Script: return parseScript(subtable, subtables, parser);
+        case LayoutSubtableType::LangSys: return parseLangSys(subtable, parser);
+        case LayoutSubtableType::FeatureList: return parseFeatureList(subtables, parser);
+        case LayoutSubtableType::Feature: return parseFeature(subtable, subtables, parser);
+        case LayoutSubtableType::FeatureParams: return parseFeatureParams(names, subtable, parser);
+        case LayoutSubtableType::LookupList: return parseLookupList(subtables, parser);
+        case LayoutSubtableType::Lookup: return parseLookup(tableType, subtable, subtables, parser);
+        case LayoutSubtableType::FeatureVariations: return parseFeatureVariations(subtables, parser);
+        case LayoutSubtableType::ConditionSet: return parseConditionSet(subtables, parser);
+        case LayoutSubtableType::Condition: return parseCondition(parser);
+        case LayoutSubtableType::FeatureTableSubstitution: return parseFeatureTableSubstitution(subtables, parser);
+        case LayoutSubtableType::Coverage: parseCoverageTable(parser); return QString();
+        case LayoutSubtableType::ClassDef: parseClassDefinitionTable(parser); return QString();
+        case LayoutSubtableType::Device: parseDeviceTable(parser); return QString();
+        case LayoutSubtableType::SequenceRuleSet:
+            return parseRuleSet(LayoutSubtableType::SequenceRule, subtables, parser);
+        case LayoutSubtableType::SequenceRule: return parseSequenceRule<GlyphId>(parser);
+        case LayoutSubtableType::ClassSequenceRuleSet:
+            return parseRuleSet(LayoutSubtableType::ClassSequenceRule, subtables, parser);
+        case LayoutSubtableType::ClassSequenceRule: return parseSequenceRule<UInt16>(parser);
+        case LayoutSubtableType::ChainedSequenceRuleSet:
+            return parseRuleSet(LayoutSubtableType::ChainedSequenceRule, subtables, parser);
+        case LayoutSubtableType::ChainedSequenceRule: return parseChainedSequenceRule<GlyphId>(parser);
+        case LayoutSubtableType::ChainedClassSequenceRuleSet:
+            return parseRuleSet(LayoutSubtableType::ChainedClassSequenceRule, subtables, parser);
+        case LayoutSubtableType::ChainedClassSequenceRule: return parseChainedSequenceRule<UInt16>(parser);
+        default: return parseSubtable(subtable, subtables, parser);
+        }
+    });
+}
+
+QVector<quint16> GlyphCoverage::glyphs() const
+{
+    QVector<quint16> list;
+    list.reserve(int(m_numberOfGlyphs));
+    for (int word = 0; word < m_bits.size(); ++word) {
+        auto bits = m_bits[word];
+        while (bits != 0) {
+            list << quint16((word << 6) | qCountTrailingZeroBits(bits));
+            bits &= bits - 1;
+        }
+    }
+
+    return list;
+}
+
+void GlyphCoverage::unite(const GlyphCoverage &other)
+{
+    if (m_bits.size() < other.m_bits.size()) {
+        m_bits.resize(other.m_bits.size());
+    }
+
+    m_numberOfGlyphs = 0;
+    for (int i = 0; i < m_bits.size(); ++i) {
+        if (i < other.m_bits.size()) {
+            m_bits[i] |= other.m_bits[i];
+        }
+        m_numberOfGlyphs += qPopulationCount(m_bits[i]);
+    }
+}
+
+void GlyphCoverage::insert(const quint16 glyphId)
+{
+    const auto word = glyphId >> 6;
+    if (word >= m_bits.size()) {
+        m_bits.resize(word + 1);
+    }
+
+    const auto bit = quint64(1) << (glyphId & 63);
+    if ((m_bits[word] & bit) == 0) {
+        m_bits[word] |= bit;
+        m_numberOfGlyphs += 1;
+    }
+}
+
+GlyphCoverage collectCoverage(ShadowParser &parser)
+{
+    GlyphCoverage coverage;
+
+    const auto format = parser.read<UInt16>();
+    if (format == 1) {
+        const auto count = parser.read<UInt16>();
+        for (quint16 i = 0; i < count; ++i) {
+            coverage.insert(parser.read<GlyphId>());
+        }
+    } else if (format == 2) {
+        const auto count = parser.read<UInt16>();
+        for (quint16 i = 0; i < count; ++i) {
+            const quint16 first = parser.read<UInt16>();
+            const quint16 last = parser.read<UInt16>();
+            parser.skip<UInt16>(); // Coverage index
+            for (quint32 id = first; id <= last; ++id) {
+                coverage.insert(quint16(id));
+            }
+        }
+    } else {
+        throw QString("invalid coverage format");
+    }
+
+    return coverage;
+}
+
+GlyphClassDefinition::GlyphClassDefinition()
+    : m_pages(256, 0)
+{
+    m_pageIndex.fill(0);
+}
+
+void GlyphClassDefinition::insert(const quint16 glyphId, const quint16 glyphClass)
+{
+    if (glyphClass == 0) {
+        return;
+    }
+
+    const auto page = glyphId >> 8;
+    if (m_pageIndex[page] == 0) {
+        m_pageIndex[page] = quint16(m_pages.size() / 256);
+        m_pages.resize(m_pages.size() + 256);
+    }
+
+    m_pages[(quint32(m_pageIndex[page]) << 8) | (glyphId & 0xFF)] = glyphClass;
+    m_maxClass = std::max(m_maxClass, glyphClass);
+}
+
+GlyphClassDefinition collectClassDefinition(ShadowParser &parser)
+{
+    GlyphClassDefinition classDef;
+
+    const auto format = parser.read<UInt16>();
+    if (format == 1) {
+        const quint16 first = parser.read<UInt16>();
+        const auto count = parser.read<UInt16>();
+        for (quint32 i = 0; i < count && first + i <= 0xFFFF; ++i) {
+            classDef.insert(quint16(first + i), parser.read<UInt16>());
+        }
+    } else if (format == 2) {
+        const auto count = parser.read<UInt16>();
+        for (quint16 i = 0; i < count; ++i) {
+            const quint16 first = parser.read<UInt16>();
+            const quint16 last = parser.read<UInt16>();
+            const quint16 glyphClass = parser.read<UInt16>();
+            for (quint32 id = first; id <= last; ++id) {
+                classDef.insert(quint16(id), glyphClass);
+            }
+        }
+    } else {
+        throw QString("invalid class format");
+    }
+
+    return classDef;
+}
+
+// Decodes tables only once per offset and returns their indices.
+template<typename T>
+class DecodedTables
+{
+public:
+    explicit DecodedTables(QVector<T> &tables, T (*collect)(ShadowParser&))
+        : m_tables(tables)
+        , m_collect(collect)
+    {}
+
+    int add(const quint32 offset, ShadowParser &parser)
+    {
+        if (m_indices.contains(offset)) {
+            return m_indices.value(offset);
+        }
+
+        parser.jumpTo(offset);
+        const auto index = m_tables.size();
+        m_tables << m_collect(parser);
+        m_indices.insert(offset, index);
+        return index;
+    }
+
+private:
+    QVector<T> &m_tables;
+    T (*m_collect)(ShadowParser&);
+    QHash<quint32, int> m_indices;
+};
+
+static quint32 readOffset16(const quint32 base, ShadowParser &parser)
+{
+    return base + parser.read<Offset16>();
+}
+
+LayoutLookups collectLayoutLookups(const LayoutTableType tableType, ShadowParser &parser)
+{
+    const auto tableStart = parser.offset();
+
+    LayoutLookups lookups;
+    lookups.tableType = tableType;
+
+    if (parser.read<UInt16>() != 1) {
+        throw QString("invalid table version");
+    }
+
+    parser.jumpTo(tableStart + 8);
+    const auto lookupListStart = readOffset16(tableStart, parser);
+
+    DecodedTables<GlyphCoverage> coverages(lookups.coverages, collectCoverage);
+    DecodedTables<GlyphClassDefinition> classDefinitions(lookups.classDefinitions, collectClassDefinition);
+
+    const quint16 extensionType = tableType == LayoutTableType::Gsub ? 7 : 9;
+    const quint16 contextType = tableType == LayoutTableType::Gsub ? 5 : 7;
+    const quint16 chainedContextType = tableType == LayoutTableType::Gsub ? 6 : 8;
+
+    parser.jumpTo(lookupListStart);
+    const auto numberOfLookups = parser.read<UInt16>();
+    for (quint16 i = 0; i < numberOfLookups; ++i) {
+        parser.jumpTo(lookupListStart + 2 + quint32(i) * 2);
+        const auto lookupStart = readOffset16(lookupListStart, parser);
+
+        LayoutLookup lookup;
+        parser.jumpTo(lookupStart);
+        lookup.type = parser.read<UInt16>();
+        lookup.flags = parser.read<UInt16>();
+        const auto numberOfSubtables = parser.read<UInt16>();
+
+        for (quint16 j = 0; j < numberOfSubtables; ++j) {
+            parser.jumpTo(lookupStart + 6 + quint32(j) * 2);
+            auto subtableStart = readOffset16(lookupStart, parser);
+            auto type = lookup.type;
+
+            parser.jumpTo(subtableStart);
+            if (type == extensionType) {
+                parser.skip<UInt16>(); // Format
+                type = parser.read<UInt16>();
+                subtableStart += parser.read<Offset32>();
+                parser.jumpTo(subtableStart);
+            }
+
+            if (j == 0) {
+                lookup.type = type;
+            }
+
+            LayoutLookupSubtable subtable;
+            subtable.offset = subtableStart - tableStart;
+
+            auto addCoverage = [&](const quint32 offset){
+                const auto index = coverages.add(offset, parser);
+                subtable.coverage = index;
+                if (!lookup.coverages.contains(index)) {
+                    lookup.coverages << index;
+                    lookup.coverage.unite(lookups.coverages[index]);
+                }
+            };
+
+            auto addClassDefinitions = [&](const quint32 offset, const int count){
+                for (int k = 0; k < count; ++k) {
+                    parser.jumpTo(offset + quint32(k) * 2);
+                    const quint32 classDefOffset = parser.read<OptionalOffset16>();
+                    if (classDefOffset == 0) {
+                        subtable.classDefinitions << -1;
+                        continue;
+                    }
+
+                    const auto index = classDefinitions.add(subtableStart + classDefOffset, parser);
+                    subtable.classDefinitions << index;
+                    if (!lookup.classDefinitions.contains(index)) {
+                        lookup.classDefinitions << index;
+                    }
+                }
+            };
+
+            const auto format = parser.read<UInt16>();
+            subtable.format = format;
+            if ((type == contextType || type == chainedContextType) && format == 3) {
+                // The first input coverage defines glyphs the lookup is applied at.
+                if (type == chainedContextType) {
+                    const auto backtrackCount = parser.read<UInt16>();
+                    parser.jumpTo(subtableStart + 4 + quint32(backtrackCount) * 2);
+                }
+
+                if (parser.read<UInt16>() != 0) {
+                    if (type == contextType) {
+                        parser.skip<UInt16>(); // Number of sequence lookup records
+                    }
+                    addCoverage(readOffset16(subtableStart, parser));
+                }
+
+                lookup.subtables << subtable;
+                continue;
+            }
+
+            // All other subtables start with a format and a coverage offset.
+            addCoverage(readOffset16(subtableStart, parser));
+
+            if (format == 2 && type == contextType) {
+                addClassDefinitions(subtableStart + 4, 1);
+            } else if (format == 2 && type == chainedContextType) {
+                addClassDefinitions(subtableStart + 4, 3);
+            } else if (format == 2 && tableType == LayoutTableType::Gpos && type == 2) {
+                addClassDefinitions(subtableStart + 8, 2);
+            }
+
+            lookup.subtables << subtable;
+        }
+
+        lookups.lookups << lookup;
+    }
+
+    return lookups;
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <array>
+#include <functional>
+
+#include "src/parser.h"
+#include "subtables.h"
+
+// OpenType Layout Common Table Formats, shared by `GDEF`, `GSUB` and `GPOS`.
+
+void parseCoverageTable(Parser &parser);
+void parseClassDefinitionTable(Parser &parser);
+void parseDeviceTable(Parser &parser);
+
+enum class LayoutSubtableType
+{
+    ScriptList,
+    Script,
+    LangSys,
+    FeatureList,
+    Feature,
+    FeatureParams,
+    LookupList,
+    Lookup,
+    // A subtable of a lookup with a specified lookup type.
+    LookupSubtable,
+    FeatureVariations,
+    ConditionSet,
+    Condition,
+    FeatureTableSubstitution,
+    Coverage,
+    ClassDef,
+    Device,
+    SequenceRuleSet,
+    SequenceRule,
+    ClassSequenceRuleSet,
+    ClassSequenceRule,
+    ChainedSequenceRuleSet,
+    ChainedSequenceRule,
+    ChainedClassSequenceRuleSet,
+    ChainedClassSequenceRule,
+    // GSUB
+    Sequence,
+    AlternateSet,
+    LigatureSet,
+    Ligature,
+    // GPOS
+    PairSet,
+    Anchor,
+    MarkArray,
+    BaseArray,
+    LigatureArray,
+    LigatureAttach,
+    Mark2Array,
+    LastType,
+};
+
+struct LayoutSubtable
+{
+    LayoutSubtableType type;
+    // An absolute offset.
+    quint32 offset = 0;
+    // The lookup type of a lookup subtable.
+    quint16 lookupType = 0;
+    // Value formats of a pair set or the number of mark classes of an attachment array.
+    quint16 format1 = 0;
+    quint16 format2 = 0;
+    // A tag of a script, a language system or a feature.
+    Tag tag = { 0 };
+    QString title;
+};
+
+// A queue of subtables of a layout table.
+//
+// Subtables are often shared between lookups.
+using LayoutSubtables = SubtableQueue<LayoutSubtable>;
+
+enum class LayoutTableType
+{
+    Gsub,
+    Gpos,
+};
+
+// Parses lookup subtables, which are specific to a table.
+using LayoutSubtableParser = std::function<QString(const LayoutSubtable&, LayoutSubtables&, Parser&)>;
+
+void parseLayoutTable(const LayoutTableType tableType, const NamesHash &names, const quint32 tableSize,
+                      const LayoutSubtableParser &parseSubtable, Parser &parser);
+
+// Contextual and extension lookups have the same structure in `GSUB` and `GPOS`.
+QString parseSequenceContext(const LayoutSubtable &subtable, LayoutSubtables &subtables, Parser &parser);
+QString parseChainedSequenceContext(const LayoutSubtable &subtable, LayoutSubtables &subtables, Parser &parser);
+QString parseExtension(const LayoutTableType tableType, const LayoutSubtable &subtable,
+                       LayoutSubtables &subtables, Parser &parser);
+
+QString lookupTypeName(const LayoutTableType tableType, const quint16 lookupType);
+
+// A decoded Coverage table as a bitset over glyph IDs.
+class GlyphCoverage
+{
+public:
+    bool contains(const quint16 glyphId) const
+    {
+        const auto word = glyphId >> 6;
+        return word < m_bits.size() && ((m_bits[word] >> (glyphId & 63)) & 1);
+    }
+
+    bool isEmpty() const { return m_numberOfGlyphs == 0; }
+    quint32 numberOfGlyphs() const { return m_numberOfGlyphs; }
+
+    // Returns covered glyphs in ascending order.
+    QVector<quint16> glyphs() const;
+
+    void unite(const GlyphCoverage &other);
+
+private:
+    friend GlyphCoverage collectCoverage(ShadowParser &parser);
+
+    void insert(const quint16 glyphId);
+
+    QVector<quint64> m_bits;
+    quint32 m_numberOfGlyphs = 0;
+};
+
+// A decoded Class Definition table.
+//
+// Stored as a two-level page table, like CharacterMap, so all pages
+// without classified glyphs share the same storage.
+class GlyphClassDefinition
+{
+public:
+    GlyphClassDefinition();
+
+    // Returns 0 for glyphs that are not listed.
+    quint16 glyphClass(const quint16 glyphId) const
+    { return m_pages[(quint32(m_pageIndex[glyphId >> 8]) << 8) | (glyphId & 0xFF)]; }
+
+    // The largest class plus one.
+    quint32 numberOfClasses() const { return quint32(m_maxClass) + 1; }
+
+private:
+    friend GlyphClassDefinition collectClassDefinition(ShadowParser &parser);
+
+    void insert(const quint16 glyphId, const quint16 glyphClass);
+
+    std::array<quint16, 256> m_pageIndex;
+    // Page 0 is always empty.
+    QVector<quint16> m_pages;
+    quint16 m_maxClass = 0;
+};
+
+// `parser` must be positioned at the start of a table.
+GlyphCoverage collectCoverage(ShadowParser &parser);
+GlyphClassDefinition collectClassDefinition(ShadowParser &parser);
+
+struct LayoutLookupSubtable
+{
+    // An offset from the start of the table, with extensions resolved.
+    quint32 offset = 0;
+    quint16 format = 0;
+    // An index into LayoutLookups::coverages or -1.
+    int coverage = -1;
+    // Indices into LayoutLookups::classDefinitions in the subtable order. -1 for null offsets.
+    QVector<int> classDefinitions;
+};
+
+struct LayoutLookup
+{
+    // The type of subtables, with extensions resolved.
+    quint16 type = 0;
+    quint16 flags = 0;
+    QVector<LayoutLookupSubtable> subtables;
+    // Coverages the subtables are applied at, as indices into LayoutLookups::coverages.
+    QVector<int> coverages;
+    // Indices into LayoutLookups::classDefinitions.
+    QVector<int> classDefinitions;
+    // The union of `coverages`.
+    GlyphCoverage coverage;
+};
+
+// Lookups of a `GSUB` or a `GPOS` table.
+//
+// Coverage and Class Definition tables are decoded once per offset
+// and shared by all lookups that reference them.
+struct LayoutLookups
+{
+    LayoutTableType tableType = LayoutTableType::Gsub;
+    QVector<LayoutLookup> lookups;
+    QVector<GlyphCoverage> coverages;
+    QVector<GlyphClassDefinition> classDefinitions;
+};
+
+// `parser` must be positioned at the start of the table.
+LayoutLookups collectLayoutLookups(const LayoutTableType tableType, ShadowParser &parser);
@@ -0,0 +1,384 @@
+#include <bitset>
+
+#include "src/algo.h"
+#include "aat-common.h"
+#include "tables.h"
+
+// https://developer.apple.com/fonts/TrueType-Reference-Manual/RM06/Chap6morx.html
+
+struct MorxCoverage
+{
+    static const int Size = 4;
+    static const QString Type;
+
+    static MorxCoverage parse(const quint8 *data)
+    { return { qFromBigEndian<quint32>(data) }; }
+
+    static QString toString(const MorxCoverage &value)
+    {
+        std::bitset<32> bits(value.d);
+        auto flagsStr = QString::fromUtf8(bits.to_string().c_str()) + '\n';
+
+        flagsStr += QString("Type: %1\n").arg(value.d & 0xFF);
+        // 8-27 - reserved
+        if (bits[28]) { flagsStr += "Bit 28: Logical order\n"; }
+        if (bits[29]) { flagsStr += "Bit 29: Both horizontal and vertical\n"; }
+        if (bits[30]) { flagsStr += "Bit 30: Descending order\n"; }
+        if (bits[31]) { flagsStr += "Bit 31: Vertical only\n"; }
+
+        flagsStr.chop(1); // trim trailing newline
+
+        return flagsStr;
+    }
+
+    quint32 d;
+};
+
+const QString MorxCoverage::Type = Parser::BitflagsType;
+
+struct RearrangementFlags
+{
+    static const int Size = 2;
+    static const QString Type;
+
+    static RearrangementFlags parse(const quint8 *data)
+    { return { qFromBigEndian<quint16>(data) }; }
+
+    static QString toString(const RearrangementFlags &value)
+    {
+        static const std::array<const char*, 16> verbs = {{
+            "No change",
+            "Ax => xA",
+            "xD => Dx",
+            "AxD => DxA",
+            "ABx => xAB",
+            "ABx => xBA",
+            "xCD => CDx",
+            "xCD => DCx",
+            "AxCD => CDxA",
+            "AxCD => DCxA",
+            "ABxD => DxAB",
+            "ABxD => DxBA",
+            "ABxCD => CDxAB",
+            "ABxCD => CDxBA",
+            "ABxCD => DCxAB",
+            "ABxCD => DCxBA",
+        }};
+
+        std::bitset<16> bits(value.d);
+        auto flagsStr = QString::fromUtf8(bits.to_string().c_str()) + '\n';
+
+        flagsStr += QString("Verb: %1\n").arg(verbs[value.d & 0x000F]);
+        // 4-12 - reserved
+        if (bits[13]) { flagsStr += "Bit 13: Mark last\n"; }
+        if (bits[14]) { flagsStr += "Bit 14: Don't advance\n"; }
+        if (bits[15]) { flagsStr += "Bit 15: Mark first\n"; }
+
+        flagsStr.chop(1); // trim trailing newline
+
+        return flagsStr;
+    }
+
+    quint16 d;
+};
+
+const QString RearrangementFlags::Type = Parser::BitflagsType;
+
+struct ContextualFlags
+{
+    static const int Size = 2;
+    static const QString Type;
+
+    static ContextualFlags parse(const quint8 *data)
+    { return { qFromBigEndian<quint16>(data) }; }
+
+    static QString toString(const ContextualFlags &value)
+    {
+        std::bitset<16> bits(value.d);
+        auto flagsStr = QString::fromUtf8(bits.to_string().c_str()) + '\n';
+
+        // 0-13 - reserved
+        if (bits[14]) { flagsStr += "Bit 14: Don't advance\n"; }
+        if (bits[15]) { flagsStr += "Bit 15: Set mark\n"; }
+
+        flagsStr.chop(1); // trim trailing newline
+
+        return flagsStr;
+    }
+
+    quint16 d;
+};
+
+const QString ContextualFlags::Type = Parser::BitflagsType;
+
+struct LigatureFlags
+{
+    static const int Size = 2;
+    static const QString Type;
+
+    static LigatureFlags parse(const quint8 *data)
+    { return { qFromBigEndian<quint16>(data) }; }
+
+    static QString toString(const LigatureFlags &value)
+    {
+        std::bitset<16> bits(value.d);
+        auto flagsStr = QString::fromUtf8(bits.to_string().c_str()) + '\n';
+
+        // 0-12 - reserved
+        if (bits[13]) { flagsStr += "Bit 13: Perform action\n"; }
+        if (bits[14]) { flagsStr += "Bit 14: Don't advance\n"; }
+        if (bits[15]) { flagsStr += "Bit 15: Set component\n"; }
+
+        flagsStr.chop(1); // trim trailing newline
+
+        return flagsStr;
+    }
+
+    quint16 d;
+};
+
+const QString LigatureFlags::Type = Parser::BitflagsType;
+
+struct InsertionFlags
+{
+    static const int Size = 2;
+    static const QString Type;
+
+    static InsertionFlags parse(const quint8 *data)
+    { return { qFromBigEndian<quint16>(data) }; }
+
+    static QString toString(const InsertionFlags &value)
+    {
+        std::bitset<16> bits(value.d);
+        auto flagsStr = QString::fromUtf8(bits.to_string().c_str()) + '\n';
+
+        flagsStr += QString("Marked insert count: %1\n").arg(value.d & 0x001F);
+        flagsStr += QString("Current insert count: %1\n").arg((value.d >> 5) & 0x001F);
+        if (bits[10]) { flagsStr += "Bit 10: Marked insert before\n"; }
+        if (bits[11]) { flagsStr += "Bit 11: Current insert before\n"; }
+        if (bits[12]) { flagsStr += "Bit 12: Marked is kashida-like\n"; }
+        if (bits[13]) { flagsStr += "Bit 13: Current is kashida-like\n"; }
+        if (bits[14]) { flagsStr += "Bit 14: Don't advance\n"; }
+        if (bits[15]) { flagsStr += "Bit 15: Set mark\n"; }
+
+        flagsStr.chop(1); // trim trailing newline
+
+        return flagsStr;
+    }
+
+    quint16 d;
+};
+
+const QString InsertionFlags::Type = Parser::BitflagsType;
+
+struct LigatureAction
+{
+    static const int Size = 4;
+    static const QString Type;
+
+    static LigatureAction parse(const quint8 *data)
+    { return { qFromBigEndian<quint32>(data) }; }
+
+    static QString toString(const LigatureAction &value)
+    {
+        // A 30-bit signed offset.
+        const auto offset = qint32(value.d << 2) >> 2;
+        auto str = QString("Component offset %1").arg(offset);
+        if (value.d & 0x40000000) { str += ". Store"; }
+        if (value.d & 0x80000000) { str += ". Last"; }
+        return str;
+    }
+
+    quint32 d;
+};
+
+const QString LigatureAction::Type = QLatin1String("Action");
+
+static void readOptionalIndex(const char *title, Parser &parser)
+{
+    if (parser.peek<UInt16>() == 0xFFFF) {
+        parser.readValue<UInt16>(title, QLatin1String("None"));
+    } else {
+        parser.read<UInt16>(title);
+    }
+}
+
+static void parseRearrangement(const quint16 numberOfGlyphs, const quint32 size, Parser &parser)
+{
+    const auto table = parseAatStateTableHeader(numberOfGlyphs, size, 4, parser);
+    parseAatStateTable(numberOfGlyphs, table, size, [&](){
+        parser.read<RearrangementFlags>("Flags");
+    }, {}, parser);
+}
+
+static void parseContextual(const quint16 numberOfGlyphs, const quint32 size, Parser &parser)
+{
+    auto shadow = parser.shadow();
+
+    const auto table = parseAatStateTableHeader(numberOfGlyphs, size, 8, parser);
+    const quint32 substitutionTableOffset = parser.read<Offset32>("Offset to substitution table");
+
+    const auto parseSubstitutionTable = [&](const quint32 partSize){
+        const auto start = parser.offset();
+
+        // The number of lookups is not stored, but they are placed after the offsets.
+        // Lookups can be shared, so each one is parsed only once.
+        QVector<quint32> offsets;
+        quint32 minOffset = partSize;
+        shadow.jumpTo(substitutionTableOffset);
+        for (quint32 i = 0; (i + 1) * Offset32::Size <= minOffset; ++i) {
+            const quint32 offset = shadow.read<Offset32>();
+            if (offset < (i + 1) * Offset32::Size) {
+                throw QString("invalid substitution table");
+            }
+
+            offsets << offset;
+            minOffset = qMin(minOffset, offset);
+        }
+
+        auto lookups = offsets;
+        algo::sort_all(lookups);
+        algo::dedup_vector(lookups);
+
+        parser.readArray("Offsets to Lookup Tables", offsets.size(), [&](const auto index){
+            const auto lookupIndex = std::lower_bound(lookups.begin(), lookups.end(), offsets[index]) - lookups.begin();
+            parser.readValue<Offset32>(index, QString("Lookup Table %1 (%2)").arg(lookupIndex).arg(offsets[index]));
+        });
+
+        for (const auto [i, offset] : algo::enumerate(lookups)) {
+            parser.advanceTo(start + *offset);
+            parseAatLookup(QString("Lookup Table %1").arg(i), numberOfGlyphs, AatLookupValue::Glyph, false, parser);
+        }
+    };
+
+    parseAatStateTable(numberOfGlyphs, table, size, [&](){
+        parser.read<ContextualFlags>("Flags");
+        readOptionalIndex("Mark index", parser);
+        readOptionalIndex("Current index", parser);
+    }, {
+        { substitutionTableOffset, [&](const quint32 partSize){
+            parser.beginGroup("Substitution Table");
+            parseSubstitutionTable(partSize);
+            parser.endGroup();
+        }},
+    }, parser);
+}
+
+static void parseLigature(const quint16 numberOfGlyphs, const quint32 size, Parser &parser)
+{
+    const auto table = parseAatStateTableHeader(numberOfGlyphs, size, 6, parser);
+    const quint32 actionsOffset = parser.read<Offset32>("Offset to ligature actions");
+    const quint32 componentsOffset = parser.read<Offset32>("Offset to components");
+    const quint32 ligaturesOffset = parser.read<Offset32>("Offset to ligatures");
+
+    parseAatStateTable(numberOfGlyphs, table, size, [&](){
+        parser.read<LigatureFlags>("Flags");
+        parser.read<UInt16>("Ligature action index");
+    }, {
+        { actionsOffset, [&](const quint32 partSize){
+            parser.readBasicArray<LigatureAction>("Ligature Actions", partSize / LigatureAction::Size);
+        }},
+        { componentsOffset, [&](const quint32 partSize){
+            parser.readBasicArray<UInt16>("Components", partSize / UInt16::Size);
+        }},
+        { ligaturesOffset, [&](const quint32 partSize){
+            parser.readBasicArray<GlyphId>("Ligatures", partSize / GlyphId::Size);
+        }},
+    }, parser);
+}
+
+static void parseInsertion(const quint16 numberOfGlyphs, const quint32 size, Parser &parser)
+{
+    const auto table = parseAatStateTableHeader(numberOfGlyphs, size, 8, parser);
+    const quint32 actionsOffset = parser.read<Offset32>("Offset to insertion actions");
+
+    parseAatStateTable(numberOfGlyphs, table, size, [&](){
+        parser.read<InsertionFlags>("Flags");
+        readOptionalIndex("Current insert index", parser);
+        readOptionalIndex("Marked insert index", parser);
+    }, {
+        { actionsOffset, [&](const quint32 partSize){
+            parser.readBasicArray<GlyphId>("Insertion Glyphs", partSize / GlyphId::Size);
+        }},
+    }, parser);
+}
+
+static QString subtableTypeName(const quint8 type)
+{
+    switch (type) {
+    case 0: return "Rearrangement";
+    case 1: return "Contextual";
+    case 2: return "Ligature";
+    case 4: return "Noncontextual";
+    case 5: return "Insertion";
+    default: return "Unknown";
+    }
+}
+
+static void parseChain(const quint16 numberOfGlyphs, const quint16 version, Parser &parser)
+{
+    const auto chainStart = parser.offset();
+
+    parser.read<UInt32>("Default flags");
+    const auto chainLength = parser.read<UInt32>("Chain length");
+    const auto numberOfFeatures = parser.read<UInt32>("Number of feature entries");
+    const auto numberOfSubtables = parser.read<UInt32>("Number of subtables");
+
+    parser.readArray("Features", numberOfFeatures, [&](const auto index){
+        parser.beginGroup(index);
+        parser.read<UInt16>("Feature type");
+        parser.read<UInt16>("Feature setting");
+        parser.read<UInt32>("Enable flags");
+        parser.read<UInt32>("Disable flags");
+        parser.endGroup();
+    });
+
+    parser.readArray("Subtables", numberOfSubtables, [&](const auto index){
+        const auto subtableStart = parser.offset();
+
+        parser.beginGroup(index);
+        const quint32 length = parser.read<UInt32>("Length");
+        const quint8 type = parser.read<MorxCoverage>("Coverage").d & 0xFF;
+        parser.read<UInt32>("Sub-feature flags");
+
+        const auto headerSize = parser.offset() - subtableStart;
+        if (length < headerSize) {
+            throw QString("invalid subtable length");
+        }
+
+        const auto size = length - headerSize;
+        switch (type) {
+        case 0: parseRearrangement(numberOfGlyphs, size, parser); break;
+        case 1: parseContextual(numberOfGlyphs, size, parser); break;
+        case 2: parseLigature(numberOfGlyphs, size, parser); break;
+        case 4: parseAatLookup("Lookup Table", numberOfGlyphs, AatLookupValue::Glyph, false, parser); break;
+        case 5: parseInsertion(numberOfGlyphs, size, parser); break;
+        default: break;
+        }
+
+        parser.advanceTo(subtableStart + length);
+        parser.endGroup(QString(), subtableTypeName(type));
+    });
+
+    if (version >= 3) {
+        parseAatSubtableGlyphCoverage(numberOfGlyphs, numberOfSubtables, chainStart + chainLength, parser);
+    }
+
+    parser.advanceTo(chainStart + chainLength);
+}
+
+void parseMorx(const quint16 numberOfGlyphs, Parser &parser)
+{
+    const auto version = parser.read<UInt16>("Version");
+    if (version != 2 && version != 3) {
+        throw QString("invalid table version");
+    }
+
+    parser.read<UInt16>("Unused");
+    const auto numberOfChains = parser.read<UInt32>("Number of chains");
+    parser.readArray("Chains", numberOfChains, [&](const auto index){
+        parser.beginGroup(index);
+        parseChain(numberOfGlyphs, version, parser);
+        parser.endGroup();
+    });
+}
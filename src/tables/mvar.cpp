@@ -1,6 +1,7 @@
 #include "src/algo.h"
 #include "src/parser.h"
 #include "tables.h"
+#include "varstore.h"
 
 void parseMvar(Parser &parser)
 {
@@ -54,15 +55,23 @@ void parseVariationRegionList(Parser &parser)
 void parseItemVariationData(Parser &parser)
 {
     const auto itemCount = parser.read<UInt16>("Number of delta sets");
-    const auto shortDeltaCount = parser.read<UInt16>("Number of short deltas");
+    const auto wordDeltaCount = parser.read<UInt16>("Number of short deltas");
     const auto regionIndexCount = parser.read<UInt16>("Number of variation regions");
 
     parser.readBasicArray<UInt16>("Region Indices", regionIndexCount);
 
+    // With the LONG_WORDS flag, word deltas are 32-bit and the rest are 16-bit.
+    const bool isLong = wordDeltaCount & 0x8000;
+    const int wordCount = std::min<int>(wordDeltaCount & 0x7FFF, regionIndexCount);
     parser.readArray("Delta-set Rows", itemCount, [&](const auto index){
         parser.beginGroup(index);
-        parser.readBasicArray<Int16>("Deltas", shortDeltaCount);
-        parser.readBasicArray<Int8>("Short Deltas", regionIndexCount - shortDeltaCount);
+        if (isLong) {
+            parser.readBasicArray<Int32>("Deltas", wordCount);
+            parser.readBasicArray<Int16>("Short Deltas", regionIndexCount - wordCount);
+        } else {
+            parser.readBasicArray<Int16>("Deltas", wordCount);
+            parser.readBasicArray<Int8>("Short Deltas", regionIndexCount - wordCount);
+        }
         parser.endGroup();
     });
 }
@@ -95,3 +104,42 @@ void parseItemVariationStore(Parser &parser)
         parser.endGroup();
     });
 }
+
+GlobalMetricsVariations collectMvar(ShadowParser &parser)
+{
+    const auto start = parser.offset();
+
+    const quint16 majorVersion = parser.read<UInt16>();
+    const quint16 minorVersion = parser.read<UInt16>();
+    if (!(majorVersion == 1 && minorVersion == 0)) {
+        throw QString("invalid table version");
+    }
+
+    parser.skip<UInt16>(); // reserved
+    const quint16 recordSize = parser.read<UInt16>();
+    const quint16 recordsCount = parser.read<UInt16>();
+    const quint16 varStoreOffset = parser.read<Offset16>();
+
+    GlobalMetricsVariations variations;
+    if (recordsCount == 0 || varStoreOffset == 0) {
+        return variations;
+    }
+
+    if (recordSize < 8) {
+        throw QString("invalid value record size");
+    }
+
+    const auto recordsStart = parser.offset();
+    for (quint16 i = 0; i < recordsCount; ++i) {
+        parser.jumpTo(recordsStart + quint32(i) * recordSize);
+        const auto tag = parser.read<Tag>();
+        const quint16 outerIndex = parser.read<UInt16>();
+        const quint16 innerIndex = parser.read<UInt16>();
+        variations.records.append({ tag, outerIndex, innerIndex });
+    }
+
+    parser.jumpTo(start + varStoreOffset);
+    variations.store = collectItemVariationStore(parser);
+
+    return variations;
+}
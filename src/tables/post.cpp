@@ -1,5 +1,40 @@
 #include "tables.h"
 
+// Standard Macintosh glyph names used by `post` format 1 and 2.
+static const char* MacGlyphNames[258] = {
+    ".notdef", ".null", "nonmarkingreturn", "space", "exclam", "quotedbl", "numbersign",
+    "dollar", "percent", "ampersand", "quotesingle", "parenleft", "parenright", "asterisk",
+    "plus", "comma", "hyphen", "period", "slash", "zero", "one", "two", "three", "four",
+    "five", "six", "seven", "eight", "nine", "colon", "semicolon", "less", "equal", "greater",
+    "question", "at", "A", "B", "C", "D", "E", "F", "G", "H", "I", "J", "K", "L", "M", "N",
+    "O", "P", "Q", "R", "S", "T", "U", "V", "W", "X", "Y", "Z", "bracketleft", "backslash",
+    "bracketright", "asciicircum", "underscore", "grave", "a", "b", "c", "d", "e", "f", "g",
+    "h", "i", "j", "k", "l", "m", "n", "o", "p", "q", "r", "s", "t", "u", "v", "w", "x", "y",
+    "z", "braceleft", "bar", "braceright", "asciitilde", "Adieresis", "Aring", "Ccedilla",
+    "Eacute", "Ntilde", "Odieresis", "Udieresis", "aacute", "agrave", "acircumflex",
+    "adieresis", "atilde", "aring", "ccedilla", "eacute", "egrave", "ecircumflex", "edieresis",
+    "iacute", "igrave", "icircumflex", "idieresis", "ntilde", "oacute", "ograve",
+    "ocircumflex", "odieresis", "otilde", "uacute", "ugrave", "ucircumflex", "udieresis",
+    "dagger", "degree", "cent", "sterling", "section", "bullet", "paragraph", "germandbls",
+    "registered", "copyright", "trademark", "acute", "dieresis", "notequal", "AE", "Oslash",
+    "infinity", "plusminus", "lessequal", "greaterequal", "yen", "mu", "partialdiff",
+    "summation", "product", "pi", "integral", "ordfeminine", "ordmasculine", "Omega", "ae",
+    "oslash", "questiondown", "exclamdown", "logicalnot", "radical", "florin", "approxequal",
+    "Delta", "guillemotleft", "guillemotright", "ellipsis", "nonbreakingspace", "Agrave",
+    "Atilde", "Otilde", "OE", "oe", "endash", "emdash", "quotedblleft", "quotedblright",
+    "quoteleft", "quoteright", "divide", "lozenge", "ydieresis", "Ydieresis", "fraction",
+    "currency", "guilsinglleft", "guilsinglright", "fi", "fl", "daggerdbl", "periodcentered",
+    "quotesinglbase", "quotedblbase", "perthousand", "Acircumflex", "Ecircumflex", "Aacute",
+    "Edieresis", "Egrave", "Iacute", "Icircumflex", "Idieresis", "Igrave", "Oacute",
+    "Ocircumflex", "apple", "Ograve", "Uacute", "Ucircumflex", "Ugrave", "dotlessi",
+    "circumflex", "tilde", "macron", "breve", "dotaccent", "ring", "cedilla", "hungarumlaut",
+    "ogonek", "caron", "Lslash", "lslash", "Scaron", "scaron", "Zcaron", "zcaron", "brokenbar",
+    "Eth", "eth", "Yacute", "yacute", "Thorn", "thorn", "minus", "multiply", "onesuperior",
+    "twosuperior", "threesuperior", "onehalf", "onequarter", "threequarters", "franc",
+    "Gbreve", "gbreve", "Idotaccent", "Scedilla", "scedilla", "Cacute", "cacute", "Ccaron",
+    "ccaron", "dcroat",
+};
+
 void parsePost(Parser &parser)
 {
     const auto version = parser.read<F16DOT16>("Version");
@@ -29,3 +64,42 @@ void parsePost(Parser &parser)
         parser.readPascalString(numberToString(index));
     });
 }
+
+QVector<QString> collectPostGlyphNames(const quint16 numberOfGlyphs, ShadowParser &parser)
+{
+    const auto version = parser.read<UInt32>();
+
+    QVector<QString> names;
+    if (version == 0x00010000) {
+        for (quint16 i = 0; i < std::min<quint16>(numberOfGlyphs, 258); ++i) {
+            names << QLatin1String(MacGlyphNames[i]);
+        }
+    } else if (version == 0x00020000) {
+        parser.advance(28);
+        const quint16 count = parser.read<UInt16>();
+        QVector<quint16> indexes;
+        for (quint16 i = 0; i < count; ++i) {
+            indexes << parser.read<UInt16>();
+        }
+
+        QVector<QString> customNames;
+        const auto maxIndex = indexes.isEmpty() ? 0 : *std::max_element(indexes.begin(), indexes.end());
+        while (customNames.size() + 258 <= maxIndex && !parser.atEnd()) {
+            const auto length = parser.read<UInt8>();
+            customNames << QString::fromLatin1(parser.readBytes(length));
+        }
+
+        indexes.resize(std::min<int>(indexes.size(), numberOfGlyphs));
+        for (const auto index : indexes) {
+            if (index < 258) {
+                names << QLatin1String(MacGlyphNames[index]);
+            } else if (index - 258 < customNames.size()) {
+                names << customNames[index - 258];
+            } else {
+                names << QString();
+            }
+        }
+    }
+
+    return names;
+}
@@ -1,4 +1,5 @@
 #include <bitset>
+#include <memory>
 
 #include "src/algo.h"
 #include "tables.h"
@@ -30,7 +31,68 @@ struct SbixFlags
 const QString SbixFlags::Type = Parser::BitflagsType;
 
 
-void parseSbix(const quint16 numberOfGlyphs, Parser &parser)
+// `dupe` and `mask` are not images.
+static std::optional<BitmapInfo::Format> imageFormat(const Tag type)
+{
+    switch (type.d) {
+    case FOURCC("png "): return BitmapInfo::Format::Png;
+    case FOURCC("jpg "): return BitmapInfo::Format::Jpeg;
+    case FOURCC("tiff"): return BitmapInfo::Format::Tiff;
+    default: return std::nullopt;
+    }
+}
+
+// Strikes of large emoji fonts have hundreds of thousands of glyph nodes in total,
+// so each strike is parsed only when expanded.
+static void parseStrike(const quint16 numberOfGlyphs, const GlyphNames &glyphNames, Parser &parser)
+{
+    const auto start = parser.offset();
+
+    parser.read<UInt16>("PPEM");
+    parser.read<UInt16>("PPI");
+
+    QVector<quint32> glyphOffsets;
+    parser.readArray("Offsets", numberOfGlyphs + 1, [&](const auto index){
+        glyphOffsets << parser.read<Offset32>(index);
+    });
+
+    // Empty glyphs share an offset with the next one, so only non-empty glyphs are mapped.
+    QHash<quint32, quint16> glyphIds;
+    for (quint16 i = 0; i < numberOfGlyphs; ++i) {
+        if (glyphOffsets[i + 1] > glyphOffsets[i]) {
+            glyphIds.insert(glyphOffsets[i], i);
+        }
+    }
+
+    algo::sort_all(glyphOffsets);
+    algo::dedup_vector(glyphOffsets);
+
+    // The last offset is the end byte of the last glyph.
+    parser.readArray("Glyphs", glyphOffsets.size() - 1, [&](const auto index){
+        const auto dataSize = glyphOffsets.at(index + 1) - glyphOffsets.at(index);
+
+        const auto glyphOffset = glyphOffsets.at(index);
+        if (glyphIds.contains(glyphOffset)) {
+            parser.beginGroup(glyphNames.title(glyphIds.value(glyphOffset)));
+        } else {
+            parser.beginGroup(index);
+        }
+        parser.advanceTo(start + glyphOffset);
+        parser.read<Int16>("Horizontal offset");
+        parser.read<Int16>("Vertical offset");
+        const auto type = parser.read<Tag>("Type");
+        if (const auto format = imageFormat(type)) {
+            BitmapInfo info;
+            info.format = *format;
+            parser.readBitmap("Data", info, dataSize - 8);
+        } else {
+            parser.readBytes("Data", dataSize - 8);
+        }
+        parser.endGroup();
+    });
+}
+
+void parseSbix(const quint16 numberOfGlyphs, const GlyphNames &glyphNames, Parser &parser)
 {
     const auto start = parser.offset();
 
@@ -50,38 +112,23 @@ void parseSbix(const quint16 numberOfGlyphs, Parser &parser)
     algo::sort_all(offsets);
     algo::dedup_vector(offsets);
 
-    QVector<quint32> glyphOffsets;
-    parser.readArray("Strikes", offsets.size(), [&](const auto index){
-        glyphOffsets.clear();
-
-        const auto offset = offsets[index];
-        parser.advanceTo(start + offset);
-        parser.beginGroup(index);
+    // Shared by all strikes, which can outlive the face data.
+    const auto names = std::make_shared<const GlyphNames>(glyphNames);
 
-        parser.read<UInt16>("PPEM");
-        parser.read<UInt16>("PPI");
-
-        QVector<quint32> offsets;
-        parser.readArray("Offsets", numberOfGlyphs + 1, [&](const auto index){
-            glyphOffsets << parser.read<Offset32>(index);
-        });
-
-        algo::sort_all(glyphOffsets);
-        algo::dedup_vector(glyphOffsets);
-
-        // The last offset is the end byte of the last glyph.
-        parser.readArray("Glyphs", glyphOffsets.size() - 1, [&](const auto index){
-            const auto dataSize = glyphOffsets.at(index + 1) - glyphOffsets.at(index);
-
-            parser.beginGroup(index);
-            parser.advanceTo(start + offset + glyphOffsets.at(index));
-            parser.read<Int16>("Horizontal offset");
-            parser.read<Int16>("Vertical offset");
-            parser.read<Tag>("Type");
-            parser.readBytes("Data", dataSize - 8);
-            parser.endGroup();
+    parser.readArray("Strikes", offsets.size(), [&](const auto index){
+        parser.advanceTo(start + offsets[index]);
+
+        // Only the strike header and the last glyph offset are read here.
+        // Glyph offsets are increasing, so the last one is the strike size.
+        auto s = parser.shadow();
+        const auto ppem = s.read<UInt16>();
+        const auto ppi = s.read<UInt16>();
+        s.jumpTo(4 + quint32(numberOfGlyphs) * 4);
+        const auto size = qMax(quint32(s.read<Offset32>()), 4 + (quint32(numberOfGlyphs) + 1) * 4);
+
+        parser.readLazyGroup(numberToString(index), QString("PPEM %1, PPI %2").arg(ppem).arg(ppi), size,
+                             [numberOfGlyphs, names](Parser &p){
+            parseStrike(numberOfGlyphs, *names, p);
         });
-
-        parser.endGroup();
     });
 }
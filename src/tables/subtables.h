@@ -0,0 +1,96 @@
+#pragma once
+
+#include <QHash>
+
+#include <array>
+#include <functional>
+#include <map>
+
+#include "src/parser.h"
+
+// A queue of subtables referenced by offsets, like in `GSUB` or `COLR`.
+//
+// Subtables are often shared, so each one is parsed only once, in the file order,
+// and later references are resolved to its title.
+//
+// `Subtable` must have `type`, `offset` and `title` fields.
+// `type` must be an enum with a `LastType` value.
+template<typename Subtable>
+class SubtableQueue
+{
+public:
+    using Type = decltype(Subtable::type);
+    // Returns a title of a subtable without a number.
+    using NameFn = QString (*)(const Type type);
+
+    SubtableQueue(const quint32 tableEnd, const NameFn name)
+        : m_tableEnd(tableEnd)
+        , m_name(name)
+    {}
+
+    // Queues a subtable, unless its offset was already queued.
+    //
+    // Returns the title of a subtable at this offset.
+    QString add(Subtable subtable)
+    {
+        const auto title = m_titles.value(subtable.offset);
+        if (!title.isEmpty()) {
+            return title;
+        }
+
+        if (subtable.title.isEmpty()) {
+            auto &counter = m_counters[size_t(subtable.type)];
+            subtable.title = QString("%1 %2").arg(m_name(subtable.type)).arg(counter);
+            counter += 1;
+        }
+
+        m_titles.insert(subtable.offset, subtable.title);
+        const auto offset = subtable.offset;
+        return m_queue.emplace(offset, std::move(subtable)).first->second.title;
+    }
+
+    // Reads an offset relative to `base` and queues a subtable it points to.
+    template<typename T, typename Title>
+    void readOffset(const Title &title, const quint32 base, Subtable subtable, Parser &parser)
+    {
+        const auto offset = parser.peek<T>();
+        if (offset == 0) {
+            parser.read<T>(title);
+            return;
+        }
+
+        subtable.offset = base + offset;
+        const auto name = add(std::move(subtable));
+        parser.readValue<T>(title, QString("%1 (%2)").arg(name).arg(T::toString(offset)));
+    }
+
+    // Parses queued subtables. `f` can queue more subtables and returns a group value.
+    void parse(Parser &parser, const std::function<QString(const Subtable&)> &f)
+    {
+        while (!m_queue.empty()) {
+            const auto subtable = std::move(m_queue.begin()->second);
+            m_queue.erase(m_queue.begin());
+
+            if (subtable.offset >= m_tableEnd) {
+                throw QString("%1 is out of bounds").arg(subtable.title);
+            }
+
+            // Overlapping subtables are malformed, but their bytes are already in the tree.
+            if (subtable.offset < parser.offset()) {
+                continue;
+            }
+
+            parser.advanceTo(subtable.offset);
+            parser.beginGroup(subtable.title);
+            const auto value = f(subtable);
+            parser.endGroup(QString(), value);
+        }
+    }
+
+private:
+    const quint32 m_tableEnd;
+    const NameFn m_name;
+    std::map<quint32, Subtable> m_queue;
+    QHash<quint32, QString> m_titles;
+    std::array<quint32, size_t(Type::LastType)> m_counters = {};
+};
@@ -1,5 +1,6 @@
 #include "src/algo.h"
 #include "src/parser.h"
+#include "src/utils.h"
 #include "tables.h"
 
 void parseSvg(Parser &parser)
@@ -34,13 +35,23 @@ void parseSvg(Parser &parser)
     for (const auto &range : ranges) {
         parser.advanceTo(range.start);
 
-        if (parser.peek<UInt16>() == 8075) {
-            // Read gzip compressed SVG as is.
-            parser.readBytes("SVGZ", range.size());
+        if (range.size() >= 18 && parser.peek<UInt16>() == 0x1F8B) {
+            // A gzip member ends with the decompressed size modulo 2^32 as little-endian,
+            // so it's shown without decompression.
+            auto s = parser.shadow();
+            s.advance(range.size() - 4);
+            quint32 size = 0;
+            for (int i = 0; i < 4; ++i) {
+                size |= quint32(s.read<UInt8>()) << (i * 8);
+            }
+
+            parser.readValue("SVGZ", QString("%1 decompressed").arg(Utils::prettySize(size)),
+                             Parser::SvgzType, range.size());
         } else {
-            // Otherwise read as string.
             // According to the spec, it must be in UTF-8, so we are fine.
-            parser.readUtf8String("SVG", range.size());
+            auto s = parser.shadow();
+            const auto text = QString::fromUtf8(s.readBytes(range.size()));
+            parser.readValue("SVG", text, Parser::SvgType, range.size());
         }
     }
 }
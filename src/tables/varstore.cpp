@@ -0,0 +1,231 @@
+#include "varstore.h"
+
+QVector<float> ItemVariationStore::regionScalars(const QVector<float> &coordinates) const
+{
+    QVector<float> scalars;
+    scalars.reserve(numberOfRegions());
+
+    for (int region = 0; region < numberOfRegions(); ++region) {
+        float scalar = 1;
+        for (int axis = 0; axis < m_numberOfAxes && scalar != 0; ++axis) {
+            const auto &r = m_axes[region * m_numberOfAxes + axis];
+            const auto coord = axis < coordinates.size() ? coordinates[axis] : 0.0f;
+
+            // Invalid and unused axes do not affect the region.
+            if (r.start > r.peak || r.peak > r.end) {
+                continue;
+            } else if (r.start < 0 && r.end > 0 && r.peak != 0) {
+                continue;
+            } else if (r.peak == 0 || coord == r.peak) {
+                continue;
+            }
+
+            if (coord < r.start || coord > r.end) {
+                scalar = 0;
+            } else if (coord < r.peak) {
+                scalar *= (coord - r.start) / (r.peak - r.start);
+            } else {
+                scalar *= (r.end - coord) / (r.end - r.peak);
+            }
+        }
+
+        scalars << scalar;
+    }
+
+    return scalars;
+}
+
+const QVector<quint16>& ItemVariationStore::regionIndexes(const quint16 outerIndex) const
+{
+    if (outerIndex >= m_data.size()) {
+        throw QString("invalid ItemVariationData index");
+    }
+
+    return m_data[outerIndex].regionIndexes;
+}
+
+QVector<QVector<float>> ItemVariationStore::evaluate(const QVector<float> &regionScalars) const
+{
+    QVector<QVector<float>> deltas;
+    deltas.reserve(m_data.size());
+
+    for (const auto &data : m_data) {
+        QVector<float> itemDeltas(data.itemCount, 0.0f);
+        float *out = itemDeltas.data();
+        for (int region = 0; region < data.regionIndexes.size(); ++region) {
+            const auto scalar = regionScalars.value(data.regionIndexes[region]);
+            if (scalar == 0) {
+                continue;
+            }
+
+            // A plain loop over contiguous arrays, which compilers vectorize.
+            const float *column = data.deltas.constData() + region * data.itemCount;
+            for (int i = 0; i < data.itemCount; ++i) {
+                out[i] += column[i] * scalar;
+            }
+        }
+
+        deltas << itemDeltas;
+    }
+
+    return deltas;
+}
+
+float ItemVariationStore::delta(const quint16 outerIndex, const quint16 innerIndex,
+                                const QVector<float> &regionScalars) const
+{
+    if (outerIndex >= m_data.size() || innerIndex >= m_data[outerIndex].itemCount) {
+        return 0;
+    }
+
+    const auto &data = m_data[outerIndex];
+    float delta = 0;
+    for (int region = 0; region < data.regionIndexes.size(); ++region) {
+        delta += data.deltas[region * data.itemCount + innerIndex]
+            * regionScalars.value(data.regionIndexes[region]);
+    }
+
+    return delta;
+}
+
+ItemVariationStore collectItemVariationStore(ShadowParser &parser)
+{
+    const auto start = parser.offset();
+
+    ItemVariationStore store;
+
+    if (parser.read<UInt16>() != 1) {
+        throw QString("invalid ItemVariationStore format");
+    }
+
+    const quint32 regionListOffset = parser.read<Offset32>();
+    const quint16 dataCount = parser.read<UInt16>();
+    QVector<quint32> dataOffsets;
+    for (quint16 i = 0; i < dataCount; ++i) {
+        dataOffsets << parser.read<Offset32>();
+    }
+
+    if (regionListOffset != 0) {
+        parser.jumpTo(start + regionListOffset);
+        store.m_numberOfAxes = parser.read<UInt16>();
+        const quint16 regionCount = parser.read<UInt16>();
+        // Counts are validated before allocating, because a malformed font can have any.
+        const quint32 axesCount = quint32(regionCount) * store.m_numberOfAxes;
+        if (quint64(axesCount) * 3 * F2DOT14::Size > parser.left()) {
+            throw QString("VariationRegionList is out of bounds");
+        }
+
+        store.m_axes.reserve(int(axesCount));
+        for (quint32 i = 0; i < axesCount; ++i) {
+            const float regionStart = parser.read<F2DOT14>();
+            const float peak = parser.read<F2DOT14>();
+            const float end = parser.read<F2DOT14>();
+            store.m_axes.append({ regionStart, peak, end });
+        }
+    }
+
+    for (const auto offset : dataOffsets) {
+        ItemVariationStore::ItemVariationData data;
+        if (offset != 0) {
+            parser.jumpTo(start + offset);
+            data.itemCount = parser.read<UInt16>();
+            const quint16 wordDeltaCount = parser.read<UInt16>();
+            const quint16 regionIndexCount = parser.read<UInt16>();
+            for (quint16 i = 0; i < regionIndexCount; ++i) {
+                const quint16 index = parser.read<UInt16>();
+                if (index >= store.numberOfRegions()) {
+                    throw QString("invalid region index");
+                }
+
+                data.regionIndexes << index;
+            }
+
+            // With the LONG_WORDS flag, words are 32-bit and the rest are 16-bit.
+            const bool isLong = wordDeltaCount & 0x8000;
+            const int wordCount = std::min<int>(wordDeltaCount & 0x7FFF, regionIndexCount);
+
+            const quint32 rowSize = isLong ? quint32(wordCount) * 4 + quint32(regionIndexCount - wordCount) * 2
+                                           : quint32(wordCount) * 2 + quint32(regionIndexCount - wordCount);
+            if (quint64(data.itemCount) * rowSize > parser.left()) {
+                throw QString("ItemVariationData is out of bounds");
+            }
+
+            data.deltas.resize(int(quint32(data.itemCount) * regionIndexCount));
+            for (quint16 item = 0; item < data.itemCount; ++item) {
+                for (int region = 0; region < regionIndexCount; ++region) {
+                    float delta = 0;
+                    if (region < wordCount) {
+                        delta = isLong ? float(parser.read<Int32>()) : float(parser.read<Int16>());
+                    } else {
+                        delta = isLong ? float(parser.read<Int16>()) : float(parser.read<Int8>());
+                    }
+
+                    data.deltas[region * int(data.itemCount) + item] = delta;
+                }
+            }
+        }
+
+        store.m_data << data;
+    }
+
+    return store;
+}
+
+QVector<quint32> collectDeltaSetIndexMap(ShadowParser &parser)
+{
+    const quint8 format = parser.read<UInt8>();
+    const quint8 entryFormat = parser.read<UInt8>();
+
+    quint32 count = 0;
+    if (format == 0) {
+        count = parser.read<UInt16>();
+    } else if (format == 1) {
+        count = parser.read<UInt32>();
+    } else {
+        throw QString("invalid DeltaSetIndexMap format");
+    }
+
+    const int innerIndexBits = (entryFormat & 0x0F) + 1;
+    const int entrySize = ((entryFormat & 0x30) >> 4) + 1;
+    const quint32 innerIndexMask = (1u << innerIndexBits) - 1;
+
+    QVector<quint32> map;
+    map.reserve(int(std::min<quint32>(count, 0xFFFF)));
+    for (quint32 i = 0; i < count; ++i) {
+        quint32 entry = 0;
+        for (int b = 0; b < entrySize; ++b) {
+            entry = (entry << 8) | parser.read<UInt8>();
+        }
+
+        const auto outerIndex = entry >> innerIndexBits;
+        const auto innerIndex = entry & innerIndexMask;
+        map << ((outerIndex << 16) | (innerIndex & 0xFFFF));
+    }
+
+    return map;
+}
+
+QVector<float> glyphDeltas(const QVector<QVector<float>> &itemDeltas,
+                           const QVector<quint32> &indexMap, const quint16 numberOfGlyphs)
+{
+    QVector<float> deltas(numberOfGlyphs, 0.0f);
+    if (itemDeltas.isEmpty()) {
+        return deltas;
+    }
+
+    for (quint16 glyphId = 0; glyphId < numberOfGlyphs; ++glyphId) {
+        quint32 index = glyphId;
+        if (!indexMap.isEmpty()) {
+            // Glyphs past the end of the map use the last entry.
+            index = indexMap[std::min<int>(glyphId, indexMap.size() - 1)];
+        }
+
+        const auto outerIndex = int(index >> 16);
+        const auto innerIndex = int(index & 0xFFFF);
+        if (outerIndex < itemDeltas.size() && innerIndex < itemDeltas[outerIndex].size()) {
+            deltas[glyphId] = itemDeltas[outerIndex][innerIndex];
+        }
+    }
+
+    return deltas;
+}
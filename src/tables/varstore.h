@@ -0,0 +1,150 @@
+#pragma once
+
+#include "src/parser.h"
+
+// An `fvar` axis in user coordinates.
+struct VariationAxis
+{
+    Tag tag;
+    float minValue;
+    float defaultValue;
+    float maxValue;
+    quint16 nameId;
+
+    // Maps a user coordinate to [-1, 1] without `avar`. See Face::normalizeCoordinates.
+    float normalize(const float value) const
+    {
+        const auto v = qBound(minValue, value, maxValue);
+        if (v < defaultValue && defaultValue > minValue) {
+            return (v - defaultValue) / (defaultValue - minValue);
+        } else if (v > defaultValue && maxValue > defaultValue) {
+            return (v - defaultValue) / (maxValue - defaultValue);
+        } else {
+            return 0;
+        }
+    }
+};
+
+// An `fvar` named instance in user coordinates.
+struct NamedInstance
+{
+    quint16 subfamilyNameId;
+    QVector<float> coordinates;
+};
+
+// An `avar` segment map of a single axis.
+struct AxisSegmentMap
+{
+    QVector<float> fromCoordinates;
+    QVector<float> toCoordinates;
+
+    // Maps a normalized coordinate piecewise linearly.
+    float map(const float value) const;
+};
+
+// The parser must be at the start of the `fvar` table.
+QVector<VariationAxis> collectFvarAxes(ShadowParser &parser);
+QVector<NamedInstance> collectFvarInstances(ShadowParser &parser);
+
+// The parser must be at the start of the `avar` table.
+QVector<AxisSegmentMap> collectAvar(ShadowParser &parser);
+
+// A decoded ItemVariationStore.
+class ItemVariationStore
+{
+public:
+    bool isEmpty() const { return m_data.isEmpty(); }
+
+    quint16 numberOfAxes() const { return m_numberOfAxes; }
+    int numberOfRegions() const { return m_numberOfAxes == 0 ? 0 : m_axes.size() / m_numberOfAxes; }
+    int numberOfDataSets() const { return m_data.size(); }
+
+    // Returns scalars of all regions at normalized coordinates.
+    //
+    // Scalars depend only on coordinates, so they should be computed once per instance.
+    // Missing coordinates are treated as zero.
+    QVector<float> regionScalars(const QVector<float> &coordinates) const;
+
+    // Returns region indexes of an ItemVariationData subtable.
+    const QVector<quint16>& regionIndexes(const quint16 outerIndex) const;
+
+    // Returns deltas of all items of all ItemVariationData subtables by outer and inner index.
+    //
+    // Each subtable is evaluated in a single pass per region, which is much faster
+    // than looking up items one by one.
+    QVector<QVector<float>> evaluate(const QVector<float> &regionScalars) const;
+
+    // Returns a single item delta. Zero when the index is out of range.
+    float delta(const quint16 outerIndex, const quint16 innerIndex,
+                const QVector<float> &regionScalars) const;
+
+private:
+    friend ItemVariationStore collectItemVariationStore(ShadowParser &parser);
+
+    struct RegionAxis
+    {
+        float start;
+        float peak;
+        float end;
+    };
+
+    struct ItemVariationData
+    {
+        quint16 itemCount = 0;
+        QVector<quint16> regionIndexes;
+        // Grouped by region and then by item, so items of a region are contiguous.
+        QVector<float> deltas;
+    };
+
+    quint16 m_numberOfAxes = 0;
+    // Regions are stored one after another, `m_numberOfAxes` axes each.
+    QVector<RegionAxis> m_axes;
+    QVector<ItemVariationData> m_data;
+};
+
+// The parser must be at the start of an ItemVariationStore.
+ItemVariationStore collectItemVariationStore(ShadowParser &parser);
+
+// Returns delta-set indexes as `(outer << 16) | inner`.
+//
+// The parser must be at the start of a DeltaSetIndexMap.
+QVector<quint32> collectDeltaSetIndexMap(ShadowParser &parser);
+
+// Returns a delta for each glyph.
+//
+// Glyphs are mapped via `indexMap` or, when it is empty, to the first
+// ItemVariationData by glyph ID. `itemDeltas` is ItemVariationStore::evaluate output.
+QVector<float> glyphDeltas(const QVector<QVector<float>> &itemDeltas,
+                           const QVector<quint32> &indexMap, const quint16 numberOfGlyphs);
+
+// A decoded HVAR or VVAR table.
+struct MetricsVariations
+{
+    ItemVariationStore store;
+    QVector<quint32> advanceMap;
+    // Left or top side bearings.
+    QVector<quint32> startSideBearingMap;
+    // Right or bottom side bearings.
+    QVector<quint32> endSideBearingMap;
+};
+
+// The parser must be at the start of the table.
+MetricsVariations collectHvar(ShadowParser &parser);
+MetricsVariations collectVvar(ShadowParser &parser);
+
+// A decoded MVAR table.
+struct GlobalMetricsVariations
+{
+    struct Record
+    {
+        Tag tag;
+        quint16 outerIndex;
+        quint16 innerIndex;
+    };
+
+    ItemVariationStore store;
+    QVector<Record> records;
+};
+
+// The parser must be at the start of the table.
+GlobalMetricsVariations collectMvar(ShadowParser &parser);
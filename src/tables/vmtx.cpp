@@ -1,9 +1,10 @@
 #include "tables.h"
 
-void parseVmtx(const quint16 numberOfMetrics, const quint16 numberOfGlyphs, Parser &parser)
+void parseVmtx(const quint16 numberOfMetrics, const quint16 numberOfGlyphs,
+               const GlyphNames &glyphNames, Parser &parser)
 {
     parser.readArray("Metrics", numberOfMetrics, [&](const auto index){
-        parser.beginGroup(index);
+        parser.beginGroup(glyphNames.title(quint16(index)));
         parser.read<UInt16>("Advance height");
         parser.read<Int16>("Top side bearing");
         parser.endGroup();
@@ -14,7 +15,7 @@ void parseVmtx(const quint16 numberOfMetrics, const quint16 numberOfGlyphs, Pars
     }
 
     parser.readArray("Additional Metrics", numberOfGlyphs - numberOfMetrics, [&](const auto index){
-        parser.beginGroup(numberOfMetrics + index);
+        parser.beginGroup(glyphNames.title(quint16(numberOfMetrics + index)));
         parser.read<Int16>("Top side bearing");
         parser.endGroup();
     });
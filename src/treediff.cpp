@@ -0,0 +1,89 @@
+#include <QVector>
+
+#include "treediff.h"
+
+using namespace TreeDiff;
+
+static bool isSame(const TreeItem *a, const TreeItem *b)
+{
+    // A zero hash means that a group wasn't finished because of a parsing error.
+    return a->hash != 0 && a->hash == b->hash;
+}
+
+static void markSubtree(const TreeItem *item, const Change change,
+                        QHash<const TreeItem*, Change> &items)
+{
+    items.insert(item, change);
+    for (int i = 0; i < item->childCount(); ++i) {
+        markSubtree(item->child(i), change, items);
+    }
+}
+
+static QString itemKey(const TreeItem *item)
+{
+    return item->title + QChar('\0') + item->type;
+}
+
+static void diffItems(const TreeItem *a, const TreeItem *b, Result &result)
+{
+    result.left.insert(a, Change::Modified);
+    result.right.insert(b, Change::Modified);
+    result.leftToRight.insert(a, b);
+    result.rightToLeft.insert(b, a);
+
+    const int countA = a->childCount();
+    const int countB = b->childCount();
+
+    // Skip identical children at both ends, which is the most common case.
+    int start = 0;
+    while (start < countA && start < countB && isSame(a->child(start), b->child(start))) {
+        start += 1;
+    }
+
+    int endA = countA;
+    int endB = countB;
+    while (endA > start && endB > start && isSame(a->child(endA - 1), b->child(endB - 1))) {
+        endA -= 1;
+        endB -= 1;
+    }
+
+    // Match the remaining children by title and type, preserving the order.
+    QHash<QString, QVector<int>> candidates;
+    for (int i = endB - 1; i >= start; --i) {
+        candidates[itemKey(b->child(i))].append(i);
+    }
+
+    QVector<bool> matchedB(endB - start, false);
+    for (int i = start; i < endA; ++i) {
+        const auto childA = a->child(i);
+        auto &indexes = candidates[itemKey(childA)];
+        if (indexes.isEmpty()) {
+            markSubtree(childA, Change::Removed, result.left);
+            continue;
+        }
+
+        const auto j = indexes.takeLast();
+        matchedB[j - start] = true;
+
+        const auto childB = b->child(j);
+        if (!isSame(childA, childB)) {
+            diffItems(childA, childB, result);
+        }
+    }
+
+    for (int j = start; j < endB; ++j) {
+        if (!matchedB[j - start]) {
+            markSubtree(b->child(j), Change::Added, result.right);
+        }
+    }
+}
+
+Result TreeDiff::diff(const TreeItem *left, const TreeItem *right)
+{
+    Result result;
+    if (!isSame(left, right)) {
+        diffItems(left, right, result);
+    }
+
+    return result;
+}
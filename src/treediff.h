@@ -0,0 +1,32 @@
+#pragma once
+
+#include <QHash>
+
+#include "treeitem.h"
+
+namespace TreeDiff
+{
+    enum class Change
+    {
+        Modified,
+        Added,
+        Removed,
+    };
+
+    struct Result
+    {
+        // Modified and removed items of the left tree.
+        QHash<const TreeItem*, Change> left;
+        // Modified and added items of the right tree.
+        QHash<const TreeItem*, Change> right;
+        // Pairs of modified items.
+        QHash<const TreeItem*, const TreeItem*> leftToRight;
+        QHash<const TreeItem*, const TreeItem*> rightToLeft;
+    };
+
+    // Compares two trees parsed using Font::Mode::HashedTree.
+    //
+    // Subtrees with equal hashes are skipped, so the complexity depends
+    // on the amount of changes and not on the tree size.
+    Result diff(const TreeItem *left, const TreeItem *right);
+}
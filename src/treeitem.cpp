@@ -0,0 +1,92 @@
+#include "treeitem.h"
+
+TreeItem::TreeItem(TreeItem *parent)
+    : m_parent(parent)
+{
+}
+
+TreeItem::~TreeItem()
+{
+    qDeleteAll(m_children);
+}
+
+TreeItem* TreeItem::child(int number)
+{
+    return m_children.value(number);
+}
+
+const TreeItem* TreeItem::child(int number) const
+{
+    return m_children.value(number);
+}
+
+int TreeItem::childCount() const
+{
+    return m_children.count();
+}
+
+int TreeItem::childIndex() const
+{
+    if (m_parent) {
+        return m_parent->m_children.indexOf(const_cast<TreeItem*>(this));
+    }
+
+    return 0;
+}
+
+void TreeItem::reserveChildren(const qsizetype n)
+{
+    m_children.reserve(n);
+}
+
+void TreeItem::setChildrenLoader(ChildrenLoader loader)
+{
+    m_childrenLoader.reset(new ChildrenLoader(std::move(loader)));
+}
+
+void TreeItem::loadChildren(TreeItem *root)
+{
+    if (!m_childrenLoader) {
+        return;
+    }
+
+    // Reset first, so a loader that throws is not called again.
+    const auto loader = std::move(m_childrenLoader);
+    (*loader)(root);
+}
+
+void TreeItem::takeChildren(TreeItem *other)
+{
+    for (auto child : other->m_children) {
+        child->m_parent = this;
+        m_children.append(child);
+    }
+
+    other->m_children.clear();
+}
+
+QVariant TreeItem::data(int column) const
+{
+    switch (column) {
+        case Column::Title: return title;
+        case Column::Value: return value;
+        case Column::Type: return type;
+        case Column::Size: return size;
+        default: return QVariant();
+    }
+}
+
+void TreeItem::addChild(TreeItem *item)
+{
+    m_children.append(item);
+}
+
+TreeItem* TreeItem::parent()
+{
+    return m_parent;
+}
+
+const TreeItem* TreeItem::parent() const
+{
+    return m_parent;
+}
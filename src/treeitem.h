@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QVariant>
+#include <QVector>
+
+#include <functional>
+#include <memory>
+
+#include "range.h"
+
+namespace Column
+{
+    enum Column
+    {
+        Title,
+        Value,
+        Type,
+        Size,
+        LastColumn,
+    };
+}
+
+class TreeItem
+{
+public:
+    explicit TreeItem(TreeItem *parent);
+    virtual ~TreeItem();
+
+    TreeItem *child(int number);
+    const TreeItem *child(int number) const;
+    bool hasChildren() const { return !m_children.isEmpty(); };
+    int childCount() const;
+    virtual QVariant data(int column) const;
+    void addChild(TreeItem *item);
+    TreeItem *parent();
+    const TreeItem *parent() const;
+    int childIndex() const;
+    void reserveChildren(const qsizetype n);
+
+    // Children of a lazy group are parsed on the first expansion. See Parser::readLazyGroup.
+    using ChildrenLoader = std::function<void(TreeItem *root)>;
+    void setChildrenLoader(ChildrenLoader loader);
+    bool canLoadChildren() const { return m_childrenLoader != nullptr; }
+    // Parses children into a detached `root`. Does nothing on subsequent calls.
+    void loadChildren(TreeItem *root);
+    // Moves children of `other` to this item.
+    void takeChildren(TreeItem *other);
+
+public:
+    QString title;
+    QString value;
+    QString type;
+    Range range;
+    QString size;
+    // A hash of the title, the type and the covered bytes of a subtree.
+    // Zero when not computed.
+    quint64 hash = 0;
+
+private:
+    TreeItem *m_parent;
+    QVector<TreeItem*> m_children;
+    // Stored by pointer, because most items are not lazy.
+    std::unique_ptr<ChildrenLoader> m_childrenLoader;
+};
@@ -1,68 +1,14 @@
 #include <QFont>
 
+#include "bitmapview.h"
+#include "parser.h"
 #include "utils.h"
 
 #include "treemodel.h"
 
-TreeItem::TreeItem(TreeItem *parent)
-    : m_parent(parent)
-{
-}
-
-TreeItem::~TreeItem()
-{
-    qDeleteAll(m_children);
-}
-
-TreeItem* TreeItem::child(int number)
-{
-    return m_children.value(number);
-}
-
-int TreeItem::childCount() const
-{
-    return m_children.count();
-}
-
-int TreeItem::childIndex() const
-{
-    if (m_parent) {
-        return m_parent->m_children.indexOf(const_cast<TreeItem*>(this));
-    }
-
-    return 0;
-}
-
-void TreeItem::reserveChildren(const qsizetype n)
-{
-    m_children.reserve(n);
-}
-
-QVariant TreeItem::data(int column) const
-{
-    switch (column) {
-        case Column::Title: return title;
-        case Column::Value: return value;
-        case Column::Type: return type;
-        case Column::Size: return size;
-        default: return QVariant();
-    }
-}
-
-void TreeItem::addChild(TreeItem *item)
-{
-    m_children.append(item);
-}
-
-TreeItem* TreeItem::parent()
-{
-    return m_parent;
-}
-
-
-TreeModel::TreeModel(QObject *parent)
+TreeModel::TreeModel(TreeItem *rootItem, QObject *parent)
     : QAbstractItemModel(parent)
-    , m_rootItem(new TreeItem(nullptr))
+    , m_rootItem(rootItem ? rootItem : new TreeItem(nullptr))
 {
 }
 
@@ -118,6 +64,42 @@ int TreeModel::rowCount(const QModelIndex &parent) const
     return parentItem->childCount();
 }
 
+bool TreeModel::hasChildren(const QModelIndex &parent) const
+{
+    if (parent.column() > 0) {
+        return false;
+    }
+
+    const auto item = itemByIndex(parent);
+    return item->hasChildren() || item->canLoadChildren();
+}
+
+bool TreeModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (parent.column() > 0) {
+        return false;
+    }
+
+    return itemByIndex(parent)->canLoadChildren();
+}
+
+void TreeModel::fetchMore(const QModelIndex &parent)
+{
+    const auto item = itemByIndex(parent);
+
+    // Children are parsed into a detached item first, so rows can be announced before they are added.
+    TreeItem root(nullptr);
+    item->loadChildren(&root);
+    if (!root.hasChildren()) {
+        return;
+    }
+
+    const auto first = item->childCount();
+    beginInsertRows(parent, first, first + root.childCount() - 1);
+    item->takeChildren(&root);
+    endInsertRows();
+}
+
 int TreeModel::columnCount(const QModelIndex &/* parent */) const
 {
     return (int)Column::LastColumn;
@@ -144,6 +126,38 @@ QVariant TreeModel::data(const QModelIndex &index, int role) const
         return item->data(index.column());
     }
 
+    if (role == Qt::BackgroundRole) {
+        const auto it = m_highlights.constFind(item);
+        if (it != m_highlights.constEnd()) {
+            return *it;
+        }
+
+        return QVariant();
+    }
+
+    // Colors are stored as `#RRGGBBAA`, while QColor expects `#AARRGGBB`.
+    if (role == Qt::DecorationRole && index.column() == Column::Value && item->type == BGRAColor::Type) {
+        const auto rgba = item->value.mid(1).toUInt(nullptr, 16);
+        return QColor::fromRgba((rgba >> 8) | (rgba << 24));
+    }
+
+    // Thumbnails are decoded in the background, only for visible items.
+    if (role == Qt::DecorationRole && index.column() == Column::Value
+        && item->type == BitmapInfo::Type && m_bitmapDecoder)
+    {
+        QPixmap thumbnail;
+        if (m_bitmapDecoder->thumbnail(item, thumbnail)) {
+            if (!thumbnail.isNull()) {
+                return thumbnail;
+            }
+        } else {
+            // Rows of existing items never change, so there is no need to look them up later.
+            m_thumbnailRows.insert(item, index.row());
+        }
+
+        return QVariant();
+    }
+
     if (role == Qt::TextAlignmentRole && index.column() == Column::Size) {
         return Qt::AlignRight;
     }
@@ -179,3 +193,36 @@ TreeItem* TreeModel::itemByIndex(const QModelIndex &index) const
     }
     return m_rootItem;
 }
+
+QModelIndex TreeModel::indexByItem(const TreeItem *item) const
+{
+    if (!item || item == m_rootItem) {
+        return QModelIndex();
+    }
+
+    return createIndex(item->childIndex(), 0, const_cast<TreeItem*>(item));
+}
+
+void TreeModel::setHighlights(const QHash<const TreeItem*, QColor> &highlights)
+{
+    beginResetModel();
+    m_highlights = highlights;
+    endResetModel();
+}
+
+void TreeModel::setBitmapDecoder(BitmapDecoder *decoder)
+{
+    m_bitmapDecoder = decoder;
+    connect(decoder, &BitmapDecoder::decoded, this, [this](const TreeItem *item){
+        // Items that were not requested by the view don't need to be updated.
+        const auto row = m_thumbnailRows.value(item, -1);
+        if (row < 0) {
+            return;
+        }
+
+        m_thumbnailRows.remove(item);
+
+        const auto index = createIndex(row, Column::Value, const_cast<TreeItem*>(item));
+        emit dataChanged(index, index, { Qt::DecorationRole });
+    });
+}
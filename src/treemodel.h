@@ -1,52 +1,18 @@
 #pragma once
 
 #include <QAbstractItemModel>
+#include <QColor>
+#include <QHash>
 
-#include "range.h"
+#include "treeitem.h"
 
-namespace Column
-{
-    enum Column
-    {
-        Title,
-        Value,
-        Type,
-        Size,
-        LastColumn,
-    };
-}
-
-class TreeItem
-{
-public:
-    explicit TreeItem(TreeItem *parent);
-    virtual ~TreeItem();
-
-    TreeItem *child(int number);
-    bool hasChildren() const { return !m_children.isEmpty(); };
-    int childCount() const;
-    virtual QVariant data(int column) const;
-    void addChild(TreeItem *item);
-    TreeItem *parent();
-    int childIndex() const;
-    void reserveChildren(const qsizetype n);
-
-public:
-    QString title;
-    QString value;
-    QString type;
-    Range range;
-    QString size;
-
-private:
-    TreeItem * const m_parent;
-    QVector<TreeItem*> m_children;
-};
+class BitmapDecoder;
 
 class TreeModel : public QAbstractItemModel
 {
 public:
-    TreeModel(QObject *parent = nullptr);
+    // Takes ownership of `rootItem`. An empty tree is created when it's null.
+    explicit TreeModel(TreeItem *rootItem = nullptr, QObject *parent = nullptr);
     ~TreeModel();
 
     QModelIndex index(int row, int column,
@@ -56,6 +22,11 @@ public:
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
     int columnCount(const QModelIndex &parent = QModelIndex()) const override;
 
+    // Lazy groups have children before they are loaded.
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
     Qt::ItemFlags flags(const QModelIndex &index) const override;
 
     QVariant data(const QModelIndex &index, int role) const override;
@@ -64,7 +35,18 @@ public:
 
     TreeItem* rootItem() const { return m_rootItem; }
     TreeItem* itemByIndex(const QModelIndex &index) const;
+    QModelIndex indexByItem(const TreeItem *item) const;
+
+    // Sets background colors for specific items.
+    void setHighlights(const QHash<const TreeItem*, QColor> &highlights);
+
+    // Shows thumbnails of bitmap items. The decoder must outlive the model.
+    void setBitmapDecoder(BitmapDecoder *decoder);
 
 private:
     TreeItem * const m_rootItem;
+    QHash<const TreeItem*, QColor> m_highlights;
+    BitmapDecoder *m_bitmapDecoder = nullptr;
+    // Rows of items with thumbnails being decoded.
+    mutable QHash<const TreeItem*, int> m_thumbnailRows;
 };
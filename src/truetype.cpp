@@ -1,6 +1,8 @@
 #include <bitset>
+#include <tuple>
 
 #include "src/algo.h"
+#include "src/hash.h"
 #include "src/tables/tables.h"
 
 #include "truetype.h"
@@ -121,9 +123,10 @@ struct CommonFaceData
     quint16 numberOfVMetrics = 0;
     NamesHash names;
     QVector<quint32> locaOffsets;
-    QVector<CblcIndex> blocLocations;
-    QVector<CblcIndex> eblcLocations;
-    QVector<CblcIndex> cblcLocations;
+    CblcIndex blocIndex;
+    CblcIndex eblcIndex;
+    CblcIndex cblcIndex;
+    GlyphNames glyphNames;
 };
 
 static std::optional<FontTable> findTable(const QVector<FontTable> &tables, const quint32 faceIndex, const char* tag)
@@ -131,7 +134,53 @@ static std::optional<FontTable> findTable(const QVector<FontTable> &tables, cons
     return algo::find_if(tables, [=](const auto table){ return table.faceIndex == faceIndex && table.tag == tag; });
 }
 
-static CommonFaceData parseCommonFaceData(const QVector<FontTable> &tables, const quint32 faceIndex, ShadowParser shadow)
+// Faces of a collection usually share tables, which are identified by their ranges.
+struct TableKey
+{
+    quint32 tag = 0;
+    quint32 offset = 0;
+    quint32 length = 0;
+
+    bool operator==(const TableKey &other) const
+    { return tag == other.tag && offset == other.offset && length == other.length; }
+};
+
+static inline uint qHash(const TableKey &key, uint seed = 0)
+{
+    return uint(Hash::combine(Hash::combine(Hash::combine(seed, key.tag), key.offset), key.length));
+}
+
+static TableKey tableKey(const FontTable &table)
+{
+    return { table.tag.d, table.offset, table.length };
+}
+
+// A missing table has a null range.
+static TableKey tableKey(const QVector<FontTable> &tables, const quint32 faceIndex, const char* tag)
+{
+    if (const auto table = findTable(tables, faceIndex, tag)) {
+        return tableKey(*table);
+    }
+
+    return {};
+}
+
+// Common data that was already collected for other faces.
+//
+// Values are keyed by all the tables they depend on, so a face that points to
+// the same tables reuses them instead of reading them again.
+struct CommonFaceDataCache
+{
+    QHash<QVector<TableKey>, QVector<quint32>> locaOffsets;
+    QHash<TableKey, NamesHash> names;
+    QHash<QVector<TableKey>, GlyphNames> glyphNames;
+    QHash<TableKey, CblcIndex> bitmapIndexes;
+};
+
+// Glyph names are used only as titles, so they are not collected without a tree.
+static CommonFaceData parseCommonFaceData(const QVector<FontTable> &tables, const quint32 faceIndex,
+                                          const bool withGlyphNames, ShadowParser shadow,
+                                          CommonFaceDataCache &cache)
 {
     CommonFaceData faceData;
 
@@ -160,40 +209,127 @@ static CommonFaceData parseCommonFaceData(const QVector<FontTable> &tables, cons
     }
 
     if (const auto table = findTable(tables, faceIndex, "loca")) {
-        auto s = shadow;
-        s.advanceTo(table->offset);
-        faceData.locaOffsets = collectLocaOffsets(faceData.numberOfGlyphs, faceData.indexToLocationFormat, s);
+        const QVector<TableKey> key = {
+            tableKey(*table),
+            tableKey(tables, faceIndex, "maxp"),
+            tableKey(tables, faceIndex, "head"),
+        };
+
+        if (cache.locaOffsets.contains(key)) {
+            faceData.locaOffsets = cache.locaOffsets.value(key);
+        } else {
+            auto s = shadow;
+            s.advanceTo(table->offset);
+            faceData.locaOffsets = collectLocaOffsets(faceData.numberOfGlyphs, faceData.indexToLocationFormat, s);
+            cache.locaOffsets.insert(key, faceData.locaOffsets);
+        }
     }
 
     if (const auto table = findTable(tables, faceIndex, "name")) {
-        auto s = shadow;
-        s.advanceTo(table->offset);
-        faceData.names = collectNameNames(s);
+        const auto key = tableKey(*table);
+        if (cache.names.contains(key)) {
+            faceData.names = cache.names.value(key);
+        } else {
+            auto s = shadow;
+            s.advanceTo(table->offset);
+            faceData.names = collectNameNames(s);
+            cache.names.insert(key, faceData.names);
+        }
     }
 
-    if (const auto table = findTable(tables, faceIndex, "bloc")) {
-        auto s = shadow;
-        s.advanceTo(table->offset);
-        faceData.blocLocations = parseCblcLocations(s);
+    if (withGlyphNames) {
+        // Glyph names are optional, so a malformed table should not break the parsing.
+        const QVector<TableKey> glyphNamesKey = {
+            tableKey(tables, faceIndex, "maxp"),
+            tableKey(tables, faceIndex, "cmap"),
+            tableKey(tables, faceIndex, "post"),
+            tableKey(tables, faceIndex, "CFF "),
+        };
+        if (cache.glyphNames.contains(glyphNamesKey)) {
+            faceData.glyphNames = cache.glyphNames.value(glyphNamesKey);
+        } else {
+            CharacterMap characterMap;
+            if (const auto table = findTable(tables, faceIndex, "cmap")) {
+                try {
+                    auto s = shadow;
+                    s.advanceTo(table->offset);
+                    characterMap = collectCharacterMap(s);
+                } catch (const QString&) {
+                }
+            }
+
+            QVector<QString> names;
+            if (const auto table = findTable(tables, faceIndex, "post")) {
+                try {
+                    auto s = shadow;
+                    s.advanceTo(table->offset);
+                    names = collectPostGlyphNames(faceData.numberOfGlyphs, s);
+                } catch (const QString&) {
+                }
+            }
+
+            if (names.isEmpty()) {
+                if (const auto table = findTable(tables, faceIndex, "CFF ")) {
+                    try {
+                        auto s = shadow;
+                        s.advanceTo(table->offset);
+                        names = collectCffGlyphNames(s);
+                    } catch (const QString&) {
+                    }
+                }
+            }
+
+            faceData.glyphNames = GlyphNames(faceData.numberOfGlyphs, std::move(characterMap), names);
+            cache.glyphNames.insert(glyphNamesKey, faceData.glyphNames);
+        }
     }
 
+    // Bitmap data tables without locations are shown as unsupported,
+    // so a malformed table should not break the parsing.
+    const auto collectBitmapIndex = [&](const char *tag, CblcIndex &index) {
+        if (const auto table = findTable(tables, faceIndex, tag)) {
+            const auto key = tableKey(*table);
+            if (cache.bitmapIndexes.contains(key)) {
+                index = cache.bitmapIndexes.value(key);
+            } else {
+                try {
+                    auto s = shadow;
+                    s.advanceTo(table->offset);
+                    index = parseCblcLocations(s);
+                } catch (const QString&) {
+                }
+                cache.bitmapIndexes.insert(key, index);
+            }
+        }
+    };
+
+    collectBitmapIndex("bloc", faceData.blocIndex);
+    collectBitmapIndex("EBLC", faceData.eblcIndex);
+    collectBitmapIndex("CBLC", faceData.cblcIndex);
+
     return faceData;
 }
 
 static QStringList parseTables(const int numberOfFaces, const QVector<FontTable> &tables, ShadowParser shadow, Parser &parser)
 {
-    // We cannot use algo::dedup_vector otherwise findTable will break down.
-    QVector<quint32> processedOffsets;
-
     QVector<CommonFaceData> facesData;
     try {
+        CommonFaceDataCache cache;
         for (int i = 0; i < numberOfFaces; i++) {
-            facesData << parseCommonFaceData(tables, i, shadow);
+            facesData << parseCommonFaceData(tables, i, !parser.isHeadless(), shadow, cache);
         }
     } catch (const QString &msg) {
         throw QString("common face data parsing failed because %1").arg(msg);
     }
 
+    // Shared tables are parsed only once, using the data of the first face.
+    // Other faces reference them only via their table records.
+    // We cannot use algo::dedup_vector otherwise findTable will break down.
+    QHash<TableKey, QStringList> tableFaces;
+    for (const auto &table : tables) {
+        tableFaces[tableKey(table)] << QString::number(table.faceIndex);
+    }
+
     QStringList warnings;
 
     for (const auto table : tables) {
@@ -201,13 +337,15 @@ static QStringList parseTables(const int numberOfFaces, const QVector<FontTable>
             continue;
         }
 
-        if (processedOffsets.contains(table.offset)) {
+        const auto faces = tableFaces.take(tableKey(table));
+        if (faces.isEmpty()) {
             continue;
         }
-        processedOffsets << table.offset;
 
         QString currTableName = tableName(table.tag);
-        if (numberOfFaces > 1) {
+        if (faces.size() > 1) {
+            currTableName += QString(" (Faces %1)").arg(faces.join(", "));
+        } else if (numberOfFaces > 1) {
             currTableName += QString(" (Face %1)").arg(table.faceIndex);
         }
         parser.beginGroup(currTableName, table.tag.toString());
@@ -220,37 +358,43 @@ static QStringList parseTables(const int numberOfFaces, const QVector<FontTable>
             switch (table.tag.d) {
             case FOURCC("ankr"): parseAnkr(fd.numberOfGlyphs, parser); break;
             case FOURCC("avar"): parseAvar(parser); break;
-            case FOURCC("bdat"): parseCbdt(fd.blocLocations, parser); break;
+            case FOURCC("bdat"): parseCbdt(fd.blocIndex, fd.glyphNames, parser); break;
             case FOURCC("bloc"): parseCblc(parser); break;
-            case FOURCC("CBDT"): parseCbdt(fd.cblcLocations, parser); break;
+            case FOURCC("CBDT"): parseCbdt(fd.cblcIndex, fd.glyphNames, parser); break;
             case FOURCC("CBLC"): parseCblc(parser); break;
             case FOURCC("CFF "): parseCff(parser); break;
             case FOURCC("CFF2"): parseCff2(parser); break;
             case FOURCC("cmap"): parseCmap(parser); break;
-            case FOURCC("EBDT"): parseCbdt(fd.eblcLocations, parser); break;
+            case FOURCC("COLR"): parseColr(table.length, parser); break;
+            case FOURCC("CPAL"): parseCpal(fd.names, parser); break;
+            case FOURCC("EBDT"): parseCbdt(fd.eblcIndex, fd.glyphNames, parser); break;
             case FOURCC("EBLC"): parseCblc(parser); break;
             case FOURCC("feat"): parseFeat(fd.names, table.length, parser); break;
             case FOURCC("fvar"): parseFvar(fd.names, parser); break;
             case FOURCC("GDEF"): parseGdef(parser); break;
-            case FOURCC("glyf"): parseGlyf(fd.numberOfGlyphs, fd.locaOffsets, parser); break;
+            case FOURCC("glyf"): parseGlyf(fd.numberOfGlyphs, fd.locaOffsets, fd.glyphNames, parser); break;
+            case FOURCC("GPOS"): parseGpos(fd.names, table.length, parser); break;
+            case FOURCC("GSUB"): parseGsub(fd.names, table.length, parser); break;
             case FOURCC("gvar"): parseGvar(parser); break;
             case FOURCC("head"): parseHead(parser); break;
             case FOURCC("hhea"): parseHhea(parser); break;
-            case FOURCC("hmtx"): parseHmtx(fd.numberOfHMetrics, fd.numberOfGlyphs, parser); break;
+            case FOURCC("hmtx"): parseHmtx(fd.numberOfHMetrics, fd.numberOfGlyphs, fd.glyphNames, parser); break;
             case FOURCC("HVAR"): parseHvar(parser); break;
             case FOURCC("kern"): parseKern(parser); break;
+            case FOURCC("kerx"): parseKerx(fd.numberOfGlyphs, table.length, parser); break;
             case FOURCC("loca"): parseLoca(fd.numberOfGlyphs, fd.indexToLocationFormat, parser); break;
             case FOURCC("maxp"): parseMaxp(parser); break;
+            case FOURCC("morx"): parseMorx(fd.numberOfGlyphs, parser); break;
             case FOURCC("MVAR"): parseMvar(parser); break;
             case FOURCC("name"): parseName(parser); break;
             case FOURCC("OS/2"): parseOS2(parser); break;
             case FOURCC("post"): parsePost(parser); break;
-            case FOURCC("sbix"): parseSbix(fd.numberOfGlyphs, parser); break;
+            case FOURCC("sbix"): parseSbix(fd.numberOfGlyphs, fd.glyphNames, parser); break;
             case FOURCC("STAT"): parseStat(fd.names, parser); break;
             case FOURCC("SVG "): parseSvg(parser); break;
             case FOURCC("trak"): parseTrak(fd.names, parser); break;
             case FOURCC("vhea"): parseVhea(parser); break;
-            case FOURCC("vmtx"): parseVmtx(fd.numberOfVMetrics, fd.numberOfGlyphs, parser); break;
+            case FOURCC("vmtx"): parseVmtx(fd.numberOfVMetrics, fd.numberOfGlyphs, fd.glyphNames, parser); break;
             case FOURCC("VVAR"): parseVvar(parser); break;
             case FOURCC("VORG"): parseVorg(parser); break;
             default: parser.readUnsupported(table.length); break;
@@ -321,6 +465,15 @@ QStringList TrueType::parse(Parser &parser)
         parser.endGroup();
     }
 
-    algo::sort_all_by_key(tables, &FontTable::offset);
+    // Shared tables are listed in face order, so the first face owns them.
+    algo::sort_all(tables, [](const auto &a, const auto &b) {
+        return std::tie(a.offset, a.faceIndex) < std::tie(b.offset, b.faceIndex);
+    });
+
+    for (const auto &table : tables) {
+        parser.addTableRange(table.faceIndex, table.tag.toString(),
+                             Range(table.offset, table.offset + table.length));
+    }
+
     return parseTables(numberOfFaces, tables, shadow, parser);
 }
@@ -0,0 +1,420 @@
+#include <QAbstractTableModel>
+#include <QElapsedTimer>
+#include <QHeaderView>
+#include <QRunnable>
+#include <QSplitter>
+#include <QVBoxLayout>
+
+#include "variationsdialog.h"
+
+namespace AdvanceColumn
+{
+    enum AdvanceColumn
+    {
+        Glyph,
+        Advance,
+        Delta,
+        Instance,
+        LastColumn,
+    };
+}
+
+// Slider positions per axis range.
+static const int SliderSteps = 1000;
+// Coalesces slider ticks into one update per frame.
+static const int UpdateInterval = 16;
+
+// Default and instanced advances.
+//
+// Only visible rows are queried by the view, so an instance change is cheap
+// even for fonts with many glyphs.
+class AdvancesModel : public QAbstractTableModel
+{
+public:
+    using QAbstractTableModel::QAbstractTableModel;
+
+    void reset(const QVector<quint16> &advances)
+    {
+        beginResetModel();
+        m_advances = advances;
+        m_instanced.clear();
+        endResetModel();
+    }
+
+    void setInstanced(const QVector<float> &advances)
+    {
+        m_instanced = advances;
+        if (!m_advances.isEmpty()) {
+            emit dataChanged(index(0, AdvanceColumn::Delta),
+                             index(m_advances.size() - 1, AdvanceColumn::Instance));
+        }
+    }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : m_advances.size();
+    }
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : AdvanceColumn::LastColumn;
+    }
+
+    QVariant data(const QModelIndex &index, int role) const override
+    {
+        if (role == Qt::TextAlignmentRole && index.column() != AdvanceColumn::Glyph) {
+            return int(Qt::AlignRight | Qt::AlignVCenter);
+        }
+
+        if (role != Qt::DisplayRole) {
+            return QVariant();
+        }
+
+        const auto row = index.row();
+        const auto advance = m_advances[row];
+        const auto instanced = row < m_instanced.size() ? double(m_instanced[row]) : double(advance);
+        switch (index.column()) {
+            case AdvanceColumn::Glyph: return row;
+            case AdvanceColumn::Advance: return advance;
+            case AdvanceColumn::Delta: return QString::number(instanced - advance, 'f', 2);
+            case AdvanceColumn::Instance: return QString::number(instanced, 'f', 2);
+            default: return QVariant();
+        }
+    }
+
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const override
+    {
+        if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+            return QVariant();
+        }
+
+        switch (section) {
+            case AdvanceColumn::Glyph: return "Glyph";
+            case AdvanceColumn::Advance: return "Advance";
+            case AdvanceColumn::Delta: return "Delta";
+            case AdvanceColumn::Instance: return "Instance";
+            default: return QVariant();
+        }
+    }
+
+private:
+    QVector<quint16> m_advances;
+    QVector<float> m_instanced;
+};
+
+class InstanceTask : public QRunnable
+{
+public:
+    InstanceTask(VariationsDialog *dialog, const quint64 generation, std::shared_ptr<const Face> face,
+                 const QVector<float> &userCoords, const bool vertical)
+        : m_dialog(dialog)
+        , m_generation(generation)
+        , m_face(std::move(face))
+        , m_userCoords(userCoords)
+        , m_vertical(vertical)
+    {
+    }
+
+    void run() override
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        VariationsDialog::Instance result;
+        result.coords = m_face->normalizeCoordinates(m_userCoords);
+        result.instance = m_face->instance(result.coords);
+        result.advances = result.instance.advances();
+        result.hasDeltas = m_face->findTable(m_vertical ? "VVAR" : "HVAR").has_value();
+        if (m_vertical) {
+            const auto defaultAdvances = m_face->advances(true);
+            const auto deltas = m_face->advanceDeltas(result.coords, true);
+            result.advances.resize(defaultAdvances.size());
+            for (int i = 0; i < defaultAdvances.size(); ++i) {
+                result.advances[i] = defaultAdvances[i] + deltas.value(i);
+            }
+        }
+
+        result.elapsed = timer.nsecsElapsed();
+
+        // The dialog waits for all tasks on destruction.
+        const auto dialog = m_dialog;
+        const auto generation = m_generation;
+        QMetaObject::invokeMethod(dialog, [dialog, generation, result]{
+            dialog->onInstanceReady(generation, result);
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    VariationsDialog * const m_dialog;
+    const quint64 m_generation;
+    // Tasks are run one at a time, so the face is never used concurrently.
+    const std::shared_ptr<const Face> m_face;
+    const QVector<float> m_userCoords;
+    const bool m_vertical;
+};
+
+VariationsDialog::VariationsDialog(const std::vector<Face> &faces, QWidget *parent)
+    : QDialog(parent)
+    , m_faces(faces)
+    , m_cmbFace(new QComboBox)
+    , m_cmbInstance(new QComboBox)
+    , m_axesLayout(new QGridLayout)
+    , m_chBoxVertical(new QCheckBox("Vertical"))
+    , m_lblSummary(new QLabel)
+    , m_grid(new GlyphGrid)
+    , m_advancesModel(new AdvancesModel(this))
+    , m_viewAdvances(new QTreeView)
+    , m_treeMetrics(new QTreeWidget)
+    , m_updateTimer(new QTimer(this))
+{
+    setWindowTitle("Variations");
+
+    m_pool.setMaxThreadCount(1);
+    m_updateTimer->setSingleShot(true);
+    m_updateTimer->setInterval(UpdateInterval);
+    connect(m_updateTimer, &QTimer::timeout, this, &VariationsDialog::startUpdate);
+
+    for (const auto &face : faces) {
+        m_cmbFace->addItem(QString("Face %1").arg(face.index()));
+    }
+
+    m_viewAdvances->setModel(m_advancesModel);
+    m_viewAdvances->setRootIsDecorated(false);
+    m_viewAdvances->setUniformRowHeights(true);
+    m_viewAdvances->header()->setStretchLastSection(false);
+
+    m_treeMetrics->setColumnCount(2);
+    m_treeMetrics->setHeaderLabels({ "Tag", "Delta" });
+    m_treeMetrics->setRootIsDecorated(false);
+
+    auto tablesSplitter = new QSplitter();
+    tablesSplitter->addWidget(m_viewAdvances);
+    tablesSplitter->addWidget(m_treeMetrics);
+    tablesSplitter->setStretchFactor(0, 2);
+    tablesSplitter->setStretchFactor(1, 1);
+
+    auto splitter = new QSplitter(Qt::Vertical);
+    splitter->addWidget(m_grid);
+    splitter->addWidget(tablesSplitter);
+
+    auto form = new QGridLayout();
+    int row = 0;
+    if (faces.size() > 1) {
+        form->addWidget(new QLabel("Face:"), row, 0);
+        form->addWidget(m_cmbFace, row++, 1);
+    }
+    form->addWidget(new QLabel("Instance:"), row, 0);
+    form->addWidget(m_cmbInstance, row++, 1);
+    form->addWidget(m_chBoxVertical, row++, 1);
+
+    auto lay = new QVBoxLayout(this);
+    lay->addLayout(form);
+    lay->addLayout(m_axesLayout);
+    lay->addWidget(m_lblSummary);
+    lay->addWidget(splitter, 1);
+
+    connect(m_cmbFace, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &VariationsDialog::onFaceChanged);
+    connect(m_cmbInstance, QOverload<int>::of(&QComboBox::activated), this, &VariationsDialog::onNamedInstanceChanged);
+    connect(m_chBoxVertical, &QCheckBox::toggled, this, &VariationsDialog::onFaceChanged);
+    connect(m_grid, &GlyphGrid::glyphClicked, this, &VariationsDialog::onGlyphClicked);
+
+    onFaceChanged();
+
+    resize(700, 800);
+}
+
+VariationsDialog::~VariationsDialog()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+
+    // Render tasks reference the face.
+    m_grid->setFace(nullptr);
+}
+
+void VariationsDialog::onFaceChanged()
+{
+    m_updateTimer->stop();
+    m_pool.clear();
+    m_workerFace.reset();
+    m_generation += 1;
+
+    while (auto item = m_axesLayout->takeAt(0)) {
+        delete item->widget();
+        delete item;
+    }
+    m_axisSliders.clear();
+    m_axisSpins.clear();
+    m_cmbInstance->clear();
+    m_treeMetrics->clear();
+    m_advancesModel->reset({});
+
+    const auto index = m_cmbFace->currentIndex();
+    if (index < 0) {
+        m_grid->setFace(nullptr);
+        m_lblSummary->setText("No faces");
+        return;
+    }
+
+    const auto &face = m_faces[size_t(index)];
+    m_grid->setFace(&face);
+
+    const auto &axes = face.variationAxes();
+    if (axes.isEmpty()) {
+        m_lblSummary->setText("Not a variable font");
+        return;
+    }
+
+    for (int i = 0; i < axes.size(); ++i) {
+        const auto &axis = axes[i];
+
+        auto slider = new QSlider(Qt::Horizontal);
+        slider->setRange(0, SliderSteps);
+
+        auto spin = new QDoubleSpinBox();
+        spin->setRange(double(axis.minValue), double(axis.maxValue));
+        spin->setDecimals(2);
+
+        m_axesLayout->addWidget(new QLabel(axis.tag.toString() + ":"), i, 0);
+        m_axesLayout->addWidget(slider, i, 1);
+        m_axesLayout->addWidget(spin, i, 2);
+        m_axisSliders << slider;
+        m_axisSpins << spin;
+
+        spin->setValue(double(axis.defaultValue));
+        syncSlider(i);
+
+        connect(slider, &QSlider::valueChanged, this, [this, i]{ onSliderMoved(i); });
+        connect(spin, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, [this, i]{ onSpinChanged(i); });
+    }
+
+    m_namedInstances = face.namedInstances();
+    const auto names = face.names();
+    m_cmbInstance->addItem("Default");
+    for (const auto &instance : m_namedInstances) {
+        m_cmbInstance->addItem(names.value(instance.subfamilyNameId,
+                                           QString("Name ID %1").arg(instance.subfamilyNameId)));
+    }
+
+    m_advancesModel->reset(face.advances(m_chBoxVertical->isChecked()));
+    m_workerFace = std::make_shared<const Face>(face.detached());
+
+    onCoordinatesChanged();
+}
+
+void VariationsDialog::onNamedInstanceChanged(const int index)
+{
+    const auto faceIndex = m_cmbFace->currentIndex();
+    if (faceIndex < 0) {
+        return;
+    }
+
+    const auto &axes = m_faces[size_t(faceIndex)].variationAxes();
+    for (int i = 0; i < m_axisSpins.size() && i < axes.size(); ++i) {
+        float value = axes[i].defaultValue;
+        if (index > 0 && index - 1 < m_namedInstances.size()) {
+            value = m_namedInstances[index - 1].coordinates.value(i, value);
+        }
+
+        // Update all axes at once.
+        m_axisSpins[i]->blockSignals(true);
+        m_axisSpins[i]->setValue(double(value));
+        m_axisSpins[i]->blockSignals(false);
+        syncSlider(i);
+    }
+
+    onCoordinatesChanged();
+}
+
+void VariationsDialog::onSliderMoved(const int axis)
+{
+    const auto spin = m_axisSpins[axis];
+    const auto range = spin->maximum() - spin->minimum();
+    const auto value = spin->minimum() + range * m_axisSliders[axis]->value() / SliderSteps;
+    if (qFuzzyCompare(value, spin->value())) {
+        return;
+    }
+
+    spin->setValue(value);
+}
+
+void VariationsDialog::onSpinChanged(const int axis)
+{
+    syncSlider(axis);
+    onCoordinatesChanged();
+}
+
+void VariationsDialog::syncSlider(const int axis)
+{
+    const auto spin = m_axisSpins[axis];
+    const auto range = spin->maximum() - spin->minimum();
+    const auto position = range > 0 ? qRound((spin->value() - spin->minimum()) / range * SliderSteps) : 0;
+
+    auto slider = m_axisSliders[axis];
+    slider->blockSignals(true);
+    slider->setValue(position);
+    slider->blockSignals(false);
+}
+
+void VariationsDialog::onCoordinatesChanged()
+{
+    // Not restarted, so a continuous drag is still updated once per interval.
+    if (!m_updateTimer->isActive()) {
+        m_updateTimer->start();
+    }
+}
+
+void VariationsDialog::startUpdate()
+{
+    const auto index = m_cmbFace->currentIndex();
+    if (index < 0 || !m_workerFace || m_axisSpins.size() != m_faces[size_t(index)].variationAxes().size()) {
+        return;
+    }
+
+    QVector<float> userCoords;
+    for (const auto spin : m_axisSpins) {
+        userCoords << float(spin->value());
+    }
+
+    // Only the latest coordinates are needed.
+    m_pool.clear();
+    m_pool.start(new InstanceTask(this, m_generation, m_workerFace, userCoords, m_chBoxVertical->isChecked()));
+}
+
+void VariationsDialog::onInstanceReady(const quint64 generation, const Instance &instance)
+{
+    if (generation != m_generation) {
+        return;
+    }
+
+    m_advancesModel->setInstanced(instance.advances);
+
+    m_treeMetrics->clear();
+    for (const auto &pair : instance.instance.metricsDeltas()) {
+        auto item = new QTreeWidgetItem(m_treeMetrics);
+        item->setText(0, pair.first.toString());
+        item->setText(1, QString::number(double(pair.second), 'f', 2));
+        item->setTextAlignment(1, Qt::AlignRight);
+    }
+
+    // Only visible glyphs are re-rendered, on worker threads.
+    m_grid->setInstance(instance.instance);
+
+    QStringList normalized;
+    for (const auto c : instance.coords) {
+        normalized << QString::number(double(c), 'f', 3);
+    }
+
+    const bool vertical = m_chBoxVertical->isChecked();
+    m_lblSummary->setText(QString("Normalized: %1. %2Updated in %3 ms.")
+        .arg(normalized.join(", "))
+        .arg(instance.hasDeltas ? QString() : QString("No %1 table. ").arg(vertical ? "VVAR" : "HVAR"))
+        .arg(double(instance.elapsed) / 1e6, 0, 'f', 2));
+}
+
+void VariationsDialog::onGlyphClicked(const quint16 glyphId)
+{
+    const auto index = m_advancesModel->index(glyphId, AdvanceColumn::Glyph);
+    m_viewAdvances->setCurrentIndex(index);
+    m_viewAdvances->scrollTo(index);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDialog>
+#include <QDoubleSpinBox>
+#include <QGridLayout>
+#include <QLabel>
+#include <QSlider>
+#include <QThreadPool>
+#include <QTimer>
+#include <QTreeView>
+#include <QTreeWidget>
+
+#include <memory>
+
+#include "face.h"
+#include "glyphgrid.h"
+
+class AdvancesModel;
+class InstanceTask;
+
+// A variable font instance explorer.
+//
+// User coordinates are normalized via `fvar` and `avar`. Each change re-evaluates
+// `HVAR`, `VVAR` and `MVAR` deltas, while outlines are re-rendered with `gvar` or `CFF2`
+// variations only for glyphs visible in the preview.
+//
+// Changes are coalesced and instances are built on a worker thread,
+// so dragging a slider doesn't block the UI.
+class VariationsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    struct Instance
+    {
+        QVector<float> coords;
+        FaceInstance instance;
+        QVector<float> advances;
+        bool hasDeltas = false;
+        qint64 elapsed = 0;
+    };
+
+    explicit VariationsDialog(const std::vector<Face> &faces, QWidget *parent = nullptr);
+    ~VariationsDialog();
+
+private:
+    void onFaceChanged();
+    void onNamedInstanceChanged(const int index);
+    void onSliderMoved(const int axis);
+    void onSpinChanged(const int axis);
+    void syncSlider(const int axis);
+    void onCoordinatesChanged();
+    void startUpdate();
+    void onInstanceReady(const quint64 generation, const Instance &instance);
+    void onGlyphClicked(const quint16 glyphId);
+
+private:
+    friend class InstanceTask;
+
+    const std::vector<Face> &m_faces;
+    QComboBox * const m_cmbFace;
+    QComboBox * const m_cmbInstance;
+    QGridLayout * const m_axesLayout;
+    QCheckBox * const m_chBoxVertical;
+    QLabel * const m_lblSummary;
+    GlyphGrid * const m_grid;
+    AdvancesModel * const m_advancesModel;
+    QTreeView * const m_viewAdvances;
+    QTreeWidget * const m_treeMetrics;
+    QVector<QSlider*> m_axisSliders;
+    QVector<QDoubleSpinBox*> m_axisSpins;
+    QVector<NamedInstance> m_namedInstances;
+    QTimer * const m_updateTimer;
+    // A copy of the current face, used only by instance tasks.
+    std::shared_ptr<const Face> m_workerFace;
+    // Results for previous faces are ignored.
+    quint64 m_generation = 0;
+    QThreadPool m_pool;
+};
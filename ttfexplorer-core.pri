@@ -0,0 +1,15 @@
+# Links a project against the ttfexplorer-core library.
+
+INCLUDEPATH += $$PWD $$PWD/src
+DEPENDPATH  += $$PWD/src
+
+CORE_LIB_DIR = $$shadowed($$PWD)
+win32 {
+    CONFIG(debug, debug|release): CORE_LIB_DIR = $$CORE_LIB_DIR/debug
+    else: CORE_LIB_DIR = $$CORE_LIB_DIR/release
+}
+
+LIBS += -L$$CORE_LIB_DIR -lttfexplorer-core
+
+win32-msvc*: PRE_TARGETDEPS += $$CORE_LIB_DIR/ttfexplorer-core.lib
+else: PRE_TARGETDEPS += $$CORE_LIB_DIR/libttfexplorer-core.a